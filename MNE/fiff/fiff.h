@@ -51,11 +51,15 @@
 #include "fiff_dir_entry.h"
 #include "fiff_named_matrix.h"
 #include "fiff_tag.h"
+#include "fiff_lazy_tag.h"
+#include "fiff_buffer_codec.h"
 #include "fiff_types.h"
 #include "fiff_proj.h"
 #include "fiff_ctf_comp.h"
 #include "fiff_info.h"
 #include "fiff_raw_data.h"
+#include "fiff_raw_read_ahead.h"
+#include "fiff_raw_writer.h"
 #include "fiff_raw_dir.h"
 #include "fiff_stream.h"
 #include "fiff_evoked_set.h"
@@ -82,6 +82,10 @@ SOURCES += fiff.cpp \
     fiff_proj.cpp \
     fiff_named_matrix.cpp \
     fiff_raw_data.cpp \
+    fiff_raw_read_ahead.cpp \
+    fiff_raw_writer.cpp \
+    fiff_lazy_tag.cpp \
+    fiff_buffer_codec.cpp \
     fiff_ctf_comp.cpp \
     fiff_id.cpp \
     fiff_info.cpp \
@@ -111,6 +115,10 @@ HEADERS += fiff.h \
     fiff_ctf_comp.h \
     fiff_info.h \
     fiff_raw_data.h \
+    fiff_raw_read_ahead.h \
+    fiff_raw_writer.h \
+    fiff_lazy_tag.h \
+    fiff_buffer_codec.h \
     fiff_dir_entry.h \
     fiff_raw_dir.h \
     fiff_dig_point.h \
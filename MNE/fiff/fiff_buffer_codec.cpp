@@ -0,0 +1,454 @@
+//=============================================================================================================
+/**
+* @file     fiff_buffer_codec.cpp
+* @author   Christoph Dinh <chdinh@nmr.mgh.harvard.edu>;
+*           Matti Hamalainen <msh@nmr.mgh.harvard.edu>
+* @version  1.0
+* @date     October, 2026
+*
+* @section  LICENSE
+*
+* Copyright (C) 2012, Christoph Dinh and Matti Hamalainen. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+* the following conditions are met:
+*     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+*       following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+*       the following disclaimer in the documentation and/or other materials provided with the distribution.
+*     * Neither the name of the Massachusetts General Hospital nor the names of its contributors may be used
+*       to endorse or promote products derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+* PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL MASSACHUSETTS GENERAL HOSPITAL BE LIABLE FOR ANY DIRECT,
+* INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+* NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+* @brief    Implementation of the FiffBufferCodec Class.
+*
+*/
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include "fiff_buffer_codec.h"
+#include "fiff_constants.h"
+
+#include <cstring>
+#include <cmath>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// Qt INCLUDES
+//=============================================================================================================
+
+#include <QtEndian>
+#include <QVector>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// USED NAMESPACES
+//=============================================================================================================
+
+using namespace FIFFLIB;
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// STATIC HELPERS
+//=============================================================================================================
+
+namespace
+{
+
+const qint32 HeaderSize = 3*sizeof(qint32);
+
+inline bool isSupportedType(fiff_int_t type)
+{
+    return type == FIFFT_INT || type == FIFFT_FLOAT || type == FIFFT_DAU_PACK16 || type == FIFFT_SHORT;
+}
+
+inline int countLeadingZeros(quint64 x)
+{
+#if defined(__GNUC__)
+    return __builtin_clzll(x);
+#else
+    int n = 0;
+    while(!(x & (Q_UINT64_C(1) << 63)))
+    {
+        x <<= 1;
+        ++n;
+    }
+    return n;
+#endif
+}
+
+inline quint32 zigzag(quint32 x, quint32 prev)
+{
+    qint32 d = (qint32)(x - prev);
+    return ((quint32)d << 1) ^ (quint32)(d >> 31);
+}
+
+inline quint32 unzigzag(quint32 u, quint32 prev)
+{
+    return prev + ((u >> 1) ^ (0u - (u & 1)));
+}
+
+//=============================================================================================================
+/**
+* MSB first bit writer into a preallocated buffer. Fewer than 8 bits are pending between calls.
+*/
+class BitWriter
+{
+public:
+    BitWriter(uchar* p_pDst) : m_pDst(p_pDst), m_pPos(p_pDst), m_iAcc(0), m_iBits(0) {}
+
+    inline void zeros(int n)            // n <= 32
+    {
+        flush();
+        m_iBits += n;
+    }
+
+    inline void put(quint32 v, int n)   // 0 < n <= 32, v < 2^n
+    {
+        flush();
+        m_iAcc |= (quint64)v << (64 - m_iBits - n);
+        m_iBits += n;
+    }
+
+    inline qint64 finish()
+    {
+        flush();
+        if(m_iBits > 0)
+        {
+            *m_pPos++ = (uchar)(m_iAcc >> 56);
+            m_iAcc = 0;
+            m_iBits = 0;
+        }
+        return m_pPos - m_pDst;
+    }
+
+private:
+    inline void flush()
+    {
+        while(m_iBits >= 8)
+        {
+            *m_pPos++ = (uchar)(m_iAcc >> 56);
+            m_iAcc <<= 8;
+            m_iBits -= 8;
+        }
+    }
+
+    uchar* m_pDst;
+    uchar* m_pPos;
+    quint64 m_iAcc;
+    int m_iBits;
+};
+
+//=============================================================================================================
+/**
+* MSB first bit reader; reads zeros past the end, which is detected by overrun().
+*/
+class BitReader
+{
+public:
+    BitReader(const uchar* p_pSrc, qint64 p_iSize) : m_pSrc(p_pSrc), m_pPos(p_pSrc), m_pEnd(p_pSrc + p_iSize), m_iAcc(0), m_iBits(0) {}
+
+    inline void refill()
+    {
+        while(m_iBits <= 56)
+        {
+            quint64 b = m_pPos < m_pEnd ? *m_pPos : 0;
+            ++m_pPos;
+            m_iAcc |= b << (56 - m_iBits);
+            m_iBits += 8;
+        }
+    }
+
+    inline quint64 peek() const
+    {
+        return m_iAcc;
+    }
+
+    inline void skip(int n)             // n <= m_iBits
+    {
+        m_iAcc <<= n;
+        m_iBits -= n;
+    }
+
+    inline quint32 get(int n)           // 0 < n <= 32, n <= m_iBits
+    {
+        quint32 v = (quint32)(m_iAcc >> (64 - n));
+        m_iAcc <<= n;
+        m_iBits -= n;
+        return v;
+    }
+
+    inline bool overrun() const
+    {
+        return (m_pPos - m_pSrc)*8 - m_iBits > (m_pEnd - m_pSrc)*8;
+    }
+
+private:
+    const uchar* m_pSrc;
+    const uchar* m_pPos;
+    const uchar* m_pEnd;
+    quint64 m_iAcc;
+    int m_iBits;
+};
+
+//=============================================================================================================
+/**
+* Encodes one channel (words at stride nchan) and returns the number of bytes written.
+*/
+qint64 encodeChannel(const qint32* p_pWords, qint32 p_iStride, qint32 p_iNSamp, uchar* p_pDst)
+{
+    BitWriter writer(p_pDst);
+    quint32 residuals[FiffBufferCodec::BlockSize];
+
+    quint32 prev = 0;
+    for(qint32 start = 0; start < p_iNSamp; start += FiffBufferCodec::BlockSize)
+    {
+        qint32 n = p_iNSamp - start < FiffBufferCodec::BlockSize ? p_iNSamp - start : FiffBufferCodec::BlockSize;
+
+        quint64 sum = 0;
+        for(qint32 i = 0; i < n; ++i)
+        {
+            quint32 x = (quint32)p_pWords[(qint64)(start + i)*p_iStride];
+            residuals[i] = zigzag(x, prev);
+            sum += residuals[i];
+            prev = x;
+        }
+
+        //
+        //  Rice parameter ~ log2 of the mean residual
+        //
+        int k = 0;
+        while(k < 31 && ((quint64)n << (k + 1)) <= sum)
+            ++k;
+        writer.put(k, 5);
+
+        for(qint32 i = 0; i < n; ++i)
+        {
+            quint32 u = residuals[i];
+            quint32 q = u >> k;
+            if(q < (quint32)FiffBufferCodec::EscapeCode)
+            {
+                writer.zeros(q);
+                writer.put((1u << k) | (u & ((1u << k) - 1)), k + 1);
+            }
+            else
+            {
+                writer.zeros(FiffBufferCodec::EscapeCode);
+                writer.put(1, 1);
+                writer.put(u, 32);
+            }
+        }
+    }
+
+    return writer.finish();
+}
+
+//=============================================================================================================
+/**
+* Decodes one channel into words.
+*/
+bool decodeChannel(const uchar* p_pSrc, qint64 p_iSize, qint32 p_iNSamp, quint32* p_pWords)
+{
+    BitReader reader(p_pSrc, p_iSize);
+
+    quint32 prev = 0;
+    for(qint32 start = 0; start < p_iNSamp; start += FiffBufferCodec::BlockSize)
+    {
+        qint32 n = p_iNSamp - start < FiffBufferCodec::BlockSize ? p_iNSamp - start : FiffBufferCodec::BlockSize;
+
+        reader.refill();
+        int k = reader.get(5);
+
+        for(qint32 i = 0; i < n; ++i)
+        {
+            reader.refill();
+            quint64 acc = reader.peek();
+            if(acc == 0)
+                return false;
+            int q = countLeadingZeros(acc);
+            if(q > FiffBufferCodec::EscapeCode)
+                return false;
+            reader.skip(q + 1);
+
+            quint32 u;
+            if(q == FiffBufferCodec::EscapeCode)
+            {
+                reader.refill();
+                u = reader.get(32);
+            }
+            else
+                u = k > 0 ? ((quint32)q << k) | reader.get(k) : (quint32)q;
+
+            prev = unzigzag(u, prev);
+            p_pWords[start + i] = prev;
+        }
+    }
+
+    return !reader.overrun();
+}
+
+inline double wordToValue(quint32 w, fiff_int_t type)
+{
+    switch(type)
+    {
+        case FIFFT_FLOAT:
+        {
+            float f;
+            memcpy(&f, &w, 4);
+            return f;
+        }
+        case FIFFT_DAU_PACK16:
+        case FIFFT_SHORT:
+            return (qint16)w;
+        default:
+            return (qint32)w;
+    }
+}
+
+} // NAMESPACE
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINE MEMBER METHODS
+//=============================================================================================================
+
+bool FiffBufferCodec::encode(const qint32* p_pWords, qint32 p_iNChan, qint32 p_iNSamp, fiff_int_t p_iStoreType, QByteArray& p_qByteArrayOut)
+{
+    if(!isSupportedType(p_iStoreType) || p_iNChan <= 0 || p_iNSamp < 0)
+        return false;
+
+    //
+    //  Worst case per channel: 5 bits per block, 57 bits per escaped residual
+    //
+    qint64 t_iChanBound = (qint64)p_iNSamp*8 + (p_iNSamp/BlockSize + 1) + 8;
+    qint64 t_iDirSize = HeaderSize + (qint64)p_iNChan*sizeof(qint32);
+    p_qByteArrayOut.resize(t_iDirSize + p_iNChan*t_iChanBound);
+
+    uchar* t_pOut = reinterpret_cast<uchar*>(p_qByteArrayOut.data());
+    qToBigEndian<qint32>(p_iStoreType, t_pOut);
+    qToBigEndian<qint32>(p_iNChan, t_pOut + 4);
+    qToBigEndian<qint32>(p_iNSamp, t_pOut + 8);
+
+    qint64 t_iPos = t_iDirSize;
+    for(qint32 c = 0; c < p_iNChan; ++c)
+    {
+        qint64 t_iBytes = encodeChannel(p_pWords + c, p_iNChan, p_iNSamp, t_pOut + t_iPos);
+        qToBigEndian<qint32>((qint32)t_iBytes, t_pOut + HeaderSize + c*sizeof(qint32));
+        t_iPos += t_iBytes;
+    }
+
+    p_qByteArrayOut.resize(t_iPos);
+    return true;
+}
+
+
+//*************************************************************************************************************
+
+bool FiffBufferCodec::encode(const MatrixXd& buf, const RowVectorXd& cals, fiff_int_t p_iStoreType, QByteArray& p_qByteArrayOut)
+{
+    if(buf.rows() != cals.cols() || !isSupportedType(p_iStoreType))
+        return false;
+
+    VectorXd inv_cals = cals.transpose().cwiseInverse();
+
+    double t_dMin = p_iStoreType == FIFFT_INT ? -2147483648.0 : -32768.0;
+    double t_dMax = p_iStoreType == FIFFT_INT ? 2147483647.0 : 32767.0;
+
+    Matrix<qint32, Dynamic, Dynamic> t_matWords(buf.rows(), buf.cols());
+    for(qint64 c = 0; c < buf.cols(); ++c)
+    {
+        for(qint32 r = 0; r < buf.rows(); ++r)
+        {
+            double t_dValue = buf(r,c)*inv_cals[r];
+            if(p_iStoreType == FIFFT_FLOAT)
+            {
+                float t_fValue = (float)t_dValue;
+                memcpy(&t_matWords(r,c), &t_fValue, 4);
+            }
+            else
+                t_matWords(r,c) = (qint32)floor(qBound(t_dMin, t_dValue, t_dMax) + 0.5);
+        }
+    }
+
+    return encode(t_matWords.data(), buf.rows(), buf.cols(), p_iStoreType, p_qByteArrayOut);
+}
+
+
+//*************************************************************************************************************
+
+bool FiffBufferCodec::readHeader(const uchar* p_pData, qint64 p_iSize, fiff_int_t& p_iStoreType, qint32& p_iNChan, qint32& p_iNSamp)
+{
+    if(p_iSize < HeaderSize)
+        return false;
+
+    p_iStoreType = qFromBigEndian<qint32>(p_pData);
+    p_iNChan = qFromBigEndian<qint32>(p_pData + 4);
+    p_iNSamp = qFromBigEndian<qint32>(p_pData + 8);
+
+    return isSupportedType(p_iStoreType) && p_iNChan > 0 && p_iNSamp >= 0;
+}
+
+
+//*************************************************************************************************************
+
+bool FiffBufferCodec::decode(const uchar* p_pData, qint64 p_iSize, MatrixXd& p_matData, const RowVectorXi& sel)
+{
+    fiff_int_t t_iType;
+    qint32 nchan, nsamp;
+    if(!readHeader(p_pData, p_iSize, t_iType, nchan, nsamp))
+        return false;
+
+    qint64 t_iDirSize = HeaderSize + (qint64)nchan*sizeof(qint32);
+    if(p_iSize < t_iDirSize)
+        return false;
+
+    //
+    //  Start of each channel stream. A stream holds at least one bit per sample, which bounds nsamp before
+    //  anything is allocated for a corrupt header.
+    //
+    QVector<qint64> t_qVecOffsets(nchan + 1);
+    t_qVecOffsets[0] = t_iDirSize;
+    for(qint32 c = 0; c < nchan; ++c)
+    {
+        qint32 t_iBytes = qFromBigEndian<qint32>(p_pData + HeaderSize + c*sizeof(qint32));
+        if(t_iBytes < 0 || (qint64)nsamp > 8*(qint64)t_iBytes)
+            return false;
+        t_qVecOffsets[c + 1] = t_qVecOffsets[c] + t_iBytes;
+    }
+    if(t_qVecOffsets[nchan] > p_iSize)
+        return false;
+
+    qint32 nrows = sel.cols() > 0 ? sel.cols() : nchan;
+    p_matData.resize(nrows, nsamp);
+
+    QVector<quint32> t_qVecWords(nsamp);
+    for(qint32 r = 0; r < nrows; ++r)
+    {
+        qint32 c = sel.cols() > 0 ? sel[r] : r;
+        if(c < 0 || c >= nchan)
+            return false;
+
+        if(!decodeChannel(p_pData + t_qVecOffsets[c], t_qVecOffsets[c + 1] - t_qVecOffsets[c], nsamp, t_qVecWords.data()))
+            return false;
+
+        for(qint32 s = 0; s < nsamp; ++s)
+            p_matData(r,s) = wordToValue(t_qVecWords[s], t_iType);
+    }
+
+    return true;
+}
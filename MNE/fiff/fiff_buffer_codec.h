@@ -0,0 +1,161 @@
+//=============================================================================================================
+/**
+* @file     fiff_buffer_codec.h
+* @author   Christoph Dinh <chdinh@nmr.mgh.harvard.edu>;
+*           Matti Hamalainen <msh@nmr.mgh.harvard.edu>
+* @version  1.0
+* @date     October, 2026
+*
+* @section  LICENSE
+*
+* Copyright (C) 2012, Christoph Dinh and Matti Hamalainen. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+* the following conditions are met:
+*     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+*       following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+*       the following disclaimer in the documentation and/or other materials provided with the distribution.
+*     * Neither the name of the Massachusetts General Hospital nor the names of its contributors may be used
+*       to endorse or promote products derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+* PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL MASSACHUSETTS GENERAL HOSPITAL BE LIABLE FOR ANY DIRECT,
+* INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+* NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+* @brief    FiffBufferCodec class declaration.
+*
+*/
+
+#ifndef FIFF_BUFFER_CODEC_H
+#define FIFF_BUFFER_CODEC_H
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include "fiff_global.h"
+#include "fiff_types.h"
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// Eigen INCLUDES
+//=============================================================================================================
+
+#include <Eigen/Core>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// Qt INCLUDES
+//=============================================================================================================
+
+#include <QByteArray>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINE NAMESPACE FIFFLIB
+//=============================================================================================================
+
+namespace FIFFLIB
+{
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// USED NAMESPACES
+//=============================================================================================================
+
+using namespace Eigen;
+
+
+//=============================================================================================================
+/**
+* Lossless codec of FIFFT_COMPRESSED_BUFFER data buffers. The samples are kept as 32 bit words of the original
+* storage type (FIFFT_INT, FIFFT_DAU_PACK16/FIFFT_SHORT sign extended, or the bit pattern of FIFFT_FLOAT).
+* Each channel is predicted from its previous sample; the zigzag mapped residuals are Rice coded in blocks
+* of 64 samples, each block with its own Rice parameter. Large residuals are escaped and stored verbatim.
+*
+* Payload layout, all integers big endian:
+*   int32 storage type, int32 nchan, int32 nsamp,
+*   int32 byte count of each channel stream [nchan],
+*   the channel streams, each padded to a full byte.
+*
+* The per channel byte counts allow to decode a channel selection without touching the other channels.
+*
+* @brief Delta/Rice codec of raw data buffers
+*/
+class FIFFSHARED_EXPORT FiffBufferCodec
+{
+public:
+    //=========================================================================================================
+    /**
+    * Encodes a buffer of 32 bit sample words.
+    *
+    * @param[in] p_pWords       The sample words, nchan x nsamp column-major (channels interleaved)
+    * @param[in] p_iNChan       Number of channels
+    * @param[in] p_iNSamp       Number of samples
+    * @param[in] p_iStoreType   Storage type the words represent (FIFFT_INT, FIFFT_DAU_PACK16, FIFFT_SHORT or FIFFT_FLOAT)
+    * @param[out] p_qByteArrayOut   The encoded payload
+    *
+    * @return true if succeeded, false if the storage type is not supported
+    */
+    static bool encode(const qint32* p_pWords, qint32 p_iNChan, qint32 p_iNSamp, fiff_int_t p_iStoreType, QByteArray& p_qByteArrayOut);
+
+    //=========================================================================================================
+    /**
+    * Uncalibrates a buffer and encodes it. Integer storage types are rounded (and clipped to the type range),
+    * which is lossless for data that were acquired as integers and calibrated with the same factors.
+    *
+    * @param[in] buf            The calibrated buffer, nchan x nsamp
+    * @param[in] cals           Calibration factors, 1 x nchan
+    * @param[in] p_iStoreType   Storage type (FIFFT_INT, FIFFT_DAU_PACK16, FIFFT_SHORT or FIFFT_FLOAT)
+    * @param[out] p_qByteArrayOut   The encoded payload
+    *
+    * @return true if succeeded, false if the sizes do not match or the storage type is not supported
+    */
+    static bool encode(const MatrixXd& buf, const RowVectorXd& cals, fiff_int_t p_iStoreType, QByteArray& p_qByteArrayOut);
+
+    //=========================================================================================================
+    /**
+    * Reads the payload header.
+    *
+    * @param[in] p_pData        Start of the payload
+    * @param[in] p_iSize        Size of the payload in bytes
+    * @param[out] p_iStoreType  Storage type of the samples
+    * @param[out] p_iNChan      Number of channels
+    * @param[out] p_iNSamp      Number of samples
+    *
+    * @return true if succeeded, false if the header is not valid
+    */
+    static bool readHeader(const uchar* p_pData, qint64 p_iSize, fiff_int_t& p_iStoreType, qint32& p_iNChan, qint32& p_iNSamp);
+
+    //=========================================================================================================
+    /**
+    * Decodes a payload to uncalibrated values.
+    *
+    * @param[in] p_pData        Start of the payload
+    * @param[in] p_iSize        Size of the payload in bytes
+    * @param[out] p_matData     The decoded buffer, nchan x nsamp, or sel.cols() x nsamp if a selection is given
+    * @param[in] sel            Channel selection vector; if empty all channels are decoded
+    *
+    * @return true if succeeded, false if the payload is corrupt
+    */
+    static bool decode(const uchar* p_pData, qint64 p_iSize, MatrixXd& p_matData, const RowVectorXi& sel = defaultRowVectorXi);
+
+    static const qint32 BlockSize = 64;     /**< Number of residuals sharing one Rice parameter. */
+    static const qint32 EscapeCode = 24;    /**< Quotient from which residuals are stored verbatim. */
+};
+
+} // NAMESPACE
+
+#endif // FIFF_BUFFER_CODEC_H
@@ -768,6 +768,14 @@ namespace FIFFLIB
 
 #define FIFFT_DATA_REF_STRUCT       38
 
+/*
+* mne-cpp private type, NOT part of the FIFF standard: losslessly compressed data buffer, see FiffBufferCodec.
+* It lies at the upper end of the base type range (FIFFTS_BASE_MASK), clear of the range of standard and future
+* standard types. Other FIFF readers do not know it; files with such buffers can only be read by mne-cpp.
+*/
+
+#define FIFFT_COMPRESSED_BUFFER     0x0F40
+
 /*
 * These are for matrices of any of the above
 */
@@ -41,6 +41,7 @@
 #include "fiff_dir_tree.h"
 #include "fiff_stream.h"
 #include "fiff_tag.h"
+#include "fiff_lazy_tag.h"
 //#include "fiff_ctf_comp.h"
 //#include "fiff_proj.h"
 //#include "fiff_info.h"
@@ -323,6 +324,24 @@ bool FiffDirTree::find_tag(FiffStream* p_pStream, fiff_int_t findkind, FiffTag::
 }
 
 
+//*************************************************************************************************************
+
+bool FiffDirTree::find_tag(FiffStream* p_pStream, fiff_int_t findkind, FiffLazyTag& p_Tag) const
+{
+    for (qint32 p = 0; p < this->nent; ++p)
+    {
+       if (this->dir[p].kind == findkind)
+       {
+          p_Tag = FiffLazyTag(p_pStream, this->dir[p]);
+          return true;
+       }
+    }
+    p_Tag = FiffLazyTag();
+
+    return false;
+}
+
+
 //*************************************************************************************************************
 
 bool FiffDirTree::has_tag(fiff_int_t findkind)
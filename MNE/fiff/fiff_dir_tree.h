@@ -70,6 +70,7 @@ namespace FIFFLIB
 
 class FiffStream;
 class FiffTag;
+class FiffLazyTag;
 
 //=============================================================================================================
 /**
@@ -178,6 +179,19 @@ public:
     */
     bool find_tag(FiffStream* p_pStream, fiff_int_t findkind, QSharedPointer<FiffTag>& p_pTag) const;
 
+    //=========================================================================================================
+    /**
+    * Founds a tag of a given kind within a tree without reading it. The payload is read on first access of
+    * the returned handle.
+    *
+    * @param[in] p_pStream the opened fif file
+    * @param[in] findkind the kind which should be found
+    * @param[out] p_Tag the handle of the found tag
+    *
+    * @return true if found, false otherwise
+    */
+    bool find_tag(FiffStream* p_pStream, fiff_int_t findkind, FiffLazyTag& p_Tag) const;
+
     //=========================================================================================================
     /**
     * Implementation of the has_tag function in fiff_read_named_matrix.m
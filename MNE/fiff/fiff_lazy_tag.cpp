@@ -0,0 +1,151 @@
+//=============================================================================================================
+/**
+* @file     fiff_lazy_tag.cpp
+* @author   Christoph Dinh <chdinh@nmr.mgh.harvard.edu>;
+*           Matti Hamalainen <msh@nmr.mgh.harvard.edu>
+* @version  1.0
+* @date     October, 2026
+*
+* @section  LICENSE
+*
+* Copyright (C) 2012, Christoph Dinh and Matti Hamalainen. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+* the following conditions are met:
+*     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+*       following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+*       the following disclaimer in the documentation and/or other materials provided with the distribution.
+*     * Neither the name of the Massachusetts General Hospital nor the names of its contributors may be used
+*       to endorse or promote products derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+* PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL MASSACHUSETTS GENERAL HOSPITAL BE LIABLE FOR ANY DIRECT,
+* INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+* NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+*
+* @brief    Implementation of the FiffLazyTag Class.
+*
+*/
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include "fiff_lazy_tag.h"
+#include "fiff_stream.h"
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// USED NAMESPACES
+//=============================================================================================================
+
+using namespace FIFFLIB;
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINE MEMBER METHODS
+//=============================================================================================================
+
+FiffLazyTag::FiffLazyTag()
+: m_pStream(NULL)
+{
+
+}
+
+
+//*************************************************************************************************************
+
+FiffLazyTag::FiffLazyTag(FiffStream* p_pStream, const FiffDirEntry& p_Entry)
+: m_pStream(p_pStream)
+, m_entry(p_Entry)
+{
+
+}
+
+
+//*************************************************************************************************************
+
+FiffLazyTag::~FiffLazyTag()
+{
+
+}
+
+
+//*************************************************************************************************************
+
+FiffTag::SPtr FiffLazyTag::tag() const
+{
+    if(!m_pTag && m_pStream)
+    {
+        if(!m_pStream->read_tag_cached(m_pTag, m_entry.pos))
+            m_pTag.clear();
+    }
+    return m_pTag;
+}
+
+
+//*************************************************************************************************************
+
+bool FiffLazyTag::getMatrixDimensions(qint32& p_ndim, QVector<qint32>& p_Dims) const
+{
+    p_Dims.clear();
+    p_ndim = 0;
+
+    if(m_pTag)
+        return m_pTag->getMatrixDimensions(p_ndim, p_Dims);
+
+    if(!m_pStream || (m_entry.type & IS_MATRIX) == 0 || m_entry.size < 4)
+        return false;
+
+    qint32 t_iNumDims;
+    if (FiffTag::fiff_type_matrix_coding(m_entry.type) == FIFFTS_MC_DENSE)
+        t_iNumDims = 0;
+    else if(FiffTag::fiff_type_matrix_coding(m_entry.type) == FIFFTS_MC_CCS || FiffTag::fiff_type_matrix_coding(m_entry.type) == FIFFTS_MC_RCS)
+        t_iNumDims = 1;
+    else
+    {
+        printf("Error: Cannot handle other than dense or sparse matrices yet.\n");
+        return false;
+    }
+
+    //
+    //   The dimensions are the last ints of the payload, which starts 16 bytes after the tag position
+    //
+    qint64 t_iEnd = (qint64)m_entry.pos + 16 + m_entry.size;
+    if(!m_pStream->device()->seek(t_iEnd - 4))
+        return false;
+    *m_pStream >> p_ndim;
+
+    t_iNumDims += p_ndim;
+    if(p_ndim <= 0 || 4*(t_iNumDims + 1) > m_entry.size)
+        return false;
+
+    m_pStream->device()->seek(t_iEnd - 4*(t_iNumDims + 1));
+    qint32 t_iDim;
+    for(qint32 i = 0; i < t_iNumDims; ++i)
+    {
+        *m_pStream >> t_iDim;
+        p_Dims.append(t_iDim);
+    }
+
+    return true;
+}
+
+
+//*************************************************************************************************************
+
+void FiffLazyTag::unload()
+{
+    if(m_pTag && m_pStream)
+        m_pStream->removeCachedTag(m_entry.pos);
+    m_pTag.clear();
+}
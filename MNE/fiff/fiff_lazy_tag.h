@@ -0,0 +1,238 @@
+//=============================================================================================================
+/**
+* @file     fiff_lazy_tag.h
+* @author   Christoph Dinh <chdinh@nmr.mgh.harvard.edu>;
+*           Matti Hamalainen <msh@nmr.mgh.harvard.edu>
+* @version  1.0
+* @date     October, 2026
+*
+* @section  LICENSE
+*
+* Copyright (C) 2012, Christoph Dinh and Matti Hamalainen. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+* the following conditions are met:
+*     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+*       following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+*       the following disclaimer in the documentation and/or other materials provided with the distribution.
+*     * Neither the name of the Massachusetts General Hospital nor the names of its contributors may be used
+*       to endorse or promote products derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+* PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL MASSACHUSETTS GENERAL HOSPITAL BE LIABLE FOR ANY DIRECT,
+* INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+* NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+*
+* @brief    FiffLazyTag class declaration.
+*
+*/
+
+#ifndef FIFF_LAZY_TAG_H
+#define FIFF_LAZY_TAG_H
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include "fiff_global.h"
+#include "fiff_types.h"
+#include "fiff_dir_entry.h"
+#include "fiff_tag.h"
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// Qt INCLUDES
+//=============================================================================================================
+
+#include <QSharedPointer>
+#include <QVector>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINE NAMESPACE FIFFLIB
+//=============================================================================================================
+
+namespace FIFFLIB
+{
+
+class FiffStream;
+
+
+//=============================================================================================================
+/**
+* Handle of a tag which is not read yet. Kind, type, size and position are known from the directory; the
+* payload is read and decoded on first access, through the tag cache of the stream. The stream has to be kept
+* open as long as the handle is used.
+*
+* @brief Lazily loaded fiff tag
+*/
+class FIFFSHARED_EXPORT FiffLazyTag {
+
+public:
+    typedef QSharedPointer<FiffLazyTag> SPtr;            /**< Shared pointer type for FiffLazyTag. */
+    typedef QSharedPointer<const FiffLazyTag> ConstSPtr; /**< Const shared pointer type for FiffLazyTag. */
+
+    //=========================================================================================================
+    /**
+    * Default constructor, creates an empty handle.
+    */
+    FiffLazyTag();
+
+    //=========================================================================================================
+    /**
+    * Constructs a handle of the tag described by a directory entry.
+    *
+    * @param[in] p_pStream  The stream to read the tag from
+    * @param[in] p_Entry    The directory entry of the tag
+    */
+    FiffLazyTag(FiffStream* p_pStream, const FiffDirEntry& p_Entry);
+
+    //=========================================================================================================
+    /**
+    * Destroys the handle.
+    */
+    ~FiffLazyTag();
+
+    //=========================================================================================================
+    /**
+    * Returns whether the handle refers to a tag.
+    *
+    * @return true if empty
+    */
+    inline bool isEmpty() const;
+
+    //=========================================================================================================
+    /**
+    * Returns whether the payload was already read.
+    *
+    * @return true if loaded
+    */
+    inline bool isLoaded() const;
+
+    //=========================================================================================================
+    /**
+    * Returns the tag kind.
+    *
+    * @return the tag kind
+    */
+    inline fiff_int_t kind() const;
+
+    //=========================================================================================================
+    /**
+    * Returns the data type of the tag.
+    *
+    * @return the data type
+    */
+    inline fiff_int_t type() const;
+
+    //=========================================================================================================
+    /**
+    * Returns the size of the payload.
+    *
+    * @return the payload size in bytes
+    */
+    inline fiff_int_t size() const;
+
+    //=========================================================================================================
+    /**
+    * Returns the position of the tag inside the stream.
+    *
+    * @return the tag position
+    */
+    inline fiff_int_t pos() const;
+
+    //=========================================================================================================
+    /**
+    * Returns the decoded tag; reads it on first access.
+    *
+    * @return the tag, NULL if it could not be read
+    */
+    FiffTag::SPtr tag() const;
+
+    //=========================================================================================================
+    /**
+    * Reads the dimensions of a matrix tag from the end of the payload, without reading the matrix data.
+    *
+    * @param[out] p_ndim    number of dimensions
+    * @param[out] p_Dims    the dimensions, in the same order as FiffTag::getMatrixDimensions
+    *
+    * @return true if succeeded, false if the tag is not a dense or sparse matrix
+    */
+    bool getMatrixDimensions(qint32& p_ndim, QVector<qint32>& p_Dims) const;
+
+    //=========================================================================================================
+    /**
+    * Drops the decoded tag and evicts it from the tag cache of the stream, so a bulk payload is freed as soon
+    * as the caller is done with it. Other handles still holding the tag keep it alive.
+    */
+    void unload();
+
+private:
+    FiffStream* m_pStream;          /**< The stream to read from. */
+    FiffDirEntry m_entry;           /**< Directory entry of the tag. */
+    mutable FiffTag::SPtr m_pTag;   /**< The decoded tag, NULL until first access. */
+};
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INLINE DEFINITIONS
+//=============================================================================================================
+
+inline bool FiffLazyTag::isEmpty() const
+{
+    return m_pStream == NULL;
+}
+
+
+//*************************************************************************************************************
+
+inline bool FiffLazyTag::isLoaded() const
+{
+    return !m_pTag.isNull();
+}
+
+
+//*************************************************************************************************************
+
+inline fiff_int_t FiffLazyTag::kind() const
+{
+    return m_entry.kind;
+}
+
+
+//*************************************************************************************************************
+
+inline fiff_int_t FiffLazyTag::type() const
+{
+    return m_entry.type;
+}
+
+
+//*************************************************************************************************************
+
+inline fiff_int_t FiffLazyTag::size() const
+{
+    return m_entry.size;
+}
+
+
+//*************************************************************************************************************
+
+inline fiff_int_t FiffLazyTag::pos() const
+{
+    return m_entry.pos;
+}
+
+} // NAMESPACE
+
+#endif // FIFF_LAZY_TAG_H
@@ -116,6 +116,18 @@ void FiffNamedMatrix::transpose_named_matrix()
 
     this->data.transposeInPlace();
 
-    this->nrow = this->data.rows();
-    this->ncol = this->data.cols();
+    //
+    //   If only the dimensions were read there are no data to take the size from
+    //
+    if(this->data.size() > 0)
+    {
+        this->nrow = this->data.rows();
+        this->ncol = this->data.cols();
+    }
+    else
+    {
+        fiff_int_t nrow_old = this->nrow;
+        this->nrow = this->ncol;
+        this->ncol = nrow_old;
+    }
 }
@@ -41,7 +41,18 @@
 #include "fiff_raw_data.h"
 #include "fiff_tag.h"
 #include "fiff_stream.h"
+#include "fiff_buffer_codec.h"
 #include "cstdlib"
+#include <cstring>
+#include <algorithm>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// Qt INCLUDES
+//=============================================================================================================
+
+#include <QtEndian>
 
 //*************************************************************************************************************
 //=============================================================================================================
@@ -51,6 +62,120 @@
 using namespace FIFFLIB;
 
 
+//*************************************************************************************************************
+//=============================================================================================================
+// STATIC HELPERS
+//=============================================================================================================
+
+//
+//   Reads one big endian value from the mapped file. Goes through an unsigned integer of the same size so that
+//   floats are swapped bitwise and not converted.
+//
+template<typename T>
+static inline double fromBigEndian(const uchar* p_pSrc)
+{
+    return (double)qFromBigEndian<T>(p_pSrc);
+}
+
+template<>
+inline double fromBigEndian<float>(const uchar* p_pSrc)
+{
+    quint32 t_iBits = qFromBigEndian<quint32>(p_pSrc);
+    float t_fValue;
+    memcpy(&t_fValue, &t_iBits, sizeof(float));
+    return (double)t_fValue;
+}
+
+
+//*************************************************************************************************************
+//
+//   Swaps, converts and scales p_iNSamp samples (columns) of a channel-interleaved big endian buffer in one pass.
+//   The inner loop runs along one destination column, i.e. contiguous in memory for both source and destination.
+//
+template<typename T>
+static void decodeBigEndian(const uchar* p_pData, qint32 p_iNChan, qint32 p_iFirst, qint32 p_iNSamp, const RowVectorXi& sel, const VectorXd& p_vecScale, MatrixXd& p_matDest, qint32 p_iDestCol)
+{
+    const qint64 t_iStride = (qint64)p_iNChan*sizeof(T);
+    const double* t_pScale = p_vecScale.data();
+    const qint32 nrows = sel.size() == 0 ? p_iNChan : (qint32)sel.size();
+
+    for(qint32 s = 0; s < p_iNSamp; ++s)
+    {
+        const uchar* t_pCol = p_pData + (qint64)(p_iFirst + s)*t_iStride;
+        double* t_pDest = p_matDest.data() + (qint64)(p_iDestCol + s)*p_matDest.rows();
+
+        if(sel.size() == 0)
+        {
+            for(qint32 r = 0; r < nrows; ++r)
+                t_pDest[r] = t_pScale[r]*fromBigEndian<T>(t_pCol + r*sizeof(T));
+        }
+        else
+        {
+            for(qint32 r = 0; r < nrows; ++r)
+                t_pDest[r] = t_pScale[r]*fromBigEndian<T>(t_pCol + sel[r]*sizeof(T));
+        }
+    }
+}
+
+
+//
+//   Exact comparison of two vectors of possibly different size.
+//
+template<typename DerivedA, typename DerivedB>
+static inline bool isSameMatrix(const MatrixBase<DerivedA>& a, const MatrixBase<DerivedB>& b)
+{
+    return a.rows() == b.rows() && a.cols() == b.cols() && (a.size() == 0 || a == b);
+}
+
+
+//
+//   Fingerprint of an operator matrix: shape, address of the data, the whole diagonal (all elements of a vector)
+//   and up to 64 strided elements. A new projector, compensator or calibration changes it, whether it was
+//   assigned in place or not, at O(nchan) instead of the O(nchan^2) of an element wise comparison.
+//
+static inline void hashWord(quint64& p_iHash, quint64 p_iWord)
+{
+    p_iHash ^= p_iWord;
+    p_iHash *= Q_UINT64_C(1099511628211);
+}
+
+static inline void hashValue(quint64& p_iHash, double p_dValue)
+{
+    quint64 t_iWord;
+    memcpy(&t_iWord, &p_dValue, sizeof(t_iWord));
+    hashWord(p_iHash, t_iWord);
+}
+
+template<typename Derived>
+static quint64 fingerprint(const PlainObjectBase<Derived>& p_mat)
+{
+    quint64 t_iHash = Q_UINT64_C(14695981039346656037);
+    hashWord(t_iHash, (quint64)p_mat.rows());
+    hashWord(t_iHash, (quint64)p_mat.cols());
+    hashWord(t_iHash, (quint64)(quintptr)p_mat.data());
+
+    if(p_mat.size() == 0)
+        return t_iHash;
+
+    if(p_mat.rows() == 1 || p_mat.cols() == 1)
+    {
+        for(typename Derived::Index i = 0; i < p_mat.size(); ++i)
+            hashValue(t_iHash, p_mat.data()[i]);
+        return t_iHash;
+    }
+
+    typename Derived::Index t_iDiag = qMin(p_mat.rows(), p_mat.cols());
+    for(typename Derived::Index i = 0; i < t_iDiag; ++i)
+        hashValue(t_iHash, p_mat.coeff(i,i));
+
+    typename Derived::Index t_iStride = qMax(p_mat.size() / 64, (typename Derived::Index)1);
+    for(typename Derived::Index i = 0; i < p_mat.size(); i += t_iStride)
+        hashValue(t_iHash, p_mat.data()[i]);
+
+    return t_iHash;
+}
+
+
 //*************************************************************************************************************
 //=============================================================================================================
 // DEFINE MEMBER METHODS
@@ -59,6 +184,10 @@ using namespace FIFFLIB;
 FiffRawData::FiffRawData()
 : first_samp(-1)
 , last_samp(-1)
+, m_bReadOp(false)
+, m_iReadOpCalsPrint(0)
+, m_iReadOpProjPrint(0)
+, m_iReadOpCompPrint(0)
 {
 
 }
@@ -69,6 +198,10 @@ FiffRawData::FiffRawData()
 FiffRawData::FiffRawData(QIODevice &p_IODevice)
 : first_samp(-1)
 , last_samp(-1)
+, m_bReadOp(false)
+, m_iReadOpCalsPrint(0)
+, m_iReadOpProjPrint(0)
+, m_iReadOpCompPrint(0)
 {
     //setup FiffRawData object
     if(!FiffStream::setup_read_raw(p_IODevice, *this))
@@ -89,8 +222,13 @@ FiffRawData::FiffRawData(const FiffRawData &p_FiffRawData)
 , last_samp(p_FiffRawData.last_samp)
 , cals(p_FiffRawData.cals)
 , rawdir(p_FiffRawData.rawdir)
+, rawdir_last(p_FiffRawData.rawdir_last)
 , proj(p_FiffRawData.proj)
 , comp(p_FiffRawData.comp)
+, m_bReadOp(false)
+, m_iReadOpCalsPrint(0)
+, m_iReadOpProjPrint(0)
+, m_iReadOpCompPrint(0)
 {
 
 }
@@ -113,8 +251,10 @@ void FiffRawData::clear()
     last_samp = -1;
     cals = RowVectorXd();
     rawdir.clear();
+    rawdir_last.clear();
     proj = MatrixXd();
     comp.clear();
+    m_bReadOp = false;
 }
 
 
@@ -122,11 +262,6 @@ void FiffRawData::clear()
 
 bool FiffRawData::read_raw_segment(MatrixXd& data, MatrixXd& times, fiff_int_t from, fiff_int_t to, const RowVectorXi& sel)
 {
-    bool projAvailable = true;
-
-    if (this->proj.size() == 0)
-        projAvailable = false;
-
     if(from == -1)
         from = this->first_samp;
     if(to == -1)
@@ -152,201 +287,72 @@ bool FiffRawData::read_raw_segment(MatrixXd& data, MatrixXd& times, fiff_int_t f
     qint32 dest  = 0;//1;
     qint32 i, k, r;
 
-    typedef Eigen::Triplet<double> T;
-    std::vector<T> tripletList;
-    tripletList.reserve(nchan);
-    for(i = 0; i < nchan; ++i)
-        tripletList.push_back(T(i, i, this->cals[i]));
-
-    SparseMatrix<double> cal(nchan, nchan);
-    cal.setFromTriplets(tripletList.begin(), tripletList.end());
-//    cal.makeCompressed();
-
-    MatrixXd mult_full;
-    //
     if (sel.size() == 0)
-    {
         data = MatrixXd(nchan, to-from+1);
-//            data->setZero();
-        if (projAvailable || this->comp.kind != -1)
-        {
-            if (!projAvailable)
-                mult_full = this->comp.data->data*cal;
-            else if (this->comp.kind == -1)
-                mult_full = this->proj*cal;
-            else
-                mult_full = this->proj*this->comp.data->data*cal;
-        }
-    }
     else
-    {
         data = MatrixXd(sel.size(),to-from+1);
-//            data->setZero();
+//    data->setZero();
 
-        MatrixXd selVect(sel.size(), nchan);
+    //
+    //  The calibration, compensation and projection operator is only rebuilt if the selection, cals, proj or
+    //  comp changed since the last call
+    //
+    if (!has_read_operator(sel))
+        make_read_operator(sel);
+    const SparseMatrix<double>& cal = m_matReadOpCal;
+    const SparseMatrix<double>& mult = m_matReadOpMult;
 
-        selVect.setZero();
+    bool do_debug = false;
 
-        if (!projAvailable && this->comp.kind == -1)
-        {
-            tripletList.clear();
-            tripletList.reserve(sel.size());
-            for(i = 0; i < sel.size(); ++i)
-                tripletList.push_back(T(i, i, this->cals[sel[i]]));
-            cal = SparseMatrix<double>(sel.size(), sel.size());
-            cal.setFromTriplets(tripletList.begin(), tripletList.end());
-        }
-        else
+    FiffStream::SPtr fid = this->file;
+    if (!fid->isMapped() && !fid->device()->isOpen())
+    {
+        if (!fid->device()->open(QIODevice::ReadOnly))
         {
-            if (!projAvailable)
-            {
-                qDebug() << "This has to be debugged! #1";
-                for( i = 0; i  < sel.size(); ++i)
-                    selVect.row(i) = this->comp.data->data.block(sel[i],0,1,nchan);
-                mult_full = selVect*cal;
-            }
-            else if (this->comp.kind == -1)
-            {
-                for( i = 0; i  < sel.size(); ++i)
-                    selVect.row(i) = this->proj.block(sel[i],0,1,nchan);
-
-                mult_full = selVect*cal;
-            }
-            else
-            {
-                qDebug() << "This has to be debugged! #3";
-                for( i = 0; i  < sel.size(); ++i)
-                    selVect.row(i) = this->proj.block(sel[i],0,1,nchan);
-
-                mult_full = selVect*this->comp.data->data*cal;
-            }
+            printf("Cannot open file %s",this->info.filename.toUtf8().constData());
         }
     }
 
-    bool do_debug = false;
     //
-    // Make mult sparse
+    //  Scaling applied while decoding mapped buffers: the calibration if there is nothing else to apply,
+    //  otherwise mult already contains the calibration
     //
-    tripletList.clear();
-    tripletList.reserve(mult_full.rows()*mult_full.cols());
-    for(i = 0; i < mult_full.rows(); ++i)
-        for(k = 0; k < mult_full.cols(); ++k)
-            if(mult_full(i,k) != 0)
-                tripletList.push_back(T(i, k, mult_full(i,k)));
-
-    SparseMatrix<double> mult(mult_full.rows(),mult_full.cols());
-    if(tripletList.size() > 0)
-        mult.setFromTriplets(tripletList.begin(), tripletList.end());
-//    mult.makeCompressed();
-
-    //
-
-    FiffStream::SPtr fid;
-    if (!this->file->device()->isOpen())
+    VectorXd scale;
+    if (fid->isMapped())
     {
-        if (!this->file->device()->open(QIODevice::ReadOnly))
+        if (mult.cols() == 0)
         {
-            printf("Cannot open file %s",this->info.filename.toUtf8().constData());
+            scale.resize(data.rows());
+            for(i = 0; i < data.rows(); ++i)
+                scale[i] = this->cals[sel.size() == 0 ? i : sel[i]];
         }
-        fid = this->file;
+        else
+            scale = VectorXd::Ones(nchan);
     }
-    else
+
+    //
+    //  Binary search for the buffers we need
+    //
+    if(this->rawdir_last.size() != this->rawdir.size())
+        this->make_rawdir_index();
+
+    qint32 first_buf, last_buf;
+    if(!find_raw_buffers(from, to, first_buf, last_buf))
     {
-        fid = this->file;
+        printf("No data buffers in this range\n");
+        return false;
     }
 
     MatrixXd one;
     fiff_int_t first_pick, last_pick, picksamp;
-    for(k = 0; k < this->rawdir.size(); ++k)
+    for(k = first_buf; k <= last_buf; ++k)
     {
-        FiffRawDir thisRawDir = this->rawdir[k];
+        const FiffRawDir& thisRawDir = this->rawdir[k];
         //
         //  Do we need this buffer
         //
-        if (thisRawDir.last > from)
+        if (thisRawDir.last >= from)
         {
-            if (thisRawDir.ent.kind == -1)
-            {
-                //
-                //  Take the easy route: skip is translated to zeros
-                //
-                if(do_debug)
-                    printf("S");
-                if (sel.cols() <= 0)
-                    one.resize(nchan,thisRawDir.nsamp);
-                else
-                    one.resize(sel.cols(),thisRawDir.nsamp);
-
-                one.setZero();
-            }
-            else
-            {
-                FiffTag::SPtr t_pTag;
-                FiffTag::read_tag(fid.data(), t_pTag, thisRawDir.ent.pos);
-                //
-                //   Depending on the state of the projection and selection
-                //   we proceed a little bit differently
-                //
-                if (mult.cols() == 0)
-                {
-                    if (sel.cols() == 0)
-                    {
-                        if (t_pTag->type == FIFFT_DAU_PACK16)
-                            one = cal*(Map< MatrixDau16 >( t_pTag->toDauPack16(),nchan, thisRawDir.nsamp)).cast<double>();
-                        else if(t_pTag->type == FIFFT_INT)
-                            one = cal*(Map< MatrixXi >( t_pTag->toInt(),nchan, thisRawDir.nsamp)).cast<double>();
-                        else if(t_pTag->type == FIFFT_FLOAT)
-                            one = cal*(Map< MatrixXf >( t_pTag->toFloat(),nchan, thisRawDir.nsamp)).cast<double>();
-                        else
-                            printf("Data Storage Format not known jet [1]!! Type: %d\n", t_pTag->type);
-                    }
-                    else
-                    {
-
-                        //ToDo find a faster solution for this!! --> make cal and mul sparse like in MATLAB
-                        MatrixXd newData(sel.cols(), thisRawDir.nsamp); //ToDo this can be done much faster, without newData
-
-                        if (t_pTag->type == FIFFT_DAU_PACK16)
-                        {
-                            MatrixXd tmp_data = (Map< MatrixDau16 > ( t_pTag->toDauPack16(),nchan, thisRawDir.nsamp)).cast<double>();
-
-                            for(r = 0; r < sel.size(); ++r)
-                                newData.block(r,0,1,thisRawDir.nsamp) = tmp_data.block(sel[r],0,1,thisRawDir.nsamp);
-                        }
-                        else if(t_pTag->type == FIFFT_INT)
-                        {
-                            MatrixXd tmp_data = (Map< MatrixXi >( t_pTag->toInt(),nchan, thisRawDir.nsamp)).cast<double>();
-
-                            for(r = 0; r < sel.size(); ++r)
-                                newData.block(r,0,1,thisRawDir.nsamp) = tmp_data.block(sel[r],0,1,thisRawDir.nsamp);
-                        }
-                        else if(t_pTag->type == FIFFT_FLOAT)
-                        {
-                            MatrixXd tmp_data = (Map< MatrixXf > ( t_pTag->toFloat(),nchan, thisRawDir.nsamp)).cast<double>();
-
-                            for(r = 0; r < sel.size(); ++r)
-                                newData.block(r,0,1,thisRawDir.nsamp) = tmp_data.block(sel[r],0,1,thisRawDir.nsamp);
-                        }
-                        else
-                        {
-                            printf("Data Storage Format not known jet [2]!! Type: %d\n", t_pTag->type);
-                        }
-
-                        one = cal*newData;
-                    }
-                }
-                else
-                {
-                    if (t_pTag->type == FIFFT_DAU_PACK16)
-                        one = mult*(Map< MatrixDau16 >( t_pTag->toDauPack16(),nchan, thisRawDir.nsamp)).cast<double>();
-                    else if(t_pTag->type == FIFFT_INT)
-                        one = mult*(Map< MatrixXi >( t_pTag->toInt(),nchan, thisRawDir.nsamp)).cast<double>();
-                    else if(t_pTag->type == FIFFT_FLOAT)
-                        one = mult*(Map< MatrixXf >( t_pTag->toFloat(),nchan, thisRawDir.nsamp)).cast<double>();
-                    else
-                        printf("Data Storage Format not known jet [3]!! Type: %d\n", t_pTag->type);
-                }
-            }
             //
             //  The picking logic is a bit complicated
             //
@@ -393,9 +399,6 @@ bool FiffRawData::read_raw_segment(MatrixXd& data, MatrixXd& times, fiff_int_t f
                 if (do_debug)
                     printf("B");
             }
-            //
-            //  Now we are ready to pick
-            //
             picksamp = last_pick - first_pick + 1;
 
             if(do_debug)
@@ -405,14 +408,160 @@ bool FiffRawData::read_raw_segment(MatrixXd& data, MatrixXd& times, fiff_int_t f
                 qDebug() << "picksamp: " << picksamp;
             }
 
-            if (picksamp > 0)
+            const uchar* t_pMapped = NULL;
+            if (thisRawDir.ent.kind != -1 && fid->isMapped())
+                t_pMapped = fid->mappedTagData(thisRawDir.ent);
+
+            if (t_pMapped)
+            {
+                //
+                //  Decode only the picked samples straight from the mapped file
+                //
+                if (picksamp > 0)
+                {
+                    if (mult.cols() == 0)
+                    {
+                        if(!decode_mapped_buffer(t_pMapped, thisRawDir.ent.type, thisRawDir.ent.size, first_pick, picksamp, sel, scale, data, dest))
+                            printf("Data Storage Format not known jet [4]!! Type: %d\n", thisRawDir.ent.type);
+                    }
+                    else
+                    {
+                        one.resize(nchan, picksamp);
+                        if(!decode_mapped_buffer(t_pMapped, thisRawDir.ent.type, thisRawDir.ent.size, first_pick, picksamp, defaultRowVectorXi, scale, one, 0))
+                            printf("Data Storage Format not known jet [4]!! Type: %d\n", thisRawDir.ent.type);
+                        data.block(0,dest,data.rows(),picksamp) = mult*one;
+                    }
+                    dest += picksamp;
+                }
+            }
+            else
             {
+                if (thisRawDir.ent.kind == -1)
+                {
+                    //
+                    //  Take the easy route: skip is translated to zeros
+                    //
+                    if(do_debug)
+                        printf("S");
+                    if (sel.cols() <= 0)
+                        one.resize(nchan,thisRawDir.nsamp);
+                    else
+                        one.resize(sel.cols(),thisRawDir.nsamp);
+
+                    one.setZero();
+                }
+                else
+                {
+                    //
+                    //  Not mapped (tag outside the mapping or mapping failed) -> read it from the device, which
+                    //  is not opened up front in the mapped mode
+                    //
+                    if (!fid->device()->isOpen() && !fid->device()->open(QIODevice::ReadOnly))
+                    {
+                        printf("Cannot open file %s\n",this->info.filename.toUtf8().constData());
+                        return false;
+                    }
+
+                    FiffTag::SPtr t_pTag;
+                    FiffTag::read_tag(fid.data(), t_pTag, thisRawDir.ent.pos);
+                    //
+                    //   Depending on the state of the projection and selection
+                    //   we proceed a little bit differently
+                    //
+                    if (mult.cols() == 0)
+                    {
+                        if (sel.cols() == 0)
+                        {
+                            if (t_pTag->type == FIFFT_DAU_PACK16)
+                                one = cal*(Map< MatrixDau16 >( t_pTag->toDauPack16(),nchan, thisRawDir.nsamp)).cast<double>();
+                            else if(t_pTag->type == FIFFT_INT)
+                                one = cal*(Map< MatrixXi >( t_pTag->toInt(),nchan, thisRawDir.nsamp)).cast<double>();
+                            else if(t_pTag->type == FIFFT_FLOAT)
+                                one = cal*(Map< MatrixXf >( t_pTag->toFloat(),nchan, thisRawDir.nsamp)).cast<double>();
+                            else if(t_pTag->type == FIFFT_COMPRESSED_BUFFER)
+                            {
+                                MatrixXd tmp_data;
+                                if(!FiffBufferCodec::decode(reinterpret_cast<const uchar*>(t_pTag->data()), t_pTag->size(), tmp_data))
+                                    printf("Corrupt compressed data buffer [1]!!\n");
+                                one = cal*tmp_data;
+                            }
+                            else
+                                printf("Data Storage Format not known jet [1]!! Type: %d\n", t_pTag->type);
+                        }
+                        else
+                        {
+
+                            //ToDo find a faster solution for this!! --> make cal and mul sparse like in MATLAB
+                            MatrixXd newData(sel.cols(), thisRawDir.nsamp); //ToDo this can be done much faster, without newData
+
+                            if (t_pTag->type == FIFFT_DAU_PACK16)
+                            {
+                                MatrixXd tmp_data = (Map< MatrixDau16 > ( t_pTag->toDauPack16(),nchan, thisRawDir.nsamp)).cast<double>();
+
+                                for(r = 0; r < sel.size(); ++r)
+                                    newData.block(r,0,1,thisRawDir.nsamp) = tmp_data.block(sel[r],0,1,thisRawDir.nsamp);
+                            }
+                            else if(t_pTag->type == FIFFT_INT)
+                            {
+                                MatrixXd tmp_data = (Map< MatrixXi >( t_pTag->toInt(),nchan, thisRawDir.nsamp)).cast<double>();
+
+                                for(r = 0; r < sel.size(); ++r)
+                                    newData.block(r,0,1,thisRawDir.nsamp) = tmp_data.block(sel[r],0,1,thisRawDir.nsamp);
+                            }
+                            else if(t_pTag->type == FIFFT_FLOAT)
+                            {
+                                MatrixXd tmp_data = (Map< MatrixXf > ( t_pTag->toFloat(),nchan, thisRawDir.nsamp)).cast<double>();
+
+                                for(r = 0; r < sel.size(); ++r)
+                                    newData.block(r,0,1,thisRawDir.nsamp) = tmp_data.block(sel[r],0,1,thisRawDir.nsamp);
+                            }
+                            else if(t_pTag->type == FIFFT_COMPRESSED_BUFFER)
+                            {
+                                //
+                                //  Only the selected channels are decoded
+                                //
+                                if(!FiffBufferCodec::decode(reinterpret_cast<const uchar*>(t_pTag->data()), t_pTag->size(), newData, sel))
+                                    printf("Corrupt compressed data buffer [2]!!\n");
+                            }
+                            else
+                            {
+                                printf("Data Storage Format not known jet [2]!! Type: %d\n", t_pTag->type);
+                            }
+
+                            one = cal*newData;
+                        }
+                    }
+                    else
+                    {
+                        if (t_pTag->type == FIFFT_DAU_PACK16)
+                            one = mult*(Map< MatrixDau16 >( t_pTag->toDauPack16(),nchan, thisRawDir.nsamp)).cast<double>();
+                        else if(t_pTag->type == FIFFT_INT)
+                            one = mult*(Map< MatrixXi >( t_pTag->toInt(),nchan, thisRawDir.nsamp)).cast<double>();
+                        else if(t_pTag->type == FIFFT_FLOAT)
+                            one = mult*(Map< MatrixXf >( t_pTag->toFloat(),nchan, thisRawDir.nsamp)).cast<double>();
+                        else if(t_pTag->type == FIFFT_COMPRESSED_BUFFER)
+                        {
+                            MatrixXd tmp_data;
+                            if(!FiffBufferCodec::decode(reinterpret_cast<const uchar*>(t_pTag->data()), t_pTag->size(), tmp_data))
+                                printf("Corrupt compressed data buffer [3]!!\n");
+                            one = mult*tmp_data;
+                        }
+                        else
+                            printf("Data Storage Format not known jet [3]!! Type: %d\n", t_pTag->type);
+                    }
+                }
+                //
+                //  Now we are ready to pick
+                //
+                if (picksamp > 0)
+                {
 //                    for(r = 0; r < data->rows(); ++r)
 //                        for(c = 0; c < picksamp; ++c)
 //                            (*data)(r,dest + c) = one(r,first_pick + c);
-                data.block(0,dest,data.rows(),picksamp) = one.block(0, first_pick, data.rows(), picksamp);
+                    data.block(0,dest,data.rows(),picksamp) = one.block(0, first_pick, data.rows(), picksamp);
 
-                dest += picksamp;
+                    dest += picksamp;
+                }
             }
         }
         //
@@ -436,6 +585,165 @@ bool FiffRawData::read_raw_segment(MatrixXd& data, MatrixXd& times, fiff_int_t f
 }
 
 
+//*************************************************************************************************************
+
+bool FiffRawData::has_read_operator(const RowVectorXi& sel) const
+{
+    //
+    //  No element wise comparison of cals, proj and comp - that would cost O(nchan^2) per read;
+    //  their fingerprints are compared instead
+    //
+    if (!m_bReadOp)
+        return false;
+    if (fingerprint(this->cals) != m_iReadOpCalsPrint || fingerprint(this->proj) != m_iReadOpProjPrint || comp_fingerprint() != m_iReadOpCompPrint)
+        return false;
+    return isSameMatrix(sel, m_vecReadOpSel);
+}
+
+
+//*************************************************************************************************************
+
+quint64 FiffRawData::comp_fingerprint() const
+{
+    quint64 t_iHash = Q_UINT64_C(14695981039346656037);
+    hashWord(t_iHash, (quint64)(qint64)this->comp.kind);
+    if (this->comp.kind != -1 && this->comp.data)
+        hashWord(t_iHash, fingerprint(this->comp.data->data));
+    return t_iHash;
+}
+
+
+//*************************************************************************************************************
+
+void FiffRawData::make_read_operator(const RowVectorXi& sel) const
+{
+    bool projAvailable = this->proj.size() > 0;
+
+    qint32 nchan = this->info.nchan;
+    qint32 i, k;
+
+    typedef Eigen::Triplet<double> T;
+    std::vector<T> tripletList;
+    tripletList.reserve(nchan);
+    for(i = 0; i < nchan; ++i)
+        tripletList.push_back(T(i, i, this->cals[i]));
+
+    SparseMatrix<double> cal(nchan, nchan);
+    cal.setFromTriplets(tripletList.begin(), tripletList.end());
+//    cal.makeCompressed();
+
+    MatrixXd mult_full;
+    //
+    if (sel.size() == 0)
+    {
+        if (projAvailable || this->comp.kind != -1)
+        {
+            if (!projAvailable)
+                mult_full = this->comp.data->data*cal;
+            else if (this->comp.kind == -1)
+                mult_full = this->proj*cal;
+            else
+                mult_full = this->proj*this->comp.data->data*cal;
+        }
+    }
+    else
+    {
+        MatrixXd selVect(sel.size(), nchan);
+
+        selVect.setZero();
+
+        if (!projAvailable && this->comp.kind == -1)
+        {
+            tripletList.clear();
+            tripletList.reserve(sel.size());
+            for(i = 0; i < sel.size(); ++i)
+                tripletList.push_back(T(i, i, this->cals[sel[i]]));
+            cal.resize(sel.size(), sel.size());
+            cal.setFromTriplets(tripletList.begin(), tripletList.end());
+        }
+        else
+        {
+            if (!projAvailable)
+            {
+                qDebug() << "This has to be debugged! #1";
+                for( i = 0; i  < sel.size(); ++i)
+                    selVect.row(i) = this->comp.data->data.block(sel[i],0,1,nchan);
+                mult_full = selVect*cal;
+            }
+            else if (this->comp.kind == -1)
+            {
+                for( i = 0; i  < sel.size(); ++i)
+                    selVect.row(i) = this->proj.block(sel[i],0,1,nchan);
+
+                mult_full = selVect*cal;
+            }
+            else
+            {
+                qDebug() << "This has to be debugged! #3";
+                for( i = 0; i  < sel.size(); ++i)
+                    selVect.row(i) = this->proj.block(sel[i],0,1,nchan);
+
+                mult_full = selVect*this->comp.data->data*cal;
+            }
+        }
+    }
+
+    //
+    // Make mult sparse
+    //
+    tripletList.clear();
+    tripletList.reserve(mult_full.rows()*mult_full.cols());
+    for(i = 0; i < mult_full.rows(); ++i)
+        for(k = 0; k < mult_full.cols(); ++k)
+            if(mult_full(i,k) != 0)
+                tripletList.push_back(T(i, k, mult_full(i,k)));
+
+    SparseMatrix<double> mult(mult_full.rows(),mult_full.cols());
+    if(tripletList.size() > 0)
+        mult.setFromTriplets(tripletList.begin(), tripletList.end());
+//    mult.makeCompressed();
+
+    //
+    //  Calibrated selection of all channels, for read_operator
+    //
+    SparseMatrix<double> selCal;
+    if (sel.size() > 0 && mult.cols() == 0)
+    {
+        tripletList.clear();
+        tripletList.reserve(sel.size());
+        for(i = 0; i < sel.size(); ++i)
+            tripletList.push_back(T(i, sel[i], this->cals[sel[i]]));
+        selCal.resize(sel.size(), nchan);
+        selCal.setFromTriplets(tripletList.begin(), tripletList.end());
+    }
+
+    //
+    //  Remember the state the operator was made for
+    //
+    m_vecReadOpSel = sel;
+    m_iReadOpCalsPrint = fingerprint(this->cals);
+    m_iReadOpProjPrint = fingerprint(this->proj);
+    m_iReadOpCompPrint = comp_fingerprint();
+    m_matReadOpCal = cal;
+    m_matReadOpMult = mult;
+    m_matReadOpSelCal = selCal;
+    m_bReadOp = true;
+}
+
+
+//*************************************************************************************************************
+
+const SparseMatrix<double>& FiffRawData::read_operator(const RowVectorXi& sel) const
+{
+    if (!has_read_operator(sel))
+        make_read_operator(sel);
+
+    if (m_matReadOpMult.cols() > 0)
+        return m_matReadOpMult;
+    return sel.size() == 0 ? m_matReadOpCal : m_matReadOpSelCal;
+}
+
+
 //*************************************************************************************************************
 
 bool FiffRawData::read_raw_segment_times(MatrixXd& data, MatrixXd& times, float from, float to, const RowVectorXi& sel)
@@ -450,3 +758,134 @@ bool FiffRawData::read_raw_segment_times(MatrixXd& data, MatrixXd& times, float
     //
     return this->read_raw_segment(data, times, (qint32)from, (qint32)to, sel);
 }
+
+
+//*************************************************************************************************************
+
+bool FiffRawData::mapFile()
+{
+    if(!this->file)
+        return false;
+
+    return this->file->mapFile();
+}
+
+
+//*************************************************************************************************************
+
+bool FiffRawData::read_raw_buffer(qint32 p_iBuf, MatrixXd& p_matData) const
+{
+    if(p_iBuf < 0 || p_iBuf >= this->rawdir.size())
+        return false;
+
+    const FiffRawDir& t_rawDir = this->rawdir[p_iBuf];
+    qint32 nchan = this->info.nchan;
+
+    p_matData.resize(nchan, t_rawDir.nsamp);
+
+    if(t_rawDir.ent.kind == -1)
+    {
+        p_matData.setZero();
+        return true;
+    }
+
+    const uchar* t_pMapped = this->file->isMapped() ? this->file->mappedTagData(t_rawDir.ent) : NULL;
+    if(t_pMapped)
+        return decode_mapped_buffer(t_pMapped, t_rawDir.ent.type, t_rawDir.ent.size, 0, t_rawDir.nsamp, defaultRowVectorXi, VectorXd::Ones(nchan), p_matData, 0);
+
+    if (!this->file->device()->isOpen())
+    {
+        if (!this->file->device()->open(QIODevice::ReadOnly))
+        {
+            printf("Cannot open file %s",this->info.filename.toUtf8().constData());
+            return false;
+        }
+    }
+
+    FiffTag::SPtr t_pTag;
+    if(!FiffTag::read_tag(this->file.data(), t_pTag, t_rawDir.ent.pos))
+        return false;
+
+    if (t_pTag->type == FIFFT_DAU_PACK16)
+        p_matData = (Map< MatrixDau16 >( t_pTag->toDauPack16(),nchan, t_rawDir.nsamp)).cast<double>();
+    else if(t_pTag->type == FIFFT_INT)
+        p_matData = (Map< MatrixXi >( t_pTag->toInt(),nchan, t_rawDir.nsamp)).cast<double>();
+    else if(t_pTag->type == FIFFT_FLOAT)
+        p_matData = (Map< MatrixXf >( t_pTag->toFloat(),nchan, t_rawDir.nsamp)).cast<double>();
+    else if(t_pTag->type == FIFFT_COMPRESSED_BUFFER)
+        return FiffBufferCodec::decode(reinterpret_cast<const uchar*>(t_pTag->data()), t_pTag->size(), p_matData);
+    else
+    {
+        printf("Data Storage Format not known jet!! Type: %d\n", t_pTag->type);
+        return false;
+    }
+
+    return true;
+}
+
+
+//*************************************************************************************************************
+
+bool FiffRawData::decode_mapped_buffer(const uchar* p_pData, fiff_int_t p_iType, fiff_int_t p_iSize, fiff_int_t p_iFirst, fiff_int_t p_iNSamp, const RowVectorXi& sel, const VectorXd& p_vecScale, MatrixXd& p_matDest, fiff_int_t p_iDestCol) const
+{
+    switch(p_iType)
+    {
+        case FIFFT_DAU_PACK16:
+        case FIFFT_SHORT:
+            decodeBigEndian<qint16>(p_pData, this->info.nchan, p_iFirst, p_iNSamp, sel, p_vecScale, p_matDest, p_iDestCol);
+            return true;
+        case FIFFT_INT:
+            decodeBigEndian<qint32>(p_pData, this->info.nchan, p_iFirst, p_iNSamp, sel, p_vecScale, p_matDest, p_iDestCol);
+            return true;
+        case FIFFT_FLOAT:
+            decodeBigEndian<float>(p_pData, this->info.nchan, p_iFirst, p_iNSamp, sel, p_vecScale, p_matDest, p_iDestCol);
+            return true;
+        case FIFFT_COMPRESSED_BUFFER:
+        {
+            //
+            //  The channel streams can not be entered at an arbitrary sample: decode the selected channels
+            //  of the whole buffer and pick from it
+            //
+            MatrixXd t_matBuffer;
+            if(!FiffBufferCodec::decode(p_pData, p_iSize, t_matBuffer, sel) || p_iFirst + p_iNSamp > t_matBuffer.cols())
+                return false;
+            p_matDest.block(0, p_iDestCol, t_matBuffer.rows(), p_iNSamp) = p_vecScale.asDiagonal()*t_matBuffer.block(0, p_iFirst, t_matBuffer.rows(), p_iNSamp);
+            return true;
+        }
+        default:
+            return false;
+    }
+}
+
+
+//*************************************************************************************************************
+
+void FiffRawData::make_rawdir_index()
+{
+    rawdir_last.resize(rawdir.size());
+    for(qint32 k = 0; k < rawdir.size(); ++k)
+        rawdir_last[k] = rawdir[k].last;
+}
+
+
+//*************************************************************************************************************
+
+bool FiffRawData::find_raw_buffers(fiff_int_t from, fiff_int_t to, qint32& p_iFirstBuf, qint32& p_iLastBuf) const
+{
+    if(rawdir_last.size() == 0 || rawdir_last.size() != rawdir.size())
+        return false;
+
+    //
+    //  First buffer: the first one ending at or after from; last buffer: the first one ending at or after to
+    //
+    const fiff_int_t* t_pBegin = rawdir_last.constData();
+    const fiff_int_t* t_pEnd = t_pBegin + rawdir_last.size();
+
+    p_iFirstBuf = std::lower_bound(t_pBegin, t_pEnd, from) - t_pBegin;
+    p_iLastBuf = std::lower_bound(t_pBegin, t_pEnd, to) - t_pBegin;
+
+    if(p_iLastBuf >= rawdir_last.size())
+        p_iLastBuf = rawdir_last.size() - 1;
+
+    return p_iFirstBuf <= p_iLastBuf;
+}
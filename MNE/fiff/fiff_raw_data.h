@@ -64,6 +64,7 @@
 #include <QFile>
 #include <QList>
 #include <QSharedPointer>
+#include <QVector>
 
 
 //*************************************************************************************************************
@@ -174,6 +175,114 @@ public:
     */
     bool read_raw_segment_times(MatrixXd& data, MatrixXd& times, float from, float to, const RowVectorXi& sel = defaultRowVectorXi);
 
+    //=========================================================================================================
+    /**
+    * Switches to memory mapped reading. Afterwards read_raw_segment decodes the data buffers directly from the
+    * mapped file: byte swapping and calibration are done in a single pass into the output matrix and only the
+    * requested samples are touched. Only available for raw data read from a QFile.
+    *
+    * @return true if succeeded, false otherwise
+    */
+    bool mapFile();
+
+    //=========================================================================================================
+    /**
+    * Builds the sample to buffer index of rawdir. This is done by FiffStream::setup_read_raw; it has to be
+    * called again only if rawdir is modified by hand.
+    */
+    void make_rawdir_index();
+
+    //=========================================================================================================
+    /**
+    * Looks up the rawdir entries which contain the samples from ... to by a binary search in the rawdir index.
+    *
+    * @param[in] from           first sample of the segment
+    * @param[in] to             last sample of the segment
+    * @param[out] p_iFirstBuf   index of the first rawdir entry to read
+    * @param[out] p_iLastBuf    index of the last rawdir entry to read
+    *
+    * @return true if the range is covered by rawdir, false otherwise
+    */
+    bool find_raw_buffers(fiff_int_t from, fiff_int_t to, qint32& p_iFirstBuf, qint32& p_iLastBuf) const;
+
+    //=========================================================================================================
+    /**
+    * Reads one complete data buffer of rawdir without calibration, projection or channel selection. Skips are
+    * returned as zeros. Uses the memory mapped file if available.
+    *
+    * @param[in] p_iBuf     index of the rawdir entry
+    * @param[out] p_matData returns the raw buffer (all channels x samples of the buffer)
+    *
+    * @return true if succeeded, false otherwise
+    */
+    bool read_raw_buffer(qint32 p_iBuf, MatrixXd& p_matData) const;
+
+    //=========================================================================================================
+    /**
+    * Discards the cached calibration, compensation and projection operator. Not needed after changing cals,
+    * proj or comp, read_raw_segment detects that by itself; it only forces the operator to be rebuilt.
+    */
+    inline void invalidate_read_operator();
+
+    //=========================================================================================================
+    /**
+    * Returns the calibration, compensation and projection operator of read_raw_segment for data of all channels,
+    * e.g. whole buffers from read_raw_buffer. The operator is cached and only rebuilt if the selection, cals,
+    * proj or comp changed.
+    *
+    * @param[in] sel    Channel selection vector; if empty all channels are selected
+    *
+    * @return the operator, selected channels x nchan
+    */
+    const SparseMatrix<double>& read_operator(const RowVectorXi& sel = defaultRowVectorXi) const;
+
+private:
+    //=========================================================================================================
+    /**
+    * Decodes samples of a memory mapped data buffer (file byte order) into the columns of a matrix.
+    *
+    * @param[in] p_pData        Start of the buffer payload inside the mapped file
+    * @param[in] p_iType        Buffer data type (FIFFT_DAU_PACK16, FIFFT_SHORT, FIFFT_INT, FIFFT_FLOAT or FIFFT_COMPRESSED_BUFFER)
+    * @param[in] p_iSize        Size of the buffer payload in bytes
+    * @param[in] p_iFirst       First sample of the buffer to decode
+    * @param[in] p_iNSamp       Number of samples to decode
+    * @param[in] sel            Channel selection vector; if empty all channels are decoded
+    * @param[in] p_vecScale     Scaling factor for each decoded row
+    * @param[out] p_matDest     The matrix to write to
+    * @param[in] p_iDestCol     The first column of p_matDest to write to
+    *
+    * @return true if succeeded, false if the data type is not supported
+    */
+    bool decode_mapped_buffer(const uchar* p_pData, fiff_int_t p_iType, fiff_int_t p_iSize, fiff_int_t p_iFirst, fiff_int_t p_iNSamp, const RowVectorXi& sel, const VectorXd& p_vecScale, MatrixXd& p_matDest, fiff_int_t p_iDestCol) const;
+
+    //=========================================================================================================
+    /**
+    * Checks whether the cached read operator was made for this selection and for the current cals, proj and
+    * comp, by comparing their fingerprints.
+    *
+    * @param[in] sel    Channel selection vector
+    *
+    * @return true if the cached operator can be used, false otherwise
+    */
+    bool has_read_operator(const RowVectorXi& sel) const;
+
+    //=========================================================================================================
+    /**
+    * Composes the calibration, compensation and projection operator for the given selection and caches it
+    * together with the state it was made for.
+    *
+    * @param[in] sel    Channel selection vector
+    */
+    void make_read_operator(const RowVectorXi& sel) const;
+
+    //=========================================================================================================
+    /**
+    * Fingerprint of the compensator: its kind and, if set, a fingerprint of the compensation matrix.
+    *
+    * @return the fingerprint
+    */
+    quint64 comp_fingerprint() const;
+
 public:
     FiffStream::SPtr file;      /**< replaces fid */
     FiffInfo info;              /**< Fiff measurement information */
@@ -181,10 +290,32 @@ public:
     fiff_int_t last_samp;       /**< Do we have a skip ToDo... */
     RowVectorXd cals;              /**< Calibration matrix: ToDo Check if RowVectorXd is enough */
     QList<FiffRawDir> rawdir;   /**< Special fiff diretory entry for raw data. */
-    MatrixXd proj;              /**< SSP operator to apply to the data. */
-    FiffCtfComp comp;           /**< Compensator. */
+    QVector<fiff_int_t> rawdir_last; /**< Last sample of each rawdir entry (ascending), the index for binary searches. */
+    MatrixXd proj;              /**< SSP operator to apply to the data */
+    FiffCtfComp comp;           /**< Compensator */
+
+private:
+    mutable bool m_bReadOp;                         /**< Whether the cached read operator is valid. */
+    mutable RowVectorXi m_vecReadOpSel;             /**< Selection the read operator was made for. */
+    mutable quint64 m_iReadOpCalsPrint;             /**< Fingerprint of cals the read operator was made for. */
+    mutable quint64 m_iReadOpProjPrint;             /**< Fingerprint of proj the read operator was made for. */
+    mutable quint64 m_iReadOpCompPrint;             /**< Fingerprint of comp the read operator was made for. */
+    mutable SparseMatrix<double> m_matReadOpCal;    /**< Cached (selected) calibration, used if there is no mult. */
+    mutable SparseMatrix<double> m_matReadOpMult;   /**< Cached calibration, compensation and projection operator. */
+    mutable SparseMatrix<double> m_matReadOpSelCal; /**< Cached calibrated selection (selected channels x nchan), returned by read_operator if there is no mult. */
 };
 
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INLINE DEFINITIONS
+//=============================================================================================================
+
+inline void FiffRawData::invalidate_read_operator()
+{
+    m_bReadOp = false;
+}
+
 } // NAMESPACE
 
 #endif // FIFF_RAW_DATA_H
@@ -0,0 +1,250 @@
+//=============================================================================================================
+/**
+* @file     fiff_raw_read_ahead.cpp
+* @author   Christoph Dinh <chdinh@nmr.mgh.harvard.edu>;
+*           Matti Hamalainen <msh@nmr.mgh.harvard.edu>
+* @version  1.0
+* @date     October, 2026
+*
+* @section  LICENSE
+*
+* Copyright (C) 2012, Christoph Dinh and Matti Hamalainen. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+* the following conditions are met:
+*     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+*       following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+*       the following disclaimer in the documentation and/or other materials provided with the distribution.
+*     * Neither the name of the Massachusetts General Hospital nor the names of its contributors may be used
+*       to endorse or promote products derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+* PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL MASSACHUSETTS GENERAL HOSPITAL BE LIABLE FOR ANY DIRECT,
+* INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+* NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+*
+* @brief    Implementation of the FiffRawReadAhead Class.
+*
+*/
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include "fiff_raw_read_ahead.h"
+#include "fiff_stream.h"
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// Qt INCLUDES
+//=============================================================================================================
+
+#include <QFile>
+#include <QThread>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINE NAMESPACE FIFFLIB
+//=============================================================================================================
+
+namespace FIFFLIB
+{
+
+//=============================================================================================================
+/**
+* Decoding thread of FiffRawReadAhead. Works on its own copy of the raw data, with its own file handle if the
+* raw data were read from a file, so that read_raw_segment can run concurrently.
+*
+* @brief Worker thread of FiffRawReadAhead
+*/
+class FiffRawReadAheadWorker : public QThread
+{
+public:
+    FiffRawReadAheadWorker(FiffRawReadAhead* p_pReadAhead, const FiffRawData& p_FiffRawData, const RowVectorXi& sel)
+    : m_pReadAhead(p_pReadAhead)
+    , m_raw(p_FiffRawData)
+    , m_sel(sel)
+    {
+        QFile* t_pFile = qobject_cast<QFile*>(p_FiffRawData.file->device());
+        if(t_pFile)
+        {
+            m_pFile = QSharedPointer<QFile>(new QFile(t_pFile->fileName()));
+            m_raw.file = FiffStream::SPtr(new FiffStream(m_pFile.data()));
+            if(p_FiffRawData.file->isMapped())
+                m_raw.file->mapFile();
+        }
+    }
+
+protected:
+    void run()
+    {
+        MatrixXd data, times;
+        fiff_int_t from, to;
+        qint32 chunk;
+        while((chunk = m_pReadAhead->claimChunk(from, to)) >= 0)
+        {
+            bool ok = m_raw.read_raw_segment(data, times, from, to, m_sel);
+            m_pReadAhead->putChunk(chunk, ok, data, times);
+        }
+        if(m_pFile && m_pFile->isOpen())
+            m_pFile->close();
+    }
+
+private:
+    FiffRawReadAhead* m_pReadAhead;     /**< The owning iterator. */
+    QSharedPointer<QFile> m_pFile;      /**< Own file handle, if the raw data were read from a file. */
+    FiffRawData m_raw;                  /**< Own copy of the raw data. */
+    RowVectorXi m_sel;                  /**< Channel selection. */
+};
+
+} // NAMESPACE
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// USED NAMESPACES
+//=============================================================================================================
+
+using namespace FIFFLIB;
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINE MEMBER METHODS
+//=============================================================================================================
+
+FiffRawReadAhead::FiffRawReadAhead(const FiffRawData& p_FiffRawData, fiff_int_t p_iChunkSize, qint32 p_iPrefetchDepth, qint32 p_iNumWorkers, fiff_int_t from, fiff_int_t to, const RowVectorXi& sel)
+: m_iFrom(from == -1 ? p_FiffRawData.first_samp : qMax(from, p_FiffRawData.first_samp))
+, m_iTo(to == -1 ? p_FiffRawData.last_samp : qMin(to, p_FiffRawData.last_samp))
+, m_iChunkSize(qMax(p_iChunkSize, 1))
+, m_iChunkCount(0)
+, m_qVecSlots(qMax(p_iPrefetchDepth, 1))
+, m_iNextClaim(0)
+, m_iNextDeliver(0)
+, m_bStop(false)
+{
+    if(m_iTo >= m_iFrom)
+        m_iChunkCount = (m_iTo - m_iFrom + m_iChunkSize) / m_iChunkSize;
+
+    for(qint32 i = 0; i < m_qVecSlots.size(); ++i)
+    {
+        m_qVecSlots[i].ready = false;
+        m_qVecSlots[i].ok = false;
+    }
+
+    //
+    //   Without an own file handle per worker the reads can't run concurrently
+    //
+    qint32 t_iNumWorkers = qBound(1, p_iNumWorkers, m_qVecSlots.size());
+    if(!qobject_cast<QFile*>(p_FiffRawData.file->device()))
+        t_iNumWorkers = 1;
+    t_iNumWorkers = qMin(t_iNumWorkers, qMax(m_iChunkCount, 1));
+
+    for(qint32 i = 0; i < t_iNumWorkers; ++i)
+        m_qListWorkers.append(new FiffRawReadAheadWorker(this, p_FiffRawData, sel));
+    for(qint32 i = 0; i < m_qListWorkers.size(); ++i)
+        m_qListWorkers[i]->start();
+}
+
+
+//*************************************************************************************************************
+
+FiffRawReadAhead::~FiffRawReadAhead()
+{
+    stop();
+    for(qint32 i = 0; i < m_qListWorkers.size(); ++i)
+    {
+        m_qListWorkers[i]->wait();
+        delete m_qListWorkers[i];
+    }
+}
+
+
+//*************************************************************************************************************
+
+bool FiffRawReadAhead::next(MatrixXd& data, MatrixXd& times)
+{
+    QMutexLocker locker(&m_qMutex);
+
+    if(m_bStop || m_iNextDeliver >= m_iChunkCount)
+        return false;
+
+    Slot& t_slot = m_qVecSlots[m_iNextDeliver % m_qVecSlots.size()];
+    while(!t_slot.ready && !m_bStop)
+        m_qCondReady.wait(&m_qMutex);
+
+    if(m_bStop)
+        return false;
+
+    data.swap(t_slot.data);
+    times.swap(t_slot.times);
+    t_slot.ready = false;
+    ++m_iNextDeliver;
+
+    m_qCondFree.wakeAll();
+
+    return t_slot.ok;
+}
+
+
+//*************************************************************************************************************
+
+void FiffRawReadAhead::stop()
+{
+    QMutexLocker locker(&m_qMutex);
+    m_bStop = true;
+    m_qCondFree.wakeAll();
+    m_qCondReady.wakeAll();
+}
+
+
+//*************************************************************************************************************
+
+qint32 FiffRawReadAhead::claimChunk(fiff_int_t& p_iFrom, fiff_int_t& p_iTo)
+{
+    QMutexLocker locker(&m_qMutex);
+
+    if(m_bStop || m_iNextClaim >= m_iChunkCount)
+        return -1;
+
+    qint32 t_iChunk = m_iNextClaim++;
+
+    //
+    //   Wait until the chunk fits into the queue; the chunk to be delivered next always does, so this can't deadlock
+    //
+    while(t_iChunk >= m_iNextDeliver + m_qVecSlots.size() && !m_bStop)
+        m_qCondFree.wait(&m_qMutex);
+
+    if(m_bStop)
+        return -1;
+
+    p_iFrom = m_iFrom + t_iChunk*m_iChunkSize;
+    p_iTo = qMin(p_iFrom + m_iChunkSize - 1, m_iTo);
+
+    return t_iChunk;
+}
+
+
+//*************************************************************************************************************
+
+void FiffRawReadAhead::putChunk(qint32 p_iChunk, bool p_bOk, MatrixXd& data, MatrixXd& times)
+{
+    QMutexLocker locker(&m_qMutex);
+
+    Slot& t_slot = m_qVecSlots[p_iChunk % m_qVecSlots.size()];
+    t_slot.data.swap(data);
+    t_slot.times.swap(times);
+    t_slot.ok = p_bOk;
+    t_slot.ready = true;
+
+    m_qCondReady.wakeAll();
+}
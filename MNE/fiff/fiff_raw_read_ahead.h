@@ -0,0 +1,230 @@
+//=============================================================================================================
+/**
+* @file     fiff_raw_read_ahead.h
+* @author   Christoph Dinh <chdinh@nmr.mgh.harvard.edu>;
+*           Matti Hamalainen <msh@nmr.mgh.harvard.edu>
+* @version  1.0
+* @date     October, 2026
+*
+* @section  LICENSE
+*
+* Copyright (C) 2012, Christoph Dinh and Matti Hamalainen. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+* the following conditions are met:
+*     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+*       following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+*       the following disclaimer in the documentation and/or other materials provided with the distribution.
+*     * Neither the name of the Massachusetts General Hospital nor the names of its contributors may be used
+*       to endorse or promote products derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+* PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL MASSACHUSETTS GENERAL HOSPITAL BE LIABLE FOR ANY DIRECT,
+* INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+* NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+*
+* @brief    FiffRawReadAhead class declaration.
+*
+*/
+
+#ifndef FIFF_RAW_READ_AHEAD_H
+#define FIFF_RAW_READ_AHEAD_H
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include "fiff_global.h"
+#include "fiff_types.h"
+#include "fiff_raw_data.h"
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// Eigen INCLUDES
+//=============================================================================================================
+
+#include <Eigen/Core>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// Qt INCLUDES
+//=============================================================================================================
+
+#include <QList>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QSharedPointer>
+#include <QVector>
+#include <QWaitCondition>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINE NAMESPACE FIFFLIB
+//=============================================================================================================
+
+namespace FIFFLIB
+{
+
+class FiffRawReadAheadWorker;
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// USED NAMESPACES
+//=============================================================================================================
+
+using namespace Eigen;
+
+
+//=============================================================================================================
+/**
+* Read-ahead iterator for sequential scans over raw data. The range from ... to is split into chunks of a fixed
+* number of samples. Worker threads read, decode and calibrate/project the chunks in advance (each with its own
+* file handle) into a bounded queue of prefetch depth slots, while the caller consumes them in order by next().
+* If the raw data were not read from a file, a single worker shares the stream, which must then not be read
+* elsewhere while the iterator is active.
+*
+* @brief Prefetching raw data reader
+*/
+class FIFFSHARED_EXPORT FiffRawReadAhead
+{
+    friend class FiffRawReadAheadWorker;
+
+public:
+    typedef QSharedPointer<FiffRawReadAhead> SPtr;              /**< Shared pointer type for FiffRawReadAhead. */
+    typedef QSharedPointer<const FiffRawReadAhead> ConstSPtr;   /**< Const shared pointer type for FiffRawReadAhead. */
+
+    //=========================================================================================================
+    /**
+    * Constructs the read-ahead iterator and starts prefetching.
+    *
+    * @param[in] p_FiffRawData      The raw data to scan; its proj and comp are applied
+    * @param[in] p_iChunkSize       Number of samples per chunk (the last chunk may be shorter)
+    * @param[in] p_iPrefetchDepth   Maximal number of decoded chunks held in advance
+    * @param[in] p_iNumWorkers      Number of decoding threads; limited to the prefetch depth
+    * @param[in] from               first sample to include. If omitted, defaults to the first sample in data (optional)
+    * @param[in] to                 last sample to include. If omitted, defaults to the last sample in data (optional)
+    * @param[in] sel                channel selection vector (optional)
+    */
+    FiffRawReadAhead(const FiffRawData& p_FiffRawData, fiff_int_t p_iChunkSize, qint32 p_iPrefetchDepth = 4, qint32 p_iNumWorkers = 2, fiff_int_t from = -1, fiff_int_t to = -1, const RowVectorXi& sel = defaultRowVectorXi);
+
+    //=========================================================================================================
+    /**
+    * Stops the workers and destroys the iterator.
+    */
+    ~FiffRawReadAhead();
+
+    //=========================================================================================================
+    /**
+    * Returns the next chunk. Blocks only if the chunk is not decoded yet. The memory of the passed matrices is
+    * handed back to the queue and reused for later chunks.
+    *
+    * @param[out] data      returns the data matrix (channels x samples) of the chunk
+    * @param[out] times     returns the time values corresponding to the samples
+    *
+    * @return true if a chunk was returned, false at the end of the range or if the chunk could not be read
+    */
+    bool next(MatrixXd& data, MatrixXd& times);
+
+    //=========================================================================================================
+    /**
+    * Stops prefetching; subsequent calls of next() return false.
+    */
+    void stop();
+
+    //=========================================================================================================
+    /**
+    * Returns the number of chunks the range is split into.
+    *
+    * @return the number of chunks
+    */
+    inline qint32 chunkCount() const;
+
+    //=========================================================================================================
+    /**
+    * Returns whether all chunks were consumed.
+    *
+    * @return true if next() has no more chunks
+    */
+    inline bool atEnd() const;
+
+private:
+    //=========================================================================================================
+    /**
+    * Claims the next chunk to decode; waits until its queue slot is free. Called by the workers.
+    *
+    * @param[out] p_iFrom   first sample of the claimed chunk
+    * @param[out] p_iTo     last sample of the claimed chunk
+    *
+    * @return the index of the claimed chunk, -1 if there is nothing left to do
+    */
+    qint32 claimChunk(fiff_int_t& p_iFrom, fiff_int_t& p_iTo);
+
+    //=========================================================================================================
+    /**
+    * Hands a decoded chunk over to the queue. The passed matrices receive the slots previous memory.
+    *
+    * @param[in] p_iChunk   index of the chunk
+    * @param[in] p_bOk      whether the chunk was read successfully
+    * @param[in] data       the chunk data
+    * @param[in] times      the chunk times
+    */
+    void putChunk(qint32 p_iChunk, bool p_bOk, MatrixXd& data, MatrixXd& times);
+
+    struct Slot
+    {
+        MatrixXd data;      /**< Decoded data of the chunk. */
+        MatrixXd times;     /**< Times of the chunk. */
+        bool ready;         /**< Whether the chunk is decoded. */
+        bool ok;            /**< Whether the chunk was read successfully. */
+    };
+
+    fiff_int_t m_iFrom;                             /**< First sample of the range. */
+    fiff_int_t m_iTo;                               /**< Last sample of the range. */
+    fiff_int_t m_iChunkSize;                        /**< Samples per chunk. */
+    qint32 m_iChunkCount;                           /**< Number of chunks. */
+
+    mutable QMutex m_qMutex;                        /**< Guards the queue state. */
+    QWaitCondition m_qCondReady;                    /**< Signaled when a chunk got decoded. */
+    QWaitCondition m_qCondFree;                     /**< Signaled when a slot got consumed. */
+    QVector<Slot> m_qVecSlots;                      /**< Queue slots, chunk i is held by slot i % prefetch depth. */
+    qint32 m_iNextClaim;                            /**< Next chunk to be claimed by a worker. */
+    qint32 m_iNextDeliver;                          /**< Next chunk to be returned by next(). */
+    bool m_bStop;                                   /**< Whether prefetching was stopped. */
+
+    QList<FiffRawReadAheadWorker*> m_qListWorkers;  /**< Decoding threads. */
+};
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INLINE DEFINITIONS
+//=============================================================================================================
+
+inline qint32 FiffRawReadAhead::chunkCount() const
+{
+    return m_iChunkCount;
+}
+
+
+//*************************************************************************************************************
+
+inline bool FiffRawReadAhead::atEnd() const
+{
+    QMutexLocker locker(&m_qMutex);
+    return m_bStop || m_iNextDeliver >= m_iChunkCount;
+}
+
+} // NAMESPACE
+
+#endif // FIFF_RAW_READ_AHEAD_H
@@ -0,0 +1,327 @@
+//=============================================================================================================
+/**
+* @file     fiff_raw_writer.cpp
+* @author   Christoph Dinh <chdinh@nmr.mgh.harvard.edu>;
+*           Matti Hamalainen <msh@nmr.mgh.harvard.edu>
+* @version  1.0
+* @date     October, 2026
+*
+* @section  LICENSE
+*
+* Copyright (C) 2012, Christoph Dinh and Matti Hamalainen. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+* the following conditions are met:
+*     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+*       following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+*       the following disclaimer in the documentation and/or other materials provided with the distribution.
+*     * Neither the name of the Massachusetts General Hospital nor the names of its contributors may be used
+*       to endorse or promote products derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+* PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL MASSACHUSETTS GENERAL HOSPITAL BE LIABLE FOR ANY DIRECT,
+* INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+* NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+*
+* @brief    Implementation of the FiffRawWriter Class.
+*
+*/
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include "fiff_raw_writer.h"
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// Qt INCLUDES
+//=============================================================================================================
+
+#include <QElapsedTimer>
+#include <QMutexLocker>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// USED NAMESPACES
+//=============================================================================================================
+
+using namespace FIFFLIB;
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINE MEMBER METHODS
+//=============================================================================================================
+
+FiffRawWriter::FiffRawWriter(qint32 p_iQueueSize, qint32 p_iBlockSize)
+: m_iRunning(0)
+, m_iParked(0)
+, m_qVecQueue(qMax(p_iQueueSize, 2))
+, m_iHead(0)
+, m_iTail(0)
+, m_iDropped(0)
+, m_iError(0)
+, m_iFailed(0)
+, m_iBlockSize(qMax(p_iBlockSize / 4096, 1) * 4096)
+, m_iBytesWritten(0)
+, m_iElapsedMSecs(0)
+, m_iBytesFailed(0)
+{
+}
+
+
+//*************************************************************************************************************
+
+FiffRawWriter::~FiffRawWriter()
+{
+    stop();
+}
+
+
+//*************************************************************************************************************
+
+bool FiffRawWriter::start(QIODevice& p_IODevice, const FiffInfo& info, fiff_int_t p_iFirstSample, const MatrixXi& sel)
+{
+    if(m_iRunning.loadAcquire())
+        return false;
+
+    MatrixXd cals;
+    m_pStream = FiffStream::start_writing_raw(p_IODevice, info, cals, sel);
+    if(!m_pStream)
+        return false;
+    m_invCals = FiffInvCals(cals);
+
+    if(p_iFirstSample > 0)
+        m_pStream->write_int(FIFF_FIRST_SAMPLE, &p_iFirstSample);
+
+    m_iHead.storeRelease(0);
+    m_iTail.storeRelease(0);
+    m_iDropped.storeRelease(0);
+    m_iError.storeRelease(0);
+    m_iFailed.storeRelease(0);
+    {
+        QMutexLocker locker(&m_qMutexStats);
+        m_iBytesWritten = 0;
+        m_iElapsedMSecs = 0;
+        m_iBytesFailed = 0;
+        m_sErrorString.clear();
+    }
+
+    m_iRunning.storeRelease(1);
+    QThread::start();
+
+    return true;
+}
+
+
+//*************************************************************************************************************
+
+bool FiffRawWriter::stop()
+{
+    if(!m_iRunning.loadAcquire())
+        return false;
+
+    //
+    //   The thread writes what is left in the queue and finishes the file
+    //
+    m_iRunning.storeRelease(0);
+    m_qMutexPark.lock();
+    m_qWaitData.wakeAll();
+    m_qMutexPark.unlock();
+
+    QThread::wait();
+
+    m_pStream.clear();
+
+    return !hasError();
+}
+
+
+//*************************************************************************************************************
+
+bool FiffRawWriter::append(const MatrixXd& p_matBuffer)
+{
+    if(!m_iRunning.loadAcquire())
+        return false;
+
+    if(hasError())
+    {
+        m_iFailed.fetchAndAddRelaxed(1);
+        return false;
+    }
+
+    qint32 t_iHead = m_iHead.load();
+    if(t_iHead - m_iTail.loadAcquire() >= m_qVecQueue.size())
+    {
+        m_iDropped.fetchAndAddRelaxed(1);
+        return false;
+    }
+
+    //
+    //   The slot keeps its memory, so buffers of constant size are copied without allocation
+    //
+    m_qVecQueue[t_iHead % m_qVecQueue.size()] = p_matBuffer;
+
+    //
+    //   Wake the writer thread only if it parks; both sides use full barriers, so either the writer sees the new
+    //   head before it waits or the producer sees it parked
+    //
+    m_iHead.fetchAndStoreOrdered(t_iHead + 1);
+    if(m_iParked.loadAcquire())
+    {
+        m_qMutexPark.lock();
+        m_qWaitData.wakeOne();
+        m_qMutexPark.unlock();
+    }
+
+    return true;
+}
+
+
+//*************************************************************************************************************
+
+qint64 FiffRawWriter::bytesWritten() const
+{
+    QMutexLocker locker(&m_qMutexStats);
+    return m_iBytesWritten;
+}
+
+
+//*************************************************************************************************************
+
+double FiffRawWriter::bytesPerSecond() const
+{
+    QMutexLocker locker(&m_qMutexStats);
+    return m_iElapsedMSecs > 0 ? 1000.0*m_iBytesWritten/m_iElapsedMSecs : 0.0;
+}
+
+
+//*************************************************************************************************************
+
+QString FiffRawWriter::errorString() const
+{
+    QMutexLocker locker(&m_qMutexStats);
+    return m_sErrorString;
+}
+
+
+//*************************************************************************************************************
+
+qint64 FiffRawWriter::bytesFailed() const
+{
+    QMutexLocker locker(&m_qMutexStats);
+    return m_iBytesFailed;
+}
+
+
+//*************************************************************************************************************
+
+void FiffRawWriter::run()
+{
+    QElapsedTimer t_timer;
+    t_timer.start();
+
+    //
+    //   Buffers are encoded into memory and go to the device in large blocks
+    //
+    QBuffer t_qBuffer;
+    t_qBuffer.open(QIODevice::WriteOnly);
+    FiffStream t_encoder(&t_qBuffer);
+
+    while(true)
+    {
+        qint32 t_iTail = m_iTail.load();
+        if(t_iTail == m_iHead.loadAcquire())
+        {
+            if(!m_iRunning.loadAcquire())
+                break;
+
+            //
+            //   Park until append() or stop() signals; the queue and the state are checked again under the lock
+            //
+            m_qMutexPark.lock();
+            m_iParked.fetchAndStoreOrdered(1);
+            if(t_iTail == m_iHead.loadAcquire() && m_iRunning.loadAcquire())
+                m_qWaitData.wait(&m_qMutexPark);
+            m_iParked.storeRelease(0);
+            m_qMutexPark.unlock();
+            continue;
+        }
+
+        //
+        //   After a failed write the queued buffers are only counted; the data which could not be written stay
+        //   in the encoder buffer
+        //
+        if(hasError())
+            m_iFailed.fetchAndAddRelaxed(1);
+        else if(!t_encoder.write_raw_buffer(m_qVecQueue[t_iTail % m_qVecQueue.size()], m_invCals))
+            m_iDropped.fetchAndAddRelaxed(1);
+        m_iTail.storeRelease(t_iTail + 1);
+
+        if(!hasError() && t_qBuffer.size() >= m_iBlockSize)
+        {
+            flush(t_qBuffer, false);
+
+            QMutexLocker locker(&m_qMutexStats);
+            m_iElapsedMSecs = t_timer.elapsed();
+        }
+    }
+
+    if(!hasError() && flush(t_qBuffer, true))
+        m_pStream->finish_writing_raw();
+
+    QMutexLocker locker(&m_qMutexStats);
+    m_iElapsedMSecs = t_timer.elapsed();
+    m_iBytesFailed = t_qBuffer.buffer().size();
+}
+
+
+//*************************************************************************************************************
+
+bool FiffRawWriter::flush(QBuffer& p_qBuffer, bool p_bAll)
+{
+    QIODevice* t_pDevice = m_pStream->device();
+    QByteArray& t_data = p_qBuffer.buffer();
+
+    qint64 t_iBytes = t_data.size();
+    if(!p_bAll)
+    {
+        //
+        //   End the write at a block boundary of the file, the rest goes with the next write
+        //
+        qint64 t_iPos = t_pDevice->isSequential() ? 0 : t_pDevice->pos();
+        t_iBytes = ((t_iPos + t_iBytes) / 4096) * 4096 - t_iPos;
+    }
+    if(t_iBytes <= 0)
+        return true;
+
+    qint64 t_iWritten = t_pDevice->write(t_data.constData(), t_iBytes);
+    if(t_iWritten < 0)
+    {
+        QMutexLocker locker(&m_qMutexStats);
+        m_sErrorString = t_pDevice->errorString();
+        m_iBytesFailed = t_data.size();
+        m_iError.storeRelease(1);
+
+        printf("FiffRawWriter: Error while writing to the device (%s), recording stopped.\n", m_sErrorString.toUtf8().constData());
+        return false;
+    }
+
+    t_data.remove(0, (int)t_iWritten);
+    p_qBuffer.seek(t_data.size());
+
+    QMutexLocker locker(&m_qMutexStats);
+    m_iBytesWritten += t_iWritten;
+
+    return true;
+}
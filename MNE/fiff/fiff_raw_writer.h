@@ -0,0 +1,299 @@
+//=============================================================================================================
+/**
+* @file     fiff_raw_writer.h
+* @author   Christoph Dinh <chdinh@nmr.mgh.harvard.edu>;
+*           Matti Hamalainen <msh@nmr.mgh.harvard.edu>
+* @version  1.0
+* @date     October, 2026
+*
+* @section  LICENSE
+*
+* Copyright (C) 2012, Christoph Dinh and Matti Hamalainen. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+* the following conditions are met:
+*     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+*       following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+*       the following disclaimer in the documentation and/or other materials provided with the distribution.
+*     * Neither the name of the Massachusetts General Hospital nor the names of its contributors may be used
+*       to endorse or promote products derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+* PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL MASSACHUSETTS GENERAL HOSPITAL BE LIABLE FOR ANY DIRECT,
+* INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+* NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+*
+* @brief    FiffRawWriter class declaration.
+*
+*/
+
+#ifndef FIFF_RAW_WRITER_H
+#define FIFF_RAW_WRITER_H
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include "fiff_global.h"
+#include "fiff_types.h"
+#include "fiff_info.h"
+#include "fiff_stream.h"
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// Eigen INCLUDES
+//=============================================================================================================
+
+#include <Eigen/Core>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// Qt INCLUDES
+//=============================================================================================================
+
+#include <QAtomicInt>
+#include <QBuffer>
+#include <QIODevice>
+#include <QMutex>
+#include <QSharedPointer>
+#include <QString>
+#include <QThread>
+#include <QVector>
+#include <QWaitCondition>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINE NAMESPACE FIFFLIB
+//=============================================================================================================
+
+namespace FIFFLIB
+{
+
+//*************************************************************************************************************
+//=============================================================================================================
+// USED NAMESPACES
+//=============================================================================================================
+
+using namespace Eigen;
+
+
+//=============================================================================================================
+/**
+* Asynchronous raw data recorder. append() copies a buffer into a preallocated lock-free single producer /
+* single consumer ring and returns immediately; if the ring is full the buffer is dropped and counted, so the
+* acquisition never waits for the disk. A dedicated thread calibrates and encodes the buffers into memory and
+* writes them to the device in large blocks aligned to the file position. While the queue is empty the thread
+* sleeps on a wait condition, which append() only signals if the thread is parked. A failing device write latches
+* an error: the unwritten bytes are kept and counted, append() rejects all further buffers and the recorder has to
+* poll hasError() to stop the recording and warn the user.
+*
+* @brief Asynchronous double buffered raw FIFF writer
+*/
+class FIFFSHARED_EXPORT FiffRawWriter : public QThread
+{
+public:
+    typedef QSharedPointer<FiffRawWriter> SPtr;             /**< Shared pointer type for FiffRawWriter. */
+    typedef QSharedPointer<const FiffRawWriter> ConstSPtr;  /**< Const shared pointer type for FiffRawWriter. */
+
+    //=========================================================================================================
+    /**
+    * Constructs the writer.
+    *
+    * @param[in] p_iQueueSize   Number of buffers the queue can hold before buffers are dropped
+    * @param[in] p_iBlockSize   Size of the blocks written to the device in bytes (multiple of 4096)
+    */
+    explicit FiffRawWriter(qint32 p_iQueueSize = 64, qint32 p_iBlockSize = 4*1024*1024);
+
+    //=========================================================================================================
+    /**
+    * Stops the writer, the remaining buffers are written.
+    */
+    ~FiffRawWriter();
+
+    //=========================================================================================================
+    /**
+    * Starts a raw file on the device (FiffStream::start_writing_raw) and starts the writer thread.
+    *
+    * @param[in] p_IODevice     The device to write to, e.g. a QFile
+    * @param[in] info           The measurement info
+    * @param[in] p_iFirstSample The first sample of the recording, written as FIFF_FIRST_SAMPLE
+    * @param[in] sel            Which channels will be included in the output file (optional)
+    *
+    * @return true if succeeded, false otherwise
+    */
+    bool start(QIODevice& p_IODevice, const FiffInfo& info, fiff_int_t p_iFirstSample = 0, const MatrixXi& sel = defaultMatrixXi);
+
+    //=========================================================================================================
+    /**
+    * Writes the remaining buffers, finishes the file (FiffStream::finish_writing_raw) and stops the thread.
+    *
+    * @return true if succeeded, false if the writer was not running or a write failed
+    */
+    bool stop();
+
+    //=========================================================================================================
+    /**
+    * Queues a calibrated buffer (channels x samples) for writing. Never waits for the disk, a lock is only taken
+    * shortly to wake the parked writer thread; must be called from a single thread.
+    *
+    * @param[in] p_matBuffer    The buffer to write
+    *
+    * @return true if the buffer was queued, false if it was dropped or a write failed before
+    */
+    bool append(const MatrixXd& p_matBuffer);
+
+    //=========================================================================================================
+    /**
+    * Returns whether a write to the device failed since start. The error is latched until the next start.
+    *
+    * @return true if a write failed
+    */
+    inline bool hasError() const;
+
+    //=========================================================================================================
+    /**
+    * Returns the device error of the first failed write.
+    *
+    * @return the error description, empty if there was no error
+    */
+    QString errorString() const;
+
+    //=========================================================================================================
+    /**
+    * Returns the number of buffers which were not written because of a failed write, in addition to the
+    * droppedBuffers().
+    *
+    * @return the number of failed buffers
+    */
+    inline qint32 failedBuffers() const;
+
+    //=========================================================================================================
+    /**
+    * Returns the number of encoded bytes which could not be written to the device.
+    *
+    * @return the failed bytes
+    */
+    qint64 bytesFailed() const;
+
+    //=========================================================================================================
+    /**
+    * Returns the number of buffers waiting to be written.
+    *
+    * @return the queue depth
+    */
+    inline qint32 queueDepth() const;
+
+    //=========================================================================================================
+    /**
+    * Returns the number of buffers dropped because the queue was full.
+    *
+    * @return the number of dropped buffers
+    */
+    inline qint32 droppedBuffers() const;
+
+    //=========================================================================================================
+    /**
+    * Returns the number of bytes written to the device so far.
+    *
+    * @return the written bytes
+    */
+    qint64 bytesWritten() const;
+
+    //=========================================================================================================
+    /**
+    * Returns the write rate, averaged since start.
+    *
+    * @return the written bytes per second
+    */
+    double bytesPerSecond() const;
+
+protected:
+    //=========================================================================================================
+    /**
+    * Takes the buffers from the queue and writes them.
+    */
+    virtual void run();
+
+private:
+    //=========================================================================================================
+    /**
+    * Writes the encoded data up to the last block boundary of the device position to the device.
+    *
+    * @param[in] p_qBuffer  The encoded data; the written part is removed
+    * @param[in] p_bAll     If true all encoded data are written regardless of the alignment
+    *
+    * @return false if the device write failed; the data are kept and the error is latched
+    */
+    bool flush(QBuffer& p_qBuffer, bool p_bAll);
+
+    QAtomicInt m_iRunning;                  /**< Whether the writer thread is running, set by start() and stop(). */
+    QAtomicInt m_iParked;                   /**< Whether the writer thread is about to wait or waits for data. */
+    QMutex m_qMutexPark;                    /**< Guards parking the writer thread. */
+    QWaitCondition m_qWaitData;             /**< Signaled by append() and stop() to wake the parked writer thread. */
+
+    QVector<MatrixXd> m_qVecQueue;          /**< Ring of queued buffers. */
+    QAtomicInt m_iHead;                     /**< Count of appended buffers, written by the producer only. */
+    QAtomicInt m_iTail;                     /**< Count of written buffers, written by the writer thread only. */
+    QAtomicInt m_iDropped;                  /**< Count of dropped buffers. */
+    QAtomicInt m_iError;                    /**< Latched by the first failed write, reset by start(). */
+    QAtomicInt m_iFailed;                   /**< Count of buffers not written because of a failed write. */
+
+    qint32 m_iBlockSize;                    /**< Size of the blocks written to the device. */
+    FiffStream::SPtr m_pStream;             /**< The output stream. */
+    FiffInvCals m_invCals;                  /**< Inverse calibration of the written channels. */
+
+    mutable QMutex m_qMutexStats;           /**< Guards the statistics. */
+    qint64 m_iBytesWritten;                 /**< Bytes written to the device. */
+    qint64 m_iElapsedMSecs;                 /**< Time between start and the last write in milliseconds. */
+    qint64 m_iBytesFailed;                  /**< Encoded bytes which could not be written. */
+    QString m_sErrorString;                 /**< Device error of the first failed write. */
+};
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INLINE DEFINITIONS
+//=============================================================================================================
+
+inline qint32 FiffRawWriter::queueDepth() const
+{
+    return m_iHead.loadAcquire() - m_iTail.loadAcquire();
+}
+
+
+//*************************************************************************************************************
+
+inline qint32 FiffRawWriter::droppedBuffers() const
+{
+    return m_iDropped.loadAcquire();
+}
+
+
+//*************************************************************************************************************
+
+inline bool FiffRawWriter::hasError() const
+{
+    return m_iError.loadAcquire() != 0;
+}
+
+
+//*************************************************************************************************************
+
+inline qint32 FiffRawWriter::failedBuffers() const
+{
+    return m_iFailed.loadAcquire();
+}
+
+} // NAMESPACE
+
+#endif // FIFF_RAW_WRITER_H
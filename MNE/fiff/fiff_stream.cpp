@@ -40,6 +40,8 @@
 
 #include "fiff_stream.h"
 #include "fiff_tag.h"
+#include "fiff_lazy_tag.h"
+#include "fiff_buffer_codec.h"
 #include "fiff_dir_tree.h"
 #include "fiff_ctf_comp.h"
 #include "fiff_info.h"
@@ -50,12 +52,30 @@
 #include <utils/mnemath.h>
 
 
+//*************************************************************************************************************
+//=============================================================================================================
+// STL INCLUDES
+//=============================================================================================================
+
+#include <cstring>
+
+
 //*************************************************************************************************************
 //=============================================================================================================
 // Qt INCLUDES
 //=============================================================================================================
 
+#include <QCache>
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QDateTime>
+#include <QDir>
 #include <QFile>
+#include <QFileInfo>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QStandardPaths>
+#include <QtEndian>
 
 
 //*************************************************************************************************************
@@ -67,6 +87,181 @@ using namespace FIFFLIB;
 using namespace UTILSLIB;
 
 
+//*************************************************************************************************************
+//=============================================================================================================
+// STATIC DATA
+//=============================================================================================================
+
+//
+//   Raw buffer directories of recordings opened by setup_read_raw, keyed by file path, size and modification
+//   time. The cost of an entry is its number of buffers. Across processes the directory is kept in an index
+//   file in the user's cache directory, see rawDirIndexFile.
+//
+struct RawDirCacheEntry
+{
+    fiff_int_t first_samp;
+    fiff_int_t last_samp;
+    QList<FiffRawDir> rawdir;
+    QVector<fiff_int_t> rawdir_last;
+};
+
+static QCache<QString, RawDirCacheEntry> s_rawDirCache(256*1024);
+static QMutex s_rawDirCacheMutex;
+
+#define RAWDIR_INDEX_MAGIC      0x46524431  // "FRD1"
+#define RAWDIR_INDEX_VERSION    1
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// STATIC HELPERS
+//=============================================================================================================
+
+//
+//   Byte swaps of whole arrays into file (big endian) byte order. The words are moved with memcpy and stored with
+//   qToBigEndian, so the buffers need no alignment and are not accessed through a different type; the compiler
+//   still turns the loops into plain loads, byte swaps and stores.
+//
+static void copyToBigEndian32(const void* p_pSrc, char* p_pDst, qint64 p_iNel)
+{
+#if Q_BYTE_ORDER == Q_BIG_ENDIAN
+    memcpy(p_pDst, p_pSrc, p_iNel*4);
+#else
+    const uchar* t_pSrc = static_cast<const uchar*>(p_pSrc);
+    uchar* t_pDst = reinterpret_cast<uchar*>(p_pDst);
+    quint32 t_iWord;
+    for(qint64 i = 0; i < p_iNel; ++i)
+    {
+        memcpy(&t_iWord, t_pSrc + 4*i, 4);
+        qToBigEndian<quint32>(t_iWord, t_pDst + 4*i);
+    }
+#endif
+}
+
+static void copyToBigEndian64(const void* p_pSrc, char* p_pDst, qint64 p_iNel)
+{
+#if Q_BYTE_ORDER == Q_BIG_ENDIAN
+    memcpy(p_pDst, p_pSrc, p_iNel*8);
+#else
+    const uchar* t_pSrc = static_cast<const uchar*>(p_pSrc);
+    uchar* t_pDst = reinterpret_cast<uchar*>(p_pDst);
+    quint64 t_iWord;
+    for(qint64 i = 0; i < p_iNel; ++i)
+    {
+        memcpy(&t_iWord, t_pSrc + 8*i, 8);
+        qToBigEndian<quint64>(t_iWord, t_pDst + 8*i);
+    }
+#endif
+}
+
+
+
+//*************************************************************************************************************
+
+//
+//   The buffer directory index of a recording, "<cache location>/rawdir/<sha1 of the cache key>.rawdir". The
+//   recording's directory is never written to. Returns an empty string if there is no cache location.
+//
+static QString rawDirIndexFile(const QString& p_sCacheKey)
+{
+    QString t_sCacheDir = QStandardPaths::writableLocation(QStandardPaths::CacheLocation);
+    if(t_sCacheDir.isEmpty())
+        return QString();
+
+    QByteArray t_hash = QCryptographicHash::hash(p_sCacheKey.toUtf8(), QCryptographicHash::Sha1);
+    return t_sCacheDir + "/rawdir/" + QString::fromLatin1(t_hash.toHex()) + ".rawdir";
+}
+
+
+//*************************************************************************************************************
+
+//
+//   Reads the buffer directory of a recording from its index. The index is only used if it was written for a file
+//   of the same size, modification time and channel count, and all buffers lie inside the file.
+//
+static bool readRawDirIndex(const QString& p_sIndexFile, const QFileInfo& p_fileInfo, fiff_int_t p_iNChan, fiff_int_t& p_iFirstSamp, fiff_int_t& p_iLastSamp, QList<FiffRawDir>& p_qListRawDir)
+{
+    if(p_sIndexFile.isEmpty())
+        return false;
+
+    QFile t_fileIndex(p_sIndexFile);
+    if(!t_fileIndex.open(QIODevice::ReadOnly))
+        return false;
+
+    QDataStream t_stream(&t_fileIndex);
+    t_stream.setByteOrder(QDataStream::LittleEndian);
+
+    quint32 t_iMagic;
+    qint32 t_iVersion, t_iNChan, t_iFirstSamp, t_iLastSamp, t_iNDir;
+    qint64 t_iSize, t_iModified;
+    t_stream >> t_iMagic >> t_iVersion >> t_iSize >> t_iModified >> t_iNChan >> t_iFirstSamp >> t_iLastSamp >> t_iNDir;
+    if(t_stream.status() != QDataStream::Ok || t_iMagic != RAWDIR_INDEX_MAGIC || t_iVersion != RAWDIR_INDEX_VERSION
+            || t_iSize != p_fileInfo.size() || t_iModified != p_fileInfo.lastModified().toMSecsSinceEpoch()
+            || t_iNChan != p_iNChan || t_iNDir < 0 || (qint64)t_iNDir*7*(qint64)sizeof(qint32) != t_fileIndex.size() - t_fileIndex.pos())
+        return false;
+
+    QList<FiffRawDir> t_qListRawDir;
+    t_qListRawDir.reserve(t_iNDir);
+    for(qint32 k = 0; k < t_iNDir; ++k)
+    {
+        FiffRawDir t_RawDir;
+        t_stream >> t_RawDir.ent.kind >> t_RawDir.ent.type >> t_RawDir.ent.size >> t_RawDir.ent.pos >> t_RawDir.first >> t_RawDir.last >> t_RawDir.nsamp;
+        if(t_RawDir.ent.kind != -1 && (t_RawDir.ent.pos < 0 || (qint64)t_RawDir.ent.pos + FIFFC_DATA_OFFSET + t_RawDir.ent.size > t_iSize))
+            return false;
+        t_qListRawDir.append(t_RawDir);
+    }
+    if(t_stream.status() != QDataStream::Ok)
+        return false;
+
+    p_iFirstSamp = t_iFirstSamp;
+    p_iLastSamp = t_iLastSamp;
+    p_qListRawDir = t_qListRawDir;
+
+    return true;
+}
+
+
+//*************************************************************************************************************
+
+//
+//   Writes the buffer directory of a recording to its index. Failing to write it is not an error; the directory is
+//   scanned again on the next open.
+//
+static void writeRawDirIndex(const QString& p_sIndexFile, const QFileInfo& p_fileInfo, fiff_int_t p_iNChan, fiff_int_t p_iFirstSamp, fiff_int_t p_iLastSamp, const QList<FiffRawDir>& p_qListRawDir)
+{
+    if(p_sIndexFile.isEmpty() || !QDir().mkpath(QFileInfo(p_sIndexFile).absolutePath()))
+        return;
+
+    //
+    //   Write to a temporary file first, so that an interrupted write never leaves a valid looking index
+    //
+    QFile t_fileOut(p_sIndexFile + ".part");
+    if(!t_fileOut.open(QIODevice::WriteOnly | QIODevice::Truncate))
+        return;
+
+    QDataStream t_stream(&t_fileOut);
+    t_stream.setByteOrder(QDataStream::LittleEndian);
+    t_stream << (quint32)RAWDIR_INDEX_MAGIC << (qint32)RAWDIR_INDEX_VERSION;
+    t_stream << (qint64)p_fileInfo.size() << (qint64)p_fileInfo.lastModified().toMSecsSinceEpoch();
+    t_stream << (qint32)p_iNChan << (qint32)p_iFirstSamp << (qint32)p_iLastSamp << (qint32)p_qListRawDir.size();
+    for(qint32 k = 0; k < p_qListRawDir.size(); ++k)
+    {
+        const FiffRawDir& t_RawDir = p_qListRawDir[k];
+        t_stream << t_RawDir.ent.kind << t_RawDir.ent.type << t_RawDir.ent.size << t_RawDir.ent.pos << t_RawDir.first << t_RawDir.last << t_RawDir.nsamp;
+    }
+
+    if(t_stream.status() != QDataStream::Ok)
+    {
+        t_fileOut.remove();
+        return;
+    }
+    t_fileOut.close();
+
+    QFile::remove(p_sIndexFile);
+    if(!t_fileOut.rename(p_sIndexFile))
+        t_fileOut.remove();
+}
+
 //*************************************************************************************************************
 //=============================================================================================================
 // DEFINE MEMBER METHODS
@@ -74,10 +269,13 @@ using namespace UTILSLIB;
 
 FiffStream::FiffStream(QIODevice *p_pIODevice)
 : QDataStream(p_pIODevice)
+, m_pMappedData(NULL)
+, m_iMappedSize(0)
 {
     this->setFloatingPointPrecision(QDataStream::SinglePrecision);
     this->setByteOrder(QDataStream::BigEndian);
     this->setVersion(QDataStream::Qt_5_0);
+    m_qCacheTags.setMaxCost(16*1024);
 }
 
 
@@ -85,10 +283,13 @@ FiffStream::FiffStream(QIODevice *p_pIODevice)
 
 FiffStream::FiffStream(QByteArray * a, QIODevice::OpenMode mode)
 : QDataStream(a, mode)
+, m_pMappedData(NULL)
+, m_iMappedSize(0)
 {
     this->setFloatingPointPrecision(QDataStream::SinglePrecision);
     this->setByteOrder(QDataStream::BigEndian);
     this->setVersion(QDataStream::Qt_5_0);
+    m_qCacheTags.setMaxCost(16*1024);
 }
 
 
@@ -281,6 +482,108 @@ bool FiffStream::open(FiffDirTree& p_Tree, QList<FiffDirEntry>& p_Dir)
 }
 
 
+//*************************************************************************************************************
+
+bool FiffStream::mapFile()
+{
+    if(m_pMappedData)
+        return true;
+
+    QFile* t_pFile = qobject_cast<QFile*>(this->device());
+    if(!t_pFile)
+    {
+        printf("Memory mapping is only supported for files.\n");
+        return false;
+    }
+
+    bool t_bOpened = false;
+    if(!t_pFile->isOpen())
+    {
+        if(!t_pFile->open(QIODevice::ReadOnly))
+        {
+            printf("Cannot open file %s\n", t_pFile->fileName().toUtf8().constData());
+            return false;
+        }
+        t_bOpened = true;
+    }
+
+    m_iMappedSize = t_pFile->size();
+    m_pMappedData = t_pFile->map(0, m_iMappedSize);
+
+    if(t_bOpened)
+        t_pFile->close();
+
+    if(!m_pMappedData)
+    {
+        printf("Could not map file %s\n", t_pFile->fileName().toUtf8().constData());
+        m_iMappedSize = 0;
+        return false;
+    }
+
+    return true;
+}
+
+
+//*************************************************************************************************************
+
+void FiffStream::unmapFile()
+{
+    if(!m_pMappedData)
+        return;
+
+    QFile* t_pFile = qobject_cast<QFile*>(this->device());
+    if(t_pFile)
+        t_pFile->unmap(m_pMappedData);
+
+    m_pMappedData = NULL;
+    m_iMappedSize = 0;
+}
+
+
+//*************************************************************************************************************
+
+bool FiffStream::read_tag_cached(FiffTag::SPtr& p_pTag, qint64 pos)
+{
+    FiffTag::SPtr* t_pCached = m_qCacheTags.object(pos);
+    if(t_pCached)
+    {
+        p_pTag = *t_pCached;
+        return true;
+    }
+
+    if(!FiffTag::read_tag(this, p_pTag, pos))
+        return false;
+
+    m_qCacheTags.insert(pos, new FiffTag::SPtr(p_pTag), qMax(p_pTag->size() / 1024, 1));
+
+    return true;
+}
+
+
+//*************************************************************************************************************
+
+void FiffStream::setTagCacheSize(int p_iKBytes)
+{
+    m_qCacheTags.setMaxCost(p_iKBytes);
+}
+
+
+//*************************************************************************************************************
+
+void FiffStream::removeCachedTag(qint64 pos)
+{
+    m_qCacheTags.remove(pos);
+}
+
+
+//*************************************************************************************************************
+
+void FiffStream::clearTagCache()
+{
+    m_qCacheTags.clear();
+}
+
+
 //*************************************************************************************************************
 
 QStringList FiffStream::read_bad_channels(const FiffDirTree& p_Node)
@@ -357,9 +660,13 @@ bool FiffStream::read_cov(const FiffDirTree& p_Node, fiff_int_t cov_kind, FiffCo
                     return false;
                 }
             }
-            if (!current->find_tag(this, FIFF_MNE_COV, tag))
+            //
+            //   The covariance payload is read through the tag cache only after the header was checked
+            //
+            FiffLazyTag t_covTag;
+            if (!current->find_tag(this, FIFF_MNE_COV, t_covTag))
             {
-                if (!current->find_tag(this, FIFF_MNE_COV_DIAG, tag))
+                if (!current->find_tag(this, FIFF_MNE_COV_DIAG, t_covTag) || !(tag = t_covTag.tag()))
                 {
                     printf("No covariance matrix data found\n");
                     return false;
@@ -388,6 +695,11 @@ bool FiffStream::read_cov(const FiffDirTree& p_Node, fiff_int_t cov_kind, FiffCo
             }
             else
             {
+                if(!(tag = t_covTag.tag()))
+                {
+                    printf("No covariance matrix data found\n");
+                    return false;
+                }
                 VectorXd vals;
                 nn = dim*(dim+1)/2;
                 if (tag->type == FIFFT_DOUBLE)
@@ -466,16 +778,25 @@ bool FiffStream::read_cov(const FiffDirTree& p_Node, fiff_int_t cov_kind, FiffCo
 //                    end
 //MATLAB END
             }
+            tag.clear();
+            t_covTag.unload();
             //
             //   Read the possibly precomputed decomposition
             //
-            FiffTag::SPtr tag1;
-            FiffTag::SPtr tag2;
-            if (current->find_tag(this, FIFF_MNE_COV_EIGENVALUES, tag1) && current->find_tag(this, FIFF_MNE_COV_EIGENVECTORS, tag2))
+            FiffLazyTag t_eigTag;
+            FiffLazyTag t_eigvecTag;
+            if (current->find_tag(this, FIFF_MNE_COV_EIGENVALUES, t_eigTag) && current->find_tag(this, FIFF_MNE_COV_EIGENVECTORS, t_eigvecTag))
             {
-                eig = VectorXd(Map<VectorXd>(tag1->toDouble(),dim));
-                eigvec = tag2->toFloatMatrix().cast<double>();
-                eigvec.transposeInPlace();
+                FiffTag::SPtr tag1 = t_eigTag.tag();
+                FiffTag::SPtr tag2 = t_eigvecTag.tag();
+                if(tag1 && tag2)
+                {
+                    eig = VectorXd(Map<VectorXd>(tag1->toDouble(),dim));
+                    eigvec = tag2->toFloatMatrix().cast<double>();
+                    eigvec.transposeInPlace();
+                }
+                t_eigTag.unload();
+                t_eigvecTag.unload();
             }
             //
             //   Read the projection operator
@@ -1056,7 +1377,7 @@ bool FiffStream::read_meas_info(const FiffDirTree& p_Node, FiffInfo& info, FiffD
 
 //*************************************************************************************************************
 
-bool FiffStream::read_named_matrix(const FiffDirTree& p_Node, fiff_int_t matkind, FiffNamedMatrix& mat)
+bool FiffStream::read_named_matrix(const FiffDirTree& p_Node, fiff_int_t matkind, FiffNamedMatrix& mat, bool p_bReadData)
 {
     mat.clear();
 
@@ -1096,22 +1417,19 @@ bool FiffStream::read_named_matrix(const FiffDirTree& p_Node, fiff_int_t matkind
 
     FiffTag::SPtr t_pTag;
     //
-    //   Read everything we need
+    //   Read everything we need; the dimensions are stored at the end of the matrix tag, so the payload is
+    //   only read after they were checked against FIFF_MNE_NROW and FIFF_MNE_NCOL
     //
-    if(!node.find_tag(this, matkind, t_pTag))
+    FiffLazyTag t_lazyTag;
+    qint32 ndim;
+    QVector<qint32> dims;
+    if(!node.find_tag(this, matkind, t_lazyTag) || !t_lazyTag.getMatrixDimensions(ndim, dims) || ndim != 2)
     {
         printf("Matrix data missing.\n");
         return false;
     }
-    else
-    {
-        //qDebug() << "Is Matrix" << t_pTag->isMatrix() << "Special Type:" << t_pTag->getType();
-        mat.data = t_pTag->toFloatMatrix().cast<double>();
-        mat.data.transposeInPlace();
-    }
-
-    mat.nrow = mat.data.rows();
-    mat.ncol = mat.data.cols();
+    mat.nrow = dims[1];
+    mat.ncol = dims[0];
 
     if(node.find_tag(this, FIFF_MNE_NROW, t_pTag))
         if (*t_pTag->toInt() != mat.nrow)
@@ -1126,6 +1444,23 @@ bool FiffStream::read_named_matrix(const FiffDirTree& p_Node, fiff_int_t matkind
             return false;
         }
 
+    if(p_bReadData)
+    {
+        t_pTag = t_lazyTag.tag();
+        if(!t_pTag)
+        {
+            printf("Matrix data missing.\n");
+            return false;
+        }
+        //qDebug() << "Is Matrix" << t_pTag->isMatrix() << "Special Type:" << t_pTag->getType();
+        mat.data = t_pTag->toFloatMatrix().cast<double>();
+        mat.data.transposeInPlace();
+        t_lazyTag.unload();
+
+        mat.nrow = mat.data.rows();
+        mat.ncol = mat.data.cols();
+    }
+
     QString row_names;
     if(node.find_tag(this, FIFF_MNE_ROW_NAMES, t_pTag))
         row_names = t_pTag->toString();
@@ -1362,115 +1697,168 @@ bool FiffStream::setup_read_raw(QIODevice &p_IODevice, FiffRawData& data, bool a
     data.first_samp = 0;
     data.last_samp  = 0;
     //
-    //   Process the directory
-    //
-
-    QList<FiffDirEntry> dir = raw[0].dir;
-    fiff_int_t nent = raw[0].nent;
-    fiff_int_t nchan = info.nchan;
-    fiff_int_t first = 0;
-    fiff_int_t first_samp = 0;
-    fiff_int_t first_skip = 0;
-    //
-    //  Get first sample tag if it is there
+    //   Reuse the buffer directory if this recording was opened before
     //
-    FiffTag::SPtr t_pTag;
-    if (dir[first].kind == FIFF_FIRST_SAMPLE)
+    QString t_sCacheKey;
+    QFileInfo t_fileInfo;
+    QFile* t_pFile = qobject_cast<QFile*>(&p_IODevice);
+    if(t_pFile)
     {
-        FiffTag::read_tag(p_pStream.data(), t_pTag, dir[first].pos);
-        first_samp = *t_pTag->toInt();
-        ++first;
+        t_fileInfo = QFileInfo(*t_pFile);
+        t_sCacheKey = QString("%1:%2:%3").arg(t_fileInfo.absoluteFilePath()).arg(t_fileInfo.size()).arg(t_fileInfo.lastModified().toMSecsSinceEpoch());
     }
 
-    //
-    //  Omit initial skip
-    //
-    if (dir.at(first).kind == FIFF_DATA_SKIP)
+    bool t_bCached = false;
+    if(!t_sCacheKey.isEmpty())
     {
-        //
-        //  This first skip can be applied only after we know the buffer size
-        //
-        FiffTag::read_tag(p_pStream.data(), t_pTag, dir[first].pos);
-        first_skip = *t_pTag->toInt();
-        ++first;
+        QMutexLocker locker(&s_rawDirCacheMutex);
+        const RawDirCacheEntry* t_pCached = s_rawDirCache.object(t_sCacheKey);
+        if(t_pCached)
+        {
+            data.first_samp  = t_pCached->first_samp;
+            data.last_samp   = t_pCached->last_samp;
+            data.rawdir      = t_pCached->rawdir;
+            data.rawdir_last = t_pCached->rawdir_last;
+            t_bCached = true;
+        }
     }
-    data.first_samp = first_samp;
-    //
-    //   Go through the remaining tags in the directory
-    //
+
     QList<FiffRawDir> rawdir;
-//        rawdir = struct('ent',{},'first',{},'last',{},'nsamp',{});
-    fiff_int_t nskip = 0;
-    fiff_int_t ndir  = 0;
-    fiff_int_t nsamp = 0;
-    for (qint32 k = first; k < nent; ++k)
+    QString t_sIndexFile;
+    bool t_bIndexed = false;
+    if(!t_bCached && !t_sCacheKey.isEmpty())
     {
-        FiffDirEntry ent = dir.at(k);
-        if (ent.kind == FIFF_DATA_SKIP)
+        t_sIndexFile = rawDirIndexFile(t_sCacheKey);
+        t_bIndexed = readRawDirIndex(t_sIndexFile, t_fileInfo, info.nchan, data.first_samp, data.last_samp, rawdir);
+    }
+
+    if(!t_bCached && !t_bIndexed)
+    {
+        //
+        //   Process the directory
+        //
+
+        QList<FiffDirEntry> dir = raw[0].dir;
+        fiff_int_t nent = raw[0].nent;
+        fiff_int_t nchan = info.nchan;
+        fiff_int_t first = 0;
+        fiff_int_t first_samp = 0;
+        fiff_int_t first_skip = 0;
+        //
+        //  Get first sample tag if it is there
+        //
+        FiffTag::SPtr t_pTag;
+        if (dir[first].kind == FIFF_FIRST_SAMPLE)
         {
-            FiffTag::read_tag(p_pStream.data(), t_pTag, ent.pos);
-            nskip = *t_pTag->toInt();
+            FiffTag::read_tag(p_pStream.data(), t_pTag, dir[first].pos);
+            first_samp = *t_pTag->toInt();
+            ++first;
         }
-        else if(ent.kind == FIFF_DATA_BUFFER)
+
+        //
+        //  Omit initial skip
+        //
+        if (dir.at(first).kind == FIFF_DATA_SKIP)
         {
             //
-            //   Figure out the number of samples in this buffer
-            //
-            switch(ent.type)
-            {
-                case FIFFT_DAU_PACK16:
-                    nsamp = ent.size/(2*nchan);
-                    break;
-                case FIFFT_SHORT:
-                    nsamp = ent.size/(2*nchan);
-                    break;
-                case FIFFT_FLOAT:
-                    nsamp = ent.size/(4*nchan);
-                    break;
-                case FIFFT_INT:
-                    nsamp = ent.size/(4*nchan);
-                    break;
-                default:
-                    printf("Cannot handle data buffers of type %d\n",ent.type);
-                    return false;
-            }
-            //
-            //  Do we have an initial skip pending?
+            //  This first skip can be applied only after we know the buffer size
             //
-            if (first_skip > 0)
+            FiffTag::read_tag(p_pStream.data(), t_pTag, dir[first].pos);
+            first_skip = *t_pTag->toInt();
+            ++first;
+        }
+        data.first_samp = first_samp;
+        //
+        //   Go through the remaining tags in the directory
+        //
+//        rawdir = struct('ent',{},'first',{},'last',{},'nsamp',{});
+        fiff_int_t nskip = 0;
+        fiff_int_t ndir  = 0;
+        fiff_int_t nsamp = 0;
+        for (qint32 k = first; k < nent; ++k)
+        {
+            FiffDirEntry ent = dir.at(k);
+            if (ent.kind == FIFF_DATA_SKIP)
             {
-                first_samp += nsamp*first_skip;
-                data.first_samp = first_samp;
-                first_skip = 0;
+                FiffTag::read_tag(p_pStream.data(), t_pTag, ent.pos);
+                nskip = *t_pTag->toInt();
             }
-            //
-            //  Do we have a skip pending?
-            //
-            if (nskip > 0)
+            else if(ent.kind == FIFF_DATA_BUFFER)
             {
+                //
+                //   Figure out the number of samples in this buffer
+                //
+                switch(ent.type)
+                {
+                    case FIFFT_DAU_PACK16:
+                        nsamp = ent.size/(2*nchan);
+                        break;
+                    case FIFFT_SHORT:
+                        nsamp = ent.size/(2*nchan);
+                        break;
+                    case FIFFT_FLOAT:
+                        nsamp = ent.size/(4*nchan);
+                        break;
+                    case FIFFT_INT:
+                        nsamp = ent.size/(4*nchan);
+                        break;
+                    case FIFFT_COMPRESSED_BUFFER:
+                    {
+                        //
+                        //  The number of samples is stored in the payload header
+                        //
+                        fiff_int_t t_iStoreType, t_iNChan;
+                        p_pStream->device()->seek(ent.pos + 16);
+                        QByteArray t_qByteArrayHeader = p_pStream->device()->read(12);
+                        if (!FiffBufferCodec::readHeader(reinterpret_cast<const uchar*>(t_qByteArrayHeader.constData()), t_qByteArrayHeader.size(), t_iStoreType, t_iNChan, nsamp) || t_iNChan != nchan)
+                        {
+                            printf("Corrupt compressed data buffer at %d\n",ent.pos);
+                            return false;
+                        }
+                        break;
+                    }
+                    default:
+                        printf("Cannot handle data buffers of type %d\n",ent.type);
+                        return false;
+                }
+                //
+                //  Do we have an initial skip pending?
+                //
+                if (first_skip > 0)
+                {
+                    first_samp += nsamp*first_skip;
+                    data.first_samp = first_samp;
+                    first_skip = 0;
+                }
+                //
+                //  Do we have a skip pending?
+                //
+                if (nskip > 0)
+                {
+                    FiffRawDir t_RawDir;
+                    t_RawDir.first = first_samp;
+                    t_RawDir.last  = first_samp + nskip*nsamp - 1;//ToDo -1 right or is that MATLAB syntax
+                    t_RawDir.nsamp = nskip*nsamp;
+                    rawdir.append(t_RawDir);
+                    first_samp = first_samp + nskip*nsamp;
+                    nskip = 0;
+                    ++ndir;
+                }
+                //
+                //  Add a data buffer
+                //
                 FiffRawDir t_RawDir;
+                t_RawDir.ent   = ent;
                 t_RawDir.first = first_samp;
-                t_RawDir.last  = first_samp + nskip*nsamp - 1;//ToDo -1 right or is that MATLAB syntax
-                t_RawDir.nsamp = nskip*nsamp;
+                t_RawDir.last  = first_samp + nsamp - 1;//ToDo -1 right or is that MATLAB syntax
+                t_RawDir.nsamp = nsamp;
                 rawdir.append(t_RawDir);
-                first_samp = first_samp + nskip*nsamp;
-                nskip = 0;
+                first_samp += nsamp;
                 ++ndir;
             }
-            //
-            //  Add a data buffer
-            //
-            FiffRawDir t_RawDir;
-            t_RawDir.ent   = ent;
-            t_RawDir.first = first_samp;
-            t_RawDir.last  = first_samp + nsamp - 1;//ToDo -1 right or is that MATLAB syntax
-            t_RawDir.nsamp = nsamp;
-            rawdir.append(t_RawDir);
-            first_samp += nsamp;
-            ++ndir;
         }
+        data.last_samp  = first_samp - 1;//ToDo -1 right or is that MATLAB syntax
     }
-    data.last_samp  = first_samp - 1;//ToDo -1 right or is that MATLAB syntax
     //
     //   Add the calibration factors
     //
@@ -1480,7 +1868,26 @@ bool FiffStream::setup_read_raw(QIODevice &p_IODevice, FiffRawData& data, bool a
         cals(0,k) = data.info.chs.at(k).range*data.info.chs[k].cal;
     //
     data.cals       = cals;
-    data.rawdir     = rawdir;
+    if(!t_bCached)
+    {
+        data.rawdir     = rawdir;
+        data.make_rawdir_index();
+
+        if(!t_sCacheKey.isEmpty())
+        {
+            if(!t_bIndexed)
+                writeRawDirIndex(t_sIndexFile, t_fileInfo, data.info.nchan, data.first_samp, data.last_samp, data.rawdir);
+
+            RawDirCacheEntry* t_pCached = new RawDirCacheEntry;
+            t_pCached->first_samp  = data.first_samp;
+            t_pCached->last_samp   = data.last_samp;
+            t_pCached->rawdir      = data.rawdir;
+            t_pCached->rawdir_last = data.rawdir_last;
+
+            QMutexLocker locker(&s_rawDirCacheMutex);
+            s_rawDirCache.insert(t_sCacheKey, t_pCached, qMax(1, data.rawdir.size()));
+        }
+    }
     //data->proj       = [];
     //data.comp       = [];
     //
@@ -1977,10 +2384,7 @@ void FiffStream::write_double(fiff_int_t kind, const double* data, fiff_int_t ne
     *this << (qint32)datasize;
     *this << (qint32)FIFFV_NEXT_SEQ;
 
-//    this->setFloatingPointPrecision(QDataStream::SinglePrecision);
-
-    for(qint32 i = 0; i < nel; ++i)
-        *this << data[i];
+    write_big_endian(data, 8, nel);
 }
 
 
@@ -1995,10 +2399,7 @@ void FiffStream::write_float(fiff_int_t kind, const float* data, fiff_int_t nel)
     *this << (qint32)datasize;
     *this << (qint32)FIFFV_NEXT_SEQ;
 
-//    this->setFloatingPointPrecision(QDataStream::SinglePrecision);
-
-    for(qint32 i = 0; i < nel; ++i)
-        *this << data[i];
+    write_big_endian(data, 4, nel);
 }
 
 
@@ -2019,8 +2420,7 @@ void FiffStream::write_float_matrix(fiff_int_t kind, const MatrixXf& mat)
     *this << (qint32)FIFFV_NEXT_SEQ;
 
     qint32 i;
-    for(i = 0; i < numel; ++i)
-        *this << mat.data()[i];
+    write_big_endian(mat.data(), 4, numel);
 
     qint32 dims[3];
     dims[0] = mat.cols();
@@ -2343,8 +2743,7 @@ void FiffStream::write_int(fiff_int_t kind, const fiff_int_t* data, fiff_int_t n
     *this << (qint32)datasize;
     *this << (qint32)FIFFV_NEXT_SEQ;
 
-    for(qint32 i = 0; i < nel; ++i)
-        *this << data[i];
+    write_big_endian(data, 4, nel);
 }
 
 
@@ -2365,8 +2764,7 @@ void FiffStream::write_int_matrix(fiff_int_t kind, const MatrixXi& mat)
     *this << (qint32)FIFFV_NEXT_SEQ;
 
     qint32 i;
-    for(i = 0; i < numel; ++i)
-        *this << mat.data()[i];
+    write_big_endian(mat.data(), 4, numel);
 
     qint32 dims[3];
     dims[0] = mat.cols();
@@ -2445,17 +2843,77 @@ bool FiffStream::write_raw_buffer(const MatrixXd& buf, const RowVectorXd& cals)
         return false;
     }
 
-    typedef Eigen::Triplet<double> T;
-    std::vector<T> tripletList;
-    tripletList.reserve(cals.cols());
-    for(qint32 i = 0; i < cals.cols(); ++i)
-        tripletList.push_back(T(i, i, 1.0/cals[i]));
+    return write_raw_buffer(buf, FiffInvCals(cals));
+}
+
+
+//*************************************************************************************************************
+
+bool FiffStream::write_raw_buffer(const MatrixXd& buf, const FiffInvCals& invCals)
+{
+    if (buf.rows() != invCals.inv_cals.cols())
+    {
+        printf("buffer and calibration sizes do not match\n");
+        return false;
+    }
+
+    //
+    //   Uncalibrate, convert and swap in a single pass into the scratch buffer
+    //
+    qint64 nel = (qint64)buf.rows()*buf.cols();
+
+    *this << (qint32)FIFF_DATA_BUFFER;
+    *this << (qint32)FIFFT_FLOAT;
+    *this << (qint32)(nel*4);
+    *this << (qint32)FIFFV_NEXT_SEQ;
 
-    SparseMatrix<double> inv_calsMat(cals.cols(), cals.cols());
-    inv_calsMat.setFromTriplets(tripletList.begin(), tripletList.end());
+    if(m_qByteArrayScratch.size() < nel*4)
+        m_qByteArrayScratch.resize(nel*4);
+    uchar* t_pDst = reinterpret_cast<uchar*>(m_qByteArrayScratch.data());
 
-    MatrixXf tmp = (inv_calsMat*buf).cast<float>();
-    this->write_float(FIFF_DATA_BUFFER,tmp.data(),tmp.rows()*tmp.cols());
+    const double* t_pSrc = buf.data();
+    const double* t_pInvCals = invCals.inv_cals.data();
+    qint32 nrows = buf.rows();
+    for(qint64 c = 0; c < buf.cols(); ++c)
+    {
+        for(qint32 r = 0; r < nrows; ++r)
+        {
+            float t_fValue = (float)(t_pSrc[r]*t_pInvCals[r]);
+            quint32 t_iValue;
+            memcpy(&t_iValue, &t_fValue, 4);
+            qToBigEndian<quint32>(t_iValue, t_pDst + 4*r);
+        }
+        t_pSrc += nrows;
+        t_pDst += 4*nrows;
+    }
+
+    this->writeRawData(m_qByteArrayScratch.constData(), (int)(nel*4));
+    return true;
+}
+
+
+//*************************************************************************************************************
+
+bool FiffStream::write_raw_buffer_compressed(const MatrixXd& buf, const RowVectorXd& cals, fiff_int_t p_iStoreType)
+{
+    if (buf.rows() != cals.cols())
+    {
+        printf("buffer and calibration sizes do not match\n");
+        return false;
+    }
+
+    if (!FiffBufferCodec::encode(buf, cals, p_iStoreType, m_qByteArrayScratch))
+    {
+        printf("Cannot compress data buffers of type %d\n", p_iStoreType);
+        return false;
+    }
+
+    *this << (qint32)FIFF_DATA_BUFFER;
+    *this << (qint32)FIFFT_COMPRESSED_BUFFER;
+    *this << (qint32)m_qByteArrayScratch.size();
+    *this << (qint32)FIFFV_NEXT_SEQ;
+
+    this->writeRawData(m_qByteArrayScratch.constData(), m_qByteArrayScratch.size());
     return true;
 }
 
@@ -2487,3 +2945,23 @@ void FiffStream::write_rt_command(fiff_int_t command, const QString& data)
 
     this->writeRawData(data.toUtf8().constData(),datasize);
 }
+
+
+//*************************************************************************************************************
+
+void FiffStream::write_big_endian(const void* p_pData, qint32 p_iElSize, qint64 p_iNel)
+{
+    qint64 t_iBytes = p_iNel*p_iElSize;
+    if(t_iBytes <= 0)
+        return;
+
+    if(m_qByteArrayScratch.size() < t_iBytes)
+        m_qByteArrayScratch.resize(t_iBytes);
+
+    if(p_iElSize == 8)
+        copyToBigEndian64(p_pData, m_qByteArrayScratch.data(), p_iNel);
+    else
+        copyToBigEndian32(p_pData, m_qByteArrayScratch.data(), p_iNel);
+
+    this->writeRawData(m_qByteArrayScratch.constData(), (int)t_iBytes);
+}
@@ -77,6 +77,7 @@
 //=============================================================================================================
 
 #include <QByteArray>
+#include <QCache>
 #include <QDataStream>
 #include <QFile>
 #include <QIODevice>
@@ -119,6 +120,25 @@ static FiffId defaultFiffId;
 using namespace Eigen;
 
 
+//=============================================================================================================
+/**
+* Inverse calibration factors of the channels of a raw buffer. Computed once per recording and passed to
+* FiffStream::write_raw_buffer for every buffer, which then only multiplies.
+*
+* @brief Precomputed inverse calibration for writing raw buffers.
+*/
+struct FiffInvCals
+{
+    FiffInvCals() {}
+
+    explicit FiffInvCals(const RowVectorXd& cals)
+    : inv_cals(cals.cwiseInverse())
+    {}
+
+    RowVectorXd inv_cals;   /**< 1/cal of each channel. */
+};
+
+
 //=============================================================================================================
 /**
 * FiffStream provides an interface for reading from and writing to fiff files
@@ -219,6 +239,77 @@ public:
     */
     bool open(FiffDirTree& p_Tree, QList<FiffDirEntry>& p_Dir);
 
+    //=========================================================================================================
+    /**
+    * Memory maps the whole file behind this stream. The IO device has to be a QFile. Mapping reserves address
+    * space only, pages are loaded by the OS when they are touched, so seeking through a large recording does
+    * not read the skipped parts. The mapping stays valid after the device is closed; it is released by
+    * unmapFile() or when the QFile is destroyed.
+    *
+    * @return true if succeeded, false otherwise
+    */
+    bool mapFile();
+
+    //=========================================================================================================
+    /**
+    * Releases a mapping created by mapFile().
+    */
+    void unmapFile();
+
+    //=========================================================================================================
+    /**
+    * Returns whether the file behind this stream is memory mapped.
+    *
+    * @return true if mapped, false otherwise
+    */
+    inline bool isMapped() const;
+
+    //=========================================================================================================
+    /**
+    * Returns a pointer into the mapped file where the payload of the given tag starts. The data is not
+    * converted, i.e. it is still in file (big endian) byte order.
+    *
+    * @param[in] p_Entry    Directory entry of the tag
+    *
+    * @return pointer to the tag payload, NULL if the file is not mapped or the tag lies outside the mapping
+    */
+    inline const uchar* mappedTagData(const FiffDirEntry& p_Entry) const;
+
+    //=========================================================================================================
+    /**
+    * Reads a tag through the LRU cache of decoded tags of this stream. Reading the same tag again returns the
+    * cached tag without touching the device; the tag is shared, so it must not be modified. Tags larger than
+    * the cache are decoded but not kept.
+    *
+    * @param[out] p_pTag    the read tag
+    * @param[in] pos        position of the tag inside the stream
+    *
+    * @return true if succeeded, false otherwise
+    */
+    bool read_tag_cached(QSharedPointer<FiffTag>& p_pTag, qint64 pos);
+
+    //=========================================================================================================
+    /**
+    * Sets the size of the decoded tag cache, default is 16 MB.
+    *
+    * @param[in] p_iKBytes  maximal size of the cached tag data in kilobytes
+    */
+    void setTagCacheSize(int p_iKBytes);
+
+    //=========================================================================================================
+    /**
+    * Drops the cached tag at the given position, if any.
+    *
+    * @param[in] pos        position of the tag inside the stream
+    */
+    void removeCachedTag(qint64 pos);
+
+    //=========================================================================================================
+    /**
+    * Drops all cached tags.
+    */
+    void clearTagCache();
+
     //=========================================================================================================
     /**
     * fiff_read_bad_channels
@@ -307,10 +398,11 @@ public:
     * @param[in] p_Node     The node of interest
     * @param[in] matkind    The matrix kind to look for
     * @param[out] mat       The named matrix
+    * @param[in] p_bReadData    If false only dimensions and names are read, the matrix data stays empty (optional)
     *
     * @return true if succeeded, false otherwise
     */
-    bool read_named_matrix(const FiffDirTree& p_Node, fiff_int_t matkind, FiffNamedMatrix& mat);
+    bool read_named_matrix(const FiffDirTree& p_Node, fiff_int_t matkind, FiffNamedMatrix& mat, bool p_bReadData = true);
 
     //=========================================================================================================
     /**
@@ -642,6 +734,32 @@ public:
     */
     bool write_raw_buffer(const MatrixXd& buf, const RowVectorXd& cals);
 
+    //=========================================================================================================
+    /**
+    * Writes a raw buffer with precomputed inverse calibration factors, so writing a recording does not divide
+    * by the calibration of every buffer again. Uncalibrates, converts and byte swaps in a single pass.
+    *
+    * @param[in] buf        the buffer to write
+    * @param[in] invCals    the inverse calibration factors
+    *
+    * @return true if succeeded, false otherwise
+    */
+    bool write_raw_buffer(const MatrixXd& buf, const FiffInvCals& invCals);
+
+    //=========================================================================================================
+    /**
+    * Writes a raw buffer as a losslessly compressed FIFFT_COMPRESSED_BUFFER tag (see FiffBufferCodec). The
+    * buffer is uncalibrated and stored as p_iStoreType before compression; integer types are rounded, which is
+    * exact for data acquired as integers. FiffRawData decodes these buffers transparently.
+    *
+    * @param[in] buf            the buffer to write
+    * @param[in] cals           calibration factors
+    * @param[in] p_iStoreType   the storage type to compress (FIFFT_INT, FIFFT_DAU_PACK16, FIFFT_SHORT or FIFFT_FLOAT)
+    *
+    * @return true if succeeded, false otherwise
+    */
+    bool write_raw_buffer_compressed(const MatrixXd& buf, const RowVectorXd& cals, fiff_int_t p_iStoreType = FIFFT_INT);
+
     //=========================================================================================================
     /**
     * fiff_write_string
@@ -663,8 +781,49 @@ public:
     * @param[in] data       The string data to write
     */
     void write_rt_command(fiff_int_t command, const QString& data);
+
+private:
+    //=========================================================================================================
+    /**
+    * Writes an array of 4 or 8 byte values in file byte order. The array is swapped as a whole into a reusable
+    * scratch buffer and written with a single call.
+    *
+    * @param[in] p_pData    The values to write
+    * @param[in] p_iElSize  Size of one value in bytes (4 or 8)
+    * @param[in] p_iNel     Number of values
+    */
+    void write_big_endian(const void* p_pData, qint32 p_iElSize, qint64 p_iNel);
+
+    uchar*  m_pMappedData;      /**< Start of the memory mapped file, NULL if not mapped. */
+    qint64  m_iMappedSize;      /**< Size of the mapped region in bytes. */
+    QByteArray m_qByteArrayScratch; /**< Reusable buffer of the bulk writers. */
+    QCache<qint64, QSharedPointer<FiffTag> > m_qCacheTags;  /**< Decoded tags by position, cost in kilobytes. */
 };
 
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INLINE DEFINITIONS
+//=============================================================================================================
+
+inline bool FiffStream::isMapped() const
+{
+    return m_pMappedData != NULL;
+}
+
+
+//*************************************************************************************************************
+
+inline const uchar* FiffStream::mappedTagData(const FiffDirEntry& p_Entry) const
+{
+    // tag header: kind, type, size, next -> 4*4 bytes in front of the payload
+    qint64 pos = (qint64)p_Entry.pos + 16;
+    if(!m_pMappedData || p_Entry.pos < 0 || pos + p_Entry.size > m_iMappedSize)
+        return NULL;
+
+    return m_pMappedData + pos;
+}
+
 } // NAMESPACE
 
 #endif // FIFF_STREAM_H
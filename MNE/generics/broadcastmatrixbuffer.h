@@ -0,0 +1,620 @@
+//=============================================================================================================
+/**
+* @file     broadcastmatrixbuffer.h
+* @author   Christoph Dinh <chdinh@nmr.mgh.harvard.edu>;
+*           Matti Hamalainen <msh@nmr.mgh.harvard.edu>
+* @version  1.0
+* @date     October, 2026
+*
+* @section  LICENSE
+*
+* Copyright (C) 2012, Christoph Dinh and Matti Hamalainen. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+* the following conditions are met:
+*     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+*       following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+*       the following disclaimer in the documentation and/or other materials provided with the distribution.
+*     * Neither the name of the Massachusetts General Hospital nor the names of its contributors may be used
+*       to endorse or promote products derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+* PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL MASSACHUSETTS GENERAL HOSPITAL BE LIABLE FOR ANY DIRECT,
+* INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+* NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+* @brief     BroadcastMatrixBuffer class declaration
+*
+*/
+
+#ifndef BROADCASTMATRIXBUFFER_H
+#define BROADCASTMATRIXBUFFER_H
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include "generics_global.h"
+#include "buffer.h"
+
+#include <typeinfo>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// Eigen INCLUDES
+//=============================================================================================================
+
+#include <Eigen/Core>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// QT INCLUDES
+//=============================================================================================================
+
+#include <QList>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QSharedPointer>
+#include <QWaitCondition>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINE NAMESPACE IOBuffer
+//=============================================================================================================
+
+namespace IOBuffer
+{
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// USED NAMESPACES
+//=============================================================================================================
+
+using namespace Eigen;
+
+
+//=============================================================================================================
+/**
+* Broadcast matrix buffer: one producer writes each matrix once into a ring of slots, any number of readers
+* see every matrix through their own cursor, without copies. A reader is attached by constructing a
+* BroadcastMatrixBuffer::Reader and detached by destroying it; it sees the matrices written after it was
+* attached.
+*
+* Each reader chooses what happens when it falls a whole ring behind: a Block reader stalls the producer until
+* it catches up, a Skip reader is moved forward and loses the oldest matrices, which are counted in
+* Reader::dropped().
+*
+* Each matrix can carry a time stamp, usually the Tracer::now() acquisition time of its data, which the readers
+* get by Reader::timestamp().
+*
+* Slot views returned by peekWrite()/Reader::peek() stay valid until the corresponding commit; the buffer has
+* to outlive its readers.
+*
+* @brief Single-producer/multi-consumer broadcast matrix buffer
+*/
+template<typename _Tp>
+class BroadcastMatrixBuffer : public Buffer
+{
+public:
+    typedef QSharedPointer<BroadcastMatrixBuffer> SPtr;             /**< Shared pointer type for BroadcastMatrixBuffer. */
+    typedef QSharedPointer<const BroadcastMatrixBuffer> ConstSPtr;  /**< Const shared pointer type for BroadcastMatrixBuffer. */
+
+    typedef Matrix<_Tp, Dynamic, Dynamic> MatrixType;               /**< The stored matrix type. */
+    typedef Map<MatrixType> MatrixMap;                              /**< View of a writable slot. */
+    typedef Map<const MatrixType> ConstMatrixMap;                   /**< View of a readable slot. */
+
+    //=========================================================================================================
+    /**
+    * What happens if a reader falls a whole ring behind the producer.
+    */
+    enum ReaderPolicy {
+        Block,  /**< The producer waits for the reader. */
+        Skip    /**< The reader loses the oldest matrices. */
+    };
+
+    //=========================================================================================================
+    /**
+    * A reader of a BroadcastMatrixBuffer, to be used by one thread.
+    */
+    class Reader
+    {
+    public:
+        typedef QSharedPointer<Reader> SPtr;    /**< Shared pointer type for Reader. */
+
+        //=====================================================================================================
+        /**
+        * Attaches a reader.
+        *
+        * @param [in] pBuffer   The buffer to read from.
+        * @param [in] policy    What happens if the reader falls a whole ring behind.
+        */
+        Reader(BroadcastMatrixBuffer* pBuffer, ReaderPolicy policy);
+
+        //=====================================================================================================
+        /**
+        * Detaches the reader.
+        */
+        ~Reader();
+
+        //=====================================================================================================
+        /**
+        * Returns a view of the next matrix; the slot is handed back by commit().
+        *
+        * @param [in] bWait     Whether to wait for the next matrix.
+        *
+        * @return the view, with a NULL data pointer if there is none (and bWait is false) or the reader was released.
+        */
+        ConstMatrixMap peek(bool bWait = true);
+
+        //=====================================================================================================
+        /**
+        * Hands back the slot returned by the last peek().
+        */
+        void commit();
+
+        //=====================================================================================================
+        /**
+        * Copies the next matrix. No memory is allocated if matrix has the right size already.
+        *
+        * @param [out] matrix   the matrix.
+        * @param [in] bWait     Whether to wait for the next matrix.
+        *
+        * @return true if a matrix was read.
+        */
+        bool pop(MatrixType& matrix, bool bWait = true);
+
+        //=====================================================================================================
+        /**
+        * Releases a waiting peek/pop and lets further calls return immediately. A released reader no longer
+        * blocks the producer.
+        */
+        void release();
+
+        //=====================================================================================================
+        /**
+        * Number of matrices the reader lost because it fell behind (Skip policy only).
+        */
+        quint64 dropped() const;
+
+        //=====================================================================================================
+        /**
+        * Number of matrices written but not read yet.
+        */
+        quint32 available() const;
+
+        //=====================================================================================================
+        /**
+        * Time stamp of the matrix returned by the last peek() or pop(), -1 if it was written without one.
+        */
+        inline qint64 timestamp() const;
+
+        //=====================================================================================================
+        /**
+        * The policy of the reader.
+        */
+        inline ReaderPolicy policy() const;
+
+    private:
+        friend class BroadcastMatrixBuffer;
+
+        BroadcastMatrixBuffer*  m_pBuffer;      /**< The buffer.*/
+        ReaderPolicy            m_policy;       /**< The policy.*/
+        quint64                 m_uiCursor;     /**< Number of matrices read, guarded by the buffer mutex.*/
+        quint64                 m_uiDropped;    /**< Number of matrices lost, guarded by the buffer mutex.*/
+        bool                    m_bPeeked;      /**< Whether a slot is held by peek(), guarded by the buffer mutex.*/
+        bool                    m_bReleased;    /**< Whether release() was called, guarded by the buffer mutex.*/
+        qint64                  m_iTimestamp;   /**< Time stamp of the last peeked matrix.*/
+    };
+
+    //=========================================================================================================
+    /**
+    * Constructs a BroadcastMatrixBuffer.
+    *
+    * @param [in] uiMaxNumMatrices  Number of slots, rounded up to the next power of two.
+    * @param [in] uiRows            Number of rows.
+    * @param [in] uiCols            Number of columns.
+    */
+    explicit BroadcastMatrixBuffer(unsigned int uiMaxNumMatrices, unsigned int uiRows, unsigned int uiCols);
+
+    //=========================================================================================================
+    /**
+    * Destroys the BroadcastMatrixBuffer.
+    */
+    ~BroadcastMatrixBuffer();
+
+    //=========================================================================================================
+    /**
+    * Returns a view of the next slot to write; it is published to all readers by commitWrite().
+    *
+    * @param [in] bWait     Whether to wait for Block readers to free the slot.
+    *
+    * @return the view, with a NULL data pointer if the slot is still in use (and bWait is false) or the buffer was released.
+    */
+    MatrixMap peekWrite(bool bWait = true);
+
+    //=========================================================================================================
+    /**
+    * Publishes the slot returned by the last peekWrite().
+    *
+    * @param [in] iTimestamp    Time stamp of the matrix, -1 if none.
+    */
+    void commitWrite(qint64 iTimestamp = -1);
+
+    //=========================================================================================================
+    /**
+    * Copies a matrix into the buffer.
+    *
+    * @param [in] pMatrix   the matrix to append, of size rows() x cols().
+    * @param [in] bWait     Whether to wait for Block readers to free the slot.
+    * @param [in] iTimestamp    Time stamp of the matrix, -1 if none.
+    *
+    * @return true if the matrix was appended.
+    */
+    bool push(const MatrixType* pMatrix, bool bWait = true, qint64 iTimestamp = -1);
+
+    //=========================================================================================================
+    /**
+    * Releases all waiting calls of the producer and of the readers.
+    */
+    void release();
+
+    //=========================================================================================================
+    /**
+    * Number of attached readers.
+    */
+    int readerCount() const;
+
+    //=========================================================================================================
+    /**
+    * Size of the buffer.
+    */
+    inline quint32 size() const;
+
+    //=========================================================================================================
+    /**
+    * Rows of the stored matrices of the buffer.
+    */
+    inline quint32 rows() const;
+
+    //=========================================================================================================
+    /**
+    * Cols of the stored matrices of the buffer.
+    */
+    inline quint32 cols() const;
+
+private:
+    inline _Tp* slot(quint64 uiIndex) const;
+
+    quint32             m_uiMaxNumMatrices;     /**< Holds the number of slots, a power of two.*/
+    quint32             m_uiRows;               /**< Holds the number rows.*/
+    quint32             m_uiCols;               /**< Holds the number cols.*/
+    quint32             m_uiSlotSize;           /**< Holds the number of elements per slot.*/
+    _Tp*                m_pBuffer;              /**< Holds the slots.*/
+    qint64*             m_pTimestamps;          /**< Holds the time stamps of the slots.*/
+
+    quint64             m_uiWriteCount;         /**< Number of committed writes.*/
+    bool                m_bReleased;            /**< Set by release().*/
+    QList<Reader*>      m_qListReaders;         /**< The attached readers.*/
+    mutable QMutex      m_mutex;                /**< Guards counters, cursors and the reader list.*/
+    QWaitCondition      m_readable;             /**< Readers wait here for new matrices.*/
+    QWaitCondition      m_writable;             /**< The producer waits here for Block readers.*/
+};
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINE MEMBER METHODS
+//=============================================================================================================
+
+template<typename _Tp>
+BroadcastMatrixBuffer<_Tp>::Reader::Reader(BroadcastMatrixBuffer* pBuffer, ReaderPolicy policy)
+: m_pBuffer(pBuffer)
+, m_policy(policy)
+, m_uiCursor(0)
+, m_uiDropped(0)
+, m_bPeeked(false)
+, m_bReleased(false)
+, m_iTimestamp(-1)
+{
+    QMutexLocker locker(&m_pBuffer->m_mutex);
+    m_uiCursor = m_pBuffer->m_uiWriteCount;
+    m_pBuffer->m_qListReaders.append(this);
+}
+
+
+//*************************************************************************************************************
+
+template<typename _Tp>
+BroadcastMatrixBuffer<_Tp>::Reader::~Reader()
+{
+    QMutexLocker locker(&m_pBuffer->m_mutex);
+    m_pBuffer->m_qListReaders.removeAll(this);
+    m_pBuffer->m_writable.wakeAll();
+}
+
+
+//*************************************************************************************************************
+
+template<typename _Tp>
+typename BroadcastMatrixBuffer<_Tp>::ConstMatrixMap BroadcastMatrixBuffer<_Tp>::Reader::peek(bool bWait)
+{
+    QMutexLocker locker(&m_pBuffer->m_mutex);
+    while(m_uiCursor == m_pBuffer->m_uiWriteCount)
+    {
+        if(!bWait || m_bReleased || m_pBuffer->m_bReleased)
+            return ConstMatrixMap(NULL, 0, 0);
+        m_pBuffer->m_readable.wait(&m_pBuffer->m_mutex);
+    }
+    if(m_bReleased)
+        return ConstMatrixMap(NULL, 0, 0);
+
+    m_bPeeked = true;
+    m_iTimestamp = m_pBuffer->m_pTimestamps[m_uiCursor & (m_pBuffer->m_uiMaxNumMatrices - 1)];
+    return ConstMatrixMap(m_pBuffer->slot(m_uiCursor), m_pBuffer->m_uiRows, m_pBuffer->m_uiCols);
+}
+
+
+//*************************************************************************************************************
+
+template<typename _Tp>
+void BroadcastMatrixBuffer<_Tp>::Reader::commit()
+{
+    QMutexLocker locker(&m_pBuffer->m_mutex);
+    if(m_bPeeked)
+    {
+        m_bPeeked = false;
+        ++m_uiCursor;
+        m_pBuffer->m_writable.wakeAll();
+    }
+}
+
+
+//*************************************************************************************************************
+
+template<typename _Tp>
+bool BroadcastMatrixBuffer<_Tp>::Reader::pop(MatrixType& matrix, bool bWait)
+{
+    ConstMatrixMap view = peek(bWait);
+    if(!view.data())
+        return false;
+
+    matrix = view;
+    commit();
+    return true;
+}
+
+
+//*************************************************************************************************************
+
+template<typename _Tp>
+void BroadcastMatrixBuffer<_Tp>::Reader::release()
+{
+    QMutexLocker locker(&m_pBuffer->m_mutex);
+    m_bReleased = true;
+    m_pBuffer->m_readable.wakeAll();
+    m_pBuffer->m_writable.wakeAll();
+}
+
+
+//*************************************************************************************************************
+
+template<typename _Tp>
+quint64 BroadcastMatrixBuffer<_Tp>::Reader::dropped() const
+{
+    QMutexLocker locker(&m_pBuffer->m_mutex);
+    return m_uiDropped;
+}
+
+
+//*************************************************************************************************************
+
+template<typename _Tp>
+quint32 BroadcastMatrixBuffer<_Tp>::Reader::available() const
+{
+    QMutexLocker locker(&m_pBuffer->m_mutex);
+    return (quint32)(m_pBuffer->m_uiWriteCount - m_uiCursor);
+}
+
+
+//*************************************************************************************************************
+
+template<typename _Tp>
+inline qint64 BroadcastMatrixBuffer<_Tp>::Reader::timestamp() const
+{
+    return m_iTimestamp;
+}
+
+
+//*************************************************************************************************************
+
+template<typename _Tp>
+inline typename BroadcastMatrixBuffer<_Tp>::ReaderPolicy BroadcastMatrixBuffer<_Tp>::Reader::policy() const
+{
+    return m_policy;
+}
+
+
+//*************************************************************************************************************
+
+template<typename _Tp>
+BroadcastMatrixBuffer<_Tp>::BroadcastMatrixBuffer(unsigned int uiMaxNumMatrices, unsigned int uiRows, unsigned int uiCols)
+: Buffer(typeid(_Tp).name())
+, m_uiMaxNumMatrices(1)
+, m_uiRows(uiRows)
+, m_uiCols(uiCols)
+, m_uiSlotSize(uiRows*uiCols)
+, m_uiWriteCount(0)
+, m_bReleased(false)
+{
+    while(m_uiMaxNumMatrices < uiMaxNumMatrices)
+        m_uiMaxNumMatrices <<= 1;
+    m_pBuffer = new _Tp[m_uiMaxNumMatrices*m_uiSlotSize];
+    m_pTimestamps = new qint64[m_uiMaxNumMatrices];
+}
+
+
+//*************************************************************************************************************
+
+template<typename _Tp>
+BroadcastMatrixBuffer<_Tp>::~BroadcastMatrixBuffer()
+{
+    delete [] m_pBuffer;
+    delete [] m_pTimestamps;
+}
+
+
+//*************************************************************************************************************
+
+template<typename _Tp>
+typename BroadcastMatrixBuffer<_Tp>::MatrixMap BroadcastMatrixBuffer<_Tp>::peekWrite(bool bWait)
+{
+    QMutexLocker locker(&m_mutex);
+    for(;;)
+    {
+        if(m_bReleased)
+            return MatrixMap(NULL, 0, 0);
+
+        //
+        //  The slot to write still holds the matrix m_uiWriteCount - size(); every reader which has not read it
+        //  yet either blocks the producer or is moved past it
+        //
+        bool bFree = true;
+        for(int i = 0; i < m_qListReaders.size(); ++i)
+        {
+            Reader* pReader = m_qListReaders[i];
+            if(m_uiWriteCount - pReader->m_uiCursor < m_uiMaxNumMatrices)
+                continue;
+
+            if(pReader->m_bReleased || (pReader->m_policy == Skip && !pReader->m_bPeeked))
+            {
+                quint64 uiCursor = m_uiWriteCount - m_uiMaxNumMatrices + 1;
+                if(!pReader->m_bReleased)
+                    pReader->m_uiDropped += uiCursor - pReader->m_uiCursor;
+                pReader->m_uiCursor = uiCursor;
+                continue;
+            }
+
+            bFree = false;
+        }
+
+        if(bFree)
+            break;
+        if(!bWait)
+            return MatrixMap(NULL, 0, 0);
+        m_writable.wait(&m_mutex);
+    }
+
+    return MatrixMap(slot(m_uiWriteCount), m_uiRows, m_uiCols);
+}
+
+
+//*************************************************************************************************************
+
+template<typename _Tp>
+void BroadcastMatrixBuffer<_Tp>::commitWrite(qint64 iTimestamp)
+{
+    QMutexLocker locker(&m_mutex);
+    m_pTimestamps[m_uiWriteCount & (m_uiMaxNumMatrices - 1)] = iTimestamp;
+    ++m_uiWriteCount;
+    m_readable.wakeAll();
+}
+
+
+//*************************************************************************************************************
+
+template<typename _Tp>
+bool BroadcastMatrixBuffer<_Tp>::push(const MatrixType* pMatrix, bool bWait, qint64 iTimestamp)
+{
+    if((quint32)pMatrix->size() != m_uiSlotSize)
+        return false;
+
+    MatrixMap view = peekWrite(bWait);
+    if(!view.data())
+        return false;
+
+    view = *pMatrix;
+    commitWrite(iTimestamp);
+    return true;
+}
+
+
+//*************************************************************************************************************
+
+template<typename _Tp>
+void BroadcastMatrixBuffer<_Tp>::release()
+{
+    QMutexLocker locker(&m_mutex);
+    m_bReleased = true;
+    m_readable.wakeAll();
+    m_writable.wakeAll();
+}
+
+
+//*************************************************************************************************************
+
+template<typename _Tp>
+int BroadcastMatrixBuffer<_Tp>::readerCount() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_qListReaders.size();
+}
+
+
+//*************************************************************************************************************
+
+template<typename _Tp>
+inline quint32 BroadcastMatrixBuffer<_Tp>::size() const
+{
+    return m_uiMaxNumMatrices;
+}
+
+
+//*************************************************************************************************************
+
+template<typename _Tp>
+inline quint32 BroadcastMatrixBuffer<_Tp>::rows() const
+{
+    return m_uiRows;
+}
+
+
+//*************************************************************************************************************
+
+template<typename _Tp>
+inline quint32 BroadcastMatrixBuffer<_Tp>::cols() const
+{
+    return m_uiCols;
+}
+
+
+//*************************************************************************************************************
+
+template<typename _Tp>
+inline _Tp* BroadcastMatrixBuffer<_Tp>::slot(quint64 uiIndex) const
+{
+    return m_pBuffer + (uiIndex & (m_uiMaxNumMatrices - 1))*m_uiSlotSize;
+}
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// TYPEDEF
+//=============================================================================================================
+
+typedef GENERICSSHARED_EXPORT BroadcastMatrixBuffer<float>  _float_BroadcastMatrixBuffer;   /**< Defines BroadcastMatrixBuffer of float type.*/
+typedef GENERICSSHARED_EXPORT BroadcastMatrixBuffer<double> _double_BroadcastMatrixBuffer;  /**< Defines BroadcastMatrixBuffer of double type.*/
+
+} // NAMESPACE
+
+#endif // BROADCASTMATRIXBUFFER_H
@@ -237,7 +237,7 @@ inline _Tp CircularBuffer<_Tp>::pop()
         m_pFreeElements->release();
     }
     else
-        element = 0;
+        element = _Tp();
 
     return element;
 }
@@ -285,7 +285,7 @@ inline bool CircularBuffer<_Tp>::releaseFromPop()
     if((uint)m_pUsedElements->available() < 1)
     {
         //The last value which is to be popped from the buffer is supposed to be a zero
-        m_pBuffer[mapIndex(m_iCurrentWriteIndex)] = 0;
+        m_pBuffer[mapIndex(m_iCurrentWriteIndex)] = _Tp();
 
         //Release (create) values from m_pUsedElements so that the pop function can leave the acquire statement in the pop function
         m_pUsedElements->release(1);
@@ -305,7 +305,7 @@ inline bool CircularBuffer<_Tp>::releaseFromPush()
     if((uint)m_pFreeElements->available() < 1)
     {
         //The last value which is to be pushed to the buffer is supposed to be a zero
-        m_pBuffer[mapIndex(m_iCurrentWriteIndex)] = 0;
+        m_pBuffer[mapIndex(m_iCurrentWriteIndex)] = _Tp();
 
         //Release (create) value from m_pFreeElements so that the push function can leave the acquire statement in the push function
         m_pFreeElements->release(1);
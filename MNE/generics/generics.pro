@@ -64,11 +64,19 @@ win32 {
 SOURCES += \ 
     circularbuffer.cpp \
     circularmatrixbuffer.cpp \
+    spscmatrixbuffer.cpp \
+    broadcastmatrixbuffer.cpp \
+    tracer.cpp \
+    playbackclock.cpp \
     observerpattern.cpp \
     buffer.cpp
 
 HEADERS += generics_global.h \
     circularmatrixbuffer.h \
+    spscmatrixbuffer.h \
+    broadcastmatrixbuffer.h \
+    tracer.h \
+    playbackclock.h \
     circularbuffer.h \
     observerpattern.h \
     commandpattern.h \
@@ -0,0 +1,266 @@
+//=============================================================================================================
+/**
+* @file     playbackclock.cpp
+* @author   Christoph Dinh <chdinh@nmr.mgh.harvard.edu>;
+*           Matti Hamalainen <msh@nmr.mgh.harvard.edu>
+* @version  1.0
+* @date     October, 2026
+*
+* @section  LICENSE
+*
+* Copyright (C) 2026, Christoph Dinh and Matti Hamalainen. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+* the following conditions are met:
+*     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+*       following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+*       the following disclaimer in the documentation and/or other materials provided with the distribution.
+*     * Neither the name of the Massachusetts General Hospital nor the names of its contributors may be used
+*       to endorse or promote products derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+* PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL MASSACHUSETTS GENERAL HOSPITAL BE LIABLE FOR ANY DIRECT,
+* INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+* NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+* @brief    Contains implementations of the PlaybackClock Class
+*
+*/
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include "playbackclock.h"
+#include "tracer.h"
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// QT INCLUDES
+//=============================================================================================================
+
+#include <QMutexLocker>
+#include <QThread>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// USED NAMESPACES
+//=============================================================================================================
+
+using namespace IOBuffer;
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINE MEMBER METHODS
+//=============================================================================================================
+
+PlaybackClock::PlaybackClock()
+: m_dPeriod(1.0e9)
+, m_dSpeed(1.0)
+, m_mode(Paced)
+, m_iMaxCatchUp(16)
+, m_bStarted(false)
+, m_iAnchor(0)
+, m_iTick(0)
+{
+    m_statistics.iTicks = 0;
+    m_statistics.iOverruns = 0;
+    m_statistics.iResyncs = 0;
+    m_statistics.iMaxLate = 0;
+    m_statistics.iTotalLate = 0;
+}
+
+
+//*************************************************************************************************************
+
+void PlaybackClock::setPeriod(double p_dSamplingRate, qint32 p_iSamplesPerTick)
+{
+    if(p_dSamplingRate <= 0 || p_iSamplesPerTick <= 0)
+        return;
+
+    QMutexLocker locker(&m_mutex);
+
+    if(m_bStarted)
+    {
+        m_iAnchor = nextDeadline();
+        m_iTick = 0;
+    }
+
+    m_dPeriod = 1.0e9 * p_iSamplesPerTick / p_dSamplingRate;
+}
+
+
+//*************************************************************************************************************
+
+void PlaybackClock::setSpeed(double p_dSpeed)
+{
+    QMutexLocker locker(&m_mutex);
+
+    if(m_bStarted)
+    {
+        m_iAnchor = m_mode == Paced ? nextDeadline() : Tracer::now();
+        m_iTick = 0;
+    }
+
+    if(p_dSpeed > 0)
+    {
+        m_dSpeed = p_dSpeed;
+        m_mode = Paced;
+    }
+    else
+        m_mode = Unpaced;
+}
+
+
+//*************************************************************************************************************
+
+double PlaybackClock::speed() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_mode == Paced ? m_dSpeed : 0.0;
+}
+
+
+//*************************************************************************************************************
+
+void PlaybackClock::setMode(Mode p_mode)
+{
+    QMutexLocker locker(&m_mutex);
+
+    if(m_bStarted && p_mode != m_mode)
+    {
+        m_iAnchor = Tracer::now();
+        m_iTick = 0;
+    }
+
+    m_mode = p_mode;
+}
+
+
+//*************************************************************************************************************
+
+PlaybackClock::Mode PlaybackClock::mode() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_mode;
+}
+
+
+//*************************************************************************************************************
+
+void PlaybackClock::setMaxCatchUp(qint32 p_iTicks)
+{
+    QMutexLocker locker(&m_mutex);
+    m_iMaxCatchUp = p_iTicks > 0 ? p_iTicks : 1;
+}
+
+
+//*************************************************************************************************************
+
+void PlaybackClock::start()
+{
+    QMutexLocker locker(&m_mutex);
+
+    m_iAnchor = Tracer::now();
+    m_iTick = 0;
+    m_bStarted = true;
+
+    m_statistics.iTicks = 0;
+    m_statistics.iOverruns = 0;
+    m_statistics.iResyncs = 0;
+    m_statistics.iMaxLate = 0;
+    m_statistics.iTotalLate = 0;
+}
+
+
+//*************************************************************************************************************
+
+qint64 PlaybackClock::wait()
+{
+    qint64 t_iDeadline;
+    qint64 t_iNow;
+
+    {
+        QMutexLocker locker(&m_mutex);
+
+        if(!m_bStarted)
+        {
+            m_iAnchor = Tracer::now();
+            m_iTick = 0;
+            m_bStarted = true;
+        }
+
+        ++m_statistics.iTicks;
+
+        if(m_mode == Unpaced)
+            return Tracer::now();
+
+        t_iDeadline = nextDeadline();
+        ++m_iTick;
+
+        t_iNow = Tracer::now();
+
+        if(t_iNow >= t_iDeadline)
+        {
+            qint64 t_iLate = t_iNow - t_iDeadline;
+
+            if(t_iLate > 0)
+            {
+                ++m_statistics.iOverruns;
+                m_statistics.iTotalLate += t_iLate;
+                if(t_iLate > m_statistics.iMaxLate)
+                    m_statistics.iMaxLate = t_iLate;
+            }
+
+            // Too far behind to catch up - continue the schedule from now
+            if(t_iLate > m_iMaxCatchUp * m_dPeriod / m_dSpeed)
+            {
+                ++m_statistics.iResyncs;
+                m_iAnchor = t_iNow;
+                m_iTick = 1;
+            }
+
+            return t_iDeadline;
+        }
+    }
+
+    // Sleep in steps, the sleep may end early or late; the deadline itself does not move
+    while(t_iNow < t_iDeadline)
+    {
+        qint64 t_iRemaining = (t_iDeadline - t_iNow) / 1000;
+        if(t_iRemaining > 0)
+            QThread::usleep((unsigned long)t_iRemaining);
+        else
+            QThread::yieldCurrentThread();
+
+        t_iNow = Tracer::now();
+    }
+
+    return t_iDeadline;
+}
+
+
+//*************************************************************************************************************
+
+PlaybackClock::Statistics PlaybackClock::statistics() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_statistics;
+}
+
+
+//*************************************************************************************************************
+
+qint64 PlaybackClock::nextDeadline() const
+{
+    return m_iAnchor + (qint64)(m_iTick * m_dPeriod / m_dSpeed);
+}
@@ -0,0 +1,199 @@
+//=============================================================================================================
+/**
+* @file     playbackclock.h
+* @author   Christoph Dinh <chdinh@nmr.mgh.harvard.edu>;
+*           Matti Hamalainen <msh@nmr.mgh.harvard.edu>
+* @version  1.0
+* @date     October, 2026
+*
+* @section  LICENSE
+*
+* Copyright (C) 2026, Christoph Dinh and Matti Hamalainen. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+* the following conditions are met:
+*     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+*       following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+*       the following disclaimer in the documentation and/or other materials provided with the distribution.
+*     * Neither the name of the Massachusetts General Hospital nor the names of its contributors may be used
+*       to endorse or promote products derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+* PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL MASSACHUSETTS GENERAL HOSPITAL BE LIABLE FOR ANY DIRECT,
+* INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+* NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+* @brief     PlaybackClock class declaration
+*
+*/
+
+#ifndef PLAYBACKCLOCK_H
+#define PLAYBACKCLOCK_H
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include "generics_global.h"
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// QT INCLUDES
+//=============================================================================================================
+
+#include <QMutex>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINE NAMESPACE IOBuffer
+//=============================================================================================================
+
+namespace IOBuffer
+{
+
+
+//=============================================================================================================
+/**
+* Paces a producer to the sampling rate of the data it plays back. Tick k is due at t0 + k * period / speed on the
+* monotonic Tracer clock, so sleep jitter and the time spent between two ticks do not accumulate into drift. A
+* producer which falls behind is not slowed down any further: late ticks return immediately until the schedule is
+* met again. If it lags by more than the catch-up limit the schedule is re-anchored instead of bursting out the
+* whole backlog. In the Unpaced mode wait() never sleeps, which replays the data as fast as it can be consumed.
+*
+* The clock is meant to be waited on by a single thread; setSpeed() and statistics() may be called from others.
+*
+* @brief Drift free, deadline based pacing of simulated acquisition
+*/
+class GENERICSSHARED_EXPORT PlaybackClock
+{
+public:
+    /**
+    * Pacing modes.
+    */
+    enum Mode
+    {
+        Paced,      /**< Ticks are due at the sampling rate times the speed. */
+        Unpaced     /**< As fast as possible, wait() never sleeps. */
+    };
+
+    /**
+    * Pacing statistics since the last start(), all times in nanoseconds.
+    */
+    struct Statistics
+    {
+        qint64 iTicks;          /**< Number of ticks waited for. */
+        qint64 iOverruns;       /**< Number of ticks which were already due when waited for. */
+        qint64 iResyncs;        /**< Number of times the schedule was re-anchored since the lag exceeded the catch-up limit. */
+        qint64 iMaxLate;        /**< Largest lag behind a deadline. */
+        qint64 iTotalLate;      /**< Sum of the lags of all overruns. */
+    };
+
+    //=========================================================================================================
+    /**
+    * Constructs a paced clock with a period of one second at normal speed.
+    */
+    PlaybackClock();
+
+    //=========================================================================================================
+    /**
+    * Sets the tick period from the sampling rate of the played back data.
+    *
+    * @param [in] p_dSamplingRate   Sampling rate in Hz.
+    * @param [in] p_iSamplesPerTick Number of samples released per tick, e.g. the buffer size.
+    */
+    void setPeriod(double p_dSamplingRate, qint32 p_iSamplesPerTick = 1);
+
+    //=========================================================================================================
+    /**
+    * Sets the playback speed. While running, the next deadline is kept and the schedule continues from there at
+    * the new speed.
+    *
+    * @param [in] p_dSpeed  Speed multiplier, 1.0 is real time. A speed <= 0 switches to the Unpaced mode.
+    */
+    void setSpeed(double p_dSpeed);
+
+    //=========================================================================================================
+    /**
+    * Returns the playback speed.
+    *
+    * @return the speed multiplier, 0 in the Unpaced mode.
+    */
+    double speed() const;
+
+    //=========================================================================================================
+    /**
+    * Sets the pacing mode.
+    *
+    * @param [in] p_mode    The pacing mode.
+    */
+    void setMode(Mode p_mode);
+
+    //=========================================================================================================
+    /**
+    * Returns the pacing mode.
+    *
+    * @return the pacing mode.
+    */
+    Mode mode() const;
+
+    //=========================================================================================================
+    /**
+    * Sets how many periods a producer may lag behind before the schedule is re-anchored.
+    *
+    * @param [in] p_iTicks  Catch-up limit in ticks, default 16.
+    */
+    void setMaxCatchUp(qint32 p_iTicks);
+
+    //=========================================================================================================
+    /**
+    * Anchors the schedule at the current time and resets the statistics. The first tick is due immediately.
+    */
+    void start();
+
+    //=========================================================================================================
+    /**
+    * Waits until the next tick is due.
+    *
+    * @return the deadline of the tick on the Tracer clock in nanoseconds, usable as time stamp of the released data.
+    */
+    qint64 wait();
+
+    //=========================================================================================================
+    /**
+    * Returns the pacing statistics since the last start().
+    *
+    * @return the statistics.
+    */
+    Statistics statistics() const;
+
+private:
+    //=========================================================================================================
+    /**
+    * Returns the deadline of the next tick. Has to be called with the mutex locked.
+    *
+    * @return the deadline in nanoseconds.
+    */
+    qint64 nextDeadline() const;
+
+    mutable QMutex  m_mutex;            /**< Guards all members against the setters of other threads. */
+    double          m_dPeriod;          /**< Tick period at normal speed in nanoseconds. */
+    double          m_dSpeed;           /**< Speed multiplier. */
+    Mode            m_mode;             /**< Pacing mode. */
+    qint32          m_iMaxCatchUp;      /**< Catch-up limit in ticks. */
+    bool            m_bStarted;         /**< Whether the schedule is anchored. */
+    qint64          m_iAnchor;          /**< Time of tick 0 of the current schedule. */
+    qint64          m_iTick;            /**< Index of the next tick within the current schedule. */
+    Statistics      m_statistics;       /**< Pacing statistics. */
+};
+
+} // NAMESPACE
+
+#endif // PLAYBACKCLOCK_H
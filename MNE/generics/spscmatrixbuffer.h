@@ -0,0 +1,539 @@
+//=============================================================================================================
+/**
+* @file     spscmatrixbuffer.h
+* @author   Christoph Dinh <chdinh@nmr.mgh.harvard.edu>;
+*           Matti Hamalainen <msh@nmr.mgh.harvard.edu>
+* @version  1.0
+* @date     October, 2026
+*
+* @section  LICENSE
+*
+* Copyright (C) 2012, Christoph Dinh and Matti Hamalainen. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+* the following conditions are met:
+*     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+*       following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+*       the following disclaimer in the documentation and/or other materials provided with the distribution.
+*     * Neither the name of the Massachusetts General Hospital nor the names of its contributors may be used
+*       to endorse or promote products derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+* PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL MASSACHUSETTS GENERAL HOSPITAL BE LIABLE FOR ANY DIRECT,
+* INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+* NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+* @brief     SpscMatrixBuffer class declaration
+*
+*/
+
+#ifndef SPSCMATRIXBUFFER_H
+#define SPSCMATRIXBUFFER_H
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include "generics_global.h"
+#include "buffer.h"
+
+#include <typeinfo>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// Eigen INCLUDES
+//=============================================================================================================
+
+#include <Eigen/Core>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// QT INCLUDES
+//=============================================================================================================
+
+#include <QAtomicInt>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QSharedPointer>
+#include <QWaitCondition>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINE NAMESPACE IOBuffer
+//=============================================================================================================
+
+namespace IOBuffer
+{
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// USED NAMESPACES
+//=============================================================================================================
+
+using namespace Eigen;
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINES
+//=============================================================================================================
+
+#define SPSC_CACHE_LINE 64  /**< Padding between the producer and the consumer index, avoids false sharing. */
+
+
+//=============================================================================================================
+/**
+* Lock-free single-producer/single-consumer variant of CircularMatrixBuffer. The ring holds a fixed number of
+* matrix slots of equal size; producer and consumer each own one index, kept on separate cache lines, and
+* exchange them with acquire/release atomics only.
+*
+* Besides the copying push/pop, the buffer offers a zero-copy API: peekWrite() returns a Map view of the next
+* free slot, which is published by commitWrite(); peekRead() returns a view of the oldest slot, which is
+* handed back by commitRead(). Views stay valid until the corresponding commit.
+*
+* Waiting calls spin for a short while before they park the thread on a wait condition; a committing side
+* only touches the mutex if the other side is parked.
+*
+* Exactly one thread may push/peekWrite and exactly one thread may pop/peekRead.
+*
+* @brief Lock-free single-producer/single-consumer matrix buffer
+*/
+template<typename _Tp>
+class SpscMatrixBuffer : public Buffer
+{
+public:
+    typedef QSharedPointer<SpscMatrixBuffer> SPtr;              /**< Shared pointer type for SpscMatrixBuffer. */
+    typedef QSharedPointer<const SpscMatrixBuffer> ConstSPtr;   /**< Const shared pointer type for SpscMatrixBuffer. */
+
+    typedef Matrix<_Tp, Dynamic, Dynamic> MatrixType;           /**< The stored matrix type. */
+    typedef Map<MatrixType> MatrixMap;                          /**< View of a writable slot. */
+    typedef Map<const MatrixType> ConstMatrixMap;               /**< View of a readable slot. */
+
+    //=========================================================================================================
+    /**
+    * Constructs a SpscMatrixBuffer.
+    *
+    * @param [in] uiMaxNumMatrices  Number of slots, rounded up to the next power of two.
+    * @param [in] uiRows            Number of rows.
+    * @param [in] uiCols            Number of columns.
+    * @param [in] iSpinCount        Number of polls of a waiting call before the thread is parked.
+    */
+    explicit SpscMatrixBuffer(unsigned int uiMaxNumMatrices, unsigned int uiRows, unsigned int uiCols, int iSpinCount = 1000);
+
+    //=========================================================================================================
+    /**
+    * Destroys the SpscMatrixBuffer.
+    */
+    ~SpscMatrixBuffer();
+
+    //=========================================================================================================
+    /**
+    * Returns a view of the next free slot. The slot is published by commitWrite().
+    *
+    * @param [in] bWait     Whether to wait for a free slot.
+    *
+    * @return the view, with a NULL data pointer if the buffer is full (and bWait is false) or was released.
+    */
+    inline MatrixMap peekWrite(bool bWait = true);
+
+    //=========================================================================================================
+    /**
+    * Publishes the slot returned by the last peekWrite().
+    */
+    inline void commitWrite();
+
+    //=========================================================================================================
+    /**
+    * Returns a view of the oldest written slot. The slot is handed back to the producer by commitRead().
+    *
+    * @param [in] bWait     Whether to wait for a written slot.
+    *
+    * @return the view, with a NULL data pointer if the buffer is empty (and bWait is false) or was released.
+    */
+    inline ConstMatrixMap peekRead(bool bWait = true);
+
+    //=========================================================================================================
+    /**
+    * Frees the slot returned by the last peekRead().
+    */
+    inline void commitRead();
+
+    //=========================================================================================================
+    /**
+    * Copies a matrix into the buffer.
+    *
+    * @param [in] pMatrix   the matrix to append, of size rows() x cols().
+    * @param [in] bWait     Whether to wait for a free slot.
+    *
+    * @return true if the matrix was appended.
+    */
+    inline bool push(const MatrixType* pMatrix, bool bWait = true);
+
+    //=========================================================================================================
+    /**
+    * Copies the oldest matrix out of the buffer. No memory is allocated if matrix has the right size already.
+    *
+    * @param [out] matrix   the popped matrix.
+    * @param [in] bWait     Whether to wait for a written slot.
+    *
+    * @return true if a matrix was popped.
+    */
+    inline bool pop(MatrixType& matrix, bool bWait = true);
+
+    //=========================================================================================================
+    /**
+    * Clears the buffer. Must not be called while a producer or consumer is active.
+    */
+    void clear();
+
+    //=========================================================================================================
+    /**
+    * Releases all waiting calls and lets further waiting calls return immediately until clear() is called.
+    */
+    void release();
+
+    //=========================================================================================================
+    /**
+    * Number of written slots which were not read yet.
+    */
+    inline quint32 count() const;
+
+    //=========================================================================================================
+    /**
+    * Size of the buffer.
+    */
+    inline quint32 size() const;
+
+    //=========================================================================================================
+    /**
+    * Rows of the stored matrices of the buffer.
+    */
+    inline quint32 rows() const;
+
+    //=========================================================================================================
+    /**
+    * Cols of the stored matrices of the buffer.
+    */
+    inline quint32 cols() const;
+
+private:
+    //=========================================================================================================
+    /**
+    * Waits until a slot is free (bWrite) or written. Spins first, then parks the thread.
+    *
+    * @param [in] bWrite    Whether the producer or the consumer waits.
+    *
+    * @return true if the slot is available, false if the buffer was released.
+    */
+    bool wait(bool bWrite);
+
+    //=========================================================================================================
+    /**
+    * Wakes the other side if it is parked.
+    */
+    inline void wake();
+
+    inline bool writable();
+    inline bool readable();
+
+    inline static void cpuRelax();
+
+    quint32         m_uiMaxNumMatrices;         /**< Holds the number of slots, a power of two.*/
+    quint32         m_uiMask;                   /**< m_uiMaxNumMatrices - 1.*/
+    quint32         m_uiRows;                   /**< Holds the number rows.*/
+    quint32         m_uiCols;                   /**< Holds the number cols.*/
+    quint32         m_uiSlotSize;               /**< Holds the number of elements per slot.*/
+    _Tp*            m_pBuffer;                  /**< Holds the slots.*/
+    int             m_iSpinCount;               /**< Holds the number of polls before parking.*/
+
+    char            m_cPadWrite[SPSC_CACHE_LINE];
+    QAtomicInt      m_iWriteCount;              /**< Number of committed writes, written by the producer only.*/
+    quint32         m_uiCachedReadCount;        /**< Producer's copy of m_iReadCount, refreshed when the ring looks full.*/
+
+    char            m_cPadRead[SPSC_CACHE_LINE];
+    QAtomicInt      m_iReadCount;               /**< Number of committed reads, written by the consumer only.*/
+    quint32         m_uiCachedWriteCount;       /**< Consumer's copy of m_iWriteCount, refreshed when the ring looks empty.*/
+
+    char            m_cPadShared[SPSC_CACHE_LINE];
+    QAtomicInt      m_iParked;                  /**< Number of parked threads.*/
+    QAtomicInt      m_iReleased;                /**< Set by release().*/
+    QMutex          m_mutex;                    /**< Guards parking.*/
+    QWaitCondition  m_waitCondition;            /**< Parked threads wait here.*/
+};
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINE MEMBER METHODS
+//=============================================================================================================
+
+template<typename _Tp>
+SpscMatrixBuffer<_Tp>::SpscMatrixBuffer(unsigned int uiMaxNumMatrices, unsigned int uiRows, unsigned int uiCols, int iSpinCount)
+: Buffer(typeid(_Tp).name())
+, m_uiMaxNumMatrices(1)
+, m_uiRows(uiRows)
+, m_uiCols(uiCols)
+, m_uiSlotSize(uiRows*uiCols)
+, m_iSpinCount(iSpinCount)
+, m_iWriteCount(0)
+, m_uiCachedReadCount(0)
+, m_iReadCount(0)
+, m_uiCachedWriteCount(0)
+, m_iParked(0)
+, m_iReleased(0)
+{
+    while(m_uiMaxNumMatrices < uiMaxNumMatrices)
+        m_uiMaxNumMatrices <<= 1;
+    m_uiMask = m_uiMaxNumMatrices - 1;
+    m_pBuffer = new _Tp[m_uiMaxNumMatrices*m_uiSlotSize];
+}
+
+
+//*************************************************************************************************************
+
+template<typename _Tp>
+SpscMatrixBuffer<_Tp>::~SpscMatrixBuffer()
+{
+    delete [] m_pBuffer;
+}
+
+
+//*************************************************************************************************************
+
+template<typename _Tp>
+inline typename SpscMatrixBuffer<_Tp>::MatrixMap SpscMatrixBuffer<_Tp>::peekWrite(bool bWait)
+{
+    if(!writable() && (!bWait || !wait(true)))
+        return MatrixMap(NULL, 0, 0);
+
+    quint32 uiSlot = (quint32)m_iWriteCount.load() & m_uiMask;
+    return MatrixMap(m_pBuffer + uiSlot*m_uiSlotSize, m_uiRows, m_uiCols);
+}
+
+
+//*************************************************************************************************************
+
+template<typename _Tp>
+inline void SpscMatrixBuffer<_Tp>::commitWrite()
+{
+    //Full barrier: publishes the slot and orders the store before reading m_iParked in wake()
+    m_iWriteCount.fetchAndAddOrdered(1);
+    wake();
+}
+
+
+//*************************************************************************************************************
+
+template<typename _Tp>
+inline typename SpscMatrixBuffer<_Tp>::ConstMatrixMap SpscMatrixBuffer<_Tp>::peekRead(bool bWait)
+{
+    if(!readable() && (!bWait || !wait(false)))
+        return ConstMatrixMap(NULL, 0, 0);
+
+    quint32 uiSlot = (quint32)m_iReadCount.load() & m_uiMask;
+    return ConstMatrixMap(m_pBuffer + uiSlot*m_uiSlotSize, m_uiRows, m_uiCols);
+}
+
+
+//*************************************************************************************************************
+
+template<typename _Tp>
+inline void SpscMatrixBuffer<_Tp>::commitRead()
+{
+    m_iReadCount.fetchAndAddOrdered(1);
+    wake();
+}
+
+
+//*************************************************************************************************************
+
+template<typename _Tp>
+inline bool SpscMatrixBuffer<_Tp>::push(const MatrixType* pMatrix, bool bWait)
+{
+    if((quint32)pMatrix->size() != m_uiSlotSize)
+        return false;
+
+    MatrixMap slot = peekWrite(bWait);
+    if(!slot.data())
+        return false;
+
+    slot = *pMatrix;
+    commitWrite();
+    return true;
+}
+
+
+//*************************************************************************************************************
+
+template<typename _Tp>
+inline bool SpscMatrixBuffer<_Tp>::pop(MatrixType& matrix, bool bWait)
+{
+    ConstMatrixMap slot = peekRead(bWait);
+    if(!slot.data())
+        return false;
+
+    matrix = slot;
+    commitRead();
+    return true;
+}
+
+
+//*************************************************************************************************************
+
+template<typename _Tp>
+void SpscMatrixBuffer<_Tp>::clear()
+{
+    m_iWriteCount.store(0);
+    m_iReadCount.store(0);
+    m_uiCachedReadCount = 0;
+    m_uiCachedWriteCount = 0;
+    m_iReleased.store(0);
+}
+
+
+//*************************************************************************************************************
+
+template<typename _Tp>
+void SpscMatrixBuffer<_Tp>::release()
+{
+    m_iReleased.store(1);
+
+    QMutexLocker locker(&m_mutex);
+    m_waitCondition.wakeAll();
+}
+
+
+//*************************************************************************************************************
+
+template<typename _Tp>
+inline quint32 SpscMatrixBuffer<_Tp>::count() const
+{
+    return (quint32)m_iWriteCount.load() - (quint32)m_iReadCount.load();
+}
+
+
+//*************************************************************************************************************
+
+template<typename _Tp>
+inline quint32 SpscMatrixBuffer<_Tp>::size() const
+{
+    return m_uiMaxNumMatrices;
+}
+
+
+//*************************************************************************************************************
+
+template<typename _Tp>
+inline quint32 SpscMatrixBuffer<_Tp>::rows() const
+{
+    return m_uiRows;
+}
+
+
+//*************************************************************************************************************
+
+template<typename _Tp>
+inline quint32 SpscMatrixBuffer<_Tp>::cols() const
+{
+    return m_uiCols;
+}
+
+
+//*************************************************************************************************************
+
+template<typename _Tp>
+bool SpscMatrixBuffer<_Tp>::wait(bool bWrite)
+{
+    for(int i = 0; i < m_iSpinCount; ++i)
+    {
+        if(m_iReleased.load())
+            return false;
+        if(bWrite ? writable() : readable())
+            return true;
+        cpuRelax();
+    }
+
+    QMutexLocker locker(&m_mutex);
+    m_iParked.fetchAndAddOrdered(1);
+    //Checked again after announcing the park, so that a commit in between can not be missed
+    while(!m_iReleased.load() && !(bWrite ? writable() : readable()))
+        m_waitCondition.wait(&m_mutex);
+    m_iParked.fetchAndAddOrdered(-1);
+
+    return !m_iReleased.load();
+}
+
+
+//*************************************************************************************************************
+
+template<typename _Tp>
+inline void SpscMatrixBuffer<_Tp>::wake()
+{
+    if(m_iParked.load())
+    {
+        QMutexLocker locker(&m_mutex);
+        m_waitCondition.wakeAll();
+    }
+}
+
+
+//*************************************************************************************************************
+
+template<typename _Tp>
+inline bool SpscMatrixBuffer<_Tp>::writable()
+{
+    quint32 uiWrite = (quint32)m_iWriteCount.load();
+    if(uiWrite - m_uiCachedReadCount < m_uiMaxNumMatrices)
+        return true;
+    m_uiCachedReadCount = (quint32)m_iReadCount.loadAcquire();
+    return uiWrite - m_uiCachedReadCount < m_uiMaxNumMatrices;
+}
+
+
+//*************************************************************************************************************
+
+template<typename _Tp>
+inline bool SpscMatrixBuffer<_Tp>::readable()
+{
+    quint32 uiRead = (quint32)m_iReadCount.load();
+    if(m_uiCachedWriteCount != uiRead)
+        return true;
+    m_uiCachedWriteCount = (quint32)m_iWriteCount.loadAcquire();
+    return m_uiCachedWriteCount != uiRead;
+}
+
+
+//*************************************************************************************************************
+
+template<typename _Tp>
+inline void SpscMatrixBuffer<_Tp>::cpuRelax()
+{
+#if defined(__GNUC__) && (defined(__i386__) || defined(__x86_64__))
+    __builtin_ia32_pause();
+#endif
+}
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// TYPEDEF
+//=============================================================================================================
+
+typedef GENERICSSHARED_EXPORT SpscMatrixBuffer<int>     _int_SpscMatrixBuffer;      /**< Defines SpscMatrixBuffer of integer type.*/
+typedef GENERICSSHARED_EXPORT SpscMatrixBuffer<float>   _float_SpscMatrixBuffer;    /**< Defines SpscMatrixBuffer of float type.*/
+typedef GENERICSSHARED_EXPORT SpscMatrixBuffer<double>  _double_SpscMatrixBuffer;   /**< Defines SpscMatrixBuffer of double type.*/
+
+} // NAMESPACE
+
+#endif // SPSCMATRIXBUFFER_H
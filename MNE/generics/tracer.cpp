@@ -0,0 +1,287 @@
+//=============================================================================================================
+/**
+* @file     tracer.cpp
+* @author   Christoph Dinh <chdinh@nmr.mgh.harvard.edu>;
+*           Matti Hamalainen <msh@nmr.mgh.harvard.edu>
+* @version  1.0
+* @date     October, 2026
+*
+* @section  LICENSE
+*
+* Copyright (C) 2026, Christoph Dinh and Matti Hamalainen. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+* the following conditions are met:
+*     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+*       following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+*       the following disclaimer in the documentation and/or other materials provided with the distribution.
+*     * Neither the name of the Massachusetts General Hospital nor the names of its contributors may be used
+*       to endorse or promote products derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+* PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL MASSACHUSETTS GENERAL HOSPITAL BE LIABLE FOR ANY DIRECT,
+* INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+* NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+* @brief    Contains implementations of the Tracer Class
+*
+*/
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include "tracer.h"
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// QT INCLUDES
+//=============================================================================================================
+
+#include <QAtomicInt>
+#include <QByteArray>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QHash>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QTextStream>
+#include <QThread>
+#include <QVector>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// USED NAMESPACES
+//=============================================================================================================
+
+using namespace IOBuffer;
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// STATIC HELPERS
+//=============================================================================================================
+
+namespace
+{
+    const int s_iNumEvents = 1 << 16;   // Size of the event ring
+    const int s_iNumBuckets = 32;       // Number of log2 histogram buckets
+
+    struct TraceEvent
+    {
+        const char* sStage;
+        qint64 iBegin;
+        qint64 iEnd;
+        qint64 iTimestamp;
+        quintptr iThread;
+    };
+
+    struct Histogram
+    {
+        Histogram() : iCount(0), iSum(0), iMax(0) { for(int i = 0; i < s_iNumBuckets; ++i) iBuckets[i] = 0; }
+
+        void add(qint64 p_iValue)
+        {
+            qint64 t_iMicro = p_iValue / 1000;
+            int t_iBucket = 0;
+            while(t_iMicro > 0 && t_iBucket < s_iNumBuckets - 1)
+            {
+                t_iMicro >>= 1;
+                ++t_iBucket;
+            }
+            ++iBuckets[t_iBucket];
+            ++iCount;
+            iSum += p_iValue;
+            if(p_iValue > iMax)
+                iMax = p_iValue;
+        }
+
+        quint64 iCount;
+        qint64 iSum;
+        qint64 iMax;
+        quint64 iBuckets[s_iNumBuckets];
+    };
+
+    struct StageHistograms
+    {
+        Histogram duration;
+        Histogram age;
+    };
+
+    // Started while the library is loaded, before any thread can read it
+    struct TracerData
+    {
+        TracerData() : iHead(0), iCount(0) { timer.start(); }
+
+        QElapsedTimer timer;
+        QAtomicInt enabled;
+
+        QMutex mutex;                                   // Guards everything below
+        QVector<TraceEvent> qVecEvents;                 // Event ring, allocated when tracing is enabled
+        int iHead;                                      // Index of the oldest event
+        int iCount;                                     // Number of events
+        QHash<QByteArray, StageHistograms> qHashStages; // Histograms by stage name
+    };
+
+    TracerData s_tracer;
+
+    void writeHistogram(QTextStream &p_stream, const QByteArray &p_sStage, const char* p_sKind, const Histogram &p_histogram)
+    {
+        if(p_histogram.iCount == 0)
+            return;
+
+        p_stream << p_sStage.constData() << "," << p_sKind << "," << p_histogram.iCount << ","
+                 << (double)p_histogram.iSum / p_histogram.iCount / 1000.0 << "," << p_histogram.iMax / 1000.0;
+        for(int i = 0; i < s_iNumBuckets; ++i)
+            p_stream << "," << p_histogram.iBuckets[i];
+        p_stream << "\n";
+    }
+}
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINE MEMBER METHODS
+//=============================================================================================================
+
+qint64 Tracer::now()
+{
+    return s_tracer.timer.nsecsElapsed();
+}
+
+
+//*************************************************************************************************************
+
+void Tracer::setEnabled(bool p_bEnabled)
+{
+    QMutexLocker locker(&s_tracer.mutex);
+    if(p_bEnabled && s_tracer.qVecEvents.isEmpty())
+        s_tracer.qVecEvents.resize(s_iNumEvents);
+    s_tracer.enabled.store(p_bEnabled ? 1 : 0);
+}
+
+
+//*************************************************************************************************************
+
+bool Tracer::isEnabled()
+{
+    return s_tracer.enabled.load() != 0;
+}
+
+
+//*************************************************************************************************************
+
+void Tracer::record(const char* p_sStage, qint64 p_iBegin, qint64 p_iEnd, qint64 p_iTimestamp)
+{
+    quintptr t_iThread = (quintptr)QThread::currentThreadId();
+
+    QMutexLocker locker(&s_tracer.mutex);
+    if(s_tracer.qVecEvents.isEmpty())
+        return;
+
+    TraceEvent &t_event = s_tracer.qVecEvents[(s_tracer.iHead + s_tracer.iCount) % s_iNumEvents];
+    t_event.sStage = p_sStage;
+    t_event.iBegin = p_iBegin;
+    t_event.iEnd = p_iEnd;
+    t_event.iTimestamp = p_iTimestamp;
+    t_event.iThread = t_iThread;
+    if(s_tracer.iCount < s_iNumEvents)
+        ++s_tracer.iCount;
+    else
+        s_tracer.iHead = (s_tracer.iHead + 1) % s_iNumEvents;
+
+    // fromRawData does not copy, the key is only deep copied when a new stage is inserted
+    QHash<QByteArray, StageHistograms>::iterator it = s_tracer.qHashStages.find(QByteArray::fromRawData(p_sStage, (int)qstrlen(p_sStage)));
+    if(it == s_tracer.qHashStages.end())
+        it = s_tracer.qHashStages.insert(QByteArray(p_sStage), StageHistograms());
+
+    it->duration.add(p_iEnd - p_iBegin);
+    if(p_iTimestamp >= 0)
+        it->age.add(p_iEnd - p_iTimestamp);
+}
+
+
+//*************************************************************************************************************
+
+void Tracer::clear()
+{
+    QMutexLocker locker(&s_tracer.mutex);
+    s_tracer.iHead = 0;
+    s_tracer.iCount = 0;
+    s_tracer.qHashStages.clear();
+}
+
+
+//*************************************************************************************************************
+
+bool Tracer::writeChromeTrace(const QString &p_sFileName)
+{
+    QFile t_file(p_sFileName);
+    if(!t_file.open(QIODevice::WriteOnly | QIODevice::Text))
+        return false;
+
+    QTextStream t_stream(&t_file);
+    t_stream.setRealNumberNotation(QTextStream::FixedNotation);
+    t_stream.setRealNumberPrecision(3);
+
+    QMutexLocker locker(&s_tracer.mutex);
+
+    QHash<quintptr, int> t_qHashThreads;
+
+    t_stream << "{\"traceEvents\":[";
+    for(int i = 0; i < s_tracer.iCount; ++i)
+    {
+        const TraceEvent &t_event = s_tracer.qVecEvents[(s_tracer.iHead + i) % s_iNumEvents];
+
+        if(!t_qHashThreads.contains(t_event.iThread))
+            t_qHashThreads.insert(t_event.iThread, t_qHashThreads.size() + 1);
+
+        t_stream << (i > 0 ? ",\n" : "\n")
+                 << "{\"name\":\"" << t_event.sStage << "\",\"cat\":\"mne\",\"ph\":\"X\",\"pid\":1"
+                 << ",\"tid\":" << t_qHashThreads[t_event.iThread]
+                 << ",\"ts\":" << t_event.iBegin / 1000.0
+                 << ",\"dur\":" << (t_event.iEnd - t_event.iBegin) / 1000.0;
+        if(t_event.iTimestamp >= 0)
+            t_stream << ",\"args\":{\"age_us\":" << (t_event.iEnd - t_event.iTimestamp) / 1000.0 << "}";
+        t_stream << "}";
+    }
+    t_stream << "\n],\"displayTimeUnit\":\"ms\"}\n";
+
+    return t_stream.status() == QTextStream::Ok;
+}
+
+
+//*************************************************************************************************************
+
+bool Tracer::writeHistograms(const QString &p_sFileName)
+{
+    QFile t_file(p_sFileName);
+    if(!t_file.open(QIODevice::WriteOnly | QIODevice::Text))
+        return false;
+
+    QTextStream t_stream(&t_file);
+
+    t_stream << "stage,kind,count,mean_us,max_us";
+    for(int i = 0; i < s_iNumBuckets; ++i)
+        t_stream << ",b" << i;
+    t_stream << "\n";
+
+    QMutexLocker locker(&s_tracer.mutex);
+
+    QHash<QByteArray, StageHistograms>::const_iterator it;
+    for(it = s_tracer.qHashStages.constBegin(); it != s_tracer.qHashStages.constEnd(); ++it)
+    {
+        writeHistogram(t_stream, it.key(), "duration", it->duration);
+        writeHistogram(t_stream, it.key(), "age", it->age);
+    }
+
+    return t_stream.status() == QTextStream::Ok;
+}
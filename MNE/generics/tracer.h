@@ -0,0 +1,198 @@
+//=============================================================================================================
+/**
+* @file     tracer.h
+* @author   Christoph Dinh <chdinh@nmr.mgh.harvard.edu>;
+*           Matti Hamalainen <msh@nmr.mgh.harvard.edu>
+* @version  1.0
+* @date     October, 2026
+*
+* @section  LICENSE
+*
+* Copyright (C) 2026, Christoph Dinh and Matti Hamalainen. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+* the following conditions are met:
+*     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+*       following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+*       the following disclaimer in the documentation and/or other materials provided with the distribution.
+*     * Neither the name of the Massachusetts General Hospital nor the names of its contributors may be used
+*       to endorse or promote products derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+* PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL MASSACHUSETTS GENERAL HOSPITAL BE LIABLE FOR ANY DIRECT,
+* INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+* NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+* @brief     Tracer class declaration
+*
+*/
+
+#ifndef TRACER_H
+#define TRACER_H
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include "generics_global.h"
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// QT INCLUDES
+//=============================================================================================================
+
+#include <QString>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINE NAMESPACE IOBuffer
+//=============================================================================================================
+
+namespace IOBuffer
+{
+
+
+//=============================================================================================================
+/**
+* Process wide tracing of the real-time pipeline. Producers stamp their data blocks with now(), the stages record
+* when they entered and left the processing of a block, usually by a Tracer::Scope. From that the Tracer keeps
+* per stage histograms of the processing time and of the block age at the end of the stage, i.e. the latency
+* since acquisition, and a ring of the last 65536 events for a Chrome trace (chrome://tracing, Perfetto).
+*
+* Tracing is off by default; a disabled Scope costs one atomic load. Enabled, a record takes well below a
+* microsecond, which is negligible at block rates.
+*
+* @brief Pipeline latency and throughput tracing
+*/
+class GENERICSSHARED_EXPORT Tracer
+{
+public:
+    //=========================================================================================================
+    /**
+    * Records the enclosing block as one event of a stage.
+    */
+    class Scope
+    {
+    public:
+        //=====================================================================================================
+        /**
+        * Enters the stage.
+        *
+        * @param [in] p_sStage      Name of the stage, has to be a string literal or otherwise outlive the Tracer.
+        * @param [in] p_iTimestamp  Acquisition time stamp of the processed block, -1 if unknown.
+        */
+        inline Scope(const char* p_sStage, qint64 p_iTimestamp = -1);
+
+        //=====================================================================================================
+        /**
+        * Leaves the stage and records the event.
+        */
+        inline ~Scope();
+
+    private:
+        const char* m_sStage;       /**< The stage name.*/
+        qint64      m_iTimestamp;   /**< Time stamp of the processed block.*/
+        qint64      m_iBegin;       /**< Enter time, -1 if tracing was disabled.*/
+    };
+
+    //=========================================================================================================
+    /**
+    * Returns the time of the process wide monotonic clock all time stamps refer to.
+    *
+    * @return the time in nanoseconds.
+    */
+    static qint64 now();
+
+    //=========================================================================================================
+    /**
+    * Enables or disables tracing.
+    *
+    * @param [in] p_bEnabled    Whether to trace.
+    */
+    static void setEnabled(bool p_bEnabled);
+
+    //=========================================================================================================
+    /**
+    * Returns whether tracing is enabled.
+    *
+    * @return true if tracing is enabled.
+    */
+    static bool isEnabled();
+
+    //=========================================================================================================
+    /**
+    * Records one event of a stage.
+    *
+    * @param [in] p_sStage      Name of the stage, has to be a string literal or otherwise outlive the Tracer.
+    * @param [in] p_iBegin      Enter time, see now().
+    * @param [in] p_iEnd        Exit time, see now().
+    * @param [in] p_iTimestamp  Acquisition time stamp of the processed block, -1 if unknown.
+    */
+    static void record(const char* p_sStage, qint64 p_iBegin, qint64 p_iEnd, qint64 p_iTimestamp = -1);
+
+    //=========================================================================================================
+    /**
+    * Discards all recorded events and histograms.
+    */
+    static void clear();
+
+    //=========================================================================================================
+    /**
+    * Writes the recorded events in the Chrome trace event format: one complete ("X") event per record, times in
+    * microseconds; the block age at the end of the stage is given in args.age_us.
+    *
+    * @param [in] p_sFileName   The JSON file to write.
+    *
+    * @return true if the file was written.
+    */
+    static bool writeChromeTrace(const QString &p_sFileName);
+
+    //=========================================================================================================
+    /**
+    * Writes the per stage histograms as CSV with the columns stage, kind, count, mean_us, max_us, b0 ... b31.
+    * kind is "duration" for the processing time or "age" for the block age at the end of the stage. Bucket b0
+    * counts values below 1 us, bucket bi values in [2^(i-1), 2^i) us; b31 also holds everything larger.
+    *
+    * @param [in] p_sFileName   The CSV file to write.
+    *
+    * @return true if the file was written.
+    */
+    static bool writeHistograms(const QString &p_sFileName);
+
+private:
+    Tracer();
+};
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INLINE DEFINITIONS
+//=============================================================================================================
+
+inline Tracer::Scope::Scope(const char* p_sStage, qint64 p_iTimestamp)
+: m_sStage(p_sStage)
+, m_iTimestamp(p_iTimestamp)
+, m_iBegin(Tracer::isEnabled() ? Tracer::now() : -1)
+{
+}
+
+
+//*************************************************************************************************************
+
+inline Tracer::Scope::~Scope()
+{
+    if(m_iBegin >= 0)
+        Tracer::record(m_sStage, m_iBegin, Tracer::now(), m_iTimestamp);
+}
+
+} // NAMESPACE
+
+#endif // TRACER_H
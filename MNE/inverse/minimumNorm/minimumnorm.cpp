@@ -42,6 +42,7 @@
 
 #include <mne/mne_sourceestimate.h>
 #include <fiff/fiff_evoked.h>
+#include <generics/tracer.h>
 
 
 //*************************************************************************************************************
@@ -60,6 +61,7 @@
 using namespace Eigen;
 using namespace MNELIB;
 using namespace INVERSELIB;
+using namespace IOBuffer;
 
 
 //*************************************************************************************************************
@@ -70,6 +72,10 @@ using namespace INVERSELIB;
 MinimumNorm::MinimumNorm(const MNEInverseOperator &p_inverseOperator, float lambda, const QString method)
 : m_inverseOperator(p_inverseOperator)
 , inverseSetup(false)
+, m_bFactored(false)
+, m_bSinglePrecision(false)
+, m_pSetup(new KernelSetup)
+, m_iKernelCacheSize(4)
 {
     this->setRegularization(lambda);
     this->setMethod(method);
@@ -80,6 +86,10 @@ MinimumNorm::MinimumNorm(const MNEInverseOperator &p_inverseOperator, float lamb
 MinimumNorm::MinimumNorm(const MNEInverseOperator &p_inverseOperator, float lambda, bool dSPM, bool sLORETA)
 : m_inverseOperator(p_inverseOperator)
 , inverseSetup(false)
+, m_bFactored(false)
+, m_bSinglePrecision(false)
+, m_pSetup(new KernelSetup)
+, m_iKernelCacheSize(4)
 {
     this->setRegularization(lambda);
     this->setMethod(dSPM, sLORETA);
@@ -103,10 +113,13 @@ MNESourceEstimate MinimumNorm::calculateInverse(const FiffEvoked &p_fiffEvoked,
 
     doInverseSetup(nave,pick_normal);
 
+    if(!inverseSetup)
+        return MNESourceEstimate();
+
     //
     //   Pick the correct channels from the data
     //
-    FiffEvoked t_fiffEvoked = p_fiffEvoked.pick_channels(inv.noise_cov->names);
+    FiffEvoked t_fiffEvoked = p_fiffEvoked.pick_channels(m_pSetup->inv.noise_cov->names);
 
     printf("Picked %d channels from the data\n",t_fiffEvoked.info.nchan);
 
@@ -187,43 +200,38 @@ MNESourceEstimate MinimumNorm::calculateInverse(const FiffEvoked &p_fiffEvoked,
 
 MNESourceEstimate MinimumNorm::calculateInverse(const MatrixXd &data, float tmin, float tstep) const
 {
+    Tracer::Scope trace("MinimumNorm::calculateInverse");
+
     if(!inverseSetup)
     {
         qWarning("Inverse not setup -> call doInverseSetup first!");
         return MNESourceEstimate();
     }
 
-    MatrixXd sol = K * data; //apply imaging kernel
-
-    if (inv.source_ori == FIFFV_MNE_FREE_ORI)
-    {
-        printf("combining the current components...");
-        MatrixXd sol1(sol.rows()/3,sol.cols());
-        for(qint32 i = 0; i < sol.cols(); ++i)
-        {
-            VectorXd* tmp = MNEMath::combine_xyz(sol.block(0,i,sol.rows(),1));
-            sol1.block(0,i,sol.rows()/3,1) = tmp->cwiseSqrt();
-            delete tmp;
-        }
-        sol.resize(sol1.rows(),sol1.cols());
-        sol = sol1;
-    }
-
     if (m_bdSPM)
-    {
         printf("(dSPM)...");
-        sol = inv.noisenorm*sol;
-    }
     else if (m_bsLORETA)
-    {
         printf("(sLORETA)...");
-        sol = inv.noisenorm*sol;
+    if (m_pSetup->inv.source_ori == FIFFV_MNE_FREE_ORI && !m_pSetup->pick_normal)
+        printf("combining the current components...");
+
+    MatrixXd sol;
+    if(m_bSinglePrecision)
+    {
+        MatrixXf t_matSol;
+        if(!applyInverse<float>(data.cast<float>(), t_matSol))
+            return MNESourceEstimate();
+        sol = t_matSol.cast<double>();
     }
+    else if(!applyInverse<double>(data, sol))
+        return MNESourceEstimate();
+
     printf("[done]\n");
 
     //Results
-    VectorXi p_vecVertices(inv.src[0].vertno.size() + inv.src[1].vertno.size());
-    p_vecVertices << inv.src[0].vertno, inv.src[1].vertno;
+    const MNESourceSpace &t_src = m_pSetup->inv.src;
+    VectorXi p_vecVertices(t_src[0].vertno.size() + t_src[1].vertno.size());
+    p_vecVertices << t_src[0].vertno, t_src[1].vertno;
 
 //    VectorXi p_vecVertices();
 //    for(qint32 h = 0; h < inv.src.size(); ++h)
@@ -234,21 +242,221 @@ MNESourceEstimate MinimumNorm::calculateInverse(const MatrixXd &data, float tmin
 }
 
 
+//*************************************************************************************************************
+
+MNESourceEstimate MinimumNorm::calculateInverse(const MatrixXf &data, float tmin, float tstep) const
+{
+    if(!m_bSinglePrecision)
+        return calculateInverse(MatrixXd(data.cast<double>()), tmin, tstep);
+
+    Tracer::Scope trace("MinimumNorm::calculateInverse");
+
+    if(!inverseSetup)
+    {
+        qWarning("Inverse not setup -> call doInverseSetup first!");
+        return MNESourceEstimate();
+    }
+
+    MatrixXf t_matSol;
+    if(!applyInverse<float>(data, t_matSol))
+        return MNESourceEstimate();
+
+    //Results
+    const MNESourceSpace &t_src = m_pSetup->inv.src;
+    VectorXi p_vecVertices(t_src[0].vertno.size() + t_src[1].vertno.size());
+    p_vecVertices << t_src[0].vertno, t_src[1].vertno;
+
+    return MNESourceEstimate(t_matSol.cast<double>(), p_vecVertices, tmin, tstep);
+}
+
+
 //*************************************************************************************************************
 
 void MinimumNorm::doInverseSetup(qint32 nave, bool pick_normal)
 {
+    Tracer::Scope trace("MinimumNorm::doInverseSetup");
+
+    inverseSetup = false;
+
+    QSharedPointer<KernelSetup> t_pSetup = findKernel(nave, pick_normal);
+
+    if(t_pSetup)
+        printf("Using the kept inverse kernel for nave = %d\n", nave);
+    else
+    {
+        t_pSetup = setupKernel(nave, pick_normal);
+        if(!t_pSetup)
+            return;
+        cacheKernel(t_pSetup);
+    }
+
+    m_pSetup = t_pSetup;
+    inverseSetup = true;
+}
+
+
+//*************************************************************************************************************
+
+QSharedPointer<MinimumNorm::KernelSetup> MinimumNorm::setupKernel(qint32 nave, bool pick_normal) const
+{
+    QSharedPointer<KernelSetup> t_pSetup(new KernelSetup);
+    t_pSetup->nave = nave;
+    t_pSetup->lambda2 = m_fLambda;
+    t_pSetup->method = m_sMethod;
+    t_pSetup->pick_normal = pick_normal;
+    t_pSetup->label = label;
+
     //
     //   Set up the inverse according to the parameters
     //
+    MNEInverseOperator &inv = t_pSetup->inv;
     inv = m_inverseOperator.prepare_inverse_operator(nave, m_fLambda, m_bdSPM, m_bsLORETA);
+    if(inv.nsource < 0)
+        return QSharedPointer<KernelSetup>();
 
     printf("Computing inverse...");
-    inv.assemble_kernel(label, m_sMethod, pick_normal, K, noise_norm, vertno);
+    if(m_bFactored)
+    {
+        if(!inv.assemble_kernel_factors(label, m_sMethod, pick_normal, t_pSetup->matLeads, t_pSetup->matTrans, t_pSetup->noise_norm, t_pSetup->vertno))
+            return QSharedPointer<KernelSetup>();
+
+        //
+        //   Fold the noise normalization into the eigenleads. The factors are positive, so for free orientations
+        //   scaling the three components of a source scales the combined norm the same way.
+        //
+        VectorXd t_vecNoiseNorm = noiseNormVector(t_pSetup->noise_norm);
+        if(t_vecNoiseNorm.size() > 0)
+        {
+            if(t_pSetup->matLeads.rows() % t_vecNoiseNorm.size() != 0)
+            {
+                qWarning("Noise normalization of %d sources does not match the %d kernel rows!", (int)t_vecNoiseNorm.size(), (int)t_pSetup->matLeads.rows());
+                return QSharedPointer<KernelSetup>();
+            }
+
+            qint32 nComp = t_pSetup->matLeads.rows() / t_vecNoiseNorm.size();
+            for(qint32 i = 0; i < t_vecNoiseNorm.size(); ++i)
+                t_pSetup->matLeads.middleRows(i*nComp, nComp) *= t_vecNoiseNorm[i];
+        }
+    }
+    else
+    {
+        if(!inv.assemble_kernel(label, m_sMethod, pick_normal, t_pSetup->K, t_pSetup->noise_norm, t_pSetup->vertno))
+            return QSharedPointer<KernelSetup>();
+
+        // Noise normalization of the selected sources as a plain vector for the fused combine
+        t_pSetup->vecNoiseNorm = noiseNormVector(t_pSetup->noise_norm);
+    }
+
+    //
+    //   Keep only the single precision kernel
+    //
+    if(m_bSinglePrecision)
+    {
+        t_pSetup->matKF = t_pSetup->K.cast<float>();
+        t_pSetup->matLeadsF = t_pSetup->matLeads.cast<float>();
+        t_pSetup->matTransF = t_pSetup->matTrans.cast<float>();
+        t_pSetup->vecNoiseNormF = t_pSetup->vecNoiseNorm.cast<float>();
+        t_pSetup->K = MatrixXd();
+        t_pSetup->matLeads = MatrixXd();
+        t_pSetup->matTrans = MatrixXd();
+        t_pSetup->vecNoiseNorm = VectorXd();
+    }
 
-    std::cout << "K " << K.rows() << " x " << K.cols() << std::endl;
+    return t_pSetup;
+}
 
-    inverseSetup = true;
+
+//*************************************************************************************************************
+
+VectorXd MinimumNorm::noiseNormVector(const SparseMatrix<double> &p_noiseNorm)
+{
+    VectorXd t_vecNoiseNorm;
+    if(p_noiseNorm.nonZeros() == 0)
+        return t_vecNoiseNorm;
+
+    t_vecNoiseNorm = VectorXd::Ones(p_noiseNorm.rows());
+    for(qint32 k = 0; k < p_noiseNorm.outerSize(); ++k)
+        for(SparseMatrix<double>::InnerIterator it(p_noiseNorm,k); it; ++it)
+            t_vecNoiseNorm[it.row()] = it.value();
+
+    return t_vecNoiseNorm;
+}
+
+
+//*************************************************************************************************************
+
+QSharedPointer<MinimumNorm::KernelSetup> MinimumNorm::findKernel(qint32 nave, bool pick_normal)
+{
+    for(qint32 i = 0; i < m_qListKernelCache.size(); ++i)
+    {
+        const KernelSetup &t_setup = *m_qListKernelCache[i];
+
+        if(t_setup.nave != nave || t_setup.lambda2 != m_fLambda || t_setup.method != m_sMethod || t_setup.pick_normal != pick_normal)
+            continue;
+
+        if(t_setup.label.hemi != label.hemi || t_setup.label.label_id != label.label_id || t_setup.label.name != label.name
+                || t_setup.label.vertices.size() != label.vertices.size()
+                || (label.vertices.size() > 0 && t_setup.label.vertices != label.vertices))
+            continue;
+
+        m_qListKernelCache.move(i, 0);
+        return m_qListKernelCache[0];
+    }
+
+    return QSharedPointer<KernelSetup>();
+}
+
+
+//*************************************************************************************************************
+
+void MinimumNorm::cacheKernel(const QSharedPointer<KernelSetup> &p_pSetup)
+{
+    if(m_iKernelCacheSize <= 0)
+        return;
+
+    m_qListKernelCache.prepend(p_pSetup);
+    while(m_qListKernelCache.size() > m_iKernelCacheSize)
+        m_qListKernelCache.removeLast();
+}
+
+
+//*************************************************************************************************************
+
+void MinimumNorm::setKernelCacheSize(qint32 size)
+{
+    m_iKernelCacheSize = size > 0 ? size : 0;
+
+    while(m_qListKernelCache.size() > m_iKernelCacheSize)
+        m_qListKernelCache.removeLast();
+}
+
+
+//*************************************************************************************************************
+
+void MinimumNorm::clearKernelCache()
+{
+    m_qListKernelCache.clear();
+}
+
+
+//*************************************************************************************************************
+
+void MinimumNorm::precomputeKernels(const QList<qint32> &naves, bool pick_normal)
+{
+    if(naves.size() > m_iKernelCacheSize)
+        m_iKernelCacheSize = naves.size();
+
+    for(qint32 i = 0; i < naves.size(); ++i)
+    {
+        if(findKernel(naves[i], pick_normal))
+            continue;
+
+        QSharedPointer<KernelSetup> t_pSetup = setupKernel(naves[i], pick_normal);
+        if(t_pSetup)
+            cacheKernel(t_pSetup);
+        else
+            printf("Kernel for nave = %d could not be set up.\n", naves[i]);
+    }
 }
 
 
@@ -319,3 +527,31 @@ void MinimumNorm::setRegularization(float lambda)
 {
     m_fLambda = lambda;
 }
+
+
+//*************************************************************************************************************
+
+void MinimumNorm::setSinglePrecision(bool single)
+{
+    if(single != m_bSinglePrecision)
+    {
+        inverseSetup = false;
+        clearKernelCache();
+    }
+
+    m_bSinglePrecision = single;
+}
+
+
+//*************************************************************************************************************
+
+void MinimumNorm::setFactoredKernel(bool factored)
+{
+    if(factored != m_bFactored)
+    {
+        inverseSetup = false;
+        clearKernelCache();
+    }
+
+    m_bFactored = factored;
+}
@@ -46,6 +46,7 @@
 
 #include <mne/mne_inverse_operator.h>
 #include <fs/label.h>
+#include <utils/mnemath.h>
 
 #include <QSharedPointer>
 
@@ -71,6 +72,7 @@ namespace INVERSELIB
 
 using namespace MNELIB;
 using namespace FSLIB;
+using namespace UTILSLIB;
 
 
 //=============================================================================================================
@@ -127,6 +129,40 @@ public:
 
     virtual MNESourceEstimate calculateInverse(const MatrixXd &data, float tmin, float tstep) const;
 
+    //=========================================================================================================
+    /**
+    * Computes the inverse solution of single precision data, e.g. as delivered by the real-time acquisition.
+    * With a single precision setup the data are used as they are, otherwise they are converted to double.
+    *
+    * @param[in] data       Data, channels x times.
+    * @param[in] tmin       Time of the first sample.
+    * @param[in] tstep      Time between two samples.
+    *
+    * @return the calculated source estimation
+    */
+    MNESourceEstimate calculateInverse(const MatrixXf &data, float tmin, float tstep) const;
+
+    //=========================================================================================================
+    /**
+    * Applies the prepared kernel, combines free orientations and noise normalizes, in the scalar type T. The
+    * solution stays in T; T has to match the precision of the setup (float with setSinglePrecision(true),
+    * double otherwise).
+    *
+    * Error bounds of the single precision path against the double path, u = 2^-24 the float unit roundoff,
+    * n the number of channels and r the rank of the factored kernel: each source value differs by at most
+    * (n + 4) u |K| |x| with the dense kernel and (n + r + 5) u |L| |T| |x| with the factored one, |.| taken
+    * elementwise. For Vectorview sized operators this is below 1e-4 of the largest source value, the observed
+    * error is typically around 1e-6 of it. Sources much weaker than the kernel magnitude, where the sum cancels,
+    * only keep this absolute accuracy.
+    *
+    * @param[in] data       Data, channels x times.
+    * @param[out] sol       The source values, sources x times.
+    *
+    * @return true if successful, false if the inverse is not set up in the precision T
+    */
+    template<typename T>
+    bool applyInverse(const Matrix<T, Dynamic, Dynamic> &data, Matrix<T, Dynamic, Dynamic> &sol) const;
+
     virtual void doInverseSetup(qint32 nave, bool pick_normal = false);
 
 
@@ -167,9 +203,164 @@ public:
     */
     void setRegularization(float lambda);
 
+    //=========================================================================================================
+    /**
+    * Selects how the imaging kernel is applied. The factored kernel keeps the weighted eigenleads and the data
+    * transformation of MNEInverseOperator::assemble_kernel_factors and applies them right to left: project,
+    * whiten, eigenfields, reginv, eigenleads. The dSPM/sLORETA noise normalization is folded into the eigenleads
+    * as a diagonal scale. The dense kernel K is not formed then, getKernel() returns an empty matrix.
+    * Changing the mode requires a new doInverseSetup.
+    *
+    * @param[in] factored   Whether to apply the factored kernel.
+    */
+    void setFactoredKernel(bool factored);
+
+    //=========================================================================================================
+    /**
+    * Returns whether the factored kernel is applied.
+    *
+    * @return true if the factored kernel is applied.
+    */
+    inline bool isFactoredKernel() const;
+
+    //=========================================================================================================
+    /**
+    * Selects single precision for the kernel application. The operator is still prepared and assembled in double,
+    * then the kernel is stored as float only, which halves its memory and roughly doubles the GEMM throughput.
+    * calculateInverse then runs in float for double data as well and converts at the boundaries; getKernel()
+    * returns an empty matrix. See applyInverse for the error bounds. Changing the precision requires a new
+    * doInverseSetup.
+    *
+    * @param[in] single     Whether to apply the kernel in single precision.
+    */
+    void setSinglePrecision(bool single);
+
+    //=========================================================================================================
+    /**
+    * Returns whether the kernel is applied in single precision.
+    *
+    * @return true if the kernel is applied in single precision.
+    */
+    inline bool isSinglePrecision() const;
+
+    //=========================================================================================================
+    /**
+    * Sets how many set up kernels are kept. doInverseSetup, and therefore calculateInverse(FiffEvoked), reuses a
+    * kept kernel when nave, lambda2, method, pick_normal and label match and skips the preparation and assembly
+    * entirely. The least recently used kernel is dropped first. Each kernel holds its prepared inverse operator
+    * (sharing the unscaled parts with the original one) and the kernel in the selected form and precision.
+    *
+    * @param[in] size   Maximal number of kept kernels, default 4; 0 disables the cache.
+    */
+    void setKernelCacheSize(qint32 size);
+
+    //=========================================================================================================
+    /**
+    * Returns the maximal number of kept kernels.
+    *
+    * @return the kernel cache size.
+    */
+    inline qint32 getKernelCacheSize() const;
+
+    //=========================================================================================================
+    /**
+    * Drops all kept kernels except the current one.
+    */
+    void clearKernelCache();
+
+    //=========================================================================================================
+    /**
+    * Sets up the kernels for a list of nave values with the current lambda2, method and label, e.g. for the
+    * averages a real-time averaging will pass through. The cache size is raised to hold all of them if needed. The
+    * current setup stays active.
+    *
+    * @param[in] naves          The numbers of averages.
+    * @param[in] pick_normal    Pick the normal components, see doInverseSetup.
+    */
+    void precomputeKernels(const QList<qint32> &naves, bool pick_normal = false);
+
     inline MatrixXd& getKernel();
 
 private:
+    //=========================================================================================================
+    /**
+    * One set up kernel, keyed by the parameters it was set up with.
+    */
+    struct KernelSetup
+    {
+        KernelSetup() : nave(-1), lambda2(0), pick_normal(false) {}
+
+        qint32 nave;                        /**< Number of averages */
+        float lambda2;                      /**< Regularization parameter */
+        QString method;                     /**< Method ("MNE" | "dSPM" | "sLORETA") */
+        bool pick_normal;                   /**< Only the normal components were kept */
+        Label label;                        /**< The corresponding label */
+
+        MNEInverseOperator inv;             /**< The setup inverse operator */
+        SparseMatrix<double> noise_norm;    /**< The noise normalization */
+        QList<VectorXi> vertno;             /**< The vertices numbers */
+        MatrixXd K;                         /**< Imaging kernel */
+        MatrixXd matLeads;                  /**< Factored kernel: noise normalized, weighted eigenleads */
+        MatrixXd matTrans;                  /**< Factored kernel: reginv * eigen_fields * whitener * proj */
+        VectorXd vecNoiseNorm;              /**< Noise normalization per source applied after K, empty if none */
+        MatrixXf matKF;                     /**< Single precision K */
+        MatrixXf matLeadsF;                 /**< Single precision factored kernel eigenleads */
+        MatrixXf matTransF;                 /**< Single precision factored kernel data transformation */
+        VectorXf vecNoiseNormF;             /**< Single precision noise normalization */
+    };
+
+    //=========================================================================================================
+    /**
+    * Prepares the inverse operator and assembles the kernel in the selected form and precision.
+    *
+    * @param[in] nave           Number of averages.
+    * @param[in] pick_normal    Pick the normal components.
+    *
+    * @return the kernel setup, NULL if the kernel could not be assembled
+    */
+    QSharedPointer<KernelSetup> setupKernel(qint32 nave, bool pick_normal) const;
+
+    //=========================================================================================================
+    /**
+    * Converts a diagonal noise normalization into a vector of its factors.
+    *
+    * @param[in] p_noiseNorm    the diagonal noise normalization of the selected sources.
+    *
+    * @return the factors, empty if there is no noise normalization.
+    */
+    static VectorXd noiseNormVector(const SparseMatrix<double> &p_noiseNorm);
+
+    //=========================================================================================================
+    /**
+    * Looks up a kept kernel and marks it as most recently used.
+    *
+    * @param[in] nave           Number of averages.
+    * @param[in] pick_normal    Pick the normal components.
+    *
+    * @return the kept kernel setup, NULL if none matches
+    */
+    QSharedPointer<KernelSetup> findKernel(qint32 nave, bool pick_normal);
+
+    //=========================================================================================================
+    /**
+    * Keeps a kernel as most recently used and drops the least recently used ones beyond the cache size.
+    *
+    * @param[in] p_pSetup   The kernel setup to keep.
+    */
+    void cacheKernel(const QSharedPointer<KernelSetup> &p_pSetup);
+
+    //=========================================================================================================
+    /**
+    * Returns the kernel of the double precision setup, empty matrices if it was set up in single precision.
+    */
+    inline void getKernels(const MatrixXd* &p_pK, const MatrixXd* &p_pLeads, const MatrixXd* &p_pTrans, const VectorXd* &p_pNoiseNorm) const;
+
+    //=========================================================================================================
+    /**
+    * Returns the kernel of the single precision setup, empty matrices if it was set up in double precision.
+    */
+    inline void getKernels(const MatrixXf* &p_pK, const MatrixXf* &p_pLeads, const MatrixXf* &p_pTrans, const VectorXf* &p_pNoiseNorm) const;
+
     MNEInverseOperator m_inverseOperator;   /**< The inverse operator */
     float m_fLambda;                        /**< Regularization parameter */
     QString m_sMethod;                      /**< Selected method */
@@ -177,12 +368,13 @@ private:
     bool m_bdSPM;                           /**< Do dSPM method */
 
     bool inverseSetup;                      /**< Inverse Setup Calcluated */
-    MNEInverseOperator inv;                 /**< The setup inverse operator */
-    SparseMatrix<double> noise_norm;        /**< The noise normalization */
-    QList<VectorXi> vertno;                 /**< The vertices numbers */
     Label label;                            /**< The corresponding labels */
-    MatrixXd K;                             /**< Imaging kernel */
+    bool m_bFactored;                       /**< Apply the factored kernel instead of K */
+    bool m_bSinglePrecision;                /**< Apply the kernel in single precision */
 
+    QSharedPointer<KernelSetup> m_pSetup;                   /**< The current kernel setup */
+    QList<QSharedPointer<KernelSetup> > m_qListKernelCache; /**< Kept kernel setups, most recently used first */
+    qint32 m_iKernelCacheSize;                              /**< Maximal number of kept kernel setups */
 };
 
 //*************************************************************************************************************
@@ -190,9 +382,106 @@ private:
 // INLINE DEFINITIONS
 //=============================================================================================================
 
+inline bool MinimumNorm::isFactoredKernel() const
+{
+    return m_bFactored;
+}
+
+
+//*************************************************************************************************************
+
+inline bool MinimumNorm::isSinglePrecision() const
+{
+    return m_bSinglePrecision;
+}
+
+
+//*************************************************************************************************************
+
+inline qint32 MinimumNorm::getKernelCacheSize() const
+{
+    return m_iKernelCacheSize;
+}
+
+
+//*************************************************************************************************************
+
+template<typename T>
+bool MinimumNorm::applyInverse(const Matrix<T, Dynamic, Dynamic> &data, Matrix<T, Dynamic, Dynamic> &sol) const
+{
+    const Matrix<T, Dynamic, Dynamic>* t_pK;
+    const Matrix<T, Dynamic, Dynamic>* t_pLeads;
+    const Matrix<T, Dynamic, Dynamic>* t_pTrans;
+    const Matrix<T, Dynamic, 1>* t_pNoiseNorm;
+    getKernels(t_pK, t_pLeads, t_pTrans, t_pNoiseNorm);
+
+    if(!inverseSetup || (m_bFactored ? t_pLeads->size() : t_pK->size()) == 0)
+    {
+        qWarning("Inverse not setup in this precision -> call doInverseSetup first!");
+        return false;
+    }
+
+    //
+    //   The noise normalization has to match the selected sources, skipping it would return unnormalized values
+    //
+    const bool t_bCombine = m_pSetup->inv.source_ori == FIFFV_MNE_FREE_ORI && !m_pSetup->pick_normal;
+    const qint32 t_iNumRows = m_bFactored ? t_pLeads->rows() : t_pK->rows();
+    const qint32 t_iNumSources = t_bCombine ? t_iNumRows / 3 : t_iNumRows;
+    if(t_pNoiseNorm->size() > 0 && t_pNoiseNorm->size() != t_iNumSources)
+    {
+        qWarning("Noise normalization of %d sources does not match the kernel of %d sources!", (int)t_pNoiseNorm->size(), t_iNumSources);
+        return false;
+    }
+
+    Matrix<T, Dynamic, Dynamic> t_matSol;
+    if(m_bFactored)
+        t_matSol = *t_pLeads * (*t_pTrans * data); //apply factored imaging kernel, noise normalization included
+    else
+        t_matSol = *t_pK * data; //apply imaging kernel
+
+    //
+    //   Combine the current components and noise normalize in one pass
+    //
+    if(t_bCombine)
+        MNEMath::combine_xyz_normalized(t_matSol, *t_pNoiseNorm, sol);
+    else
+    {
+        sol.swap(t_matSol);
+        if(t_pNoiseNorm->size() > 0)
+            sol.array().colwise() *= t_pNoiseNorm->array();
+    }
+
+    return true;
+}
+
+
+//*************************************************************************************************************
+
+inline void MinimumNorm::getKernels(const MatrixXd* &p_pK, const MatrixXd* &p_pLeads, const MatrixXd* &p_pTrans, const VectorXd* &p_pNoiseNorm) const
+{
+    p_pK = &m_pSetup->K;
+    p_pLeads = &m_pSetup->matLeads;
+    p_pTrans = &m_pSetup->matTrans;
+    p_pNoiseNorm = &m_pSetup->vecNoiseNorm;
+}
+
+
+//*************************************************************************************************************
+
+inline void MinimumNorm::getKernels(const MatrixXf* &p_pK, const MatrixXf* &p_pLeads, const MatrixXf* &p_pTrans, const VectorXf* &p_pNoiseNorm) const
+{
+    p_pK = &m_pSetup->matKF;
+    p_pLeads = &m_pSetup->matLeadsF;
+    p_pTrans = &m_pSetup->matTransF;
+    p_pNoiseNorm = &m_pSetup->vecNoiseNormF;
+}
+
+
+//*************************************************************************************************************
+
 inline MatrixXd& MinimumNorm::getKernel()
 {
-    return K;
+    return m_pSetup->K;
 }
 
 
@@ -200,7 +489,7 @@ inline MatrixXd& MinimumNorm::getKernel()
 
 inline MNEInverseOperator& MinimumNorm::getPreparedInverseOperator()
 {
-    return inv;
+    return m_pSetup->inv;
 }
 
 } //NAMESPACE
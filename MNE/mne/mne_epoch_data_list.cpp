@@ -41,6 +41,24 @@
 #include "mne_epoch_data_list.h"
 
 
+//*************************************************************************************************************
+//=============================================================================================================
+// STL INCLUDES
+//=============================================================================================================
+
+#include <algorithm>
+#include <math.h>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// QT INCLUDES
+//=============================================================================================================
+
+#include <QMap>
+#include <QPair>
+
+
 //*************************************************************************************************************
 //=============================================================================================================
 // USED NAMESPACES
@@ -125,3 +143,129 @@ FiffEvoked MNEEpochDataList::average(FiffInfo& info, fiff_int_t first, fiff_int_
 
     return p_evoked;
 }
+
+
+//*************************************************************************************************************
+
+MNEEpochDataList MNEEpochDataList::readEpochs(const FiffRawData& raw, const MatrixXi& events, float tmin, float tmax, qint32 event, const RowVectorXi& picks)
+{
+    MNEEpochDataList data;
+
+    qint32 p, k;
+
+    //
+    //   Select the desired events and sort them by onset, so that buffers can be released as soon as no
+    //   later epoch needs them. The epochs start at event_samp + tmin*sfreq, truncated, and end at
+    //   event_samp + floor(tmax*sfreq + 0.5), as in the former per epoch reads; inside the recording the truncated
+    //   start is event_samp + floor(tmin*sfreq), so all epochs have the same length.
+    //
+    fiff_int_t t_iEnd = (fiff_int_t)floor(tmax*raw.info.sfreq + 0.5);
+    qint32 ns = t_iEnd - (fiff_int_t)floor(tmin*raw.info.sfreq) + 1;
+
+    QList<QPair<fiff_int_t, fiff_int_t> > t_qListEpochs; // (from, event_samp)
+    for (p = 0; p < events.rows(); ++p)
+    {
+        if (events(p,1) == 0 && events(p,2) == event)
+        {
+            fiff_int_t from = events(p,0) + tmin*raw.info.sfreq;
+            if(from < raw.first_samp || from + ns - 1 > raw.last_samp)
+            {
+                printf("Event at sample %d is too close to the data boundaries - omitted\n", events(p,0));
+                continue;
+            }
+            t_qListEpochs.append(qMakePair(from, events(p,0)));
+        }
+    }
+
+    if (t_qListEpochs.size() == 0 || ns <= 0)
+    {
+        printf("No desired events found.\n");
+        return data;
+    }
+    std::sort(t_qListEpochs.begin(), t_qListEpochs.end());
+
+    printf("Reading %d epochs, %d samples each...", t_qListEpochs.size(), ns);
+
+    //
+    //   The calibration, compensation and projection operator of the raw data, as read_raw_segment applies it
+    //
+    qint32 nchan = raw.info.nchan;
+    SparseMatrix<double> mult = raw.read_operator(picks);
+    qint32 nsel = mult.rows();
+
+    //
+    //   Collect the uncalibrated epochs batch wise, so the operator is applied to many epochs at once
+    //   without keeping the whole data set in memory twice (~256 MB per batch)
+    //
+    qint32 nbatch = qMax(1, qMin(t_qListEpochs.size(), (qint32)((32*1024*1024) / ((qint64)nchan*ns))));
+    MatrixXd t_matBatch(nchan, nbatch*ns);
+    MatrixXd t_matOut;
+
+    QMap<qint32, MatrixXd> t_mapBuffers; // decoded buffers which are still needed
+    qint32 first_buf, last_buf;
+    qint32 t_iBatchCount = 0;
+    qint32 t_iBufferReads = 0;
+
+    for (p = 0; p < t_qListEpochs.size(); ++p)
+    {
+        fiff_int_t from = t_qListEpochs[p].first;
+        fiff_int_t to = from + ns - 1;
+
+        if(!raw.find_raw_buffers(from, to, first_buf, last_buf))
+        {
+            printf("Can't find the data buffers of the epoch %d ... %d\n", from, to);
+            return MNEEpochDataList();
+        }
+
+        //
+        //   Epochs are sorted by onset -> buffers before first_buf are not needed anymore
+        //
+        while(!t_mapBuffers.isEmpty() && t_mapBuffers.firstKey() < first_buf)
+            t_mapBuffers.erase(t_mapBuffers.begin());
+
+        for(k = first_buf; k <= last_buf; ++k)
+        {
+            if(!t_mapBuffers.contains(k))
+            {
+                if(!raw.read_raw_buffer(k, t_mapBuffers[k]))
+                {
+                    printf("Can't read the data buffer %d\n", k);
+                    return MNEEpochDataList();
+                }
+                ++t_iBufferReads;
+            }
+
+            const FiffRawDir& t_rawDir = raw.rawdir[k];
+            fiff_int_t s0 = qMax(from, t_rawDir.first);
+            fiff_int_t s1 = qMin(to, t_rawDir.last);
+            if(s1 >= s0)
+                t_matBatch.block(0, t_iBatchCount*ns + s0 - from, nchan, s1 - s0 + 1) = t_mapBuffers[k].block(0, s0 - t_rawDir.first, nchan, s1 - s0 + 1);
+        }
+        ++t_iBatchCount;
+
+        //
+        //   Apply the operator to the batch and split it into epochs
+        //
+        if(t_iBatchCount == nbatch || p == t_qListEpochs.size() - 1)
+        {
+            t_matOut = mult*t_matBatch.leftCols(t_iBatchCount*ns);
+
+            for(qint32 b = 0; b < t_iBatchCount; ++b)
+            {
+                fiff_int_t t_iFrom = t_qListEpochs[p - t_iBatchCount + 1 + b].first;
+
+                MNEEpochData::SPtr epoch(new MNEEpochData());
+                epoch->epoch = t_matOut.block(0, b*ns, nsel, ns);
+                epoch->event = event;
+                epoch->tmin = ((float)(t_iFrom)-(float)(raw.first_samp))/raw.info.sfreq;
+                epoch->tmax = ((float)(t_iFrom + ns - 1)-(float)(raw.first_samp))/raw.info.sfreq;
+                data.append(epoch);
+            }
+            t_iBatchCount = 0;
+        }
+    }
+
+    printf("[done] (%d buffers read)\n", t_iBufferReads);
+
+    return data;
+}
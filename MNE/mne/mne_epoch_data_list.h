@@ -43,6 +43,7 @@
 
 #include <fiff/fiff_types.h>
 #include <fiff/fiff_evoked.h>
+#include <fiff/fiff_raw_data.h>
 
 
 //*************************************************************************************************************
@@ -112,6 +113,23 @@ public:
     * @param[in] proj       Apply SSP projection vectors (optional, default = false)
     */
     FiffEvoked average(FiffInfo& p_info, fiff_int_t first, fiff_int_t last, VectorXi sel = defaultVectorXi, bool proj = false);
+
+    //=========================================================================================================
+    /**
+    * Reads the epochs around all events of one kind in a single pass over the raw data. Each data buffer on
+    * disk is read at most once, even if it is shared by several epochs, and the calibration, SSP and
+    * compensation operator is built once and applied to batches of epochs as a single matrix product.
+    *
+    * @param[in] raw        The raw data to read from; its proj and comp are applied
+    * @param[in] events     The events as read by MNE::read_events (sample, before, after)
+    * @param[in] tmin       Start time of the epochs relative to the event in seconds
+    * @param[in] tmax       End time of the epochs relative to the event in seconds
+    * @param[in] event      The event code to select
+    * @param[in] picks      Channel selection vector (optional, default all channels)
+    *
+    * @return the epochs in chronological order, empty if no matching event was found
+    */
+    static MNEEpochDataList readEpochs(const FiffRawData& raw, const MatrixXi& events, float tmin, float tmax, qint32 event, const RowVectorXi& picks = defaultRowVectorXi);
 };
 
 } // NAMESPACE
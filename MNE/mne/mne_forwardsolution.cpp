@@ -909,7 +909,7 @@ FiffCov MNEForwardSolution::compute_depth_prior(const MatrixXd &Gain, const Fiff
 
 //*************************************************************************************************************
 
-FiffCov MNEForwardSolution::compute_orient_prior(float loose)
+FiffCov MNEForwardSolution::compute_orient_prior(float loose) const
 {
     bool is_fixed_ori = this->isFixedOrient();
     qint32 n_sources = this->sol->data.cols();
@@ -1182,206 +1182,12 @@ void MNEForwardSolution::prepare_forward(const FiffInfo &p_info, const FiffCov &
 
 bool MNEForwardSolution::read(QIODevice& p_IODevice, MNEForwardSolution& fwd, bool force_fixed, bool surf_ori, const QStringList& include, const QStringList& exclude, bool bExcludeBads)
 {
-    FiffStream::SPtr t_pStream(new FiffStream(&p_IODevice));
-    FiffDirTree t_Tree;
-    QList<FiffDirEntry> t_Dir;
-
-    printf("Reading forward solution from %s...\n", t_pStream->streamName().toUtf8().constData());
-    if(!t_pStream->open(t_Tree, t_Dir))
-        return false;
-    //
-    //   Find all forward solutions
-    //
-    QList<FiffDirTree> fwds = t_Tree.dir_tree_find(FIFFB_MNE_FORWARD_SOLUTION);
-
-    if (fwds.size() == 0)
-    {
-        t_pStream->device()->close();
-        std::cout << "No forward solutions in " << t_pStream->streamName().toUtf8().constData(); // ToDo throw error
-        return false;
-    }
-    //
-    //   Parent MRI data
-    //
-    QList<FiffDirTree> parent_mri = t_Tree.dir_tree_find(FIFFB_MNE_PARENT_MRI_FILE);
-    if (parent_mri.size() == 0)
-    {
-        t_pStream->device()->close();
-        std::cout << "No parent MRI information in " << t_pStream->streamName().toUtf8().constData(); // ToDo throw error
-        return false;
-    }
-
-    MNESourceSpace t_SourceSpace;// = NULL;
-    if(!MNESourceSpace::readFromStream(t_pStream, true, t_Tree, t_SourceSpace))
-    {
-        t_pStream->device()->close();
-        std::cout << "Could not read the source spaces\n"; // ToDo throw error
-        //ToDo error(me,'Could not read the source spaces (%s)',mne_omit_first_line(lasterr));
-        return false;
-    }
-
-    for(qint32 k = 0; k < t_SourceSpace.size(); ++k)
-        t_SourceSpace[k].id = MNESourceSpace::find_source_space_hemi(t_SourceSpace[k]);
-
-    //
-    //   Bad channel list
-    //
     QStringList bads;
-    if(bExcludeBads)
-    {
-        bads = t_pStream->read_bad_channels(t_Tree);
-        if(bads.size() > 0)
-        {
-            printf("\t%d bad channels ( ",bads.size());
-            for(qint32 i = 0; i < bads.size(); ++i)
-                printf("\"%s\" ", bads[i].toLatin1().constData());
-            printf(") read\n");
-        }
-    }
-
-    //
-    //   Locate and read the forward solutions
-    //
-    FiffTag::SPtr t_pTag;
-    FiffDirTree megnode;
-    FiffDirTree eegnode;
-    for(qint32 k = 0; k < fwds.size(); ++k)
-    {
-        if(!fwds[k].find_tag(t_pStream.data(), FIFF_MNE_INCLUDED_METHODS, t_pTag))
-        {
-            t_pStream->device()->close();
-            std::cout << "Methods not listed for one of the forward solutions\n"; // ToDo throw error
-            return false;
-        }
-        if (*t_pTag->toInt() == FIFFV_MNE_MEG)
-        {
-            printf("MEG solution found\n");
-            megnode = fwds[k];
-        }
-        else if(*t_pTag->toInt() == FIFFV_MNE_EEG)
-        {
-            printf("EEG solution found\n");
-            eegnode = fwds.at(k);
-        }
-    }
-
-    MNEForwardSolution megfwd;
-    QString ori;
-    if (read_one(t_pStream.data(), megnode, megfwd))
-    {
-        if (megfwd.source_ori == FIFFV_MNE_FIXED_ORI)
-            ori = QString("fixed");
-        else
-            ori = QString("free");
-        printf("\tRead MEG forward solution (%d sources, %d channels, %s orientations)\n", megfwd.nsource,megfwd.nchan,ori.toUtf8().constData());
-    }
-    MNEForwardSolution eegfwd;
-    if (read_one(t_pStream.data(), eegnode, eegfwd))
-    {
-        if (eegfwd.source_ori == FIFFV_MNE_FIXED_ORI)
-            ori = QString("fixed");
-        else
-            ori = QString("free");
-        printf("\tRead EEG forward solution (%d sources, %d channels, %s orientations)\n", eegfwd.nsource,eegfwd.nchan,ori.toUtf8().constData());
-    }
-
-    //
-    //   Merge the MEG and EEG solutions together
-    //
-    fwd.clear();
-
-    if (!megfwd.isEmpty() && !eegfwd.isEmpty())
-    {
-        if (megfwd.sol->data.cols() != eegfwd.sol->data.cols() ||
-                megfwd.source_ori != eegfwd.source_ori ||
-                megfwd.nsource != eegfwd.nsource ||
-                megfwd.coord_frame != eegfwd.coord_frame)
-        {
-            t_pStream->device()->close();
-            std::cout << "The MEG and EEG forward solutions do not match\n"; // ToDo throw error
-            return false;
-        }
-
-        fwd = MNEForwardSolution(megfwd);
-        fwd.sol->data = MatrixXd(megfwd.sol->nrow + eegfwd.sol->nrow, megfwd.sol->ncol);
-
-        fwd.sol->data.block(0,0,megfwd.sol->nrow,megfwd.sol->ncol) = megfwd.sol->data;
-        fwd.sol->data.block(megfwd.sol->nrow,0,eegfwd.sol->nrow,eegfwd.sol->ncol) = eegfwd.sol->data;
-        fwd.sol->nrow = megfwd.sol->nrow + eegfwd.sol->nrow;
-        fwd.sol->row_names.append(eegfwd.sol->row_names);
-
-        if (!fwd.sol_grad->isEmpty())
-        {
-            fwd.sol_grad->data.resize(megfwd.sol_grad->data.rows() + eegfwd.sol_grad->data.rows(), megfwd.sol_grad->data.cols());
-
-            fwd.sol->data.block(0,0,megfwd.sol_grad->data.rows(),megfwd.sol_grad->data.cols()) = megfwd.sol_grad->data;
-            fwd.sol->data.block(megfwd.sol_grad->data.rows(),0,eegfwd.sol_grad->data.rows(),eegfwd.sol_grad->data.cols()) = eegfwd.sol_grad->data;
-
-            fwd.sol_grad->nrow      = megfwd.sol_grad->nrow + eegfwd.sol_grad->nrow;
-            fwd.sol_grad->row_names.append(eegfwd.sol_grad->row_names);
-        }
-        fwd.nchan  = megfwd.nchan + eegfwd.nchan;
-        printf("\tMEG and EEG forward solutions combined\n");
-    }
-    else if (!megfwd.isEmpty())
-        fwd = megfwd; //new MNEForwardSolution(megfwd);//not copied for the sake of speed
-    else
-        fwd = eegfwd; //new MNEForwardSolution(eegfwd);//not copied for the sake of speed
-
-    //
-    //   Get the MRI <-> head coordinate transformation
-    //
-    if(!parent_mri[0].find_tag(t_pStream.data(), FIFF_COORD_TRANS, t_pTag))
-    {
-        t_pStream->device()->close();
-        std::cout << "MRI/head coordinate transformation not found\n"; // ToDo throw error
-        return false;
-    }
-    else
-    {
-        fwd.mri_head_t = t_pTag->toCoordTrans();
-
-        if (fwd.mri_head_t.from != FIFFV_COORD_MRI || fwd.mri_head_t.to != FIFFV_COORD_HEAD)
-        {
-            fwd.mri_head_t.invert_transform();
-            if (fwd.mri_head_t.from != FIFFV_COORD_MRI || fwd.mri_head_t.to != FIFFV_COORD_HEAD)
-            {
-                t_pStream->device()->close();
-                std::cout << "MRI/head coordinate transformation not found\n"; // ToDo throw error
-                return false;
-            }
-        }
-    }
-
-    //
-    // get parent MEG info -> from python package
-    //
-    t_pStream->read_meas_info_base(t_Tree, fwd.info);
-
-
-    t_pStream->device()->close();
-
-    //
-    //   Transform the source spaces to the correct coordinate frame
-    //   if necessary
-    //
-    if (fwd.coord_frame != FIFFV_COORD_MRI && fwd.coord_frame != FIFFV_COORD_HEAD)
-    {
-        std::cout << "Only forward solutions computed in MRI or head coordinates are acceptable";
+    if(!read_solution(p_IODevice, fwd, true, bExcludeBads, bads))
         return false;
-    }
 
-    //
+    MNESourceSpace& t_SourceSpace = fwd.src;
     qint32 nuse = 0;
-    t_SourceSpace.transform_source_space_to(fwd.coord_frame,fwd.mri_head_t);
-    for(qint32 k = 0; k < t_SourceSpace.size(); ++k)
-        nuse += t_SourceSpace[k].nuse;
-
-    if (nuse != fwd.nsource)
-        throw("Source spaces do not match the forward solution.\n");
-
-    printf("\tSource spaces transformed to the forward solution coordinate frame\n");
-    fwd.src = t_SourceSpace; //not new MNESourceSpace(t_SourceSpace); for sake of speed
     //
     //   Handle the source locations and orientations
     //
@@ -1661,16 +1467,249 @@ bool MNEForwardSolution::read(QIODevice& p_IODevice, MNEForwardSolution& fwd, bo
 //        fwd.info.chs = chs;
 //    }
 
-    //garbage collecting
+    return true;
+}
+
+
+//*************************************************************************************************************
+
+bool MNEForwardSolution::read_header(QIODevice& p_IODevice, MNEForwardSolution& fwd)
+{
+    QStringList bads;
+    if(!read_solution(p_IODevice, fwd, false, false, bads))
+        return false;
+
+    printf("\tForward solution header read (%d sources, %d channels, gain matrix not loaded)\n", fwd.nsource, fwd.nchan);
+
+    return true;
+}
+
+
+//*************************************************************************************************************
+
+bool MNEForwardSolution::read_solution(QIODevice& p_IODevice, MNEForwardSolution& fwd, bool p_bReadData, bool bExcludeBads, QStringList& p_qListBads)
+{
+    FiffStream::SPtr t_pStream(new FiffStream(&p_IODevice));
+    FiffDirTree t_Tree;
+    QList<FiffDirEntry> t_Dir;
+
+    printf("Reading forward solution from %s...\n", t_pStream->streamName().toUtf8().constData());
+    if(!t_pStream->open(t_Tree, t_Dir))
+        return false;
+    //
+    //   Find all forward solutions
+    //
+    QList<FiffDirTree> fwds = t_Tree.dir_tree_find(FIFFB_MNE_FORWARD_SOLUTION);
+
+    if (fwds.size() == 0)
+    {
+        t_pStream->device()->close();
+        std::cout << "No forward solutions in " << t_pStream->streamName().toUtf8().constData(); // ToDo throw error
+        return false;
+    }
+    //
+    //   Parent MRI data
+    //
+    QList<FiffDirTree> parent_mri = t_Tree.dir_tree_find(FIFFB_MNE_PARENT_MRI_FILE);
+    if (parent_mri.size() == 0)
+    {
+        t_pStream->device()->close();
+        std::cout << "No parent MRI information in " << t_pStream->streamName().toUtf8().constData(); // ToDo throw error
+        return false;
+    }
+
+    MNESourceSpace t_SourceSpace;// = NULL;
+    if(!MNESourceSpace::readFromStream(t_pStream, true, t_Tree, t_SourceSpace))
+    {
+        t_pStream->device()->close();
+        std::cout << "Could not read the source spaces\n"; // ToDo throw error
+        //ToDo error(me,'Could not read the source spaces (%s)',mne_omit_first_line(lasterr));
+        return false;
+    }
+
+    for(qint32 k = 0; k < t_SourceSpace.size(); ++k)
+        t_SourceSpace[k].id = MNESourceSpace::find_source_space_hemi(t_SourceSpace[k]);
+
+    //
+    //   Bad channel list
+    //
+    p_qListBads.clear();
+    if(bExcludeBads)
+    {
+        p_qListBads = t_pStream->read_bad_channels(t_Tree);
+        if(p_qListBads.size() > 0)
+        {
+            printf("\t%d bad channels ( ",p_qListBads.size());
+            for(qint32 i = 0; i < p_qListBads.size(); ++i)
+                printf("\"%s\" ", p_qListBads[i].toLatin1().constData());
+            printf(") read\n");
+        }
+    }
+
+    //
+    //   Locate and read the forward solutions
+    //
+    FiffTag::SPtr t_pTag;
+    FiffDirTree megnode;
+    FiffDirTree eegnode;
+    for(qint32 k = 0; k < fwds.size(); ++k)
+    {
+        if(!fwds[k].find_tag(t_pStream.data(), FIFF_MNE_INCLUDED_METHODS, t_pTag))
+        {
+            t_pStream->device()->close();
+            std::cout << "Methods not listed for one of the forward solutions\n"; // ToDo throw error
+            return false;
+        }
+        if (*t_pTag->toInt() == FIFFV_MNE_MEG)
+        {
+            printf("MEG solution found\n");
+            megnode = fwds[k];
+        }
+        else if(*t_pTag->toInt() == FIFFV_MNE_EEG)
+        {
+            printf("EEG solution found\n");
+            eegnode = fwds.at(k);
+        }
+    }
+
+    MNEForwardSolution megfwd;
+    QString ori;
+    if (read_one(t_pStream.data(), megnode, megfwd, p_bReadData))
+    {
+        if (megfwd.source_ori == FIFFV_MNE_FIXED_ORI)
+            ori = QString("fixed");
+        else
+            ori = QString("free");
+        printf("\tRead MEG forward solution (%d sources, %d channels, %s orientations)\n", megfwd.nsource,megfwd.nchan,ori.toUtf8().constData());
+    }
+    MNEForwardSolution eegfwd;
+    if (read_one(t_pStream.data(), eegnode, eegfwd, p_bReadData))
+    {
+        if (eegfwd.source_ori == FIFFV_MNE_FIXED_ORI)
+            ori = QString("fixed");
+        else
+            ori = QString("free");
+        printf("\tRead EEG forward solution (%d sources, %d channels, %s orientations)\n", eegfwd.nsource,eegfwd.nchan,ori.toUtf8().constData());
+    }
+
+    //
+    //   Merge the MEG and EEG solutions together
+    //
+    fwd.clear();
+
+    if (!megfwd.isEmpty() && !eegfwd.isEmpty())
+    {
+        if (megfwd.sol->ncol != eegfwd.sol->ncol ||
+                megfwd.source_ori != eegfwd.source_ori ||
+                megfwd.nsource != eegfwd.nsource ||
+                megfwd.coord_frame != eegfwd.coord_frame)
+        {
+            t_pStream->device()->close();
+            std::cout << "The MEG and EEG forward solutions do not match\n"; // ToDo throw error
+            return false;
+        }
+
+        fwd = MNEForwardSolution(megfwd);
+        if(p_bReadData)
+        {
+            fwd.sol->data = MatrixXd(megfwd.sol->nrow + eegfwd.sol->nrow, megfwd.sol->ncol);
+
+            fwd.sol->data.block(0,0,megfwd.sol->nrow,megfwd.sol->ncol) = megfwd.sol->data;
+            fwd.sol->data.block(megfwd.sol->nrow,0,eegfwd.sol->nrow,eegfwd.sol->ncol) = eegfwd.sol->data;
+        }
+        fwd.sol->nrow = megfwd.sol->nrow + eegfwd.sol->nrow;
+        fwd.sol->row_names.append(eegfwd.sol->row_names);
+
+        if (!fwd.sol_grad->isEmpty())
+        {
+            if(p_bReadData)
+            {
+                fwd.sol_grad->data.resize(megfwd.sol_grad->data.rows() + eegfwd.sol_grad->data.rows(), megfwd.sol_grad->data.cols());
+
+                fwd.sol_grad->data.block(0,0,megfwd.sol_grad->data.rows(),megfwd.sol_grad->data.cols()) = megfwd.sol_grad->data;
+                fwd.sol_grad->data.block(megfwd.sol_grad->data.rows(),0,eegfwd.sol_grad->data.rows(),eegfwd.sol_grad->data.cols()) = eegfwd.sol_grad->data;
+            }
+
+            fwd.sol_grad->nrow      = megfwd.sol_grad->nrow + eegfwd.sol_grad->nrow;
+            fwd.sol_grad->row_names.append(eegfwd.sol_grad->row_names);
+        }
+        fwd.nchan  = megfwd.nchan + eegfwd.nchan;
+        printf("\tMEG and EEG forward solutions combined\n");
+    }
+    else if (!megfwd.isEmpty())
+        fwd = megfwd; //new MNEForwardSolution(megfwd);//not copied for the sake of speed
+    else
+        fwd = eegfwd; //new MNEForwardSolution(eegfwd);//not copied for the sake of speed
+
+    if (fwd.isEmpty())
+    {
+        t_pStream->device()->close();
+        std::cout << "No MEG or EEG forward solution found\n"; // ToDo throw error
+        return false;
+    }
+
+    //
+    //   Get the MRI <-> head coordinate transformation
+    //
+    if(!parent_mri[0].find_tag(t_pStream.data(), FIFF_COORD_TRANS, t_pTag))
+    {
+        t_pStream->device()->close();
+        std::cout << "MRI/head coordinate transformation not found\n"; // ToDo throw error
+        return false;
+    }
+    else
+    {
+        fwd.mri_head_t = t_pTag->toCoordTrans();
+
+        if (fwd.mri_head_t.from != FIFFV_COORD_MRI || fwd.mri_head_t.to != FIFFV_COORD_HEAD)
+        {
+            fwd.mri_head_t.invert_transform();
+            if (fwd.mri_head_t.from != FIFFV_COORD_MRI || fwd.mri_head_t.to != FIFFV_COORD_HEAD)
+            {
+                t_pStream->device()->close();
+                std::cout << "MRI/head coordinate transformation not found\n"; // ToDo throw error
+                return false;
+            }
+        }
+    }
+
+    //
+    // get parent MEG info -> from python package
+    //
+    t_pStream->read_meas_info_base(t_Tree, fwd.info);
+
+
     t_pStream->device()->close();
 
+    //
+    //   Transform the source spaces to the correct coordinate frame
+    //   if necessary
+    //
+    if (fwd.coord_frame != FIFFV_COORD_MRI && fwd.coord_frame != FIFFV_COORD_HEAD)
+    {
+        std::cout << "Only forward solutions computed in MRI or head coordinates are acceptable";
+        return false;
+    }
+
+    //
+    qint32 nuse = 0;
+    t_SourceSpace.transform_source_space_to(fwd.coord_frame,fwd.mri_head_t);
+    for(qint32 k = 0; k < t_SourceSpace.size(); ++k)
+        nuse += t_SourceSpace[k].nuse;
+
+    if (nuse != fwd.nsource)
+        throw("Source spaces do not match the forward solution.\n");
+
+    printf("\tSource spaces transformed to the forward solution coordinate frame\n");
+    fwd.src = t_SourceSpace; //not new MNESourceSpace(t_SourceSpace); for sake of speed
+
     return true;
 }
 
 
 //*************************************************************************************************************
 
-bool MNEForwardSolution::read_one(FiffStream* p_pStream, const FiffDirTree& p_Node, MNEForwardSolution& one)
+bool MNEForwardSolution::read_one(FiffStream* p_pStream, const FiffDirTree& p_Node, MNEForwardSolution& one, bool p_bReadData)
 {
     //
     //   Read all interesting stuff for one forward solution
@@ -1717,7 +1756,7 @@ bool MNEForwardSolution::read_one(FiffStream* p_pStream, const FiffDirTree& p_No
 
     one.nchan = *t_pTag->toInt();
 
-    if(p_pStream->read_named_matrix(p_Node, FIFF_MNE_FORWARD_SOLUTION, *one.sol.data()))
+    if(p_pStream->read_named_matrix(p_Node, FIFF_MNE_FORWARD_SOLUTION, *one.sol.data(), p_bReadData))
         one.sol->transpose_named_matrix();
     else
     {
@@ -1727,14 +1766,14 @@ bool MNEForwardSolution::read_one(FiffStream* p_pStream, const FiffDirTree& p_No
         return false;
     }
 
-    if(p_pStream->read_named_matrix(p_Node, FIFF_MNE_FORWARD_SOLUTION_GRAD, *one.sol_grad.data()))
+    if(p_pStream->read_named_matrix(p_Node, FIFF_MNE_FORWARD_SOLUTION_GRAD, *one.sol_grad.data(), p_bReadData))
         one.sol_grad->transpose_named_matrix();
     else
         one.sol_grad->clear();
 
 
-    if (one.sol->data.rows() != one.nchan ||
-            (one.sol->data.cols() != one.nsource && one.sol->data.cols() != 3*one.nsource))
+    if (one.sol->nrow != one.nchan ||
+            (one.sol->ncol != one.nsource && one.sol->ncol != 3*one.nsource))
     {
         p_pStream->device()->close();
         printf("Forward solution matrix has wrong dimensions.\n"); //ToDo: throw error.
@@ -1743,8 +1782,8 @@ bool MNEForwardSolution::read_one(FiffStream* p_pStream, const FiffDirTree& p_No
     }
     if (!one.sol_grad->isEmpty())
     {
-        if (one.sol_grad->data.rows() != one.nchan ||
-                (one.sol_grad->data.cols() != 3*one.nsource && one.sol_grad->data.cols() != 3*3*one.nsource))
+        if (one.sol_grad->nrow != one.nchan ||
+                (one.sol_grad->ncol != 3*one.nsource && one.sol_grad->ncol != 3*3*one.nsource))
         {
             p_pStream->device()->close();
             printf("Forward solution gradient matrix has wrong dimensions.\n"); //ToDo: throw error.
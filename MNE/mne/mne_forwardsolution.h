@@ -265,7 +265,7 @@ public:
     *
     * @return Orientation priors.
     */
-    FiffCov compute_orient_prior(float loose = 0.2);
+    FiffCov compute_orient_prior(float loose = 0.2) const;
 
     //=========================================================================================================
     /**
@@ -435,6 +435,20 @@ public:
     */
     static bool read(QIODevice& p_IODevice, MNEForwardSolution& fwd, bool force_fixed = false, bool surf_ori = false, const QStringList& include = defaultQStringList, const QStringList& exclude = defaultQStringList, bool bExcludeBads = true);
 
+    //=========================================================================================================
+    /**
+    * Reads everything of a forward solution but the gain matrices: measurement info, source spaces (in the
+    * coordinate frame of the forward solution), coordinate transformation, orientation and dimensions. sol and
+    * sol_grad hold dimensions and names only, their data stay empty; the matrix tags are not read. Use it to
+    * inspect a forward solution without loading it.
+    *
+    * @param[in] p_IODevice    A fiff IO device like a fiff QFile or QTCPSocket
+    * @param[out] fwd          The forward solution without gain matrix data
+    *
+    * @return true if succeeded, false otherwise
+    */
+    static bool read_header(QIODevice& p_IODevice, MNEForwardSolution& fwd);
+
     //ToDo readFromStream
 
     //=========================================================================================================
@@ -487,10 +501,27 @@ private:
     * @param[in] p_pStream  The opened fif file to read from
     * @param[in] p_Node     The forward solution node
     * @param[out] one       The read forward solution
+    * @param[in] p_bReadData    If false the gain matrices are not read, only their dimensions and names (optional)
+    *
+    * @return True if succeeded, false otherwise
+    */
+    static bool read_one(FiffStream* p_pStream, const FiffDirTree& p_Node, MNEForwardSolution& one, bool p_bReadData = true);
+
+    //=========================================================================================================
+    /**
+    * The part of read and read_header they share: reads and merges the MEG and EEG solutions, the coordinate
+    * transformation, the measurement info and the source spaces, transformed to the coordinate frame of the
+    * solution. Source orientations and channel selection are left to read.
+    *
+    * @param[in] p_IODevice     A fiff IO device like a fiff QFile or QTCPSocket
+    * @param[out] fwd           The read forward solution
+    * @param[in] p_bReadData    If false the gain matrices are not read, only their dimensions and names
+    * @param[in] bExcludeBads   Whether to read the bad channels
+    * @param[out] p_qListBads   The bad channels, empty if bExcludeBads is false
     *
     * @return True if succeeded, false otherwise
     */
-    static bool read_one(FiffStream* p_pStream, const FiffDirTree& p_Node, MNEForwardSolution& one);
+    static bool read_solution(QIODevice& p_IODevice, MNEForwardSolution& fwd, bool p_bReadData, bool bExcludeBads, QStringList& p_qListBads);
 
 public:
     FiffInfoBase info;                  /**< light weighted measurement info */
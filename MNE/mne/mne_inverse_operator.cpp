@@ -43,6 +43,16 @@
 #include <QFuture>
 #include <QtConcurrent>
 
+#include <limits>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// Eigen INCLUDES
+//=============================================================================================================
+
+#include <Eigen/Eigenvalues>
+
 
 //*************************************************************************************************************
 //=============================================================================================================
@@ -53,6 +63,44 @@ using namespace UTILSLIB;
 using namespace MNELIB;
 
 
+//*************************************************************************************************************
+//=============================================================================================================
+// STATIC HELPERS
+//=============================================================================================================
+
+namespace
+{
+    const qint32 s_iRowNormBlockSize = 512;     // Rows of the eigenleads per task
+
+    //=========================================================================================================
+    /**
+    * A block of rows of which the weighted squared row norms are computed.
+    */
+    struct RowNormBlock
+    {
+        const MatrixXd* pMatrix;        /**< The eigenleads. */
+        const VectorXd* pWeights;       /**< Squared column weights. */
+        VectorXd* pNorms;               /**< Squared row norms, written for the block's rows only. */
+        qint32 iStart;                  /**< First row of the block. */
+        qint32 iRows;                   /**< Number of rows of the block. */
+    };
+
+    //=========================================================================================================
+    /**
+    * Computes sum_j A(k,j)^2 w_j for the rows k of the block, column by column so that the column major eigenleads
+    * are streamed without temporaries.
+    */
+    void computeRowNorms(const RowNormBlock &p_block)
+    {
+        VectorXd::SegmentReturnType t_norms = p_block.pNorms->segment(p_block.iStart, p_block.iRows);
+        t_norms.setZero();
+
+        for(qint32 j = 0; j < p_block.pMatrix->cols(); ++j)
+            t_norms.array() += (*p_block.pWeights)[j] * p_block.pMatrix->col(j).segment(p_block.iStart, p_block.iRows).array().square();
+    }
+}
+
+
 //*************************************************************************************************************
 //=============================================================================================================
 // DEFINE MEMBER METHODS
@@ -136,6 +184,25 @@ MNEInverseOperator::~MNEInverseOperator()
 //*************************************************************************************************************
 
 bool MNEInverseOperator::assemble_kernel(const Label &label, QString method, bool pick_normal, MatrixXd &K, SparseMatrix<double> &noise_norm, QList<VectorXi> &vertno)
+{
+    MatrixXd t_leads;
+    MatrixXd t_trans;
+
+    if(!assemble_kernel_factors(label, method, pick_normal, t_leads, t_trans, noise_norm, vertno))
+        return false;
+
+    K = t_leads*t_trans;
+
+    //store assembled kernel
+    m_K = K;
+
+    return true;
+}
+
+
+//*************************************************************************************************************
+
+bool MNEInverseOperator::assemble_kernel_factors(const Label &label, QString method, bool pick_normal, MatrixXd &leads, MatrixXd &trans, SparseMatrix<double> &noise_norm, QList<VectorXi> &vertno) const
 {
     MatrixXd t_eigen_leads = this->eigen_leads->data;
     MatrixXd t_source_cov = this->source_cov->data;
@@ -168,11 +235,11 @@ bool MNEInverseOperator::assemble_kernel(const Label &label, QString method, boo
                         if(src_sel[i] == it.row())
                             row = i;
                     if(row != -1)
-                        tripletList.push_back(T(it.row(), it.col(), it.value()));
+                        tripletList.push_back(T(row, row, it.value()));
                 }
             }
 
-            noise_norm = SparseMatrix<double>(src_sel.size(),noise_norm.cols());
+            noise_norm = SparseMatrix<double>(src_sel.size(),src_sel.size());
             noise_norm.setFromTriplets(tripletList.begin(), tripletList.end());
         }
 
@@ -193,7 +260,7 @@ bool MNEInverseOperator::assemble_kernel(const Label &label, QString method, boo
         for(qint32 i = 0; i < src_sel.size(); ++i)
         {
             t_eigen_leads.row(i) = t_eigen_leads.row(src_sel[i]);
-            t_source_cov = t_source_cov.row(src_sel[i]);
+            t_source_cov.row(i) = t_source_cov.row(src_sel[i]);
         }
         t_eigen_leads.conservativeResize(src_sel.size(), t_eigen_leads.cols());
         t_source_cov.conservativeResize(src_sel.size(), t_source_cov.cols());
@@ -232,14 +299,27 @@ bool MNEInverseOperator::assemble_kernel(const Label &label, QString method, boo
         t_source_cov.conservativeResize(count, t_source_cov.cols());
     }
 
-    tripletList.clear();
-    tripletList.reserve(reginv.rows());
+    //
+    //   Components with a zero regularized inverse, e.g. the ones removed by the projection, do not contribute
+    //
+    qint32 nComp = 0;
     for(qint32 i = 0; i < reginv.rows(); ++i)
-        tripletList.push_back(T(i, i, reginv(i,0)));
-    SparseMatrix<double> t_reginv(reginv.rows(),reginv.rows());
-    t_reginv.setFromTriplets(tripletList.begin(), tripletList.end());
+        if(reginv(i,0) != 0)
+            ++nComp;
+
+    MatrixXd t_fields(nComp, eigen_fields->data.cols());
+    leads.resize(t_eigen_leads.rows(), nComp);
+    for(qint32 i = 0, j = 0; i < reginv.rows(); ++i)
+    {
+        if(reginv(i,0) != 0)
+        {
+            t_fields.row(j) = reginv(i,0)*eigen_fields->data.row(i);
+            leads.col(j) = t_eigen_leads.col(i);
+            ++j;
+        }
+    }
 
-    MatrixXd trans = t_reginv*eigen_fields->data*whitener*proj;
+    trans = t_fields*whitener*proj;
     //
     //   Transformation into current distributions by weighting the eigenleads
     //   with the weights computed above
@@ -250,31 +330,20 @@ bool MNEInverseOperator::assemble_kernel(const Label &label, QString method, boo
         //     R^0.5 has been already factored in
         //
         printf("(eigenleads already weighted)...");
-        K = t_eigen_leads*trans;
     }
     else
     {
         //
         //     R^0.5 has to factored in
         //
-       printf("(eigenleads need to be weighted)...");
+        printf("(eigenleads need to be weighted)...");
 
-       std::vector<T> tripletList2;
-       tripletList2.reserve(t_source_cov.rows());
-       for(qint32 i = 0; i < t_source_cov.rows(); ++i)
-           tripletList2.push_back(T(i, i, sqrt(t_source_cov(i,0))));
-       SparseMatrix<double> t_sourceCov(t_source_cov.rows(),t_source_cov.rows());
-       t_sourceCov.setFromTriplets(tripletList2.begin(), tripletList2.end());
-
-       K = t_sourceCov*t_eigen_leads*trans;
+        leads = t_source_cov.col(0).cwiseSqrt().asDiagonal()*leads;
     }
 
     if(method.compare("MNE") == 0)
         noise_norm = SparseMatrix<double>();
 
-    //store assembled kernel
-    m_K = K;
-
     return true;
 }
 
@@ -713,35 +782,20 @@ MNEInverseOperator MNEInverseOperator::make_inverse_operator(const FiffInfo &inf
 
     //
     // 5. Compose the depth weight matrix
+    // 6. Compose the source covariance matrix
     //
     FiffCov::SDPtr p_depth_prior;
-    MatrixXd patch_areas;
-    if(depth > 0)
-    {
-        std::cout << "ToDo: patch_areas" << std::endl;
-//        patch_areas = forward.get('patch_areas', None)
-        p_depth_prior = FiffCov::SDPtr(new FiffCov(MNEForwardSolution::compute_depth_prior(gain, gain_info, is_fixed_ori, depth, 10.0, patch_areas, limit_depth_chs)));
-    }
-    else
-    {
-        p_depth_prior->data = MatrixXd::Ones(gain.cols(), gain.cols());
-        p_depth_prior->kind = FIFFV_MNE_DEPTH_PRIOR_COV;
-        p_depth_prior->diag = true;
-        p_depth_prior->dim = gain.cols();
-        p_depth_prior->nfree = 1;
-    }
+    FiffCov::SDPtr p_orient_prior;
+    FiffCov::SDPtr p_source_cov;
+    qint32 p_iMethods;
+    compute_source_cov(forward, gain_info, gain, loose, depth, limit_depth_chs, p_depth_prior, p_orient_prior, p_source_cov, p_iMethods);
 
     // Deal with fixed orientation forward / inverse
-    if(fixed)
+    if(fixed && !is_fixed_ori)
     {
-        if(depth < 0 || depth > 1)
-        {
-            // Convert the depth prior into a fixed-orientation one
-            printf("\tToDo: Picked elements from a free-orientation depth-weighting prior into the fixed-orientation one.\n");
-        }
-        if(!is_fixed_ori)
+        // Convert the depth prior into a fixed-orientation one
+        if(p_depth_prior)
         {
-            // Convert to the fixed orientation forward solution now
             qint32 count = 0;
             for(qint32 i = 2; i < p_depth_prior->data.rows(); i+=3)
             {
@@ -749,135 +803,155 @@ MNEInverseOperator MNEInverseOperator::make_inverse_operator(const FiffInfo &inf
                 ++count;
             }
             p_depth_prior->data.conservativeResize(count, 1);
-
-//            forward = deepcopy(forward)
-            forward.to_fixed_ori();
-            is_fixed_ori = forward.isFixedOrient();
-            forward.prepare_forward(info, p_outNoiseCov, false, gain_info, gain, p_outNoiseCov, whitener, n_nzero);
+            p_depth_prior->dim = count;
         }
-    }
-    printf("\tComputing inverse operator with %d channels.\n", gain_info.ch_names.size());
 
-    //
-    // 6. Compose the source covariance matrix
-    //
-    printf("\tCreating the source covariance matrix\n");
-    FiffCov::SDPtr p_source_cov = p_depth_prior;
+        // Convert to the fixed orientation forward solution now
+        forward.to_fixed_ori();
+        forward.prepare_forward(info, p_outNoiseCov, false, gain_info, gain, p_outNoiseCov, whitener, n_nzero);
 
-    // apply loose orientations
-    FiffCov::SDPtr p_orient_prior;
-    if(!is_fixed_ori)
-    {
-        p_orient_prior = FiffCov::SDPtr(new FiffCov(forward.compute_orient_prior(loose)));
-        p_source_cov->data.array() *= p_orient_prior->data.array();
+        FiffCov::SDPtr t_pNoDepthPrior;
+        compute_source_cov(forward, gain_info, gain, loose, 0.0f, limit_depth_chs, t_pNoDepthPrior, p_orient_prior, p_source_cov, p_iMethods);
+        if(p_depth_prior)
+            p_source_cov = FiffCov::SDPtr(new FiffCov(*p_depth_prior));
     }
+    printf("\tComputing inverse operator with %d channels.\n", gain_info.ch_names.size());
 
     // 7. Apply fMRI weighting (not done)
 
     //
     // 8. Apply the linear projection to the forward solution
     // 9. Apply whitening to the forward computation matrix
-    //
-    printf("\tWhitening the forward solution.\n");
-    gain = whitener*gain;
-
     // 10. Exclude the source space points within the labels (not done)
-
-    //
     // 11. Do appropriate source weighting to the forward computation matrix
+    // 12. Decompose the combined matrix
     //
+    printf("\tWhitening the forward solution and adjusting the source covariance matrix.\n");
+    printf("Computing the decomposition of the whitened and weighted lead field matrix.\n");
+    p_MNEInverseOperator = assemble_inverse_operator(info, forward, gain_info, gain, whitener, n_nzero, p_outNoiseCov, p_depth_prior, p_orient_prior, *p_source_cov, p_iMethods);
+    printf("\tlargest singular value = %f\n", p_MNEInverseOperator.sing.maxCoeff());
 
-    // Adjusting Source Covariance matrix to make trace of G*R*G' equal
-    // to number of sensors.
-    printf("\tAdjusting source covariance matrix.\n");
-    RowVectorXd source_std = p_source_cov->data.array().sqrt().transpose();
-
-    for(qint32 i = 0; i < gain.rows(); ++i)
-        gain.row(i) = gain.row(i).array() * source_std.array();
-
-    double trace_GRGT = (gain * gain.transpose()).trace();//pow(gain.norm(), 2);
-    double scaling_source_cov = (double)n_nzero / trace_GRGT;
+    return p_MNEInverseOperator;
+}
 
-    p_source_cov->data.array() *= scaling_source_cov;
 
-    gain.array() *= sqrt(scaling_source_cov);
+//*************************************************************************************************************
 
-    // now np.trace(np.dot(gain, gain.T)) == n_nzero
-    // logger.info(np.trace(np.dot(gain, gain.T)), n_nzero)
+void MNEInverseOperator::compute_source_cov(const MNEForwardSolution &forward, const FiffInfo &gain_info, const MatrixXd &gain, float loose, float depth, bool limit_depth_chs, FiffCov::SDPtr &p_depth_prior, FiffCov::SDPtr &p_orient_prior, FiffCov::SDPtr &p_source_cov, qint32 &p_iMethods)
+{
+    bool is_fixed_ori = forward.isFixedOrient();
 
     //
-    // 12. Decompose the combined matrix
+    // Depth weighting
     //
-    printf("Computing SVD of whitened and weighted lead field matrix.\n");
-    JacobiSVD<MatrixXd> svd(gain, ComputeThinU | ComputeThinV);
-    std::cout << "ToDo Sorting Necessary?" << std::endl;
-    VectorXd p_sing = svd.singularValues();
-    MatrixXd t_U = svd.matrixU();
-    MNEMath::sort<double>(p_sing, t_U);
-    FiffNamedMatrix::SDPtr p_eigen_fields = FiffNamedMatrix::SDPtr(new FiffNamedMatrix( svd.matrixU().cols(),
-                                                                                        svd.matrixU().rows(),
-                                                                                        defaultQStringList,
-                                                                                        gain_info.ch_names,
-                                                                                        t_U.transpose() ));
-
-    p_sing = svd.singularValues();
-    MatrixXd t_V = svd.matrixV();
-    MNEMath::sort<double>(p_sing, t_V);
-    FiffNamedMatrix::SDPtr p_eigen_leads = FiffNamedMatrix::SDPtr(new FiffNamedMatrix( svd.matrixV().rows(),
-                                                                                       svd.matrixV().cols(),
-                                                                                       defaultQStringList,
-                                                                                       defaultQStringList,
-                                                                                       t_V ));
-    printf("\tlargest singular value = %f\n", p_sing.maxCoeff());
-    printf("\tscaling factor to adjust the trace = %f\n", trace_GRGT);
-
-    qint32 p_nave = 1.0;
-
-    // Handle methods
-    bool has_meg = false;
-    bool has_eeg = false;
+    if(depth > 0)
+    {
+        //ToDo: patch_areas
+        p_depth_prior = FiffCov::SDPtr(new FiffCov(MNEForwardSolution::compute_depth_prior(gain, gain_info, is_fixed_ori, depth, 10.0, defaultConstMatrixXd, limit_depth_chs)));
+        p_source_cov = FiffCov::SDPtr(new FiffCov(*p_depth_prior));
+    }
+    else
+    {
+        p_depth_prior = FiffCov::SDPtr();
+        p_source_cov = FiffCov::SDPtr(new FiffCov());
+        p_source_cov->data = MatrixXd::Ones(gain.cols(), 1);
+        p_source_cov->kind = FIFFV_MNE_DEPTH_PRIOR_COV;
+        p_source_cov->diag = true;
+        p_source_cov->dim = gain.cols();
+        p_source_cov->nfree = 1;
+    }
 
-    RowVectorXd ch_idx(info.chs.size());
-    qint32 count = 0;
-    for(qint32 i = 0; i < info.chs.size(); ++i)
+    //
+    // Loose orientations
+    //
+    if(!is_fixed_ori)
     {
-        if(gain_info.ch_names.contains(info.chs[i].ch_name))
-        {
-            ch_idx[count] = i;
-            ++count;
-        }
+        p_orient_prior = FiffCov::SDPtr(new FiffCov(forward.compute_orient_prior(loose)));
+        p_source_cov->data.array() *= p_orient_prior->data.array();
     }
-    ch_idx.conservativeResize(count);
+    else
+        p_orient_prior = FiffCov::SDPtr();
 
-    for(qint32 i = 0; i < ch_idx.size(); ++i)
+    //
+    // Methods
+    //
+    bool has_meg = false;
+    bool has_eeg = false;
+    for(qint32 i = 0; i < gain_info.chs.size(); ++i)
     {
-        QString ch_type = info.channel_type(ch_idx[i]);
+        QString ch_type = gain_info.channel_type(i);
         if (ch_type == "eeg")
             has_eeg = true;
         if ((ch_type == "mag") || (ch_type == "grad"))
             has_meg = true;
     }
 
-    qint32 p_iMethods;
-
     if(has_eeg && has_meg)
         p_iMethods = FIFFV_MNE_MEG_EEG;
     else if(has_meg)
         p_iMethods = FIFFV_MNE_MEG;
     else
         p_iMethods = FIFFV_MNE_EEG;
+}
 
-    // We set this for consistency with mne C code written inverses
-    if(depth == 0)
-        p_depth_prior = FiffCov::SDPtr();
 
-    p_MNEInverseOperator.eigen_fields = p_eigen_fields;
-    p_MNEInverseOperator.eigen_leads = p_eigen_leads;
-    p_MNEInverseOperator.sing = p_sing;
-    p_MNEInverseOperator.nave = p_nave;
+//*************************************************************************************************************
+
+MNEInverseOperator MNEInverseOperator::assemble_inverse_operator(const FiffInfo &info, const MNEForwardSolution &forward, const FiffInfo &gain_info, const MatrixXd &gain, const MatrixXd &whitener, qint32 n_nzero, const FiffCov &p_noise_cov, const FiffCov::SDPtr &p_depth_prior, const FiffCov::SDPtr &p_orient_prior, const FiffCov &p_source_cov, qint32 p_iMethods)
+{
+    //
+    // Whiten and weight the lead field, adjust the source covariance to make trace(G*R*G') equal to the rank
+    //
+    FiffCov::SDPtr t_pSourceCov(new FiffCov(p_source_cov));
+    VectorXd source_std = t_pSourceCov->data.col(0).array().sqrt();
+
+    MatrixXd t_matGain = whitener * gain;
+    t_matGain = t_matGain * source_std.asDiagonal();
+
+    double trace_GRGT = t_matGain.squaredNorm();
+    double scaling_source_cov = (double)n_nzero / trace_GRGT;
+
+    t_pSourceCov->data.array() *= scaling_source_cov;
+    t_matGain.array() *= sqrt(scaling_source_cov);
+
+    //
+    // Decompose G = U*S*V' via the small channel x channel matrix G*G' = U*S^2*U', V = G'*U*S^-1
+    //
+    SelfAdjointEigenSolver<MatrixXd> t_eig(t_matGain * t_matGain.transpose());
+    qint32 n_chan = t_matGain.rows();
+    // eigenvalues below the round-off of G*G' belong to the null space of the projection
+    double t_dTol = t_eig.eigenvalues().maxCoeff() * n_chan * std::numeric_limits<double>::epsilon();
+    VectorXd t_vecSing(n_chan);
+    MatrixXd t_matU(n_chan, n_chan);
+    for(qint32 i = 0; i < n_chan; ++i)
+    {
+        // eigenvalues are ascending, singular values descending
+        double t_dEig = t_eig.eigenvalues()[n_chan-1-i];
+        t_vecSing[i] = t_dEig > t_dTol ? sqrt(t_dEig) : 0.0;
+        t_matU.col(i) = t_eig.eigenvectors().col(n_chan-1-i);
+    }
+
+    MatrixXd t_matV = t_matGain.transpose() * t_matU;
+    for(qint32 i = 0; i < n_chan; ++i)
+    {
+        if(t_vecSing[i] > 0)
+            t_matV.col(i) /= t_vecSing[i];
+        else
+            t_matV.col(i).setZero();
+    }
+
+    //
+    // Assemble
+    //
+    MNEInverseOperator p_MNEInverseOperator;
+
+    p_MNEInverseOperator.eigen_fields = FiffNamedMatrix::SDPtr(new FiffNamedMatrix(n_chan, n_chan, defaultQStringList, gain_info.ch_names, t_matU.transpose()));
+    p_MNEInverseOperator.eigen_leads = FiffNamedMatrix::SDPtr(new FiffNamedMatrix(t_matV.rows(), t_matV.cols(), defaultQStringList, defaultQStringList, t_matV));
+    p_MNEInverseOperator.sing = t_vecSing;
+    p_MNEInverseOperator.nave = 1;
     p_MNEInverseOperator.depth_prior = p_depth_prior;
-    p_MNEInverseOperator.source_cov = p_source_cov;
-    p_MNEInverseOperator.noise_cov = FiffCov::SDPtr(new FiffCov(p_outNoiseCov));
+    p_MNEInverseOperator.source_cov = t_pSourceCov;
+    p_MNEInverseOperator.noise_cov = FiffCov::SDPtr(new FiffCov(p_noise_cov));
     p_MNEInverseOperator.orient_prior = p_orient_prior;
     p_MNEInverseOperator.projs = info.projs;
     p_MNEInverseOperator.eigen_leads_weighted = false;
@@ -950,18 +1024,19 @@ MNEInverseOperator MNEInverseOperator::prepare_inverse_operator(qint32 nave ,flo
         //
         nnzero = 0;
 
+        VectorXd t_vecScale = VectorXd::Zero(inv.noise_cov->dim);
         for (k = ncomp; k < inv.noise_cov->dim; ++k)
         {
             if (inv.noise_cov->eig[k] > 0)
             {
-                inv.whitener(k,k) = 1.0/sqrt(inv.noise_cov->eig[k]);
+                t_vecScale[k] = 1.0/sqrt(inv.noise_cov->eig[k]);
                 ++nnzero;
             }
         }
         //
-        //   Rows of eigvec are the eigenvectors
+        //   Rows of eigvec are the eigenvectors, scale them instead of a dense diagonal product
         //
-        inv.whitener *= inv.noise_cov->eigvec;
+        inv.whitener = t_vecScale.asDiagonal() * inv.noise_cov->eigvec;
         printf("\tCreated the whitener using a full noise covariance matrix (%d small eigenvalues omitted)\n", inv.noise_cov->dim - nnzero);
     }
     else
@@ -979,7 +1054,6 @@ MNEInverseOperator MNEInverseOperator::prepare_inverse_operator(qint32 nave ,flo
     //
     if (dSPM || sLORETA)
     {
-        VectorXd noise_norm = VectorXd::Zero(inv.eigen_leads->nrow);
         VectorXd noise_weight;
         if (dSPM)
         {
@@ -992,33 +1066,36 @@ MNEInverseOperator MNEInverseOperator::prepare_inverse_operator(qint32 nave ,flo
            VectorXd tmp = (VectorXd::Constant(inv.sing.size(), 1) + inv.sing.cwiseProduct(inv.sing)/lambda2);
            noise_weight = inv.reginv.cwiseProduct(tmp.cwiseSqrt());
         }
-        VectorXd one;
-        if (inv.eigen_leads_weighted)
-        {
-           for (k = 0; k < inv.eigen_leads->nrow; ++k)
-           {
-              one = inv.eigen_leads->data.block(k,0,1,inv.eigen_leads->data.cols()).cwiseProduct(noise_weight);
-              noise_norm[k] = sqrt(one.dot(one));
-           }
-        }
-        else
+
+        //
+        //   Squared row norms of the weighted eigenleads, in parallel blocks of rows
+        //
+        const MatrixXd &t_matLeads = inv.eigen_leads->data;
+        VectorXd t_vecWeights = noise_weight.cwiseProduct(noise_weight);
+        VectorXd noise_norm(t_matLeads.rows());
+
+        QVector<RowNormBlock> t_qVecBlocks;
+        for(qint32 k = 0; k < t_matLeads.rows(); k += s_iRowNormBlockSize)
         {
-//            qDebug() << 32;
-            double c;
-            for (k = 0; k < inv.eigen_leads->nrow; ++k)
-            {
-//                qDebug() << 321;
-                c = sqrt(inv.source_cov->data(k,0));
-//                qDebug() << 322;
-//                qDebug() << "inv.eigen_leads->data" << inv.eigen_leads->data.rows() << "x" << inv.eigen_leads->data.cols();
-//                qDebug() << "noise_weight" << noise_weight.rows() << "x" << noise_weight.cols();
-                one = c*(inv.eigen_leads->data.row(k).transpose()).cwiseProduct(noise_weight);//ToDo eigenleads data -> pointer
-                noise_norm[k] = sqrt(one.dot(one));
-//                qDebug() << 324;
-            }
+            RowNormBlock t_block;
+            t_block.pMatrix = &t_matLeads;
+            t_block.pWeights = &t_vecWeights;
+            t_block.pNorms = &noise_norm;
+            t_block.iStart = k;
+            t_block.iRows = qMin(s_iRowNormBlockSize, (qint32)t_matLeads.rows() - k);
+            t_qVecBlocks.append(t_block);
         }
 
-//        qDebug() << 4;
+        if(t_qVecBlocks.size() > 1)
+            QtConcurrent::blockingMap(t_qVecBlocks, computeRowNorms);
+        else if(t_qVecBlocks.size() == 1)
+            computeRowNorms(t_qVecBlocks[0]);
+
+        //
+        //   R^0.5 has to be factored in
+        //
+        if (!inv.eigen_leads_weighted)
+            noise_norm.array() *= inv.source_cov->data.col(0).array();
 
         //
         //   Compute the final result
@@ -1034,28 +1111,22 @@ MNEInverseOperator MNEInverseOperator::prepare_inverse_operator(qint32 nave ,flo
             //   Even in this case return only one noise-normalization factor
             //   per source location
             //
-            VectorXd* t = MNEMath::combine_xyz(noise_norm.transpose());
-            noise_norm_new = t->cwiseSqrt();//double otherwise values are getting too small
-            delete t;
-            //
-            //   This would replicate the same value on three consequtive
-            //   entries
-            //
-            //   noise_norm = kron(sqrt(mne_combine_xyz(noise_norm)),ones(3,1));
+            noise_norm_new.resize(noise_norm.size()/3);
+            for(qint32 i = 0; i < noise_norm_new.size(); ++i)
+                noise_norm_new[i] = sqrt(noise_norm[3*i] + noise_norm[3*i+1] + noise_norm[3*i+2]);
         }
-        VectorXd vOnes = VectorXd::Ones(noise_norm_new.size());
-        VectorXd tmp = vOnes.cwiseQuotient(noise_norm_new.cwiseAbs());
-//        if(inv.noisenorm)
-//            delete inv.noisenorm;
-
-        typedef Eigen::Triplet<double> T;
-        std::vector<T> tripletList;
-        tripletList.reserve(noise_norm_new.size());
-        for(qint32 i = 0; i < noise_norm_new.size(); ++i)
-            tripletList.push_back(T(i, i, tmp[i]));
+        else
+            noise_norm_new = noise_norm.cwiseSqrt();
 
-        inv.noisenorm = SparseMatrix<double>(noise_norm_new.size(),noise_norm_new.size());
-        inv.noisenorm.setFromTriplets(tripletList.begin(), tripletList.end());
+        //
+        //   The noise normalization is diagonal, fill the compressed storage directly
+        //
+        qint32 t_iNumSources = noise_norm_new.size();
+        inv.noisenorm = SparseMatrix<double>(t_iNumSources, t_iNumSources);
+        inv.noisenorm.reserve(VectorXi::Constant(t_iNumSources, 1));
+        for(qint32 i = 0; i < t_iNumSources; ++i)
+            inv.noisenorm.insert(i, i) = 1.0/fabs(noise_norm_new[i]);
+        inv.noisenorm.makeCompressed();
 
         printf("[done]\n");
     }
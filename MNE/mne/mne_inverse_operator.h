@@ -222,6 +222,26 @@ public:
     */
     bool assemble_kernel(const Label &label, QString method, bool pick_normal, MatrixXd &K, SparseMatrix<double> &noise_norm, QList<VectorXi> &vertno);
 
+    //=========================================================================================================
+    /**
+    * Assembles the kernel in factored form K = leads * trans, without forming K. trans is
+    * diag(reginv) * eigen_fields * whitener * proj restricted to the components with a nonzero regularized
+    * inverse, leads the matching columns of the eigenleads weighted with R^0.5. The rank of both factors is at
+    * most the number of channels, so applying them right to left, leads * (trans * data), never needs the
+    * sources x channels kernel.
+    *
+    * @param[in] label          labels.
+    * @param[in] method         The applied normals. ("MNE" | "dSPM" | "sLORETA")
+    * @param[in] pick_normal    Pick normals.
+    * @param[out] leads         Weighted eigenleads, sources (x3 for free orientations) x components.
+    * @param[out] trans         Data transformation, components x channels.
+    * @param[out] noise_norm    Noise normals.
+    * @param[out] vertno        Vertices of the hemispheres.
+    *
+    * @return true when successful, false otherwise
+    */
+    bool assemble_kernel_factors(const Label &label, QString method, bool pick_normal, MatrixXd &leads, MatrixXd &trans, SparseMatrix<double> &noise_norm, QList<VectorXi> &vertno) const;
+
     //=========================================================================================================
     /**
     * Check that channels in inverse operator are measurements.
@@ -284,6 +304,47 @@ public:
     */
     static MNEInverseOperator make_inverse_operator(const FiffInfo &info, MNEForwardSolution forward, const FiffCov& p_noise_cov, float loose = 0.2f, float depth = 0.8f, bool fixed = false, bool limit_depth_chs = true);
 
+    //=========================================================================================================
+    /**
+    * Composes the source covariance from the depth and orientation priors and determines the methods. This is
+    * the part of make_inverse_operator which does not depend on the noise covariance, it can be reused as long
+    * as the channel selection of prepare_forward stays the same.
+    *
+    * @param[in] forward            Forward operator.
+    * @param[in] gain_info          The measurement info of the selected channels, as returned by MNEForwardSolution::prepare_forward.
+    * @param[in] gain               The gain matrix of the selected channels, as returned by MNEForwardSolution::prepare_forward.
+    * @param[in] loose              float in [0, 1]. Value that weights the source variances of the dipole components defining the tangent space of the cortical surfaces.
+    * @param[in] depth              float in [0, 1]. Depth weighting coefficients. If 0, no depth weighting is performed.
+    * @param[in] limit_depth_chs    If True, use only grad channels in depth weighting.
+    * @param[out] p_depth_prior     The depth prior, NULL if depth is 0.
+    * @param[out] p_orient_prior    The orientation prior, NULL if the forward operator has fixed orientation.
+    * @param[out] p_source_cov      The source covariance, not yet adjusted to the whitened gain.
+    * @param[out] p_iMethods        FIFFV_MNE_MEG, FIFFV_MNE_EEG or FIFFV_MNE_MEG_EEG.
+    */
+    static void compute_source_cov(const MNEForwardSolution &forward, const FiffInfo &gain_info, const MatrixXd &gain, float loose, float depth, bool limit_depth_chs, FiffCov::SDPtr &p_depth_prior, FiffCov::SDPtr &p_orient_prior, FiffCov::SDPtr &p_source_cov, qint32 &p_iMethods);
+
+    //=========================================================================================================
+    /**
+    * Whitens and weights the gain matrix, decomposes it and assembles the inverse operator. This is the part of
+    * make_inverse_operator which depends on the noise covariance. The decomposition G = U*S*V' is computed from
+    * the channel x channel matrix G*G'.
+    *
+    * @param[in] info               The measurement info, provides the projections and the bad channels.
+    * @param[in] forward            Forward operator.
+    * @param[in] gain_info          The measurement info of the selected channels, as returned by MNEForwardSolution::prepare_forward.
+    * @param[in] gain               The gain matrix of the selected channels.
+    * @param[in] whitener           The whitener, as returned by MNEForwardSolution::prepare_forward.
+    * @param[in] n_nzero            Number of non-zero eigenvalues of the noise covariance.
+    * @param[in] p_noise_cov        The noise covariance, as returned by MNEForwardSolution::prepare_forward.
+    * @param[in] p_depth_prior      The depth prior, NULL if none.
+    * @param[in] p_orient_prior     The orientation prior, NULL if none.
+    * @param[in] p_source_cov       The source covariance of compute_source_cov, it is copied before the trace adjustment.
+    * @param[in] p_iMethods         FIFFV_MNE_MEG, FIFFV_MNE_EEG or FIFFV_MNE_MEG_EEG.
+    *
+    * @return the assembled inverse operator
+    */
+    static MNEInverseOperator assemble_inverse_operator(const FiffInfo &info, const MNEForwardSolution &forward, const FiffInfo &gain_info, const MatrixXd &gain, const MatrixXd &whitener, qint32 n_nzero, const FiffCov &p_noise_cov, const FiffCov::SDPtr &p_depth_prior, const FiffCov::SDPtr &p_orient_prior, const FiffCov &p_source_cov, qint32 p_iMethods);
+
     //=========================================================================================================
     /**
     * mne_prepare_inverse_operator
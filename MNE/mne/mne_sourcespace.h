@@ -230,6 +230,14 @@ public:
     */
     inline qint32 size() const;
 
+    //=========================================================================================================
+    /**
+    * Appends a hemisphere, e.g. to assemble a source space which was not read from a file.
+    *
+    * @param[in] p_Hemisphere   The hemisphere to append (lh first, then rh)
+    */
+    inline void append(const MNEHemisphere &p_Hemisphere);
+
     //=========================================================================================================
     /**
     * ### MNE toolbox root function ###: Implementation of the mne_transform_source_space_to function
@@ -347,6 +355,14 @@ inline qint32 MNESourceSpace::size() const
     return m_qListHemispheres.size();
 }
 
+
+//*************************************************************************************************************
+
+inline void MNESourceSpace::append(const MNEHemisphere &p_Hemisphere)
+{
+    m_qListHemispheres.append(p_Hemisphere);
+}
+
 } // NAMESPACE
 
 
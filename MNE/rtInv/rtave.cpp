@@ -78,6 +78,15 @@ RtAve::RtAve(quint32 numAverages, quint32 p_iPreStimSamples, quint32 p_iPostStim
 , m_pFiffInfo(p_pFiffInfo)
 , m_bIsRunning(false)
 , m_bAutoAspect(true)
+, m_iTriggerChannelIdx(-1)
+, m_iRingSamples(0)
+, m_iFirstValidSample(0)
+, m_iBlockSize(0)
+, m_iLastCode(0)
+, m_iPendingHead(0)
+, m_iPendingCount(0)
+, m_iIgnoredOnsets(0)
+, m_iDroppedOnsets(0)
 {
     qRegisterMetaType<FiffEvoked::SPtr>("FiffEvoked::SPtr");
 }
@@ -106,169 +115,169 @@ void RtAve::append(const MatrixXd &p_DataSegment)
 
 //*************************************************************************************************************
 
-void RtAve::assemblePostStimulus(const QList<QPair<QList<qint32>, MatrixXd> > &p_qListRawMatBuf, qint32 p_iStimIdx)
+void RtAve::init(qint32 p_iNumChannels, qint32 p_iBlockSize)
 {
-    if(m_iPreStimSamples > 0)
-    {
-        // middle of the assembled buffers
-        qint32 t_iMidIdx = p_qListRawMatBuf.size()/2;
-
-        qint32 nrows = p_qListRawMatBuf[t_iMidIdx].second.rows();
-        qint32 ncols = p_qListRawMatBuf[t_iMidIdx].second.cols();
-
-        //Stimulus channel row
-        qint32 t_iRowIdx = m_qListStimChannelIdcs[p_iStimIdx];
-
-//        std::cout << t_iRowIdx
-//                     << ": " << p_qListRawMatBuf[t_iMidIdx].second.row(t_iRowIdx) << std::endl;
+    m_iBlockSize = p_iBlockSize;
 
-        qint32 nSampleCount = 0;
+    // one epoch plus two blocks: onsets of the same block complete at most one block apart
+    m_matRing = MatrixXd::Zero(p_iNumChannels, m_iPreStimSamples + m_iPostStimSamples + 2*p_iBlockSize);
+    m_iRingSamples = 0;
+    m_iFirstValidSample = 0;
 
-        MatrixXd t_matPostStim(nrows, m_iPostStimSamples);
-        qint32 t_curBufIdx = t_iMidIdx;
+    m_iLastCode = 0;
 
-        qint32 t_iSize = 0;
+    m_qVecPendingOnset.fill(0, 256);
+    m_qVecPendingCode.fill(0, 256);
+    m_iPendingHead = 0;
+    m_iPendingCount = 0;
 
-        qint32 pos = 0;
-        p_qListRawMatBuf[t_iMidIdx].second.row(t_iRowIdx).maxCoeff(&pos);
-//        std::cout << "Position: " << pos << std::endl;
-
-        //
-        // assemble poststimulus
-        //
+    // one slot per code, the epochs of a code are allocated at its first trigger
+    m_qVecCodeAverage.resize(MaxTriggerCode + 1);
+    for(qint32 i = 0; i < m_qVecCodeAverage.size(); ++i)
+    {
+        m_qVecCodeAverage[i].qVecEpochs.clear();
+        m_qVecCodeAverage[i].iHead = 0;
+        m_qVecCodeAverage[i].iCount = 0;
+    }
+}
 
-        // start from the stimulus itself
-        if(pos > 0)
-        {
-            t_iSize = ncols - pos;
-            if(t_iSize <= m_iPostStimSamples)
-            {
-                t_matPostStim.block(0, 0, nrows, t_iSize) = p_qListRawMatBuf[t_iMidIdx].second.block(0, pos, nrows, t_iSize);
-                nSampleCount += t_iSize;
 
-//                qDebug() << "t_matPostStim.block" << nSampleCount;
-            }
-            else
-            {
-                t_matPostStim.block(0, 0, nrows, m_iPostStimSamples) = p_qListRawMatBuf[t_iMidIdx].second.block(0, pos, nrows, m_iPostStimSamples);
-                nSampleCount = m_iPostStimSamples;
+//*************************************************************************************************************
 
-//                qDebug() << "t_matPostStim.block" << nSampleCount;
-            }
+void RtAve::appendBlock(const MatrixXd &p_matBlock)
+{
+    qint32 nrows = p_matBlock.rows();
+    qint32 ncols = p_matBlock.cols();
+    qint32 nRing = m_matRing.cols();
 
-            ++t_curBufIdx;
-        }
+    //
+    // Store
+    //
+    qint32 iPos = (qint32)(m_iRingSamples % nRing);
+    qint32 nFirst = ncols < nRing - iPos ? ncols : nRing - iPos;
+    m_matRing.block(0, iPos, nrows, nFirst) = p_matBlock.leftCols(nFirst);
+    if(nFirst < ncols)
+        m_matRing.leftCols(ncols - nFirst) = p_matBlock.rightCols(ncols - nFirst);
 
-        // remaining samples
-        while(nSampleCount < m_iPostStimSamples)
+    //
+    // Detect Stimuli - changes of the trigger code, the first sample is compared with the last one of the
+    // previous block
+    //
+    qint32 nPending = m_qVecPendingOnset.size();
+    if(m_iTriggerChannelIdx >= 0 || !m_qListStimChannelIdcs.isEmpty())
+    {
+        qint32 t_iLast = m_iLastCode;
+        for(qint32 j = 0; j < ncols; ++j)
         {
-            t_iSize = m_iPostStimSamples-nSampleCount;
-
-            if(ncols <= t_iSize)
-            {
-                t_matPostStim.block(0, nSampleCount, nrows, ncols) = p_qListRawMatBuf[t_curBufIdx].second.block(0, 0, nrows, ncols);
-                nSampleCount += ncols;
-            }
-            else
+            qint32 t_iCode = triggerCode(p_matBlock, j);
+            if(t_iCode != t_iLast && t_iCode > 0)
             {
-                t_matPostStim.block(0, nSampleCount, nrows, t_iSize) = p_qListRawMatBuf[t_curBufIdx].second.block(0, 0, nrows, t_iSize);
-                nSampleCount = m_iPostStimSamples;
+                if(t_iCode > MaxTriggerCode)
+                {
+                    qint32 n = m_iIgnoredOnsets.fetchAndAddRelaxed(1) + 1;
+                    if(n == 1 || n % 100 == 0)
+                        qWarning("RtAve: %d onsets ignored, last code %d exceeds %d", n, t_iCode, MaxTriggerCode);
+                }
+                else if(m_iPendingCount == nPending)
+                {
+                    qint32 n = m_iDroppedOnsets.fetchAndAddRelaxed(1) + 1;
+                    if(n == 1 || n % 100 == 0)
+                        qWarning("RtAve: %d onsets dropped, more than %d onsets are waiting for their post stimulus samples", n, nPending);
+                }
+                else
+                {
+                    qint32 k = (m_iPendingHead + m_iPendingCount) % nPending;
+                    m_qVecPendingOnset[k] = m_iRingSamples + j;
+                    m_qVecPendingCode[k] = t_iCode;
+                    ++m_iPendingCount;
+                }
             }
-
-            ++t_curBufIdx;
-
-//            qDebug() << "Sample count" << nSampleCount;
+            t_iLast = t_iCode;
         }
-
-        //
-        //Store in right post stimulus buffer vector
-        //
-        m_qListQVectorPostStimBuf[p_iStimIdx].append(t_matPostStim);
+        m_iLastCode = t_iLast;
     }
+
+    m_iRingSamples += ncols;
 }
 
 
 //*************************************************************************************************************
 
-void RtAve::assemblePreStimulus(const QList<QPair<QList<qint32>, MatrixXd> > &p_qListRawMatBuf, qint32 p_iStimIdx)
+void RtAve::addEpoch(qint32 p_iCode, qint64 p_iOnset)
 {
-    if(m_iPreStimSamples > 0)
-    {
-        // middle of the assembled buffers
-        qint32 t_iMidIdx = p_qListRawMatBuf.size()/2;
+    qint32 nrows = m_matRing.rows();
+    qint32 nRing = m_matRing.cols();
+    qint32 nSamples = m_iPreStimSamples + m_iPostStimSamples;
 
-        qint32 nrows = p_qListRawMatBuf[t_iMidIdx].second.rows();
-        qint32 ncols = p_qListRawMatBuf[t_iMidIdx].second.cols();
+    // not enough pre stimulus samples recorded, already overwritten or spanning lost blocks
+    qint64 iStart = p_iOnset - m_iPreStimSamples;
+    if(iStart < m_iFirstValidSample || iStart < m_iRingSamples - nRing)
+        return;
 
-        //Stimulus channel row
-        qint32 t_iRowIdx = m_qListStimChannelIdcs[p_iStimIdx];
-
-//        std::cout << t_iRowIdx
-//                     << ": " << p_qListRawMatBuf[t_iMidIdx].second.row(t_iRowIdx) << std::endl;
-
-        qint32 nSampleCount = m_iPreStimSamples;
+    CodeAverage &t_ave = m_qVecCodeAverage[p_iCode];
+    if(t_ave.qVecEpochs.isEmpty())
+    {
+        t_ave.qVecEpochs = QVector<MatrixXd>(m_iNumAverages > 0 ? m_iNumAverages : 1, MatrixXd::Zero(nrows, nSamples));
+        t_ave.matSum = MatrixXd::Zero(nrows, nSamples);
+        t_ave.iHead = 0;
+        t_ave.iCount = 0;
+    }
 
-        MatrixXd t_matPreStim(nrows, m_iPreStimSamples);
-        qint32 t_curBufIdx = t_iMidIdx;
+    MatrixXd &t_matEpoch = t_ave.qVecEpochs[t_ave.iHead];
+    if(t_ave.iCount == t_ave.qVecEpochs.size())
+        t_ave.matSum -= t_matEpoch;
+    else
+        ++t_ave.iCount;
 
-        qint32 t_iStart = 0;
+    qint32 iPos = (qint32)(iStart % nRing);
+    qint32 nFirst = nSamples < nRing - iPos ? nSamples : nRing - iPos;
+    t_matEpoch.leftCols(nFirst) = m_matRing.block(0, iPos, nrows, nFirst);
+    if(nFirst < nSamples)
+        t_matEpoch.rightCols(nSamples - nFirst) = m_matRing.leftCols(nSamples - nFirst);
 
-        qint32 pos = 0;
-        p_qListRawMatBuf[t_iMidIdx].second.row(t_iRowIdx).maxCoeff(&pos);
-//        std::cout << "Position: " << pos << std::endl;
+    t_ave.matSum += t_matEpoch;
+    t_ave.iHead = (t_ave.iHead + 1) % t_ave.qVecEpochs.size();
+}
 
-        //
-        // assemble prestimulus
-        //
 
-        // start from the stimulus itself
-        if(pos > 0)
-        {
-            t_iStart = m_iPreStimSamples - pos;
-            if(t_iStart >= 0)
-            {
-                t_matPreStim.block(0, t_iStart, nrows, pos) = p_qListRawMatBuf[t_iMidIdx].second.block(0, 0, nrows, pos);
-                nSampleCount -= pos;
+//*************************************************************************************************************
 
-//                qDebug() << "t_matPreStim.block" << nSampleCount;
-            }
-            else
-            {
-                t_matPreStim.block(0, 0, nrows, m_iPreStimSamples) = p_qListRawMatBuf[t_iMidIdx].second.block(0, -t_iStart, nrows, m_iPreStimSamples);
-                nSampleCount = 0;
+void RtAve::attach(BroadcastMatrixBuffer<double>::SPtr p_pBroadcastBuffer, BroadcastMatrixBuffer<double>::ReaderPolicy p_policy)
+{
+    m_pRawReader.clear();
+    m_pBroadcastBuffer = p_pBroadcastBuffer;
+    if(m_pBroadcastBuffer)
+        m_pRawReader = BroadcastMatrixBuffer<double>::Reader::SPtr(new BroadcastMatrixBuffer<double>::Reader(m_pBroadcastBuffer.data(), p_policy));
+}
 
-//                qDebug() << "t_matPreStim.block" << nSampleCount;
-            }
 
-            --t_curBufIdx;
-        }
+//*************************************************************************************************************
 
-        // remaining samples
-        while(nSampleCount > 0)
-        {
-            t_iStart = nSampleCount - ncols;
+quint64 RtAve::dropped() const
+{
+    return m_pRawReader ? m_pRawReader->dropped() : 0;
+}
 
-            if(t_iStart >= 0)
-            {
-                t_matPreStim.block(0, t_iStart, nrows, ncols) = p_qListRawMatBuf[t_curBufIdx].second.block(0, 0, nrows, ncols);
-                nSampleCount -= ncols;
-            }
-            else
-            {
-                t_matPreStim.block(0, 0, nrows, nSampleCount) = p_qListRawMatBuf[t_curBufIdx].second.block(0, -t_iStart, nrows, nSampleCount);
-                nSampleCount = 0;
-            }
 
-            --t_curBufIdx;
+//*************************************************************************************************************
 
-//            qDebug() << "Sample count" << nSampleCount;
-        }
+bool RtAve::readSegment(MatrixXd &p_matSegment, qint64 &p_iTimestamp)
+{
+    if(m_pRawReader)
+    {
+        bool t_bRead = m_pRawReader->pop(p_matSegment);
+        p_iTimestamp = m_pRawReader->timestamp();
+        return t_bRead;
+    }
 
-        //
-        //Store in right pre stimulus buffer vector
-        //
-        m_qListQVectorPreStimBuf[p_iStimIdx].append(t_matPreStim);
+    if(m_pRawMatrixBuffer)
+    {
+        p_matSegment = m_pRawMatrixBuffer->pop();
+        p_iTimestamp = -1;
+        return true;
     }
+
+    return false;
 }
 
 
@@ -277,8 +286,14 @@ void RtAve::assemblePreStimulus(const QList<QPair<QList<qint32>, MatrixXd> > &p_
 bool RtAve::stop()
 {
     m_bIsRunning = false;
+    if(m_pRawReader)
+        m_pRawReader->release();
     QThread::wait();
 
+    // a released reader stays released, attach a fresh one for the next start()
+    if(m_pRawReader)
+        attach(m_pBroadcastBuffer, m_pRawReader->policy());
+
     return true;
 }
 
@@ -290,43 +305,25 @@ void RtAve::run()
     m_bIsRunning = true;
 
 
-    //
-    // Inits & Clears
-    //
-    quint32 t_nSamplesPerBuf = 0;
-    QList<QPair<QList<qint32>, MatrixXd> > t_qListRawMatBuf;
-
-    FiffEvoked::SPtr evoked(new FiffEvoked());
-    VectorXd mu;
     qint32 i = 0;
-    qint32 j = 0;
-
-    m_qListQVectorPreStimBuf.clear();
-    m_qListQVectorPostStimBuf.clear();
-    m_qListPreStimAve.clear();
-    m_qListPostStimAve.clear();
-    m_qListStimAve.clear();
 
     //
-    // get num stim channels
+    // get the trigger channel, or the stim channels to compose the code of
     //
+    m_iTriggerChannelIdx = -1;
     m_qListStimChannelIdcs.clear();
-    MatrixXd t_mat;
-    QVector<MatrixXd> t_qVecMat;
     for(i = 0; i < m_pFiffInfo->nchan; ++i)
     {
-        if(m_pFiffInfo->chs[i].kind == FIFFV_STIM_CH && (m_pFiffInfo->chs[i].ch_name != QString("STI 014")))
-        {
-            m_qListStimChannelIdcs.append(i);
+        if(m_pFiffInfo->chs[i].kind != FIFFV_STIM_CH)
+            continue;
 
-            m_qListQVectorPreStimBuf.push_back(t_qVecMat);
-            m_qListQVectorPostStimBuf.push_back(t_qVecMat);
-            m_qListPreStimAve.push_back(t_mat);
-            m_qListPostStimAve.push_back(t_mat);
-            m_qListStimAve.push_back(t_mat);
-        }
+        if(m_pFiffInfo->chs[i].ch_name == QString("STI 014"))
+            m_iTriggerChannelIdx = i;
+        else
+            m_qListStimChannelIdcs.append(i);
     }
 
+    m_iBlockSize = 0;
 
     float T = 1/m_pFiffInfo->sfreq;
 
@@ -367,145 +364,68 @@ void RtAve::run()
     t_stimEvoked.last = t_stimEvoked.times[t_stimEvoked.times.size()-1];
 
 
-    qint32 count = 0;
+    MatrixXd rawSegment;
+    qint64 iTimestamp;
+    quint64 t_iDropped = 0;
 
     //Enter the main loop
     while(m_bIsRunning)
     {
-        if(m_pRawMatrixBuffer)
+        //
+        // Acquire Data
+        //
+        if(!readSegment(rawSegment, iTimestamp))
+            continue;
+
+        Tracer::Scope trace("RtAve", iTimestamp);
+
+        if(rawSegment.cols() != m_iBlockSize || rawSegment.rows() != m_matRing.rows())
+            init(rawSegment.rows(), rawSegment.cols());
+
+        // a Skip reader lost blocks before this one, epochs reaching back before it are incomplete
+        if(m_pRawReader && m_pRawReader->dropped() != t_iDropped)
         {
-            //
-            // Acquire Data
-            //
-            MatrixXd rawSegment = m_pRawMatrixBuffer->pop();
-            if(t_nSamplesPerBuf == 0)
-                t_nSamplesPerBuf = rawSegment.cols();
+            t_iDropped = m_pRawReader->dropped();
+            m_iFirstValidSample = m_iRingSamples;
+        }
 
-            ++count;
+        appendBlock(rawSegment);
 
-            //
-            // Detect Stimuli
-            //
-            QList<qint32> t_qListStimuli;
-            for(i = 0; i < m_qListStimChannelIdcs.size(); ++i)
-            {
-                qint32 idx = m_qListStimChannelIdcs[i];
-                RowVectorXi stimSegment = rawSegment.row(idx).cast<int>();
-                int iMax = stimSegment.maxCoeff();
+        //
+        // Average the epochs whose post stimulus samples are complete
+        //
+        while(m_iPendingCount > 0 && m_qVecPendingOnset[m_iPendingHead] + m_iPostStimSamples <= m_iRingSamples)
+        {
+            qint32 t_iCode = m_qVecPendingCode[m_iPendingHead];
+            qint64 t_iOnset = m_qVecPendingOnset[m_iPendingHead];
+            m_iPendingHead = (m_iPendingHead + 1) % m_qVecPendingOnset.size();
+            --m_iPendingCount;
 
-                if(iMax > 0)
-                    t_qListStimuli.append(i);
-            }
+            addEpoch(t_iCode, t_iOnset);
+
+            //if averages are available -> buffers are filled
+            const CodeAverage &t_ave = m_qVecCodeAverage[t_iCode];
+            if(t_ave.iCount < m_iNumAverages)
+                continue;
 
             //
-            // Store
+            // Emit evoked
             //
-            t_qListRawMatBuf.push_back(qMakePair(t_qListStimuli, rawSegment));
+            FiffEvoked::SPtr t_pEvokedStim(new FiffEvoked(t_stimEvoked));
+            t_pEvokedStim->comment = QString("Code %1").arg(t_iCode);
+            t_pEvokedStim->data = t_ave.matSum / (double)t_ave.iCount;
 
-            if(t_nSamplesPerBuf*t_qListRawMatBuf.size() > (m_iPreStimSamples+m_iPostStimSamples + (2 * t_nSamplesPerBuf)))
-            {
-                //
-                // Average
-                //
-//                qDebug() << t_qListRawMatBuf.size()/2;
-//                qDebug() << (float)(m_iPreStimSamples + t_nSamplesPerBuf)/((float)t_nSamplesPerBuf);
-                qint32 t_iMidIdx = t_qListRawMatBuf.size()/2;
-
-                if(t_iMidIdx > 0 && t_qListRawMatBuf[t_iMidIdx].first.size() != 0)
-                {
-                    for(i = 0; i < t_qListRawMatBuf[t_iMidIdx].first.size(); ++i)
-                    {
-                        if(!t_qListRawMatBuf[t_iMidIdx-1].first.contains(t_qListRawMatBuf[t_iMidIdx].first[i]))//make sure that previous buffer does not conatin this stim - prevent multiple detection
-                        {
-                            qint32 t_iStimIndex = t_qListRawMatBuf[t_iMidIdx].first[i];
-
-                            //
-                            // assemble prestimulus
-                            //
-                            this->assemblePreStimulus(t_qListRawMatBuf, t_iStimIndex);
-
-                            //
-                            // assemble poststimulus
-                            //
-                            this->assemblePostStimulus(t_qListRawMatBuf, t_iStimIndex);
-
-//                            qDebug() << "Buffers of pre-stimulus" << t_iStimIndex << ":" << m_qListQVectorPreStimBuf[t_iStimIndex].size();
-                            //
-                            // Prestimulus average
-                            //
-                            if(m_qListQVectorPreStimBuf[t_iStimIndex].size() >= m_iNumAverages)
-                            {
-                                m_qListPreStimAve[t_iStimIndex] = m_qListQVectorPreStimBuf[t_iStimIndex][0];
-                                for(j = 1; j < m_qListQVectorPreStimBuf[t_iStimIndex].size(); ++j)
-                                    m_qListPreStimAve[t_iStimIndex] += m_qListQVectorPreStimBuf[t_iStimIndex][j];
-
-                                m_qListPreStimAve[t_iStimIndex].array() /= (double)m_iNumAverages;
-
-                                m_qListQVectorPreStimBuf[t_iStimIndex].pop_front();
-
-//                                qDebug() << "Pre-stim average" << t_iStimIndex;
-                            }
-
-
-//                            qDebug() << "Buffers of post-stimulus" << t_iStimIndex << ":" << m_qListQVectorPostStimBuf[t_iStimIndex].size();
-                            //
-                            // Poststimulus average
-                            //
-                            if(m_qListQVectorPostStimBuf[t_iStimIndex].size() >= m_iNumAverages)
-                            {
-                                m_qListPostStimAve[t_iStimIndex] = m_qListQVectorPostStimBuf[t_iStimIndex][0];
-                                for(j = 1; j < m_qListQVectorPostStimBuf[t_iStimIndex].size(); ++j)
-                                    m_qListPostStimAve[t_iStimIndex] += m_qListQVectorPostStimBuf[t_iStimIndex][j];
-
-                                m_qListPostStimAve[t_iStimIndex].array() /= (double)m_iNumAverages;
-
-                                m_qListQVectorPostStimBuf[t_iStimIndex].pop_front();
-
-//                                qDebug() << "Post-stim average" << t_iStimIndex;
-                            }
-
-                            //if averages are available -> buffers are filled and first average is stored
-                            if(m_qListPreStimAve[t_iStimIndex].size() > 0)
-                            {
-                                //
-                                // concatenate pre + post stimulus to full stimulus
-                                //
-                                m_qListStimAve[t_iStimIndex].resize(m_qListPreStimAve[t_iStimIndex].rows(), m_qListPreStimAve[t_iStimIndex].cols() + m_qListPostStimAve[t_iStimIndex].cols());
-                                // Pre
-                                m_qListStimAve[t_iStimIndex].block(0,0,m_qListPreStimAve[t_iStimIndex].rows(),m_qListPreStimAve[t_iStimIndex].cols()) = m_qListPreStimAve[t_iStimIndex];
-                                // Post
-                                m_qListStimAve[t_iStimIndex].block(0,m_qListPreStimAve[t_iStimIndex].cols(),m_qListPostStimAve[t_iStimIndex].rows(),m_qListPostStimAve[t_iStimIndex].cols()) = m_qListPostStimAve[t_iStimIndex];
-
-
-                                //
-                                // Emit evoked
-                                //
-                                FiffEvoked::SPtr t_pEvokedPreStim(new FiffEvoked(t_preStimEvoked));
-                                t_pEvokedPreStim->comment = QString("Stim %1").arg(t_iStimIndex);
-                                t_pEvokedPreStim->data = m_qListPreStimAve[t_iStimIndex];
-                                emit evokedPreStim(t_pEvokedPreStim);
-
-                                FiffEvoked::SPtr t_pEvokedPostStim(new FiffEvoked(t_postStimEvoked));
-                                t_pEvokedPostStim->comment = QString("Stim %1").arg(t_iStimIndex);
-                                t_pEvokedPostStim->data = m_qListPostStimAve[t_iStimIndex];
-                                emit evokedPostStim(t_pEvokedPostStim);
-
-                                FiffEvoked::SPtr t_pEvokedStim(new FiffEvoked(t_stimEvoked));
-                                t_pEvokedStim->comment = QString("Stim %1").arg(t_iStimIndex);
-                                t_pEvokedStim->data = m_qListStimAve[t_iStimIndex];
-                                emit evokedStim(t_pEvokedStim);
-//                                qDebug() << "Evoked emitted" << t_pEvokedPreStim->comment;
-                            }
-                        }
-                    }
-                }
+            FiffEvoked::SPtr t_pEvokedPreStim(new FiffEvoked(t_preStimEvoked));
+            t_pEvokedPreStim->comment = t_pEvokedStim->comment;
+            t_pEvokedPreStim->data = t_pEvokedStim->data.leftCols(m_iPreStimSamples);
+            emit evokedPreStim(t_iCode, t_pEvokedPreStim);
 
+            FiffEvoked::SPtr t_pEvokedPostStim(new FiffEvoked(t_postStimEvoked));
+            t_pEvokedPostStim->comment = t_pEvokedStim->comment;
+            t_pEvokedPostStim->data = t_pEvokedStim->data.rightCols(m_iPostStimSamples);
+            emit evokedPostStim(t_iCode, t_pEvokedPostStim);
 
-                //
-                //dump oldest buffer
-                //
-                t_qListRawMatBuf.pop_front();
-            }
+            emit evokedStim(t_iCode, t_pEvokedStim);
         }
     }
 }
@@ -59,6 +59,8 @@
 //=============================================================================================================
 
 #include <generics/circularmatrixbuffer.h>
+#include <generics/broadcastmatrixbuffer.h>
+#include <generics/tracer.h>
 
 
 //*************************************************************************************************************
@@ -68,8 +70,8 @@
 
 #include <QThread>
 #include <QMutex>
+#include <QAtomicInt>
 #include <QSharedPointer>
-#include <QSet>
 #include <QList>
 #include <QVector>
 
@@ -103,7 +105,10 @@ using namespace FIFFLIB;
 
 //=============================================================================================================
 /**
-* Real-time averaging and returns evoked data
+* Real-time averaging and returns evoked data. Epochs are averaged per trigger code. The code is read from the
+* composite trigger channel STI 014; without it, it is composed of the individual stimulus channels, the k-th
+* stimulus channel setting bit k. An epoch starts whenever the code changes to a value in [1, MaxTriggerCode];
+* onsets of larger codes and onsets beyond the pending ring are counted, see ignoredOnsets() and droppedOnsets().
 *
 * @brief Real-time averaging helper
 */
@@ -114,6 +119,8 @@ public:
     typedef QSharedPointer<RtAve> SPtr;             /**< Shared pointer type for RtCov. */
     typedef QSharedPointer<const RtAve> ConstSPtr;  /**< Const shared pointer type for RtCov. */
 
+    static const qint32 MaxTriggerCode = 255;       /**< Largest averaged trigger code, larger codes are ignored. */
+
     //=========================================================================================================
     /**
     * Creates the real-time covariance estimation object.
@@ -140,6 +147,41 @@ public:
     */
     void append(const MatrixXd &p_DataSegment);
 
+    //=========================================================================================================
+    /**
+    * Reads the incoming data from a broadcast buffer instead of append(), which saves a private copy of each
+    * block. With a Skip reader the epochs around lost blocks are not averaged. Has to be called before start().
+    *
+    * @param[in] p_pBroadcastBuffer The buffer to attach a reader to
+    * @param[in] p_policy           What happens if the estimator falls behind the producer
+    */
+    void attach(BroadcastMatrixBuffer<double>::SPtr p_pBroadcastBuffer, BroadcastMatrixBuffer<double>::ReaderPolicy p_policy = BroadcastMatrixBuffer<double>::Block);
+
+    //=========================================================================================================
+    /**
+    * Returns the number of blocks the broadcast reader lost because the estimation fell behind.
+    *
+    * @return the number of dropped blocks
+    */
+    quint64 dropped() const;
+
+    //=========================================================================================================
+    /**
+    * Returns the number of trigger onsets which were not averaged because their code exceeds MaxTriggerCode.
+    *
+    * @return the number of ignored onsets
+    */
+    inline qint32 ignoredOnsets() const;
+
+    //=========================================================================================================
+    /**
+    * Returns the number of trigger onsets which were not averaged because more onsets than the pending ring holds
+    * were waiting for their post stimulus samples.
+    *
+    * @return the number of dropped onsets
+    */
+    inline qint32 droppedOnsets() const;
+
     //=========================================================================================================
     /**
     * Stops the RtCov by stopping the producer's thread.
@@ -159,27 +201,31 @@ public:
 signals:
     //=========================================================================================================
     /**
-    * Signal which is emitted when new evoked pre stimulus data are available.
+    * Signal which is emitted when new evoked pre stimulus data are available. The comment of all evoked data is
+    * "Code <trigger code>", the code itself is passed along.
     *
+    * @param[out] p_iCode              The trigger code the evoked data were averaged for
     * @param[out] p_pEvokedPreStim     The evoked pre stimulus data
     */
-    void evokedPreStim(FIFFLIB::FiffEvoked::SPtr p_pEvokedPreStim);
+    void evokedPreStim(qint32 p_iCode, FIFFLIB::FiffEvoked::SPtr p_pEvokedPreStim);
 
     //=========================================================================================================
     /**
     * Signal which is emitted when new evoked post stimulus data are available.
     *
+    * @param[out] p_iCode              The trigger code the evoked data were averaged for
     * @param[out] p_pEvokedPostStim     The evoked post stimulus data
     */
-    void evokedPostStim(FIFFLIB::FiffEvoked::SPtr p_pEvokedPostStim);
+    void evokedPostStim(qint32 p_iCode, FIFFLIB::FiffEvoked::SPtr p_pEvokedPostStim);
 
     //=========================================================================================================
     /**
     * Signal which is emitted when new evoked stimulus data are available.
     *
+    * @param[out] p_iCode           The trigger code the evoked data were averaged for
     * @param[out] p_pEvokedStim     The evoked stimulus data
     */
-    void evokedStim(FIFFLIB::FiffEvoked::SPtr p_pEvokedStim);
+    void evokedStim(qint32 p_iCode, FIFFLIB::FiffEvoked::SPtr p_pEvokedStim);
 
 protected:
     //=========================================================================================================
@@ -193,21 +239,64 @@ protected:
 private:
     //=========================================================================================================
     /**
-    * Assemble the poststimulus
+    * Reads the next data block, either from the attached broadcast buffer or from the appended data.
+    *
+    * @param[out] p_matSegment  The data block
+    * @param[out] p_iTimestamp  Acquisition time stamp of the block, -1 if unknown
+    *
+    * @return true if a block was read
+    */
+    bool readSegment(MatrixXd &p_matSegment, qint64 &p_iTimestamp);
+
+    //=========================================================================================================
+    /**
+    * Running average of the last m_iNumAverages epochs of one trigger code.
+    */
+    struct CodeAverage {
+        QVector<MatrixXd> qVecEpochs;   /**< Ring of the last epochs, allocated at the first trigger. */
+        MatrixXd matSum;                /**< Sum of the epochs in qVecEpochs. */
+        qint32 iHead;                   /**< Epoch slot to overwrite next. */
+        qint32 iCount;                  /**< Number of valid epochs in qVecEpochs. */
+    };
+
+    //=========================================================================================================
+    /**
+    * Allocates the sample ring and the trigger bookkeeping for a block size.
+    *
+    * @param[in] p_iNumChannels     Number of channels
+    * @param[in] p_iBlockSize       Number of samples per block
+    */
+    void init(qint32 p_iNumChannels, qint32 p_iBlockSize);
+
+    //=========================================================================================================
+    /**
+    * Appends a block to the sample ring and records the trigger code changes, including changes between the last
+    * sample of the previous block and the first sample of this one.
+    *
+    * @param[in] p_matBlock     The data block
+    */
+    void appendBlock(const MatrixXd &p_matBlock);
+
+    //=========================================================================================================
+    /**
+    * Copies the epoch around p_iOnset out of the sample ring into the epoch ring of the trigger code and
+    * updates its running sum: the new epoch is added, the one it replaces subtracted.
     *
-    * @param[in] p_qListRawMatBuf   List of raw buffers
-    * @param[in] p_iStimIdx         Stimulus index to investigate
+    * @param[in] p_iCode        Trigger code, 1 to MaxTriggerCode
+    * @param[in] p_iOnset       Absolute sample index of the trigger onset
     */
-    void assemblePostStimulus(const QList<QPair<QList<qint32>, MatrixXd> > &p_qListRawMatBuf, qint32 p_iStimIdx);
+    void addEpoch(qint32 p_iCode, qint64 p_iOnset);
 
     //=========================================================================================================
     /**
-    * Assemble the prestimulus
+    * Returns the trigger code of a sample.
+    *
+    * @param[in] p_matBlock     The data block
+    * @param[in] p_iCol         Sample index into the block
     *
-    * @param[in] p_qListRawMatBuf   List of raw buffers
-    * @param[in] p_iStimIdx         Stimulus index to investigate
+    * @return the trigger code
     */
-    void assemblePreStimulus(const QList<QPair<QList<qint32>, MatrixXd> > &p_qListRawMatBuf, qint32 p_iStimIdx);
+    inline qint32 triggerCode(const MatrixXd &p_matBlock, qint32 p_iCol) const;
 
     QMutex      mutex;                  /**< Provides access serialization between threads*/
 
@@ -221,20 +310,32 @@ private:
     bool        m_bIsRunning;           /**< Holds if real-time Covariance estimation is running.*/
 
     CircularMatrixBuffer<double>::SPtr m_pRawMatrixBuffer;   /**< The Circular Raw Matrix Buffer. */
+    BroadcastMatrixBuffer<double>::SPtr m_pBroadcastBuffer;         /**< The attached broadcast buffer, if any. */
+    BroadcastMatrixBuffer<double>::Reader::SPtr m_pRawReader;   /**< The reader of the broadcast buffer. */
 
     bool m_bAutoAspect; /**< Auto aspect detection on or off. */
 
 
-    QList<qint32> m_qListStimChannelIdcs;   /**< Stimulus channel indeces. */
+    qint32 m_iTriggerChannelIdx;            /**< Index of STI 014, -1 if the code is composed of m_qListStimChannelIdcs. */
+    QList<qint32> m_qListStimChannelIdcs;   /**< Stimulus channel indeces, bit k of the code is channel k. */
 
 //    QList<fiff_int_t>  m_qSetAspectKinds;   /**< List of aspects to average. Each aspect is averaged separetely and released stored in evoked data.*/
 
-    QList<QVector<MatrixXd> > m_qListQVectorPreStimBuf;     /**< assembles the pre stimulus data */
-    QList<QVector<MatrixXd> > m_qListQVectorPostStimBuf;    /**< assembles the post stimulus data */
+    MatrixXd    m_matRing;              /**< Sample ring holding at least one epoch plus one block. */
+    qint64      m_iRingSamples;         /**< Number of samples written to the ring since start. */
+    qint64      m_iFirstValidSample;    /**< First ring sample after the last gap, earlier epochs are not averaged. */
+    qint32      m_iBlockSize;           /**< Block size the ring was allocated for. */
+
+    qint32      m_iLastCode;            /**< Trigger code of the last sample. */
+
+    QVector<qint64> m_qVecPendingOnset; /**< Onsets of epochs waiting for their post stimulus samples. */
+    QVector<qint32> m_qVecPendingCode;  /**< Trigger codes of the pending onsets. */
+    qint32      m_iPendingHead;         /**< Oldest pending onset. */
+    qint32      m_iPendingCount;        /**< Number of pending onsets. */
+    QAtomicInt  m_iIgnoredOnsets;       /**< Onsets with a code above MaxTriggerCode. */
+    QAtomicInt  m_iDroppedOnsets;       /**< Onsets lost because the pending ring was full. */
 
-    QList<MatrixXd> m_qListPreStimAve;     /**< the current pre stimulus average */
-    QList<MatrixXd> m_qListPostStimAve;    /**< the current post stimulus average */
-    QList<MatrixXd> m_qListStimAve;     /**< the current stimulus average */
+    QVector<CodeAverage> m_qVecCodeAverage; /**< Running averages indexed by trigger code, MaxTriggerCode+1 entries. */
 };
 
 //*************************************************************************************************************
@@ -247,6 +348,38 @@ inline bool RtAve::isRunning()
     return m_bIsRunning;
 }
 
+
+//*************************************************************************************************************
+
+inline qint32 RtAve::ignoredOnsets() const
+{
+    return m_iIgnoredOnsets.load();
+}
+
+
+//*************************************************************************************************************
+
+inline qint32 RtAve::droppedOnsets() const
+{
+    return m_iDroppedOnsets.load();
+}
+
+
+//*************************************************************************************************************
+
+inline qint32 RtAve::triggerCode(const MatrixXd &p_matBlock, qint32 p_iCol) const
+{
+    if(m_iTriggerChannelIdx >= 0)
+        return (qint32)p_matBlock(m_iTriggerChannelIdx, p_iCol);
+
+    qint32 t_iCode = 0;
+    for(qint32 k = 0; k < m_qListStimChannelIdcs.size() && k < 31; ++k)
+        if(p_matBlock(m_qListStimChannelIdcs[k], p_iCol) > 0)
+            t_iCode |= 1 << k;
+
+    return t_iCode;
+}
+
 } // NAMESPACE
 
 #ifndef metatype_fiffevokedsptr
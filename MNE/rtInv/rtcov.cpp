@@ -43,6 +43,7 @@
 #include "rtcov.h"
 
 #include <iostream>
+#include <cmath>
 #include <fiff/fiff_cov.h>
 
 
@@ -52,6 +53,7 @@
 //=============================================================================================================
 
 #include <QDebug>
+#include <QVector>
 
 
 //*************************************************************************************************************
@@ -73,6 +75,8 @@ RtCov::RtCov(qint32 p_iMaxSamples, FiffInfo::SPtr p_pFiffInfo, QObject *parent)
 , m_iMaxSamples(p_iMaxSamples)
 , m_pFiffInfo(p_pFiffInfo)
 , m_bIsRunning(false)
+, m_mode(Accumulate)
+, m_iEmitInterval(10)
 {
     qRegisterMetaType<FiffCov::SPtr>("FiffCov::SPtr");
 }
@@ -99,84 +103,184 @@ void RtCov::append(const MatrixXd &p_DataSegment)
 }
 
 
+//*************************************************************************************************************
+
+void RtCov::attach(BroadcastMatrixBuffer<double>::SPtr p_pBroadcastBuffer, BroadcastMatrixBuffer<double>::ReaderPolicy p_policy)
+{
+    m_pRawReader.clear();
+    m_pBroadcastBuffer = p_pBroadcastBuffer;
+    if(m_pBroadcastBuffer)
+        m_pRawReader = BroadcastMatrixBuffer<double>::Reader::SPtr(new BroadcastMatrixBuffer<double>::Reader(m_pBroadcastBuffer.data(), p_policy));
+}
+
+
+//*************************************************************************************************************
+
+quint64 RtCov::dropped() const
+{
+    return m_pRawReader ? m_pRawReader->dropped() : 0;
+}
+
+
+//*************************************************************************************************************
+
+bool RtCov::readSegment(MatrixXd &p_matSegment, qint64 &p_iTimestamp)
+{
+    if(m_pRawReader)
+    {
+        bool t_bRead = m_pRawReader->pop(p_matSegment);
+        p_iTimestamp = m_pRawReader->timestamp();
+        return t_bRead;
+    }
+
+    if(m_pRawMatrixBuffer)
+    {
+        p_matSegment = m_pRawMatrixBuffer->pop();
+        p_iTimestamp = -1;
+        return true;
+    }
+
+    return false;
+}
+
+
 //*************************************************************************************************************
 
 bool RtCov::stop()
 {
     m_bIsRunning = false;
+    if(m_pRawReader)
+        m_pRawReader->release();
     QThread::wait();
 
+    // a released reader stays released, attach a fresh one for the next start()
+    if(m_pRawReader)
+        attach(m_pBroadcastBuffer, m_pRawReader->policy());
+
     return true;
 }
 
 
+//*************************************************************************************************************
+
+void RtCov::emitCovariance(const MatrixXd &p_matOuter, const VectorXd &p_vecSum, double p_dNumSamples)
+{
+    FiffCov::SPtr cov(new FiffCov());
+
+    //
+    // C = (S - n*mu*mu') / (n - 1), evaluated on the lower triangle and mirrored once
+    //
+    VectorXd mu = p_vecSum / p_dNumSamples;
+    cov->data = p_matOuter;
+    cov->data.selfadjointView<Lower>().rankUpdate(mu, -p_dNumSamples);
+    cov->data.triangularView<StrictlyUpper>() = cov->data.transpose();
+    cov->data /= p_dNumSamples - 1;
+
+    cov->kind = FIFFV_MNE_NOISE_COV;
+    cov->diag = false;
+    cov->dim = cov->data.rows();
+
+    //ToDo do picks
+    cov->names = m_pFiffInfo->ch_names;
+    cov->projs = m_pFiffInfo->projs;
+    cov->bads  = m_pFiffInfo->bads;
+    cov->nfree  = (fiff_int_t)p_dNumSamples;
+
+    // regularize noise covariance
+    *cov.data() = cov->regularize(*m_pFiffInfo, 0.05, 0.05, 0.1, true);
+
+    emit covCalculated(cov);
+}
+
+
 //*************************************************************************************************************
 
 void RtCov::run()
 {
     m_bIsRunning = true;
 
+    MatrixXd matOuter;          // lower triangle of the sum of outer products
+    VectorXd vecSum;            // sum of the samples
+    double dNumSamples = 0;     // (weighted) number of samples in matOuter
+    quint64 uiSeenSamples = 0;  // samples received since start
+    qint32 iBlocks = 0;         // blocks since the last estimate
 
-    quint32 n_samples = 0;
+    QVector<MatrixXd> qVecWindow;   // blocks of the sliding window
+    qint32 iWindowHead = 0;
+    qint32 iWindowFill = 0;
 
-    FiffCov::SPtr cov(new FiffCov());
-    VectorXd mu;
+    MatrixXd rawSegment;
+    qint64 iTimestamp;
 
     while(m_bIsRunning)
     {
-        if(m_pRawMatrixBuffer)
+        if(!readSegment(rawSegment, iTimestamp))
+            continue;
+
+        Tracer::Scope trace("RtCov", iTimestamp);
+
+        if(matOuter.rows() != rawSegment.rows())
         {
-            MatrixXd rawSegment = m_pRawMatrixBuffer->pop();
+            matOuter = MatrixXd::Zero(rawSegment.rows(), rawSegment.rows());
+            vecSum = VectorXd::Zero(rawSegment.rows());
+            dNumSamples = 0;
+            qVecWindow.clear();
+            iWindowHead = iWindowFill = 0;
+        }
+
+        //
+        // Remove or weigh down what is leaving the estimate
+        //
+        if(m_mode == SlidingWindow)
+        {
+            if(qVecWindow.isEmpty())
+                qVecWindow.resize(qMax(1, (qint32)((m_iMaxSamples + rawSegment.cols() - 1) / rawSegment.cols())));
 
-            if(n_samples == 0)
+            if(iWindowFill == qVecWindow.size())
             {
-                mu = rawSegment.rowwise().sum();
-                cov->data = rawSegment * rawSegment.transpose();
+                const MatrixXd &oldSegment = qVecWindow[iWindowHead];
+                matOuter.selfadjointView<Lower>().rankUpdate(oldSegment, -1.0);
+                vecSum -= oldSegment.rowwise().sum();
+                dNumSamples -= oldSegment.cols();
             }
             else
-            {
-                mu.array() += rawSegment.rowwise().sum().array();
-                cov->data += rawSegment * rawSegment.transpose();
-            }
-            n_samples += rawSegment.cols();
-
-            if(n_samples > m_iMaxSamples)
-            {
-                mu /= (float)n_samples;
-                cov->data.array() -= n_samples * (mu * mu.transpose()).array();
-                cov->data.array() /= (n_samples - 1);
+                ++iWindowFill;
 
-                cov->kind = FIFFV_MNE_NOISE_COV;
-                cov->diag = false;
-                cov->dim = cov->data.rows();
-
-                //ToDo do picks
-                cov->names = m_pFiffInfo->ch_names;
-                cov->projs = m_pFiffInfo->projs;
-                cov->bads  = m_pFiffInfo->bads;
-                cov->nfree  = n_samples;
+            qVecWindow[iWindowHead] = rawSegment;
+            iWindowHead = (iWindowHead + 1) % qVecWindow.size();
+        }
+        else if(m_mode == ExponentiallyWeighted)
+        {
+            double lambda = std::pow(1.0 - 1.0/m_iMaxSamples, (double)rawSegment.cols());
+            matOuter.triangularView<Lower>() *= lambda;
+            vecSum *= lambda;
+            dNumSamples *= lambda;
+        }
 
-                // regularize noise covariance
-                *cov.data() = cov->regularize(*m_pFiffInfo, 0.05, 0.05, 0.1, true);
+        //
+        // Add the new block
+        //
+        matOuter.selfadjointView<Lower>().rankUpdate(rawSegment);
+        vecSum += rawSegment.rowwise().sum();
+        dNumSamples += rawSegment.cols();
+        uiSeenSamples += rawSegment.cols();
+        ++iBlocks;
 
-                emit covCalculated(cov);
+        if(m_mode == Accumulate)
+        {
+            if(dNumSamples > m_iMaxSamples)
+            {
+                emitCovariance(matOuter, vecSum, dNumSamples);
 
-                cov = FiffCov::SPtr(new FiffCov());
-                n_samples = 0;
+                matOuter.setZero();
+                vecSum.setZero();
+                dNumSamples = 0;
             }
-
-
-//            qint32 samples = rawSegment.cols();
-//            VectorXf mu = rawSegment.rowwise().sum().array() / (float)samples;
-
-//            MatrixXf noise_covariance = rawSegment * rawSegment.transpose();// noise_covariance == raw_covariance
-//            noise_covariance.array() -= samples * (mu * mu.transpose()).array();
-//            noise_covariance.array() /= (samples - 1);
-
-//            std::cout << "Noise Covariance:\n" << noise_covariance.block(0,0,10,10) << std::endl;
-
-//            printf("%d raw buffer (%d x %d) generated\r\n", count, tmp.rows(), tmp.cols());
-
+        }
+        else if(iBlocks >= m_iEmitInterval && uiSeenSamples >= m_iMaxSamples)
+        {
+            emitCovariance(matOuter, vecSum, dNumSamples);
+            iBlocks = 0;
         }
     }
 }
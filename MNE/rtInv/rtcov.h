@@ -59,6 +59,8 @@
 //=============================================================================================================
 
 #include <generics/circularmatrixbuffer.h>
+#include <generics/broadcastmatrixbuffer.h>
+#include <generics/tracer.h>
 
 
 //*************************************************************************************************************
@@ -100,7 +102,10 @@ using namespace FIFFLIB;
 
 //=============================================================================================================
 /**
-* Real-time covariance estimation
+* Real-time covariance estimation. In the default Accumulate mode one estimate is emitted per p_iMaxSamples
+* samples. The streaming modes keep a running estimate over the last p_iMaxSamples samples, either as a sliding
+* window or exponentially weighted, and emit it every setEmitInterval() blocks. All modes update only the lower
+* triangle of the sum of outer products with symmetric rank-k updates.
 *
 * @brief Real-time covariance estimation
 */
@@ -111,6 +116,16 @@ public:
     typedef QSharedPointer<RtCov> SPtr;             /**< Shared pointer type for RtCov. */
     typedef QSharedPointer<const RtCov> ConstSPtr;  /**< Const shared pointer type for RtCov. */
 
+    //=========================================================================================================
+    /**
+    * Estimation modes.
+    */
+    enum Mode {
+        Accumulate,             /**< Sum up p_iMaxSamples samples, emit and start from scratch. */
+        SlidingWindow,          /**< Add each new block, subtract the one leaving a window of p_iMaxSamples samples. */
+        ExponentiallyWeighted   /**< Weigh samples down with a time constant of p_iMaxSamples samples. */
+    };
+
     //=========================================================================================================
     /**
     * Creates the real-time covariance estimation object.
@@ -135,6 +150,40 @@ public:
     */
     void append(const MatrixXd &p_DataSegment);
 
+    //=========================================================================================================
+    /**
+    * Reads the incoming data from a broadcast buffer instead of append(), which saves a private copy of each
+    * block. A skipping reader suits the covariance estimate, which does not need every block. Has to be called before start().
+    *
+    * @param[in] p_pBroadcastBuffer The buffer to attach a reader to
+    * @param[in] p_policy           What happens if the estimator falls behind the producer
+    */
+    void attach(BroadcastMatrixBuffer<double>::SPtr p_pBroadcastBuffer, BroadcastMatrixBuffer<double>::ReaderPolicy p_policy = BroadcastMatrixBuffer<double>::Skip);
+
+    //=========================================================================================================
+    /**
+    * Returns the number of blocks the broadcast reader lost because the estimation fell behind.
+    *
+    * @return the number of dropped blocks
+    */
+    quint64 dropped() const;
+
+    //=========================================================================================================
+    /**
+    * Sets the estimation mode. Has to be called before start().
+    *
+    * @param[in] p_mode     The estimation mode
+    */
+    inline void setMode(Mode p_mode);
+
+    //=========================================================================================================
+    /**
+    * Sets after how many blocks a streaming mode emits its current estimate. Has to be called before start().
+    *
+    * @param[in] p_iBlocks  Number of blocks between two estimates
+    */
+    inline void setEmitInterval(qint32 p_iBlocks);
+
     //=========================================================================================================
     /**
     * Stops the RtCov by stopping the producer's thread.
@@ -170,6 +219,27 @@ protected:
     virtual void run();
 
 private:
+    //=========================================================================================================
+    /**
+    * Reads the next data block, either from the attached broadcast buffer or from the appended data.
+    *
+    * @param[out] p_matSegment  The data block
+    * @param[out] p_iTimestamp  Acquisition time stamp of the block, -1 if unknown
+    *
+    * @return true if a block was read
+    */
+    bool readSegment(MatrixXd &p_matSegment, qint64 &p_iTimestamp);
+
+    //=========================================================================================================
+    /**
+    * Turns the accumulated lower triangle into a regularized covariance and emits it.
+    *
+    * @param[in] p_matOuter     Lower triangle of the sum of the outer products of the samples
+    * @param[in] p_vecSum       Sum of the samples
+    * @param[in] p_dNumSamples  (Weighted) number of samples
+    */
+    void emitCovariance(const MatrixXd &p_matOuter, const VectorXd &p_vecSum, double p_dNumSamples);
+
     QMutex      mutex;                  /**< Provides access serialization between threads*/
 
     quint32      m_iMaxSamples;         /**< Maximal amount of samples received, before covariance is estimated.*/
@@ -178,7 +248,12 @@ private:
 
     bool        m_bIsRunning;           /**< Holds if real-time Covariance estimation is running.*/
 
+    Mode        m_mode;                 /**< The estimation mode.*/
+    qint32      m_iEmitInterval;        /**< Number of blocks between two estimates of the streaming modes.*/
+
     CircularMatrixBuffer<double>::SPtr m_pRawMatrixBuffer;   /**< The Circular Raw Matrix Buffer. */
+    BroadcastMatrixBuffer<double>::SPtr m_pBroadcastBuffer;         /**< The attached broadcast buffer, if any. */
+    BroadcastMatrixBuffer<double>::Reader::SPtr m_pRawReader;   /**< The reader of the broadcast buffer. */
 };
 
 //*************************************************************************************************************
@@ -191,6 +266,22 @@ inline bool RtCov::isRunning()
     return m_bIsRunning;
 }
 
+
+//*************************************************************************************************************
+
+inline void RtCov::setMode(Mode p_mode)
+{
+    m_mode = p_mode;
+}
+
+
+//*************************************************************************************************************
+
+inline void RtCov::setEmitInterval(qint32 p_iBlocks)
+{
+    m_iEmitInterval = p_iBlocks > 0 ? p_iBlocks : 1;
+}
+
 } // NAMESPACE
 
 #ifndef metatype_fiffcovsptr
@@ -41,13 +41,15 @@
 
 #include "rtinvop.h"
 
+#include <generics/tracer.h>
+
 
 //*************************************************************************************************************
 //=============================================================================================================
 // QT INCLUDES
 //=============================================================================================================
 
-
+#include <QElapsedTimer>
 #include <QDebug>
 
 
@@ -57,6 +59,7 @@
 //=============================================================================================================
 
 using namespace RTINVLIB;
+using namespace IOBuffer;
 
 //*************************************************************************************************************
 //=============================================================================================================
@@ -65,10 +68,17 @@ using namespace RTINVLIB;
 
 RtInvOp::RtInvOp(FiffInfo::SPtr &p_pFiffInfo, MNEForwardSolution::SPtr &p_pFwd, QObject *parent)
 : QThread(parent)
+, m_bIsRunning(false)
 , m_pFiffInfo(p_pFiffInfo)
 , m_pFwd(p_pFwd)
+, m_fLoose(0.2f)
+, m_fDepth(0.8f)
+, m_bCached(false)
+, m_iMethods(FIFFV_MNE_MEG)
 {
     qRegisterMetaType<MNEInverseOperator::SPtr>("MNEInverseOperator::SPtr");
+
+    m_latency.iPriors = m_latency.iWhitener = m_latency.iSvd = m_latency.iTotal = 0;
 }
 
 
@@ -84,11 +94,19 @@ RtInvOp::~RtInvOp()
 
 void RtInvOp::appendNoiseCov(FiffCov::SPtr p_pNoiseCov)
 {
-    mutex.lock();
-    //Use here a circular buffer
-    m_vecNoiseCov.push_back(p_pNoiseCov);
+    QMutexLocker locker(&mutex);
+    // An estimate which was not processed yet is superseded by the newer one
+    m_pNoiseCov = p_pNoiseCov;
+    m_newNoiseCov.wakeOne();
+}
 
-    mutex.unlock();
+
+//*************************************************************************************************************
+
+RtInvOp::Latency RtInvOp::lastLatency() const
+{
+    QMutexLocker locker(&mutex);
+    return m_latency;
 }
 
 
@@ -96,33 +114,101 @@ void RtInvOp::appendNoiseCov(FiffCov::SPtr p_pNoiseCov)
 
 bool RtInvOp::stop()
 {
+    mutex.lock();
     m_bIsRunning = false;
+    m_newNoiseCov.wakeAll();
+    mutex.unlock();
+
     QThread::wait();
 
     return true;
 }
 
 
+//*************************************************************************************************************
+
+MNEInverseOperator::SPtr RtInvOp::computeInverseOperator(const FiffCov &p_noiseCov, Latency &p_latency)
+{
+    Tracer::Scope trace("RtInvOp");
+
+    QElapsedTimer timer;
+    timer.start();
+
+    // Restrict forward solution as necessary for MEG, once
+    qint64 t_iPick = 0;
+    if(!m_bCached)
+    {
+        m_forwardMeg = m_pFwd->pick_types(true, false);
+        m_bCached = true;
+        t_iPick = timer.nsecsElapsed() / 1000;
+        timer.restart();
+    }
+
+    //
+    // Whitener and picked gain; the channel selection depends on the bads of the covariance
+    //
+    FiffInfo gain_info;
+    MatrixXd gain;
+    MatrixXd whitener;
+    qint32 n_nzero;
+    FiffCov t_outNoiseCov;
+    m_forwardMeg.prepare_forward(*m_pFiffInfo.data(), p_noiseCov, false, gain_info, gain, t_outNoiseCov, whitener, n_nzero);
+    p_latency.iWhitener = timer.nsecsElapsed() / 1000;
+
+    timer.restart();
+    if(!m_pSourceCov || gain_info.ch_names != m_qListPriorChNames)
+    {
+        MNEInverseOperator::compute_source_cov(m_forwardMeg, gain_info, gain, m_fLoose, m_fDepth, true, m_pDepthPrior, m_pOrientPrior, m_pSourceCov, m_iMethods);
+        m_qListPriorChNames = gain_info.ch_names;
+        t_iPick += timer.nsecsElapsed() / 1000;
+    }
+    p_latency.iPriors = t_iPick;
+
+    //
+    // Whiten, weight, decompose and assemble
+    //
+    timer.restart();
+    MNEInverseOperator::SPtr t_pInvOp(new MNEInverseOperator(MNEInverseOperator::assemble_inverse_operator(*m_pFiffInfo.data(), m_forwardMeg, gain_info, gain, whitener, n_nzero, t_outNoiseCov, m_pDepthPrior, m_pOrientPrior, *m_pSourceCov, m_iMethods)));
+    p_latency.iSvd = timer.nsecsElapsed() / 1000;
+
+    return t_pInvOp;
+}
+
+
 //*************************************************************************************************************
 
 void RtInvOp::run()
 {
+    mutex.lock();
     m_bIsRunning = true;
+    mutex.unlock();
 
-    while(m_bIsRunning)
+    QElapsedTimer timer;
+
+    while(true)
     {
-        if(m_vecNoiseCov.size() > 0)
+        mutex.lock();
+        while(m_bIsRunning && !m_pNoiseCov)
+            m_newNoiseCov.wait(&mutex);
+        if(!m_bIsRunning)
         {
-            // Restrict forward solution as necessary for MEG
-            MNEForwardSolution t_forwardMeg = m_pFwd->pick_types(true, false);
+            mutex.unlock();
+            break;
+        }
+        FiffCov::SPtr t_pNoiseCov = m_pNoiseCov;
+        m_pNoiseCov.clear();
+        mutex.unlock();
 
-            MNEInverseOperator::SPtr t_invOpMeg(new MNEInverseOperator(*m_pFiffInfo.data(), t_forwardMeg, *m_vecNoiseCov[0].data(), 0.2f, 0.8f));
+        timer.start();
 
-            mutex.lock();
-            m_vecNoiseCov.pop_front();
-            mutex.unlock();
+        Latency t_latency;
+        MNEInverseOperator::SPtr t_pInvOp = computeInverseOperator(*t_pNoiseCov.data(), t_latency);
+        t_latency.iTotal = timer.nsecsElapsed() / 1000;
 
-            emit invOperatorCalculated(t_invOpMeg);
-        }
+        mutex.lock();
+        m_latency = t_latency;
+        mutex.unlock();
+
+        emit invOperatorCalculated(t_pInvOp);
     }
 }
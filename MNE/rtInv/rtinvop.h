@@ -67,6 +67,7 @@
 
 #include <QThread>
 #include <QMutex>
+#include <QWaitCondition>
 #include <QSharedPointer>
 
 
@@ -99,7 +100,10 @@ using namespace MNELIB;
 
 //=============================================================================================================
 /**
-* Real-time inverse dSPM, sLoreta inverse operator estimation
+* Real-time inverse dSPM, sLoreta inverse operator estimation. Everything which does not depend on the noise
+* covariance (the MEG pick of the forward solution, depth and orientation priors) is computed once; a new noise
+* covariance only recomputes the whitener and the decomposition of the whitened lead field. The worker sleeps
+* until a covariance arrives; covariances which arrive while one is processed are coalesced to the newest.
 *
 * @brief Real-time inverse operator estimation
 */
@@ -110,6 +114,17 @@ public:
     typedef QSharedPointer<RtInvOp> SPtr;             /**< Shared pointer type for RtInvOp. */
     typedef QSharedPointer<const RtInvOp> ConstSPtr;  /**< Const shared pointer type for RtInvOp. */
 
+    //=========================================================================================================
+    /**
+    * Latency of the stages of one inverse operator update, in microseconds.
+    */
+    struct Latency {
+        qint64 iPriors;     /**< Forward pick and priors, 0 if they were cached. */
+        qint64 iWhitener;   /**< Whitener and channel selection. */
+        qint64 iSvd;        /**< Weighting and decomposition of the whitened lead field and assembly of the operator. */
+        qint64 iTotal;      /**< From the arrival of the noise covariance until the operator is emitted. */
+    };
+
     //=========================================================================================================
     /**
     * Creates the real-time inverse operator estimation object
@@ -134,6 +149,14 @@ public:
     */
     void appendNoiseCov(FiffCov::SPtr p_pNoiseCov);
 
+    //=========================================================================================================
+    /**
+    * Returns the stage latencies of the last inverse operator update.
+    *
+    * @return the stage latencies
+    */
+    Latency lastLatency() const;
+
     //=========================================================================================================
     /**
     * Stops the RtInv by stopping the producer's thread.
@@ -169,13 +192,38 @@ protected:
     virtual void run();
 
 private:
-    QMutex      mutex;                  /**< Provides access serialization between threads. */
+    //=========================================================================================================
+    /**
+    * Computes the inverse operator for a new noise covariance.
+    *
+    * @param[in] p_noiseCov     The noise covariance
+    * @param[out] p_latency     The stage latencies
+    *
+    * @return the inverse operator
+    */
+    MNEInverseOperator::SPtr computeInverseOperator(const FiffCov &p_noiseCov, Latency &p_latency);
+
+    mutable QMutex  mutex;              /**< Provides access serialization between threads. */
+    QWaitCondition  m_newNoiseCov;      /**< Wakes the worker. */
     bool        m_bIsRunning;           /**< Whether RtInv is running. */
 
-    QVector<FiffCov::SPtr> m_vecNoiseCov;/**< Noise covariance matrices. */
+    FiffCov::SPtr m_pNoiseCov;          /**< Newest noise covariance, not processed yet. */
 
     FiffInfo::SPtr m_pFiffInfo;         /**< The fiff measurement information. */
     MNEForwardSolution::SPtr m_pFwd;    /**< The forward solution. */
+
+    float       m_fLoose;               /**< Loose orientation weight. */
+    float       m_fDepth;               /**< Depth weighting exponent. */
+
+    bool        m_bCached;              /**< Whether the noise covariance independent parts are cached. */
+    MNEForwardSolution m_forwardMeg;    /**< The MEG pick of the forward solution. */
+    QStringList m_qListPriorChNames;    /**< Channel selection the priors were computed for. */
+    FiffCov::SDPtr m_pDepthPrior;       /**< Depth prior, NULL without depth weighting. */
+    FiffCov::SDPtr m_pOrientPrior;      /**< Orientation prior, if the forward solution has free orientation. */
+    FiffCov::SDPtr m_pSourceCov;        /**< Source covariance before the trace adjustment. */
+    qint32      m_iMethods;             /**< FIFFV_MNE_MEG, FIFFV_MNE_EEG or FIFFV_MNE_MEG_EEG. */
+
+    Latency     m_latency;              /**< Latencies of the last update. */
 };
 
 //*************************************************************************************************************
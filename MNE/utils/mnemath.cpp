@@ -84,16 +84,11 @@ VectorXd* MNEMath::combine_xyz(const VectorXd& vec)
         return NULL;
     }
 
-    MatrixXd tmp = MatrixXd(vec.transpose());
-    SparseMatrix<double>* s = make_block_diag(tmp,3);
+    VectorXd* comb = new VectorXd(vec.size()/3);
 
-    SparseMatrix<double> sC = *s*s->transpose();
-    VectorXd* comb = new VectorXd(sC.rows());
+    for(qint32 i = 0; i < comb->size(); ++i)
+        (*comb)[i] = vec[3*i]*vec[3*i] + vec[3*i+1]*vec[3*i+1] + vec[3*i+2]*vec[3*i+2];
 
-    for(qint32 i = 0; i < sC.rows(); ++i)
-        (*comb)[i] = sC.coeff(i,i);
-
-    delete s;
     return comb;
 }
 
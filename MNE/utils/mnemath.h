@@ -126,6 +126,22 @@ public:
     */
     static VectorXd* combine_xyz(const VectorXd& vec);
 
+    //=========================================================================================================
+    /**
+    * Combines the three Cartesian components of a free orientation solution and applies the noise normalization
+    * in one pass: out(i,t) = scale(i) * sqrt(x_i(t)^2 + y_i(t)^2 + z_i(t)^2), or scale(i) * z_i(t) when only the
+    * normal component is picked. Replaces the column wise combine_xyz, cwiseSqrt and the sparse noise
+    * normalization product. No temporaries are allocated; out is only resized when its size does not match.
+    * With OpenMP the columns are split into chunks which are processed in parallel.
+    *
+    * @param[in] sol            Solution [x1 y1 z1 ... x_n y_n z_n]' x times.
+    * @param[in] scale          Noise normalization factor per source, an empty vector for no normalization.
+    * @param[out] out           Combined solution, sources x times.
+    * @param[in] pick_normal    If true, the normal (z) component is kept instead of the magnitude.
+    */
+    template<typename T>
+    static void combine_xyz_normalized(const Matrix<T, Dynamic, Dynamic> &sol, const Matrix<T, Dynamic, 1> &scale, Matrix<T, Dynamic, Dynamic> &out, bool pick_normal = false);
+
 //    //=========================================================================================================
 //    /**
 //    * ### MNE toolbox root function ###: Implementation of the mne_block_diag function - decoding part
@@ -353,6 +369,69 @@ public:
 // INLINE & TEMPLATE DEFINITIONS
 //=============================================================================================================
 
+template<typename T>
+void MNEMath::combine_xyz_normalized(const Matrix<T, Dynamic, Dynamic> &sol, const Matrix<T, Dynamic, 1> &scale, Matrix<T, Dynamic, Dynamic> &out, bool pick_normal)
+{
+    if (sol.rows() % 3 != 0)
+    {
+        printf("Input must have 3N rows");
+        return;
+    }
+
+    const qint32 nSources = sol.rows() / 3;
+    const qint32 nTimes = sol.cols();
+    if (scale.size() > 0 && scale.size() != nSources)
+    {
+        printf("Scale must be empty or have one entry per source (%d != %d)", (int)scale.size(), nSources);
+        return;
+    }
+
+    const bool bScale = scale.size() > 0;
+
+    if(out.rows() != nSources || out.cols() != nTimes)
+        out.resize(nSources, nTimes);
+
+    // Columns per chunk, one chunk streams 3N inputs and writes N outputs per column
+    const qint32 nChunk = 16;
+
+    #ifdef _OPENMP
+    #pragma omp parallel for schedule(static) if(nTimes > nChunk && nSources * nTimes > 65536)
+    #endif
+    for(qint32 c = 0; c < nTimes; c += nChunk)
+    {
+        const qint32 cEnd = c + nChunk < nTimes ? c + nChunk : nTimes;
+        const T* s = scale.data();
+
+        for(qint32 t = c; t < cEnd; ++t)
+        {
+            const T* in = sol.data() + (size_t)t * sol.rows();
+            T* o = out.data() + (size_t)t * nSources;
+
+            if(pick_normal)
+            {
+                if(bScale)
+                    for(qint32 i = 0; i < nSources; ++i)
+                        o[i] = s[i] * in[3*i+2];
+                else
+                    for(qint32 i = 0; i < nSources; ++i)
+                        o[i] = in[3*i+2];
+            }
+            else
+            {
+                if(bScale)
+                    for(qint32 i = 0; i < nSources; ++i)
+                        o[i] = s[i] * std::sqrt(in[3*i]*in[3*i] + in[3*i+1]*in[3*i+1] + in[3*i+2]*in[3*i+2]);
+                else
+                    for(qint32 i = 0; i < nSources; ++i)
+                        o[i] = std::sqrt(in[3*i]*in[3*i] + in[3*i+1]*in[3*i+1] + in[3*i+2]*in[3*i+2]);
+            }
+        }
+    }
+}
+
+
+//*************************************************************************************************************
+
 template< typename T>
 VectorXi MNEMath::sort(Matrix<T, Dynamic, 1> &v, bool desc)
 {
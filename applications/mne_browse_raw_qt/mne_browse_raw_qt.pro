@@ -70,6 +70,7 @@ DESTDIR = $${MNE_BINARY_DIR}
 SOURCES += rawsettings.cpp\
     main.cpp\
     rawmodel.cpp \
+    rawcache.cpp \
     mainwindow.cpp \
     rawdelegate.cpp \
     mneoperator.cpp \
@@ -79,6 +80,7 @@ HEADERS += types.h\
     info.h\
     rawsettings.h\
     rawmodel.h\
+    rawcache.h \
     mainwindow.h \
     rawdelegate.h \
     mneoperator.h \
@@ -0,0 +1,464 @@
+//=============================================================================================================
+/**
+* @file     rawcache.cpp
+* @author   Florian Schlembach <florian.schlembach@tu-ilmenau.de>;
+*           Christoph Dinh <chdinh@nmr.mgh.harvard.edu>;
+*           Matti Hamalainen <msh@nmr.mgh.harvard.edu>;
+*           Jens Haueisen <jens.haueisen@tu-ilmenau.de>
+* @version  1.0
+* @date     October, 2026
+*
+* @section  LICENSE
+*
+* Copyright (C) 2014, Florian Schlembach, Christoph Dinh, Matti Hamalainen and Jens Haueisen. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+* the following conditions are met:
+*     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+*       following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+*       the following disclaimer in the documentation and/or other materials provided with the distribution.
+*     * Neither the name of the Massachusetts General Hospital nor the names of its contributors may be used
+*       to endorse or promote products derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+* PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL MASSACHUSETTS GENERAL HOSPITAL BE LIABLE FOR ANY DIRECT,
+* INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+* NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+*
+* @brief    Implementation of the RawCache class, the sidecar cache of raw fiff files.
+*
+*/
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include "rawcache.h"
+
+#include <fiff/fiff.h>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// Qt INCLUDES
+//=============================================================================================================
+
+#include <QDataStream>
+#include <QDateTime>
+#include <QFileInfo>
+#include <QtEndian>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// USED NAMESPACES
+//=============================================================================================================
+
+using namespace MNEBrowseRawQt;
+using namespace FIFFLIB;
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// STATIC HELPERS
+//=============================================================================================================
+
+#define RAWCACHE_MAGIC      0x4d524331  // "MRC1"
+#define RAWCACHE_VERSION    1
+
+//
+//   The cache is little endian; swap in place on big endian hosts
+//
+static inline void swapToLittleEndian(float* data, qint64 count)
+{
+#if Q_BYTE_ORDER == Q_BIG_ENDIAN
+    quint32* t_pWords = reinterpret_cast<quint32*>(data);
+    for(qint64 i = 0; i < count; ++i)
+        t_pWords[i] = qbswap(t_pWords[i]);
+#else
+    Q_UNUSED(data);
+    Q_UNUSED(count);
+#endif
+}
+
+static bool writeFloats(QFile& file, qint64 pos, float* data, qint64 count)
+{
+    swapToLittleEndian(data, count);
+    bool ok = file.seek(pos) && file.write(reinterpret_cast<const char*>(data), count*sizeof(float)) == count*(qint64)sizeof(float);
+    swapToLittleEndian(data, count);
+    return ok;
+}
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINE MEMBER METHODS
+//=============================================================================================================
+
+RawCache::RawCache()
+: m_bOpen(false)
+, m_iNChan(0)
+, m_iFirstSample(0)
+, m_iLastSample(-1)
+, m_iChunkSize(0)
+, m_iDecimation(0)
+, m_iDataOffset(0)
+{
+}
+
+
+//*************************************************************************************************************
+
+RawCache::~RawCache()
+{
+    close();
+}
+
+
+//*************************************************************************************************************
+
+QString RawCache::cacheFileName(const QString& fiffFile)
+{
+    return fiffFile + ".cache";
+}
+
+
+//*************************************************************************************************************
+
+bool RawCache::build(const QString& fiffFile, const QString& cacheFile, qint32 chunkSize, qint32 decimation, qint32 minBins)
+{
+    if(chunkSize <= 0 || decimation < 2)
+        return false;
+
+    QFile t_fileIn(fiffFile);
+    FiffRawData raw(t_fileIn);
+    if(raw.info.nchan <= 0 || raw.last_samp < raw.first_samp)
+        return false;
+
+    qint32 nchan = raw.info.nchan;
+    qint64 nsamp = raw.last_samp - raw.first_samp + 1;
+    qint64 nchunks = (nsamp + chunkSize - 1)/chunkSize;
+
+    //
+    //   Levels: decimation, decimation^2, ... until the whole recording fits into a few bins
+    //
+    QVector<Level> levels;
+    for(qint64 factor = decimation; ; factor *= decimation) {
+        Level level;
+        level.factor = factor;
+        level.nbins = (nsamp + factor - 1)/factor;
+        level.offset = 0;
+        levels.append(level);
+        if(level.nbins <= minBins || factor*decimation > nsamp)
+            break;
+    }
+
+    qint64 dataOffset = 2*sizeof(qint32) + 2*sizeof(qint64) + 6*sizeof(qint32) + levels.size()*(2*sizeof(qint32) + sizeof(qint64)) + sizeof(qint64);
+    qint64 offset = dataOffset + nchunks*nchan*chunkSize*(qint64)sizeof(float);
+    for(qint32 l = 0; l < levels.size(); ++l) {
+        levels[l].offset = offset;
+        offset += (qint64)nchan*levels[l].nbins*3*sizeof(float);
+    }
+
+    //
+    //   Write to a temporary file first, so that an interrupted build never leaves a valid looking cache
+    //
+    QFile t_fileOut(cacheFile + ".part");
+    if(!t_fileOut.open(QIODevice::ReadWrite | QIODevice::Truncate))
+        return false;
+
+    QFileInfo t_fileInfo(fiffFile);
+    QDataStream t_header(&t_fileOut);
+    t_header.setByteOrder(QDataStream::LittleEndian);
+    t_header << (quint32)RAWCACHE_MAGIC << (qint32)RAWCACHE_VERSION;
+    t_header << (qint64)t_fileInfo.size() << (qint64)t_fileInfo.lastModified().toMSecsSinceEpoch();
+    t_header << (qint32)nchan << (qint32)raw.first_samp << (qint32)raw.last_samp << (qint32)chunkSize << (qint32)decimation << (qint32)levels.size();
+    for(qint32 l = 0; l < levels.size(); ++l)
+        t_header << (qint32)levels[l].factor << (qint32)levels[l].nbins << (qint64)levels[l].offset;
+    t_header << (qint64)dataOffset;
+
+    //
+    //   Data: read and calibrate the recording once, store it channel-major per chunk
+    //
+    MatrixXd data, times;
+    MatrixXf chunk(chunkSize, nchan);
+    for(qint64 c = 0; c < nchunks; ++c) {
+        fiff_int_t from = raw.first_samp + c*chunkSize;
+        fiff_int_t to = qMin(from + chunkSize - 1, raw.last_samp);
+        if(!raw.read_raw_segment(data, times, from, to)) {
+            t_fileOut.remove();
+            return false;
+        }
+        chunk.setZero();
+        chunk.topRows(data.cols()) = data.transpose().cast<float>();
+        if(!writeFloats(t_fileOut, dataOffset + c*nchan*chunkSize*(qint64)sizeof(float), chunk.data(), chunk.size())) {
+            t_fileOut.remove();
+            return false;
+        }
+    }
+    t_fileOut.flush();
+
+    //
+    //   Summaries: one channel at a time, each level aggregated from the previous one
+    //
+    VectorXf samples(nchunks*chunkSize);
+    for(qint32 ch = 0; ch < nchan; ++ch) {
+        for(qint64 c = 0; c < nchunks; ++c) {
+            qint64 pos = dataOffset + (c*nchan + ch)*chunkSize*(qint64)sizeof(float);
+            if(!t_fileOut.seek(pos) || t_fileOut.read(reinterpret_cast<char*>(samples.data() + c*chunkSize), chunkSize*sizeof(float)) != chunkSize*(qint64)sizeof(float)) {
+                t_fileOut.remove();
+                return false;
+            }
+        }
+        swapToLittleEndian(samples.data(), samples.size());
+
+        MatrixXf prev, cur;     // 3 x nbins: min, max, mean
+        for(qint32 l = 0; l < levels.size(); ++l) {
+            const Level& level = levels[l];
+            cur.resize(3, level.nbins);
+            for(qint32 b = 0; b < level.nbins; ++b) {
+                qint64 start = (qint64)b*level.factor;
+                qint64 end = qMin(start + level.factor, nsamp);
+                float t_fMin, t_fMax;
+                double t_dSum = 0;
+                if(l == 0) {
+                    t_fMin = t_fMax = samples[start];
+                    for(qint64 s = start; s < end; ++s) {
+                        t_fMin = qMin(t_fMin, samples[s]);
+                        t_fMax = qMax(t_fMax, samples[s]);
+                        t_dSum += samples[s];
+                    }
+                }
+                else {
+                    //the previous level bins of this bin, weighted by the number of samples they cover
+                    qint32 prevFactor = levels[l-1].factor;
+                    qint32 first = b*decimation;
+                    qint32 last = qMin(first + decimation, levels[l-1].nbins);
+                    t_fMin = prev(0,first);
+                    t_fMax = prev(1,first);
+                    for(qint32 p = first; p < last; ++p) {
+                        t_fMin = qMin(t_fMin, prev(0,p));
+                        t_fMax = qMax(t_fMax, prev(1,p));
+                        t_dSum += prev(2,p)*(double)(qMin((qint64)(p+1)*prevFactor, nsamp) - (qint64)p*prevFactor);
+                    }
+                }
+                cur(0,b) = t_fMin;
+                cur(1,b) = t_fMax;
+                cur(2,b) = (float)(t_dSum/(double)(end - start));
+            }
+            if(!writeFloats(t_fileOut, level.offset + (qint64)ch*level.nbins*3*sizeof(float), cur.data(), cur.size())) {
+                t_fileOut.remove();
+                return false;
+            }
+            prev.swap(cur);
+        }
+    }
+
+    t_fileOut.close();
+
+    QFile::remove(cacheFile);
+    return t_fileOut.rename(cacheFile);
+}
+
+
+//*************************************************************************************************************
+
+bool RawCache::open(const QString& cacheFile, const QString& fiffFile)
+{
+    close();
+
+    m_qFile.setFileName(cacheFile);
+    if(!m_qFile.open(QIODevice::ReadOnly))
+        return false;
+
+    QDataStream t_header(&m_qFile);
+    t_header.setByteOrder(QDataStream::LittleEndian);
+
+    quint32 magic;
+    qint32 version, nlevels;
+    qint64 size, modified;
+    t_header >> magic >> version >> size >> modified;
+
+    QFileInfo t_fileInfo(fiffFile);
+    if(magic != RAWCACHE_MAGIC || version != RAWCACHE_VERSION || size != t_fileInfo.size() || modified != t_fileInfo.lastModified().toMSecsSinceEpoch()) {
+        close();
+        return false;
+    }
+
+    t_header >> m_iNChan >> m_iFirstSample >> m_iLastSample >> m_iChunkSize >> m_iDecimation >> nlevels;
+    if(t_header.status() != QDataStream::Ok || m_iNChan <= 0 || m_iChunkSize <= 0 || nlevels < 0) {
+        close();
+        return false;
+    }
+
+    m_qVecLevels.resize(nlevels);
+    for(qint32 l = 0; l < nlevels; ++l)
+        t_header >> m_qVecLevels[l].factor >> m_qVecLevels[l].nbins >> m_qVecLevels[l].offset;
+    t_header >> m_iDataOffset;
+
+    m_bOpen = t_header.status() == QDataStream::Ok;
+    if(!m_bOpen)
+        close();
+
+    return m_bOpen;
+}
+
+
+//*************************************************************************************************************
+
+void RawCache::close()
+{
+    QMutexLocker locker(&m_Mutex);
+    m_bOpen = false;
+    m_qVecLevels.clear();
+    if(m_qFile.isOpen())
+        m_qFile.close();
+}
+
+
+//*************************************************************************************************************
+
+bool RawCache::readSamples(qint32 from, qint32 to, MatrixXd& data)
+{
+    if(!m_bOpen)
+        return false;
+
+    from = qMax(from, m_iFirstSample);
+    to = qMin(to, m_iLastSample);
+    if(to < from)
+        return false;
+
+    data.resize(m_iNChan, to - from + 1);
+
+    //
+    //   Per chunk, the span from the first picked sample of the first channel to the last picked sample of the
+    //   last channel is contiguous: read it at once and pick
+    //
+    qint32 firstChunk = (from - m_iFirstSample)/m_iChunkSize;
+    qint32 lastChunk = (to - m_iFirstSample)/m_iChunkSize;
+    VectorXf span;
+    for(qint32 c = firstChunk; c <= lastChunk; ++c) {
+        qint32 chunkStart = m_iFirstSample + c*m_iChunkSize;
+        qint32 s0 = qMax(from, chunkStart) - chunkStart;
+        qint32 s1 = qMin(to, chunkStart + m_iChunkSize - 1) - chunkStart;
+        qint64 count = (qint64)(m_iNChan - 1)*m_iChunkSize + s1 - s0 + 1;
+
+        span.resize(count);
+        if(!readFloats(m_iDataOffset + ((qint64)c*m_iNChan*m_iChunkSize + s0)*sizeof(float), count, span.data()))
+            return false;
+
+        qint32 dest = chunkStart + s0 - from;
+        for(qint32 ch = 0; ch < m_iNChan; ++ch)
+            data.row(ch).segment(dest, s1 - s0 + 1) = span.segment((qint64)ch*m_iChunkSize, s1 - s0 + 1).cast<double>().transpose();
+    }
+
+    return true;
+}
+
+
+//*************************************************************************************************************
+
+bool RawCache::readEnvelope(qint32 chan, qint32 from, qint32 to, qint32 bins, RowVectorXd& min, RowVectorXd& max, RowVectorXd& mean)
+{
+    if(!m_bOpen || chan < 0 || chan >= m_iNChan || bins <= 0)
+        return false;
+
+    from = qMax(from, m_iFirstSample);
+    to = qMin(to, m_iLastSample);
+    if(to < from)
+        return false;
+
+    qint64 n = to - from + 1;
+    bins = (qint32)qMin((qint64)bins, n);
+    double width = (double)n/bins;
+
+    min.resize(bins);
+    max.resize(bins);
+    mean.resize(bins);
+
+    //
+    //   Coarsest level whose bins are not wider than the output bins
+    //
+    qint32 level = -1;
+    while(level + 1 < m_qVecLevels.size() && m_qVecLevels[level + 1].factor <= width)
+        ++level;
+
+    if(level < 0) {
+        //Close zoom: the samples themselves
+        VectorXf samples(n);
+        if(!readChannel(chan, from, to, samples.data()))
+            return false;
+
+        for(qint32 b = 0; b < bins; ++b) {
+            qint64 start = (qint64)(b*width);
+            qint64 end = qMax(start + 1, (qint64)((b + 1)*width));
+            min[b] = samples.segment(start, end - start).minCoeff();
+            max[b] = samples.segment(start, end - start).maxCoeff();
+            mean[b] = samples.segment(start, end - start).cast<double>().mean();
+        }
+        return true;
+    }
+
+    const Level& t_level = m_qVecLevels[level];
+    qint32 b0 = (from - m_iFirstSample)/t_level.factor;
+    qint32 b1 = (to - m_iFirstSample)/t_level.factor;
+
+    MatrixXf summary(3, b1 - b0 + 1);
+    if(!readFloats(t_level.offset + ((qint64)chan*t_level.nbins + b0)*3*sizeof(float), summary.size(), summary.data()))
+        return false;
+
+    //
+    //   Merge the level bins into the output bins; the mean is the mean of the merged bin means
+    //
+    for(qint32 b = 0; b < bins; ++b) {
+        qint64 start = from - m_iFirstSample + (qint64)(b*width);
+        qint64 end = qMax(start + 1, from - m_iFirstSample + (qint64)((b + 1)*width));
+        qint32 first = start/t_level.factor - b0;
+        qint32 last = (end - 1)/t_level.factor - b0;
+        min[b] = summary.block(0, first, 1, last - first + 1).minCoeff();
+        max[b] = summary.block(1, first, 1, last - first + 1).maxCoeff();
+        mean[b] = summary.block(2, first, 1, last - first + 1).cast<double>().mean();
+    }
+
+    return true;
+}
+
+
+//*************************************************************************************************************
+
+bool RawCache::readFloats(qint64 pos, qint64 count, float* dest)
+{
+    QMutexLocker locker(&m_Mutex);
+
+    qint64 bytes = count*sizeof(float);
+    if(!m_qFile.seek(pos) || m_qFile.read(reinterpret_cast<char*>(dest), bytes) != bytes)
+        return false;
+
+    swapToLittleEndian(dest, count);
+    return true;
+}
+
+
+//*************************************************************************************************************
+
+bool RawCache::readChannel(qint32 chan, qint32 from, qint32 to, float* dest)
+{
+    qint32 firstChunk = (from - m_iFirstSample)/m_iChunkSize;
+    qint32 lastChunk = (to - m_iFirstSample)/m_iChunkSize;
+    for(qint32 c = firstChunk; c <= lastChunk; ++c) {
+        qint32 chunkStart = m_iFirstSample + c*m_iChunkSize;
+        qint32 s0 = qMax(from, chunkStart) - chunkStart;
+        qint32 s1 = qMin(to, chunkStart + m_iChunkSize - 1) - chunkStart;
+
+        if(!readFloats(m_iDataOffset + (((qint64)c*m_iNChan + chan)*m_iChunkSize + s0)*sizeof(float), s1 - s0 + 1, dest + chunkStart + s0 - from))
+            return false;
+    }
+    return true;
+}
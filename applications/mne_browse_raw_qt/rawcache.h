@@ -0,0 +1,274 @@
+//=============================================================================================================
+/**
+* @file     rawcache.h
+* @author   Florian Schlembach <florian.schlembach@tu-ilmenau.de>;
+*           Christoph Dinh <chdinh@nmr.mgh.harvard.edu>;
+*           Matti Hamalainen <msh@nmr.mgh.harvard.edu>;
+*           Jens Haueisen <jens.haueisen@tu-ilmenau.de>
+* @version  1.0
+* @date     October, 2026
+*
+* @section  LICENSE
+*
+* Copyright (C) 2014, Florian Schlembach, Christoph Dinh, Matti Hamalainen and Jens Haueisen. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+* the following conditions are met:
+*     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+*       following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+*       the following disclaimer in the documentation and/or other materials provided with the distribution.
+*     * Neither the name of the Massachusetts General Hospital nor the names of its contributors may be used
+*       to endorse or promote products derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+* PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL MASSACHUSETTS GENERAL HOSPITAL BE LIABLE FOR ANY DIRECT,
+* INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+* NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+*
+* @brief    This class represents the model of the model/view framework of mne_browse_raw_qt application.
+* @brief    The RawCache class is a derived sidecar file of a raw fiff file, from which the RawModel renders any zoom
+*           level by reading only a few KB.
+*
+*           The cache holds the calibrated data as float32 in chunks of m_iChunkSize samples; inside a chunk the data
+*           are channel-major, so that a channel segment is one contiguous read. In addition, it holds min/max/mean
+*           summaries at several decimation levels (m_iDecimation, m_iDecimation^2, ...), each stored channel-major,
+*           so that the summary of a channel over any range is again one contiguous read.
+*
+*           File layout (little endian):
+*               header:     magic, version, size and modification time of the fiff file, nchan, first_samp,
+*                           last_samp, chunk size, decimation, number of levels
+*               levels:     for each level the decimation factor, the number of bins and the file offset
+*               data:       nchunks x nchan x chunk size float32 (the last chunk is zero padded)
+*               summaries:  for each level nchan x nbins x (min, max, mean) float32
+*
+*           The cache is invalidated when size or modification time of the fiff file change.
+*
+*/
+
+#ifndef RAWCACHE_H
+#define RAWCACHE_H
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include "types.h"
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// Qt INCLUDES
+//=============================================================================================================
+
+#include <QFile>
+#include <QMutex>
+#include <QSharedPointer>
+#include <QString>
+#include <QVector>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// Eigen INCLUDES
+//=============================================================================================================
+
+#include <Eigen/Core>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// USED NAMESPACES
+//=============================================================================================================
+
+using namespace Eigen;
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINE NAMESPACE MNEBrowseRawQt
+//=============================================================================================================
+
+namespace MNEBrowseRawQt
+{
+
+//=============================================================================================================
+/**
+* DECLARE CLASS RawCache
+*/
+class RawCache
+{
+public:
+    typedef QSharedPointer<RawCache> SPtr;              /**< Shared pointer type for RawCache. */
+    typedef QSharedPointer<const RawCache> ConstSPtr;   /**< Const shared pointer type for RawCache. */
+
+    RawCache();
+    ~RawCache();
+
+    //=========================================================================================================
+    /**
+    * cacheFileName returns the name of the sidecar file of a fiff file
+    *
+    * @param fiffFile the name of the raw fiff file
+    * @return the name of the cache file
+    */
+    static QString cacheFileName(const QString& fiffFile);
+
+    //=========================================================================================================
+    /**
+    * build reads the raw fiff file once and writes its cache. It opens its own handle of the fiff file, so it
+    * can run in a background-thread while the model keeps reading.
+    *
+    * @param fiffFile the name of the raw fiff file
+    * @param cacheFile the name of the cache file to write
+    * @param chunkSize number of samples per data chunk
+    * @param decimation decimation factor between two summary levels
+    * @param minBins the coarsest level has not fewer bins than this
+    * @return true if succeeded
+    */
+    static bool build(const QString& fiffFile, const QString& cacheFile, qint32 chunkSize, qint32 decimation, qint32 minBins = 256);
+
+    //=========================================================================================================
+    /**
+    * open opens a cache and checks it against its fiff file
+    *
+    * @param cacheFile the name of the cache file
+    * @param fiffFile the name of the raw fiff file the cache was built from
+    * @return true if the cache is valid, false if it is missing or outdated
+    */
+    bool open(const QString& cacheFile, const QString& fiffFile);
+
+    //=========================================================================================================
+    /**
+    * close closes the cache file
+    */
+    void close();
+
+    //=========================================================================================================
+    /**
+    * isOpen
+    *
+    * @return true if a valid cache is opened
+    */
+    inline bool isOpen() const;
+
+    //=========================================================================================================
+    /**
+    * readSamples reads calibrated samples of all channels
+    *
+    * @param from first sample to read [absolute, in samples]
+    * @param to last sample to read [absolute, in samples]
+    * @param data the data <n_channels x n_samples>
+    * @return true if succeeded
+    */
+    bool readSamples(qint32 from, qint32 to, MatrixXd& data);
+
+    //=========================================================================================================
+    /**
+    * readEnvelope reads min/max/mean of one channel in bins equally dividing [from,to]. The coarsest level
+    * whose decimation does not exceed the bin width is read, so at most bins*decimation entries are touched;
+    * below the first level the samples themselves are read.
+    *
+    * @param chan the channel
+    * @param from first sample [absolute, in samples]
+    * @param to last sample [absolute, in samples]
+    * @param bins number of output bins, e.g. the width of the plot in pixels
+    * @param min the minimum of each bin
+    * @param max the maximum of each bin
+    * @param mean the mean of each bin
+    * @return true if succeeded
+    */
+    bool readEnvelope(qint32 chan, qint32 from, qint32 to, qint32 bins, RowVectorXd& min, RowVectorXd& max, RowVectorXd& mean);
+
+    //=========================================================================================================
+    /**
+    * levelCount
+    *
+    * @return the number of summary levels
+    */
+    inline qint32 levelCount() const;
+
+    //=========================================================================================================
+    /**
+    * levelFactor
+    *
+    * @param level the summary level
+    * @return the number of samples per bin of the level
+    */
+    inline qint32 levelFactor(qint32 level) const;
+
+private:
+    //=========================================================================================================
+    /**
+    * readFloats reads count float32 values at a given position of the cache file
+    *
+    * @param pos the file position
+    * @param count the number of values
+    * @param dest the destination
+    * @return true if succeeded
+    */
+    bool readFloats(qint64 pos, qint64 count, float* dest);
+
+    //=========================================================================================================
+    /**
+    * readChannel reads calibrated samples of one channel
+    *
+    * @param chan the channel
+    * @param from first sample to read [absolute, in samples]
+    * @param to last sample to read [absolute, in samples]
+    * @param dest the destination, to-from+1 values
+    * @return true if succeeded
+    */
+    bool readChannel(qint32 chan, qint32 from, qint32 to, float* dest);
+
+    struct Level {
+        qint32 factor;  /**< samples per bin */
+        qint32 nbins;   /**< number of bins */
+        qint64 offset;  /**< file offset of the summaries */
+    };
+
+    QFile m_qFile;              /**< the cache file */
+    QMutex m_Mutex;             /**< serializes seek and read of m_qFile */
+    bool m_bOpen;               /**< true when a valid cache is opened */
+
+    qint32 m_iNChan;            /**< number of channels */
+    qint32 m_iFirstSample;      /**< first sample of the recording */
+    qint32 m_iLastSample;       /**< last sample of the recording */
+    qint32 m_iChunkSize;        /**< samples per data chunk */
+    qint32 m_iDecimation;       /**< decimation between two levels */
+    qint64 m_iDataOffset;       /**< file offset of the first data chunk */
+    QVector<Level> m_qVecLevels;/**< the summary levels, finest first */
+};
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INLINE DEFINITIONS
+//=============================================================================================================
+
+inline bool RawCache::isOpen() const {
+    return m_bOpen;
+}
+
+
+//*************************************************************************************************************
+
+inline qint32 RawCache::levelCount() const {
+    return m_qVecLevels.size();
+}
+
+
+//*************************************************************************************************************
+
+inline qint32 RawCache::levelFactor(qint32 level) const {
+    return m_qVecLevels[level].factor;
+}
+
+} // NAMESPACE
+
+#endif // RAWCACHE_H
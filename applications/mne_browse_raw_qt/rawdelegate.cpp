@@ -51,6 +51,14 @@
 #include <QBrush>
 
 
+//*************************************************************************************************************
+//=============================================================================================================
+// STL INCLUDES
+//=============================================================================================================
+
+#include <limits>
+
+
 //*************************************************************************************************************
 //=============================================================================================================
 // USED NAMESPACES
@@ -205,6 +213,12 @@ void RawDelegate::createPlotPath(const QModelIndex &index, QPainterPath& path, Q
     double dValue;
     double dScaleY = m_dPlotHeight/(2*dMaxValue);
 
+    //more samples than pixels -> plot the min/max envelope instead of every sample
+    if(m_dDx < 1.0) {
+        createEnvelopePath(index, path, listPairs, dScaleY);
+        return;
+    }
+
     double y_base = path.currentPosition().y();
     QPointF qSamplePosition;
 
@@ -229,6 +243,55 @@ void RawDelegate::createPlotPath(const QModelIndex &index, QPainterPath& path, Q
 }
 
 
+//*************************************************************************************************************
+
+void RawDelegate::createEnvelopePath(const QModelIndex &index, QPainterPath& path, QList<RowVectorPair>& listPairs, double dScaleY) const
+{
+    const RawModel* t_rawModel = static_cast<const RawModel*>(index.model());
+
+    qint32 nsamples = 0;
+    for(qint8 i=0; i < listPairs.size(); ++i)
+        nsamples += listPairs[i].second;
+
+    if(nsamples == 0)
+        return;
+
+    qint32 bins = qMax(1, (qint32)(nsamples*m_dDx));
+
+    //the cache holds the unfiltered data only
+    RowVectorXd min, max, mean;
+    qint32 from = t_rawModel->absFiffCursor();
+    if(t_rawModel->m_assignedOperators.contains(index.row()) || !t_rawModel->readEnvelope(index.row(), from, from+nsamples-1, bins, min, max, mean)) {
+        //summarize the loaded samples
+        min = RowVectorXd::Constant(bins, std::numeric_limits<double>::max());
+        max = RowVectorXd::Constant(bins, -std::numeric_limits<double>::max());
+
+        qint64 k = 0;
+        for(qint8 i=0; i < listPairs.size(); ++i) {
+            for(qint32 j=0; j < listPairs[i].second; ++j, ++k) {
+                double val = *(listPairs[i].first+j);
+                qint32 b = (qint32)(k*bins/nsamples);
+                if(val < min[b])
+                    min[b] = val;
+                if(val > max[b])
+                    max[b] = val;
+            }
+        }
+    }
+
+    double y_base = path.currentPosition().y();
+    double x = path.currentPosition().x();
+    double dx = nsamples*m_dDx/min.size();
+
+    //one vertical line per bin
+    for(qint32 b=0; b < min.size(); ++b) {
+        x += dx;
+        path.lineTo(x, y_base+max[b]*dScaleY);
+        path.lineTo(x, y_base+min[b]*dScaleY);
+    }
+}
+
+
 //*************************************************************************************************************
 
 void RawDelegate::createGridPath(QPainterPath& path, QList<RowVectorPair>& listPairs) const
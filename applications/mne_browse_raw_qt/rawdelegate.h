@@ -133,6 +133,19 @@ private:
     */
     void createPlotPath(const QModelIndex &index, QPainterPath& path, QList<RowVectorPair>& listPairs) const;
 
+    //=========================================================================================================
+    /**
+    * createEnvelopePath creates the QPointer path for a data plot with more samples than pixels: per pixel a
+    * vertical line from the minimum to the maximum. The envelope is read from the sidecar cache of the model and
+    * summarized from the loaded samples if the cache is not available or the channel is filtered.
+    *
+    * @param[in] index QModelIndex for accessing associated data and model object.
+    * @param[in,out] path The QPointerPath to create for the data plot.
+    * @param[in] listPairs The loaded samples of the channel.
+    * @param[in] dScaleY Pixels per data unit.
+    */
+    void createEnvelopePath(const QModelIndex &index, QPainterPath& path, QList<RowVectorPair>& listPairs, double dScaleY) const;
+
     //=========================================================================================================
     /**
     * createGridPath Creates the QPointer path for the grid plot.
@@ -68,6 +68,8 @@ RawModel::RawModel(QObject *parent)
     m_iWindowSize = m_qSettings.value("RawModel/window_size").toInt();
     m_reloadPos = m_qSettings.value("RawModel/reload_pos").toInt();
     m_maxWindows = m_qSettings.value("RawModel/max_windows").toInt();
+    m_iCacheChunkSize = m_qSettings.value("RawModel/cache_chunk_size").toInt();
+    m_iCacheDecimation = m_qSettings.value("RawModel/cache_decimation").toInt();
 }
 
 
@@ -86,6 +88,28 @@ RawModel::RawModel(QFile &qFile, QObject *parent)
     m_reloadPos = m_qSettings.value("RawModel/reload_pos").toInt();
     m_maxWindows = m_qSettings.value("RawModel/max_windows").toInt();
     m_iFilterTaps = m_qSettings.value("RawModel/num_filter_taps").toInt();
+    m_iCacheChunkSize = m_qSettings.value("RawModel/cache_chunk_size").toInt();
+    m_iCacheDecimation = m_qSettings.value("RawModel/cache_decimation").toInt();
+
+    //open the sidecar cache once it is built
+    connect(&m_cacheFutureWatcher,&QFutureWatcher<bool>::finished,[this](){
+        //the build was started for a file which is not loaded anymore -> ignore it
+        QString t_sFileName = m_sCacheBuildFileName;
+        m_sCacheBuildFileName.clear();
+        if(t_sFileName.isEmpty() || t_sFileName != m_sFiffFileName) {
+            qDebug() << "RawModel: Ignoring the sidecar cache build of" << t_sFileName << ", file is not loaded anymore.";
+            return;
+        }
+
+        RawCache::SPtr t_pCache(new RawCache);
+        if(m_cacheFutureWatcher.future().result() && t_pCache->open(RawCache::cacheFileName(t_sFileName),t_sFileName)) {
+            QMutexLocker locker(&m_Mutex);
+            m_pRawCache = t_pCache;
+            qDebug() << "RawModel: Sidecar cache" << RawCache::cacheFileName(t_sFileName) << "built.";
+        }
+        else
+            qDebug() << "RawModel: Could not build sidecar cache, reading from the fiff file.";
+    });
 
     //read fiff data
     loadFiffData(qFile);
@@ -312,6 +336,8 @@ bool RawModel::loadFiffData(QFile& qFile)
     loadFiffInfos();
     genStdFilterOps();
 
+    openCache(qFile.fileName());
+
     endResetModel();
     return true;
 }
@@ -362,6 +388,12 @@ void RawModel::clearModel() {
     //MNEOperators
     m_assignedOperators.clear();
 
+    //Sidecar cache
+    m_Mutex.lock();
+    m_pRawCache.clear();
+    m_Mutex.unlock();
+    m_sFiffFileName.clear();        //a running cache build is ignored once it finishes
+
     //View parameters
     m_iAbsFiffCursor = 0;
     m_iCurAbsScrollPos = 0;
@@ -393,17 +425,14 @@ void RawModel::resetPosition(qint32 position) {
 
     m_iAbsFiffCursor = firstSample() + mult*m_iWindowSize;
 
-    MatrixXd t_data,t_times; //type is later on (when append to m_data) casted into MatrixXdR (Row-Major)
-
-    m_Mutex.lock();
-    if(!m_pfiffIO->m_qlistRaw[0]->read_raw_segment(t_data, t_times, m_iAbsFiffCursor, m_iAbsFiffCursor+m_iWindowSize-1))
+    QPair<MatrixXd,MatrixXd> t_datatime = readSegment(m_iAbsFiffCursor, m_iAbsFiffCursor+m_iWindowSize-1);
+    if(t_datatime.first.cols() == 0)
         qDebug() << "RawModel: Error resetting position of Fiff file!";
-    m_Mutex.unlock();
 
     //append loaded block
-    m_data.append(t_data);
-    m_procData.append(MatrixXdR::Zero(t_data.rows(),m_iWindowSize));
-    m_times.append(t_times);
+    m_data.append(t_datatime.first);
+    m_procData.append(MatrixXdR::Zero(t_datatime.first.rows(),m_iWindowSize));
+    m_times.append(t_datatime.second);
 
     updateOperators();
 
@@ -465,22 +494,73 @@ void RawModel::reloadFiffData(bool before) {
 }
 
 
+//*************************************************************************************************************
+
+void RawModel::openCache(const QString& fileName)
+{
+    m_sFiffFileName = fileName;
+
+    RawCache::SPtr t_pCache(new RawCache);
+    if(t_pCache->open(RawCache::cacheFileName(fileName),fileName)) {
+        QMutexLocker locker(&m_Mutex);
+        m_pRawCache = t_pCache;
+        qDebug() << "RawModel: Using sidecar cache" << RawCache::cacheFileName(fileName);
+        return;
+    }
+
+    //a build of the same file is still running, e.g. the file was reloaded -> keep waiting for it
+    if(m_cacheFutureWatcher.isRunning() && m_sCacheBuildFileName == fileName)
+        return;
+
+    //missing or outdated -> build it in a background-thread, meanwhile the fiff file is read
+    qDebug() << "RawModel: Building sidecar cache" << RawCache::cacheFileName(fileName) << "...";
+    m_sCacheBuildFileName = fileName;
+    QFuture<bool> future = QtConcurrent::run(&RawCache::build,fileName,RawCache::cacheFileName(fileName),m_iCacheChunkSize,m_iCacheDecimation,256);
+    m_cacheFutureWatcher.setFuture(future);
+}
+
+
 //*************************************************************************************************************
 
 QPair<MatrixXd,MatrixXd> RawModel::readSegment(fiff_int_t from, fiff_int_t to) {
     QPair<MatrixXd,MatrixXd> datatime;
 
     m_Mutex.lock();
-    if(!m_pfiffIO->m_qlistRaw[0]->read_raw_segment(datatime.first, datatime.second, from, to)) {
-        printf("RawModel: Error when reading raw data!");
+    RawCache::SPtr t_pCache = m_pRawCache;
+    m_Mutex.unlock();
+
+    //the cache holds calibrated data already -> no re-reading and re-calibrating of fiff buffers
+    if(t_pCache && t_pCache->readSamples(from, to, datatime.first)) {
+        float sfreq = m_pfiffIO->m_qlistRaw[0]->info.sfreq;
+        datatime.second.resize(1, datatime.first.cols());
+        for(qint32 i = 0; i < datatime.second.cols(); ++i)
+            datatime.second(0,i) = ((float)(from+i))/sfreq;
         return datatime;
     }
-    m_Mutex.unlock();
+
+    QMutexLocker locker(&m_Mutex);
+    if(!m_pfiffIO->m_qlistRaw[0]->read_raw_segment(datatime.first, datatime.second, from, to))
+        printf("RawModel: Error when reading raw data!");
 
     return datatime;
 }
 
 
+//*************************************************************************************************************
+
+bool RawModel::readEnvelope(qint32 chan, qint32 from, qint32 to, qint32 bins, RowVectorXd& min, RowVectorXd& max, RowVectorXd& mean) const
+{
+    m_Mutex.lock();
+    RawCache::SPtr t_pCache = m_pRawCache;
+    m_Mutex.unlock();
+
+    if(!t_pCache)
+        return false;
+
+    return t_pCache->readEnvelope(chan, from, to, bins, min, max, mean);
+}
+
+
 //*************************************************************************************************************
 //public SLOTS
 void RawModel::updateScrollPos(int value) {
@@ -72,6 +72,7 @@
 
 #include "types.h"
 #include "filteroperator.h"
+#include "rawcache.h"
 
 
 //*************************************************************************************************************
@@ -166,6 +167,30 @@ public:
     */
     bool writeFiffData(QFile &qFile);
 
+    //=========================================================================================================
+    /**
+    * readEnvelope reads min/max/mean of a channel in bins, e.g. one bin per pixel, from the sidecar cache. Any
+    * zoom level, from the whole recording down to single samples, only reads a few KB.
+    *
+    * @param chan the channel
+    * @param from first sample [absolute, in samples]
+    * @param to last sample [absolute, in samples]
+    * @param bins number of bins
+    * @param min the minimum of each bin
+    * @param max the maximum of each bin
+    * @param mean the mean of each bin
+    * @return false if the cache is not available (yet)
+    */
+    bool readEnvelope(qint32 chan, qint32 from, qint32 to, qint32 bins, RowVectorXd& min, RowVectorXd& max, RowVectorXd& mean) const;
+
+    //=========================================================================================================
+    /**
+    * isCached
+    *
+    * @return true if the sidecar cache of the loaded file is available
+    */
+    inline bool isCached() const;
+
     //VARIABLES
     bool m_bFileloaded;         /**< true when a Fiff file is loaded */
 
@@ -191,6 +216,8 @@ public:
     qint32 m_reloadPos;     /**< Distance that the current window needs to be off the ends of m_data[i] [in samples] */
     qint8 m_maxWindows;     /**< number of windows that are at maximum remained in m_data */
     qint16 m_iFilterTaps;   /**< Number of Filter taps */
+    qint32 m_iCacheChunkSize;   /**< Number of samples per chunk of the sidecar cache */
+    qint32 m_iCacheDecimation;  /**< Decimation between two summary levels of the sidecar cache */
 
     QSharedPointer<FiffIO> m_pfiffIO;   /**< FiffIO objects, which holds all the information of the fiff data (excluding the samples!) */
 
@@ -230,6 +257,14 @@ private:
     */
     void reloadFiffData(bool before);
 
+    //=========================================================================================================
+    /**
+    * openCache opens the sidecar cache of the loaded file, or builds it in a background-thread if it is missing or outdated
+    *
+    * @param fileName the name of the loaded fiff file
+    */
+    void openCache(const QString& fileName);
+
     //=========================================================================================================
     /**
     * @brief readSegment is the wrapper method to read a segment from the raw fiff file
@@ -255,7 +290,13 @@ private:
     QList<QPair<int,RowVectorXd> > m_listTmpChData; /**< contains pairs with a channel number and the corresponding RowVectorXd */
     bool m_bProcessing;                             /**< true when processing in a background-thread is ongoing*/
 
-    QMutex m_Mutex;     /**< mutex for locking against simultaenous access to shared objects > */
+    mutable QMutex m_Mutex;     /**< mutex for locking against simultaenous access to shared objects > */
+
+    //Sidecar cache
+    RawCache::SPtr m_pRawCache;                 /**< the sidecar cache, read instead of the fiff file once it is open */
+    QFutureWatcher<bool> m_cacheFutureWatcher;  /**< QFutureWatcher for watching the cache build in a background-thread */
+    QString m_sFiffFileName;                    /**< the name of the loaded fiff file */
+    QString m_sCacheBuildFileName;              /**< the name of the fiff file the running cache build was started for */
 
 signals:
     //=========================================================================================================
@@ -481,6 +522,13 @@ inline qint32 RawModel::absFiffCursor() const {
     return m_iAbsFiffCursor;
 }
 
+
+//*************************************************************************************************************
+
+inline bool RawModel::isCached() const {
+    return m_pRawCache && m_pRawCache->isOpen();
+}
+
 } // NAMESPACE
 
 
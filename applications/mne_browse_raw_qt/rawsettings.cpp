@@ -90,6 +90,8 @@ void RawSettings::init()
         m_qSettings.setValue("reload_pos",MODEL_RELOAD_POS);
         m_qSettings.setValue("max_windows",MODEL_MAX_WINDOWS);
         m_qSettings.setValue("num_filter_taps",MODEL_NUM_FILTER_TAPS);
+        m_qSettings.setValue("cache_chunk_size",MODEL_CACHE_CHUNK_SIZE);
+        m_qSettings.setValue("cache_decimation",MODEL_CACHE_DECIMATION);
     m_qSettings.endGroup();
 
     //RawDelegate
@@ -76,6 +76,8 @@
 #define MODEL_RELOAD_POS 2000 //Distance that the current window needs to be off the ends of m_data[i] [in samples]
 #define MODEL_MAX_WINDOWS 3 //number of windows that are at maximum remained in m_data
 #define MODEL_NUM_FILTER_TAPS 80 //number of filter taps, required to take into account because of FFT convolution (zero padding)
+#define MODEL_CACHE_CHUNK_SIZE 4096 //number of samples per chunk of the sidecar cache
+#define MODEL_CACHE_DECIMATION 8 //decimation between two min/max/mean levels of the sidecar cache
 
 //RawDelegate
 //Look
@@ -92,6 +92,9 @@ const QString FiffSimulator::Commands::GETBUFSIZE   = "getbufsize";
 const QString FiffSimulator::Commands::ACCEL        = "accel";
 const QString FiffSimulator::Commands::GETACCEL     = "getaccel";
 const QString FiffSimulator::Commands::SIMFILE      = "simfile";
+const QString FiffSimulator::Commands::SPEED        = "speed";
+const QString FiffSimulator::Commands::GETSPEED     = "getspeed";
+const QString FiffSimulator::Commands::SIMSTATS     = "simstats";
 
 
 //*************************************************************************************************************
@@ -282,6 +285,84 @@ void FiffSimulator::comSimfile(Command p_command)
 }
 
 
+//*************************************************************************************************************
+
+void FiffSimulator::comSpeed(Command p_command)
+{
+    bool t_bOk = false;
+    double t_dSpeed = p_command.pValues()[0].toDouble(&t_bOk);
+
+    if(t_bOk && t_dSpeed >= 0)
+    {
+        // Takes effect at the next buffer, no restart needed
+        m_clock.setSpeed(t_dSpeed);
+
+        QString str;
+        if(t_dSpeed > 0)
+            str = QString("\tSet playback speed to %1x real time\r\n\n").arg(t_dSpeed, 0, 'f', 3);
+        else
+            str = QString("\tSet playback to as fast as possible\r\n\n");
+
+        m_commandManager[Commands::SPEED].reply(str);
+    }
+    else
+        m_commandManager[Commands::SPEED].reply("Playback speed not set\r\n");
+}
+
+
+//*************************************************************************************************************
+
+void FiffSimulator::comGetSpeed(Command p_command)
+{
+    double t_dSpeed = m_clock.speed();
+
+    if(p_command.isJson())
+    {
+        QJsonObject t_qJsonObjectRoot;
+        t_qJsonObjectRoot.insert(Commands::SPEED, QJsonValue(t_dSpeed));
+        QJsonDocument p_qJsonDocument(t_qJsonObjectRoot);
+
+        m_commandManager[Commands::GETSPEED].reply(p_qJsonDocument.toJson());
+    }
+    else
+    {
+        QString str = QString("\t%1\r\n\n").arg(t_dSpeed, 0, 'f', 3);
+        m_commandManager[Commands::GETSPEED].reply(str);
+    }
+}
+
+
+//*************************************************************************************************************
+
+void FiffSimulator::comSimStats(Command p_command)
+{
+    PlaybackClock::Statistics t_stats = m_clock.statistics();
+
+    double t_dMaxLate = t_stats.iMaxLate / 1000.0;
+    double t_dMeanLate = t_stats.iOverruns > 0 ? t_stats.iTotalLate / 1000.0 / t_stats.iOverruns : 0.0;
+
+    if(p_command.isJson())
+    {
+        QJsonObject t_qJsonObjectRoot;
+        t_qJsonObjectRoot.insert("buffers", QJsonValue((double)t_stats.iTicks));
+        t_qJsonObjectRoot.insert("overruns", QJsonValue((double)t_stats.iOverruns));
+        t_qJsonObjectRoot.insert("resyncs", QJsonValue((double)t_stats.iResyncs));
+        t_qJsonObjectRoot.insert("max_late_us", QJsonValue(t_dMaxLate));
+        t_qJsonObjectRoot.insert("mean_late_us", QJsonValue(t_dMeanLate));
+        QJsonDocument p_qJsonDocument(t_qJsonObjectRoot);
+
+        m_commandManager[Commands::SIMSTATS].reply(p_qJsonDocument.toJson());
+    }
+    else
+    {
+        QString str = QString("\tbuffers %1, overruns %2, resyncs %3, max late %4 us, mean late %5 us\r\n\n")
+                .arg(t_stats.iTicks).arg(t_stats.iOverruns).arg(t_stats.iResyncs)
+                .arg(t_dMaxLate, 0, 'f', 1).arg(t_dMeanLate, 0, 'f', 1);
+        m_commandManager[Commands::SIMSTATS].reply(str);
+    }
+}
+
+
 //*************************************************************************************************************
 
 void FiffSimulator::connectCommandManager()
@@ -292,6 +373,9 @@ void FiffSimulator::connectCommandManager()
     QObject::connect(&m_commandManager[Commands::ACCEL], &Command::executed, this, &FiffSimulator::comAccel);
     QObject::connect(&m_commandManager[Commands::GETACCEL], &Command::executed, this, &FiffSimulator::comGetAccel);
     QObject::connect(&m_commandManager[Commands::SIMFILE], &Command::executed, this, &FiffSimulator::comSimfile);
+    QObject::connect(&m_commandManager[Commands::SPEED], &Command::executed, this, &FiffSimulator::comSpeed);
+    QObject::connect(&m_commandManager[Commands::GETSPEED], &Command::executed, this, &FiffSimulator::comGetSpeed);
+    QObject::connect(&m_commandManager[Commands::SIMSTATS], &Command::executed, this, &FiffSimulator::comSimStats);
 }
 
 
@@ -487,10 +571,9 @@ void FiffSimulator::run()
 {
     m_bIsRunning = true;
 
-    float t_fSamplingFrequency = m_RawInfo.info.sfreq;
-    float t_fBuffSampleSize = (float)m_uiBufferSampleSize;
-
-    quint32 uiSamplePeriod = (unsigned int) ((t_fBuffSampleSize/t_fSamplingFrequency)*1000000.0f);
+    // The reported sfreq already contains the acceleration factor, the speed paces on top of it
+    m_clock.setPeriod(m_RawInfo.info.sfreq, m_uiBufferSampleSize);
+    m_clock.start();
 
 //    quint32 count = 0;
 
@@ -500,7 +583,9 @@ void FiffSimulator::run()
 //        ++count;
 //        printf("%d raw buffer (%d x %d) generated\r\n", count, t_pRawBuffer->rows(), t_pRawBuffer->cols());
 
+        // Absolute deadlines: the time spent in pop() and emit does not add up to drift
+        m_clock.wait();
+
         emit remitRawBuffer(t_pRawBuffer);
-        usleep(uiSamplePeriod);
     }
 }
@@ -52,6 +52,7 @@
 
 #include <fiff/fiff_raw_data.h>
 #include <generics/circularmatrixbuffer.h>
+#include <generics/playbackclock.h>
 
 
 //*************************************************************************************************************
@@ -112,6 +113,9 @@ public:
         static const QString ACCEL;
         static const QString GETACCEL;
         static const QString SIMFILE;
+        static const QString SPEED;
+        static const QString GETSPEED;
+        static const QString SIMSTATS;
     };
 
     //=========================================================================================================
@@ -184,6 +188,30 @@ private:
     */
     void comSimfile(Command p_command);
 
+    //=========================================================================================================
+    /**
+    * Sets the playback speed
+    *
+    * @param[in] p_command  The playback speed command.
+    */
+    void comSpeed(Command p_command);
+
+    //=========================================================================================================
+    /**
+    * Returns the playback speed
+    *
+    * @param[in] p_command  The playback speed command.
+    */
+    void comGetSpeed(Command p_command);
+
+    //=========================================================================================================
+    /**
+    * Returns the pacing statistics of the current simulation
+    *
+    * @param[in] p_command  The simulation statistics command.
+    */
+    void comSimStats(Command p_command);
+
     //////////
 
     //=========================================================================================================
@@ -205,6 +233,8 @@ private:
 
     RawMatrixBuffer* m_pRawMatrixBuffer;    /**< The Circular Raw Matrix Buffer. */
 
+    PlaybackClock   m_clock;                /**< Paces the emitted buffers to the sampling rate times the speed. */
+
     bool            m_bIsRunning;
 };
 
@@ -51,6 +51,8 @@
 #include <mne_x/Management/plugininputdata.h>
 #include <mne_x/Interfaces/IPlugin.h>
 
+#include <generics/tracer.h>
+
 
 #include <Eigen/Core>
 
@@ -72,6 +74,7 @@
 using namespace XMEASLIB;
 using namespace MNEX;
 using namespace Eigen;
+using namespace IOBuffer;
 
 
 //*************************************************************************************************************
@@ -163,6 +166,11 @@ int main(int argc, char *argv[])
 
     XMEASLIB::MeasurementTypes::registerTypes();
 
+    //Pipeline tracing: MNE_X_TRACE=<prefix> writes <prefix>.json (Chrome trace) and <prefix>.csv (histograms) on exit
+    QString sTracePrefix = QString::fromLocal8Bit(qgetenv("MNE_X_TRACE"));
+    if(!sTracePrefix.isEmpty())
+        Tracer::setEnabled(true);
+
     QPixmap pixmap(":/images/splashscreen.png");
     MainSplashScreen::SPtr splashscreen(new MainSplashScreen(pixmap));
     splashscreen->show();
@@ -207,5 +215,13 @@ int main(int argc, char *argv[])
 //    pluginOutputData->data()->setValue(v);
 //    //DEBUG
 
-    return app.exec();
+    int iReturn = app.exec();
+
+    if(!sTracePrefix.isEmpty())
+    {
+        Tracer::writeChromeTrace(sTracePrefix + ".json");
+        Tracer::writeHistograms(sTracePrefix + ".csv");
+    }
+
+    return iReturn;
 }
@@ -153,6 +153,13 @@ void BabyMEG::initConnector()
 {
     if(m_pFiffInfo)
     {
+        // Block output first - auto connection prefers it for receivers which accept blocks
+        m_pRTMSBBabyMEG = PluginOutputData<NewRealTimeMultiSampleBlock>::create(this, "RtClientBlock", "MNE Rt Client Block");
+
+        m_pRTMSBBabyMEG->data()->initFromFiffInfo(m_pFiffInfo);
+
+        m_outputConnectors.append(m_pRTMSBBabyMEG);
+
         m_pRTMSABabyMEG = PluginOutputData<NewRealTimeMultiSampleArray>::create(this, "RtClient", "MNE Rt Client");
 
         m_pRTMSABabyMEG->data()->initFromFiffInfo(m_pFiffInfo);
@@ -191,8 +198,8 @@ void BabyMEG::startRecordingFile()
     //Setup writing to file
     if(m_bWriteToFile)
     {
-        m_pOutfid->finish_writing_raw();
         m_bWriteToFile = false;
+        m_pRawWriter->stop();
         m_pTimerRecordingChange->stop();
         m_pActionRecordFile->setIcon(QIcon(":/images/record.png"));
     }
@@ -219,9 +226,10 @@ void BabyMEG::startRecordingFile()
                 return;
         }
 
-        m_pOutfid = Fiff::start_writing_raw(m_qFileOut, *m_pFiffInfo, m_cals);
-        fiff_int_t first = 0;
-        m_pOutfid->write_int(FIFF_FIRST_SAMPLE, &first);
+        //Disk writes run on the writer thread, a stalled disk drops buffers instead of blocking the acquisition
+        m_pRawWriter = FiffRawWriter::SPtr(new FiffRawWriter);
+        if(!m_pRawWriter->start(m_qFileOut, *m_pFiffInfo))
+            return;
 
         m_bWriteToFile = true;
 
@@ -380,6 +388,7 @@ void BabyMEG::run()
 {
 
     MatrixXf matValue;
+    MatrixXd matBlock;
 
     while(m_bIsRunning)
     {
@@ -388,13 +397,24 @@ void BabyMEG::run()
             //pop matrix
             matValue = m_pRawMatrixBuffer->pop();
 
+            //stamp the block on its arrival
+            qint64 t_iTimestamp = Tracer::now();
+            Tracer::Scope trace("BabyMEG::emit", t_iTimestamp);
+
             //Write raw data to fif file
             if(m_bWriteToFile)
-                m_pOutfid->write_raw_buffer(matValue.cast<double>(), m_cals);
+                m_pRawWriter->append(matValue.cast<double>());
 
-            if(m_pRTMSABabyMEG)
+            if(m_pRTMSBBabyMEG)
             {
-                //emit values
+                //emit the whole block once - its memory is handed over to the shared block
+                matBlock = matValue.cast<double>();
+                m_pRTMSBBabyMEG->data()->setValue(matBlock, t_iTimestamp);
+            }
+
+            if(m_pRTMSABabyMEG && m_pRTMSABabyMEG->isConnected())
+            {
+                //emit values - only displays and receivers which still take single samples need them
                 for(qint32 i = 0; i < matValue.cols(); ++i)
                     m_pRTMSABabyMEG->data()->setValue(matValue.col(i).cast<double>());
             }
@@ -404,8 +424,8 @@ void BabyMEG::run()
     //Close the fif output stream
     if(m_bWriteToFile)
     {
-        m_pOutfid->finish_writing_raw();
         m_bWriteToFile = false;
+        m_pRawWriter->stop();
     }
 }
 
@@ -414,6 +434,19 @@ void BabyMEG::run()
 
 void BabyMEG::changeRecordingButton()
 {
+    //The writer rejects all buffers after a failed disk write - end the recording and tell the user
+    if(m_bWriteToFile && m_pRawWriter->hasError())
+    {
+        startRecordingFile();
+
+        QMessageBox msgBox;
+        msgBox.setIcon(QMessageBox::Warning);
+        msgBox.setText("The recording was stopped, writing to the file failed.");
+        msgBox.setInformativeText(QString("%1\n%2 bytes and %3 buffers could not be written.").arg(m_pRawWriter->errorString()).arg(m_pRawWriter->bytesFailed()).arg(m_pRawWriter->failedBuffers()));
+        msgBox.exec();
+        return;
+    }
+
     if(m_iBlinkStatus == 0)
     {
         m_pActionRecordFile->setIcon(QIcon(":/images/record.png"));
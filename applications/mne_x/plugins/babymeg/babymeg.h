@@ -48,7 +48,9 @@
 #include <mne_x/Interfaces/ISensor.h>
 #include <generics/circularbuffer_old.h>
 #include <generics/circularmatrixbuffer.h>
+#include <generics/tracer.h>
 #include <xMeas/newrealtimemultisamplearray.h>
+#include <xMeas/newrealtimemultisampleblock.h>
 
 
 //*************************************************************************************************************
@@ -214,6 +216,7 @@ private:
     */
     void initConnector();
 
+    PluginOutputData<NewRealTimeMultiSampleBlock>::SPtr m_pRTMSBBabyMEG;   /**< The NewRealTimeMultiSampleBlock to provide the rt_server Channels blockwise to processing plugins.*/
     PluginOutputData<NewRealTimeMultiSampleArray>::SPtr m_pRTMSABabyMEG;   /**< The NewRealTimeMultiSampleArray to provide the rt_server Channels.*/
 
     QMutex mutex;
@@ -229,9 +232,7 @@ private:
     bool                                m_bWriteToFile;     /**< Flag for for writing the received samples to a file. Defined by the user via the GUI.*/
     QString                             m_sRecordFile;      /**< Holds the path for the sample output file. Defined by the user via the GUI.*/
     QFile                               m_qFileOut;         /**< QFile for writing to fif file.*/
-    FiffStream::SPtr                    m_pOutfid;          /**< FiffStream to write to.*/
-
-    MatrixXd                            m_cals;
+    FiffRawWriter::SPtr                 m_pRawWriter;       /**< Asynchronous writer of the recording.*/
 
 
     bool    m_bIsRunning;
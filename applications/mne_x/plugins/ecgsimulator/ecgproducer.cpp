@@ -41,6 +41,8 @@
 #include "ecgproducer.h"
 #include "ecgsimulator.h"
 
+#include <generics/playbackclock.h>
+
 #include <QDebug>
 
 
@@ -90,7 +92,11 @@ void ECGProducer::stop()
 
 void ECGProducer::run()
 {
-    unsigned int uiSamplePeriod = (unsigned int) (1000000.0/(m_pECGSimulator->m_fSamplingRate));
+    // Paced per sample against absolute deadlines, a per sample usleep drifts by its overshoot every sample
+    PlaybackClock t_clock;
+    t_clock.setPeriod(m_pECGSimulator->m_fSamplingRate);
+    t_clock.start();
+
     int uiCounter_I = 0;
     int uiCounter_II = 0;
     int uiCounter_III = 0;
@@ -102,7 +108,7 @@ void ECGProducer::run()
 
     while(m_bIsRunning)
     {
-        usleep(uiSamplePeriod);
+        t_clock.wait();
 
         //ECG I
         if(m_pECGSimulator->m_pECGChannel_ECG_I->isEnabled())
@@ -130,6 +130,13 @@ void FiffSimulator::initConnector()
 {
     if(m_pFiffInfo)
     {
+        // Block output first - auto connection prefers it for receivers which accept blocks
+        m_pRTMSB_FiffSimulator = PluginOutputData<NewRealTimeMultiSampleBlock>::create(this, "FiffSimulatorBlock", "Fiff Simulator Block Output");
+
+        m_pRTMSB_FiffSimulator->data()->initFromFiffInfo(m_pFiffInfo);
+
+        m_outputConnectors.append(m_pRTMSB_FiffSimulator);
+
         m_pRTMSA_FiffSimulator = PluginOutputData<NewRealTimeMultiSampleArray>::create(this, "FiffSimulator", "Fiff Simulator Output");
 
         m_pRTMSA_FiffSimulator->data()->initFromFiffInfo(m_pFiffInfo);
@@ -374,13 +381,23 @@ void FiffSimulator::run()
 {
 
     MatrixXf matValue;
+    MatrixXd matBlock;
     while(true)
     {
         //pop matrix
         matValue = m_pRawMatrixBuffer_In->pop();
 
-        //emit values
-        for(qint32 i = 0; i < matValue.cols(); ++i)
-            m_pRTMSA_FiffSimulator->data()->setValue(matValue.col(i).cast<double>());
+        //stamp the block on its arrival
+        qint64 t_iTimestamp = Tracer::now();
+        Tracer::Scope trace("FiffSimulator::emit", t_iTimestamp);
+
+        //emit the whole block once - its memory is handed over to the shared block
+        matBlock = matValue.cast<double>();
+        m_pRTMSB_FiffSimulator->data()->setValue(matBlock, t_iTimestamp);
+
+        //emit values - only displays and receivers which still take single samples need them
+        if(m_pRTMSA_FiffSimulator->isConnected())
+            for(qint32 i = 0; i < matValue.cols(); ++i)
+                m_pRTMSA_FiffSimulator->data()->setValue(matValue.col(i).cast<double>());
     }
 }
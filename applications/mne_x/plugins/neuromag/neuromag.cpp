@@ -131,6 +131,13 @@ void Neuromag::initConnector()
 {
     if(m_pFiffInfo)
     {
+        // Block output first - auto connection prefers it for receivers which accept blocks
+        m_pRTMSB_Neuromag = PluginOutputData<NewRealTimeMultiSampleBlock>::create(this, "RtClientBlock", "MNE Rt Client Block");
+
+        m_pRTMSB_Neuromag->data()->initFromFiffInfo(m_pFiffInfo);
+
+        m_outputConnectors.append(m_pRTMSB_Neuromag);
+
         m_pRTMSA_Neuromag = PluginOutputData<NewRealTimeMultiSampleArray>::create(this, "RtClient", "MNE Rt Client");
 
         m_pRTMSA_Neuromag->data()->initFromFiffInfo(m_pFiffInfo);
@@ -379,15 +386,25 @@ void Neuromag::run()
 {
 
     MatrixXf matValue;
+    MatrixXd matBlock;
     while(true)
     {
         //pop matrix
         matValue = m_pRawMatrixBuffer_In->pop();
 //        std::cout << "matValue " << matValue.block(0,0,1,10) << std::endl;
 
-        //emit values
-        for(qint32 i = 0; i < matValue.cols(); ++i)
-            m_pRTMSA_Neuromag->data()->setValue(matValue.col(i).cast<double>());
+        //stamp the block on its arrival
+        qint64 t_iTimestamp = Tracer::now();
+        Tracer::Scope trace("Neuromag::emit", t_iTimestamp);
+
+        //emit the whole block once - its memory is handed over to the shared block
+        matBlock = matValue.cast<double>();
+        m_pRTMSB_Neuromag->data()->setValue(matBlock, t_iTimestamp);
+
+        //emit values - only displays and receivers which still take single samples need them
+        if(m_pRTMSA_Neuromag->isConnected())
+            for(qint32 i = 0; i < matValue.cols(); ++i)
+                m_pRTMSA_Neuromag->data()->setValue(matValue.col(i).cast<double>());
 //        for(qint32 i = 0; i < matValue.cols(); i += 100)
 //            m_pRTMSA_Neuromag->setValue(matValue.col(i).cast<double>());
     }
@@ -47,7 +47,9 @@
 #include <mne_x/Interfaces/ISensor.h>
 #include <generics/circularbuffer_old.h>
 #include <generics/circularmatrixbuffer.h>
+#include <generics/tracer.h>
 #include <xMeas/newrealtimemultisamplearray.h>
+#include <xMeas/newrealtimemultisampleblock.h>
 
 
 //*************************************************************************************************************
@@ -223,6 +225,7 @@ private:
 //    float           m_fSamplingRate;                /**< The sampling rate.*/
 //    int             m_iDownsamplingFactor;          /**< The down sampling factor.*/
 
+    PluginOutputData<NewRealTimeMultiSampleBlock>::SPtr m_pRTMSB_Neuromag;   /**< The NewRealTimeMultiSampleBlock to provide the rt_server Channels blockwise to processing plugins.*/
     PluginOutputData<NewRealTimeMultiSampleArray>::SPtr m_pRTMSA_Neuromag;   /**< The NewRealTimeMultiSampleArray to provide the rt_server Channels.*/
 
     QSharedPointer<RtCmdClient> m_pRtCmdClient; /**< The command client.*/
@@ -90,10 +90,17 @@ SourceLabSetupWidget::SourceLabSetupWidget(SourceLab* toolbox, QWidget *parent)
     else
         ui.m_qLabel_surfaceStat->setText("loaded");
 
+    ui.m_qCheckBox_FactoredKernel->setChecked(m_pSourceLab->m_bFactoredKernel);
+    ui.m_qCheckBox_SinglePrecision->setChecked(m_pSourceLab->m_bSinglePrecision);
+
     connect(ui.m_qPushButton_About, &QPushButton::released, this, &SourceLabSetupWidget::showAboutDialog);
     connect(ui.m_qPushButton_FwdFileDialog, &QPushButton::released, this, &SourceLabSetupWidget::showFwdFileDialog);
     connect(ui.m_qPushButton_AtlasDirDialog, &QPushButton::released, this, &SourceLabSetupWidget::showAtlasDirDialog);
     connect(ui.m_qPushButton_SurfaceDirDialog, &QPushButton::released, this, &SourceLabSetupWidget::showSurfaceDirDialog);
+    connect(ui.m_qCheckBox_FactoredKernel, static_cast<void (QCheckBox::*)(bool)>(&QCheckBox::clicked),
+            this, &SourceLabSetupWidget::setKernelOptions);
+    connect(ui.m_qCheckBox_SinglePrecision, static_cast<void (QCheckBox::*)(bool)>(&QCheckBox::clicked),
+            this, &SourceLabSetupWidget::setKernelOptions);
 }
 
 
@@ -191,3 +198,12 @@ void SourceLabSetupWidget::showSurfaceDirDialog()
         ui.m_qLabel_surfaceStat->setText("not loaded");
     }
 }
+
+
+//*************************************************************************************************************
+
+void SourceLabSetupWidget::setKernelOptions()
+{
+    m_pSourceLab->m_bFactoredKernel = ui.m_qCheckBox_FactoredKernel->isChecked();
+    m_pSourceLab->m_bSinglePrecision = ui.m_qCheckBox_SinglePrecision->isChecked();
+}
@@ -130,6 +130,12 @@ private:
     */
     void showSurfaceDirDialog();
 
+    //=========================================================================================================
+    /**
+    * Takes over the kernel options, they are applied with the next inverse operator
+    */
+    void setKernelOptions();
+
 
     SourceLab* m_pSourceLab;            /**< Holds a pointer to corresponding DummyToolbox.*/
 
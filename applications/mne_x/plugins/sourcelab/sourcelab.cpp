@@ -69,7 +69,10 @@ using namespace XMEASLIB;
 //=============================================================================================================
 
 SourceLab::SourceLab()
-: m_bIsRunning(false)
+: m_iNumChannels(0)
+, m_iBlockSize(0)
+, m_iShapeMismatches(0)
+, m_bIsRunning(false)
 , m_bReceiveData(false)
 , m_bProcessData(false)
 , m_qFileFwdSolution("./MNE-sample-data/MEG/sample/sample_audvis-meg-eeg-oct-6-fwd.fif")
@@ -77,7 +80,9 @@ SourceLab::SourceLab()
 , m_sSurfaceDir("./MNE-sample-data/subjects/sample/surf")
 , m_iNumAverages(10)
 , m_bSingleTrial(false)
-, m_iStimChan(0)
+, m_iTriggerCode(1)
+, m_bFactoredKernel(false)
+, m_bSinglePrecision(false)
 , m_iDownSample(4)
 {
 
@@ -120,9 +125,13 @@ void SourceLab::init()
 
     //Delete Buffer - will be initailzed with first incoming data
     if(!m_pSourceLabBuffer.isNull())
-        m_pSourceLabBuffer = CircularMatrixBuffer<double>::SPtr();
+        m_pSourceLabBuffer = CircularBuffer<MultiSampleBlock::ConstSPtr>::SPtr();
 
     // Input
+    m_pRTMSBInput = PluginInputData<NewRealTimeMultiSampleBlock>::create(this, "SourceLabBlockIn", "SourceLab block input data");
+    connect(m_pRTMSBInput.data(), &PluginInputConnector::notify, this, &SourceLab::update, Qt::DirectConnection);
+    m_inputConnectors.append(m_pRTMSBInput);
+
     m_pRTMSAInput = PluginInputData<NewRealTimeMultiSampleArray>::create(this, "SourceLabIn", "SourceLab input data");
     connect(m_pRTMSAInput.data(), &PluginInputConnector::notify, this, &SourceLab::update, Qt::DirectConnection);
     m_inputConnectors.append(m_pRTMSAInput);
@@ -246,6 +255,33 @@ QWidget* SourceLab::setupWidget()
 
 void SourceLab::update(XMEASLIB::NewMeasurement::SPtr pMeasurement)
 {
+    //MEG - whole blocks, shared with the producer
+    QSharedPointer<NewRealTimeMultiSampleBlock> pRTMSB = pMeasurement.dynamicCast<NewRealTimeMultiSampleBlock>();
+    if(pRTMSB && m_bReceiveData)
+    {
+        MultiSampleBlock::ConstSPtr t_pBlock = pRTMSB->getValue();
+        if(!t_pBlock)
+            return;
+
+        //Check if buffer initialized
+        if(!m_pSourceLabBuffer)
+        {
+            m_iNumChannels = t_pBlock->data().rows();
+            m_iBlockSize = t_pBlock->data().cols();
+            m_pSourceLabBuffer = CircularBuffer<MultiSampleBlock::ConstSPtr>::SPtr(new CircularBuffer<MultiSampleBlock::ConstSPtr>(64));
+        }
+
+        //Fiff information
+        if(!m_pFiffInfo)
+            m_pFiffInfo = pRTMSB->getFiffInfo();
+
+        //Queue the block itself - it is shared with the producer and not copied
+        if(m_bProcessData)
+            m_pSourceLabBuffer->push(t_pBlock);
+
+        return;
+    }
+
     QSharedPointer<NewRealTimeMultiSampleArray> pRTMSA = pMeasurement.dynamicCast<NewRealTimeMultiSampleArray>();
 
     //MEG
@@ -253,7 +289,11 @@ void SourceLab::update(XMEASLIB::NewMeasurement::SPtr pMeasurement)
     {
         //Check if buffer initialized
         if(!m_pSourceLabBuffer)
-            m_pSourceLabBuffer = CircularMatrixBuffer<double>::SPtr(new CircularMatrixBuffer<double>(64, pRTMSA->getNumChannels(), pRTMSA->getMultiArraySize()));
+        {
+            m_iNumChannels = pRTMSA->getNumChannels();
+            m_iBlockSize = pRTMSA->getMultiArraySize();
+            m_pSourceLabBuffer = CircularBuffer<MultiSampleBlock::ConstSPtr>::SPtr(new CircularBuffer<MultiSampleBlock::ConstSPtr>(64));
+        }
 
         //Fiff information
         if(!m_pFiffInfo)
@@ -263,10 +303,11 @@ void SourceLab::update(XMEASLIB::NewMeasurement::SPtr pMeasurement)
         {
             MatrixXd t_mat(pRTMSA->getNumChannels(), pRTMSA->getMultiArraySize());
 
-            for(unsigned char i = 0; i < pRTMSA->getMultiArraySize(); ++i)
+            for(qint32 i = 0; i < pRTMSA->getMultiArraySize(); ++i)
                 t_mat.col(i) = pRTMSA->getMultiSampleArray()[i];
 
-            m_pSourceLabBuffer->push(&t_mat);
+            //The sample arrays carry neither an acquisition time nor their position in the stream, stamp them on their arrival
+            m_pSourceLabBuffer->push(MultiSampleBlock::adopt(t_mat, -1, Tracer::now()));
         }
     }
 }
@@ -274,9 +315,9 @@ void SourceLab::update(XMEASLIB::NewMeasurement::SPtr pMeasurement)
 
 //*************************************************************************************************************
 
-void SourceLab::appendEvoked(FiffEvoked::SPtr p_pEvoked)
+void SourceLab::appendEvoked(qint32 p_iCode, FiffEvoked::SPtr p_pEvoked)
 {
-    if(p_pEvoked->comment == QString("Stim %1").arg(m_iStimChan))
+    if(p_iCode == m_iTriggerCode)
     {
         std::cout << p_pEvoked->comment.toLatin1().constData() << " append" << std::endl;
 
@@ -309,12 +350,17 @@ void SourceLab::updateInvOp(MNEInverseOperator::SPtr p_pInvOp)
 
     QString method("dSPM"); //"MNE" | "dSPM" | "sLORETA"
 
-    mutex.lock();
-    m_pMinimumNorm = MinimumNorm::SPtr(new MinimumNorm(*m_pInvOp.data(), lambda2, method));
     //
-    //   Set up the inverse according to the parameters
+    //   Set up the inverse according to the parameters, off the data path
     //
-    m_pMinimumNorm->doInverseSetup(m_iNumAverages,false);
+    MinimumNorm::SPtr t_pMinimumNorm(new MinimumNorm(*m_pInvOp.data(), lambda2, method));
+    t_pMinimumNorm->setFactoredKernel(m_bFactoredKernel);
+    t_pMinimumNorm->setSinglePrecision(m_bSinglePrecision);
+    t_pMinimumNorm->doInverseSetup(m_iNumAverages,false);
+
+    // Publish the new kernel; the data path only swaps pointers under the lock
+    mutex.lock();
+    m_pMinimumNorm = t_pMinimumNorm;
     mutex.unlock();
 }
 
@@ -372,6 +418,14 @@ void SourceLab::run()
         connect(m_pRtAve.data(), &RtAve::evokedStim, this, &SourceLab::appendEvoked);
     }
 
+    //
+    // Attach the rt helpers to one shared copy of the incoming data
+    //
+    m_pBroadcastBuffer = BroadcastMatrixBuffer<double>::SPtr(new BroadcastMatrixBuffer<double>(128, m_iNumChannels, m_iBlockSize));
+    m_pRtCov->attach(m_pBroadcastBuffer, BroadcastMatrixBuffer<double>::Skip);
+    if(!m_bSingleTrial)
+        m_pRtAve->attach(m_pBroadcastBuffer, BroadcastMatrixBuffer<double>::Skip);
+
     //
     // Start the rt helpers
     //
@@ -386,63 +440,85 @@ void SourceLab::run()
     m_bProcessData = true;
 
     qint32 skip_count = 0;
+    quint64 t_iAveDropped = 0;
 
     while(m_bIsRunning)
     {
-        qint32 nrows = m_pSourceLabBuffer->rows();
-
-        if(nrows > 0) // check if init
+        if(m_iNumChannels > 0) // check if init
         {
             /* Dispatch the inputs */
-            MatrixXd t_mat = m_pSourceLabBuffer->pop();
+            MultiSampleBlock::ConstSPtr t_pBlock = m_pSourceLabBuffer->pop();
+            if(!t_pBlock)
+                continue;
 
-            //Add to covariance estimation
-            m_pRtCov->append(t_mat);
+            const MatrixXd& t_mat = t_pBlock->data();
+            qint64 t_iTimestamp = t_pBlock->timestamp();
+
+            Tracer::Scope trace("SourceLab", t_iTimestamp);
+
+            //Add to covariance estimation and averaging - the broadcast buffer holds blocks of the first block's size only
+            if(t_mat.rows() == m_iNumChannels && t_mat.cols() == m_iBlockSize)
+                m_pBroadcastBuffer->push(&t_mat, true, t_iTimestamp);
+            else if(++m_iShapeMismatches == 1 || m_iShapeMismatches % 1000 == 0)
+                qWarning("%s: %lld blocks skipped for covariance and averaging, last %d x %d instead of %d x %d",
+                         getName().toUtf8().constData(), m_iShapeMismatches, (int)t_mat.rows(), (int)t_mat.cols(), m_iNumChannels, m_iBlockSize);
+
+            //The averaging skips blocks rather than stalling the data path
+            if(!m_bSingleTrial && m_pRtAve->dropped() != t_iAveDropped)
+            {
+                t_iAveDropped = m_pRtAve->dropped();
+                qWarning("%s: averaging fell behind, %llu blocks dropped", getName().toUtf8().constData(), t_iAveDropped);
+            }
 
             if(m_bSingleTrial)
             {
                 //Continous Data
                 mutex.lock();
-                if(m_pMinimumNorm && t_mat.cols() > 0)
+                MinimumNorm::SPtr t_pMinimumNorm = m_pMinimumNorm;
+                mutex.unlock();
+
+                if(t_pMinimumNorm && t_mat.cols() > 0)
                 {
                     //
                     // calculate the inverse
                     //
-                    MNESourceEstimate sourceEstimate = m_pMinimumNorm->calculateInverse(t_mat, 0, 1/m_pFiffInfo->sfreq);
+                    MNESourceEstimate sourceEstimate = t_pMinimumNorm->calculateInverse(t_mat, 0, 1/m_pFiffInfo->sfreq);
 
                     std::cout << "Source Estimated" << std::endl;
                 }
-                mutex.unlock();
             }
             else
             {
                 //Average Data
-                m_pRtAve->append(t_mat);
-
-
-
                 mutex.lock();
-                if(m_pMinimumNorm && m_qVecEvokedData.size() > 0 && skip_count > 2)
+                MinimumNorm::SPtr t_pMinimumNorm = m_pMinimumNorm;
+                FiffEvoked::SPtr t_pFiffEvoked;
+                if(t_pMinimumNorm && m_qVecEvokedData.size() > 0 && skip_count > 2)
                 {
-                    FiffEvoked t_fiffEvoked = *m_qVecEvokedData[0].data();
+                    t_pFiffEvoked = m_qVecEvokedData[0];
+                    m_qVecEvokedData.pop_front();
+                }
+                mutex.unlock();
+
+                if(t_pFiffEvoked)
+                {
+                    const FiffEvoked &t_fiffEvoked = *t_pFiffEvoked.data();
 
                     float tmin = ((float)t_fiffEvoked.first) / t_fiffEvoked.info.sfreq;
                     float tstep = 1/t_fiffEvoked.info.sfreq;
 
-                    MNESourceEstimate sourceEstimate = m_pMinimumNorm->calculateInverse(t_fiffEvoked.data, tmin, tstep);
+                    MNESourceEstimate sourceEstimate = t_pMinimumNorm->calculateInverse(t_fiffEvoked.data, tmin, tstep);
 
                     std::cout << "SourceEstimated:\n" << std::endl;
     //                std::cout << "SourceEstimated:\n" << sourceEstimate.data.block(0,0,10,10) << std::endl;
 
-                    //emit source estimates sample wise
+                    //emit source estimates sample wise, stamped with the newest data they were computed at
+                    m_pRTSEOutput->data()->setTimestamp(t_iTimestamp);
                     for(qint32 i = 0; i < sourceEstimate.data.cols(); i += m_iDownSample)
                         m_pRTSEOutput->data()->setValue(sourceEstimate.data.col(i));
 
-                    m_qVecEvokedData.pop_front();
-
                     skip_count = 0;
                 }
-                mutex.unlock();
 
                 ++skip_count;
             }
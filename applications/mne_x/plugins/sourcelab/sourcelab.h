@@ -45,7 +45,9 @@
 #include "sourcelab_global.h"
 #include <mne_x/Interfaces/IAlgorithm.h>
 
-#include <generics/circularmatrixbuffer.h>
+#include <generics/circularbuffer.h>
+#include <generics/broadcastmatrixbuffer.h>
+#include <generics/tracer.h>
 
 #include <fs/annotationset.h>
 #include <fs/surfaceset.h>
@@ -60,6 +62,7 @@
 
 #include <xMeas/realtimesourceestimate.h>
 #include <xMeas/newrealtimemultisamplearray.h>
+#include <xMeas/newrealtimemultisampleblock.h>
 
 
 //*************************************************************************************************************
@@ -151,11 +154,12 @@ public:
 
     //=========================================================================================================
     /**
-    * Append evoked
+    * Append evoked, only the evoked data of the selected trigger code are kept
     *
+    * @param[in] p_iCode    The trigger code the evoked data were averaged for
     * @param[in] p_pEvoked  The evoked to be appended
     */
-    void appendEvoked(FiffEvoked::SPtr p_pEvoked);
+    void appendEvoked(qint32 p_iCode, FiffEvoked::SPtr p_pEvoked);
 
     void update(XMEASLIB::NewMeasurement::SPtr pMeasurement);
 
@@ -179,6 +183,7 @@ protected:
     virtual void run();
 
 private:
+    PluginInputData<NewRealTimeMultiSampleBlock>::SPtr  m_pRTMSBInput;  /**< The RealTimeMultiSampleBlock input.*/
     PluginInputData<NewRealTimeMultiSampleArray>::SPtr  m_pRTMSAInput;  /**< The RealTimeMultiSampleArray input.*/
 
     PluginOutputData<RealTimeSourceEstimate>::SPtr      m_pRTSEOutput;  /**< The RealTimeSourceEstimate output.*/
@@ -186,7 +191,11 @@ private:
 
     QMutex mutex;
 
-    CircularMatrixBuffer<double>::SPtr m_pSourceLabBuffer;   /**< Holds incoming rt server data.*/
+    CircularBuffer<MultiSampleBlock::ConstSPtr>::SPtr m_pSourceLabBuffer;   /**< Holds the incoming blocks, shared with their producer.*/
+    BroadcastMatrixBuffer<double>::SPtr m_pBroadcastBuffer;  /**< Hands each data block once to the rt helpers.*/
+    qint32 m_iNumChannels;  /**< Number of channels of the incoming blocks, 0 until the first block arrived. */
+    qint32 m_iBlockSize;    /**< Number of samples of the incoming blocks. */
+    qint64 m_iShapeMismatches;  /**< Number of blocks not matching m_iNumChannels x m_iBlockSize, not handed to the rt helpers. */
 
     bool m_bIsRunning;      /**< If source lab is running */
     bool m_bReceiveData;    /**< If thread is ready to receive data */
@@ -215,9 +224,11 @@ private:
     qint32                      m_iNumAverages;     /**< Number of averages. */
     bool                        m_bSingleTrial;     /**< Single trial mode, or averages */
     QVector<FiffEvoked::SPtr>   m_qVecEvokedData;   /**< Evoked data set */
-    qint32                      m_iStimChan;        /**< Stimulus Channel to use for source estimation */
+    qint32                      m_iTriggerCode;     /**< Trigger code of the evoked data to use for source estimation */
 
     MinimumNorm::SPtr           m_pMinimumNorm;     /**< Minimum Norm Estimation. */
+    bool                        m_bFactoredKernel;  /**< Whether the kernel is applied factored, taken over at the next inverse operator. */
+    bool                        m_bSinglePrecision; /**< Whether the kernel is applied in single precision, taken over at the next inverse operator. */
     qint32                      m_iDownSample;      /**< Sampling rate */
 
 //    RealTimeSourceEstimate::SPtr m_pRTSE_SourceLab; /**< Source Estimate output channel. */
@@ -471,9 +471,10 @@ bool TMSI::start()
 
         setUpFiffInfo();
 
-        m_pOutfid = Fiff::start_writing_raw(m_fileOut, *m_pFiffInfo, m_cals);
-        fiff_int_t first = 0;
-        m_pOutfid->write_int(FIFF_FIRST_SAMPLE, &first);
+        //Disk writes run on the writer thread, a stalled disk drops buffers instead of blocking the acquisition
+        m_pRawWriter = FiffRawWriter::SPtr(new FiffRawWriter);
+        if(!m_pRawWriter->start(m_fileOut, *m_pFiffInfo))
+            return false;
     }
     else
         setUpFiffInfo();
@@ -580,6 +581,18 @@ void TMSI::setKeyboardTriggerType(int type)
 }
 
 
+//*************************************************************************************************************
+
+void TMSI::showRecordingError()
+{
+    QMessageBox msgBox;
+    msgBox.setIcon(QMessageBox::Warning);
+    msgBox.setText("The recording was stopped, writing to the file failed.");
+    msgBox.setInformativeText(QString("%1\n%2 bytes could not be written.").arg(m_pRawWriter->errorString()).arg(m_pRawWriter->bytesFailed()));
+    msgBox.exec();
+}
+
+
 //*************************************************************************************************************
 
 void TMSI::run()
@@ -608,9 +621,18 @@ void TMSI::run()
             if(m_bUseKeyboardTrigger && m_iTriggerType!=0)
                 matValue(136, m_iSamplesPerBlock-1) = m_iTriggerType;
 
-            //Write raw data to fif file
-            if(m_bWriteToFile)
-                m_pOutfid->write_raw_buffer(matValue.cast<double>(), m_cals);
+            //Write raw data to fif file - a failed disk write ends the recording, the acquisition goes on
+            if(m_bWriteToFile && m_pRawWriter->isRunning())
+            {
+                m_pRawWriter->append(matValue.cast<double>());
+
+                if(m_pRawWriter->hasError())
+                {
+                    m_pRawWriter->stop();
+                    qWarning() << "Plugin TMSI - ERROR - Recording stopped, writing to" << m_sOutputFilePath << "failed:" << m_pRawWriter->errorString() << "-" << m_pRawWriter->bytesFailed() << "bytes and" << m_pRawWriter->failedBuffers() << "buffers were not written.";
+                    QMetaObject::invokeMethod(this, "showRecordingError", Qt::QueuedConnection);
+                }
+            }
 
             // TODO: Use preprocessing if wanted by the user
             if(m_bUseFiltering)
@@ -696,7 +718,7 @@ void TMSI::run()
 
     //Close the fif output stream
     if(m_bWriteToFile)
-        m_pOutfid->finish_writing_raw();
+        m_pRawWriter->stop();
 
     //std::cout<<"EXITING - TMSI::run()"<<std::endl;
 }
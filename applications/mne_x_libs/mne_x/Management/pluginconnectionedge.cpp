@@ -0,0 +1,299 @@
+//=============================================================================================================
+/**
+* @file     pluginconnectionedge.cpp
+* @author   Christoph Dinh <chdinh@nmr.mgh.harvard.edu>;
+*           Matti Hamalainen <msh@nmr.mgh.harvard.edu>
+* @version  1.0
+* @date     October, 2026
+*
+* @section  LICENSE
+*
+* Copyright (C) 2026, Christoph Dinh and Matti Hamalainen. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+* the following conditions are met:
+*     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+*       following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+*       the following disclaimer in the documentation and/or other materials provided with the distribution.
+*     * Neither the name of the Massachusetts General Hospital nor the names of its contributors may be used
+*       to endorse or promote products derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+* PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL MASSACHUSETTS GENERAL HOSPITAL BE LIABLE FOR ANY DIRECT,
+* INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+* NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+* @brief    Contains the implementation of the PluginConnectionEdge class.
+*
+*/
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include "pluginconnectionedge.h"
+#include "pluginscheduler.h"
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// QT INCLUDES
+//=============================================================================================================
+
+#include <QMutexLocker>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// USED NAMESPACES
+//=============================================================================================================
+
+using namespace MNEX;
+using namespace XMEASLIB;
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINE MEMBER METHODS
+//=============================================================================================================
+
+PluginConnectionEdge::PluginConnectionEdge(IPlugin* pReceiverPlugin, QSharedPointer<PluginInputConnector> pReceiver, Policy policy, qint32 capacity, QObject *parent)
+: QObject(parent)
+, m_pReceiverMutex(PluginScheduler::receiverMutex(pReceiverPlugin))
+, m_pReceiver(pReceiver)
+, m_policy(policy)
+, m_iCapacity(0)
+, m_iHead(0)
+, m_iCount(0)
+, m_iTicket(0)
+, m_iCompleted(0)
+, m_bScheduled(false)
+, m_bClosed(false)
+, m_iLatencySum(0)
+{
+    m_statistics.iReceived = 0;
+    m_statistics.iDelivered = 0;
+    m_statistics.iDropped = 0;
+    m_statistics.iQueued = 0;
+    m_statistics.iMaxQueued = 0;
+    m_statistics.iLastLatency = 0;
+    m_statistics.iMeanLatency = 0;
+    m_statistics.iMaxLatency = 0;
+
+    m_timer.start();
+
+    setPolicy(policy, capacity);
+}
+
+
+//*************************************************************************************************************
+
+PluginConnectionEdge::~PluginConnectionEdge()
+{
+    close();
+}
+
+
+//*************************************************************************************************************
+
+void PluginConnectionEdge::setPolicy(Policy policy, qint32 capacity)
+{
+    QMutexLocker locker(&m_mutex);
+
+    m_policy = policy;
+    m_iCapacity = capacity > 0 ? capacity : 0;
+
+    qint32 t_iSlots = m_policy == CoalesceLatest ? 1 : qMax(1, m_iCapacity);
+    if(t_iSlots != m_qVecItems.size())
+    {
+        dropOldest(t_iSlots);
+
+        QVector<Item> t_qVecItems(t_iSlots);
+        for(qint32 k = 0; k < m_iCount; ++k)
+            t_qVecItems[k] = m_qVecItems[(m_iHead + k) % m_qVecItems.size()];
+
+        m_qVecItems.swap(t_qVecItems);
+        m_iHead = 0;
+    }
+
+    m_notFull.wakeAll();
+    m_delivered.wakeAll();
+}
+
+
+//*************************************************************************************************************
+
+PluginConnectionEdge::Policy PluginConnectionEdge::policy() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_policy;
+}
+
+
+//*************************************************************************************************************
+
+qint32 PluginConnectionEdge::capacity() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_iCapacity;
+}
+
+
+//*************************************************************************************************************
+
+PluginConnectionEdge::Statistics PluginConnectionEdge::statistics() const
+{
+    QMutexLocker locker(&m_mutex);
+
+    Statistics t_statistics = m_statistics;
+    t_statistics.iQueued = m_iCount;
+    t_statistics.iMeanLatency = m_statistics.iDelivered > 0 ? m_iLatencySum / (qint64)m_statistics.iDelivered : 0;
+
+    return t_statistics;
+}
+
+
+//*************************************************************************************************************
+
+void PluginConnectionEdge::close()
+{
+    QMutexLocker locker(&m_mutex);
+
+    m_bClosed = true;
+    dropOldest(0);
+
+    m_notFull.wakeAll();
+    m_delivered.wakeAll();
+
+    while(m_bScheduled)
+        m_idle.wait(&m_mutex);
+}
+
+
+//*************************************************************************************************************
+
+void PluginConnectionEdge::push(NewMeasurement::SPtr pMeasurement)
+{
+    //Producers overwrite their measurement with every update; queue a snapshot of this notify. Measurements
+    //without snapshot are shared with the producer and always handed over in a rendezvous.
+    NewMeasurement::SPtr t_pSnapshot = pMeasurement->snapshot();
+    bool t_bShared = t_pSnapshot.isNull();
+    if(!t_bShared)
+        pMeasurement = t_pSnapshot;
+
+    QMutexLocker locker(&m_mutex);
+
+    if(m_bClosed)
+        return;
+
+    ++m_statistics.iReceived;
+
+    if(m_iCount == m_qVecItems.size())
+    {
+        if(m_policy == Block)
+        {
+            while(m_iCount == m_qVecItems.size() && !m_bClosed)
+                PluginScheduler::wait(m_notFull, m_mutex);
+
+            if(m_bClosed)
+                return;
+        }
+        else
+            dropOldest(m_qVecItems.size() - 1);
+    }
+
+    Item &t_item = m_qVecItems[(m_iHead + m_iCount) % m_qVecItems.size()];
+    t_item.pMeasurement = pMeasurement;
+    t_item.iEnqueued = m_timer.nsecsElapsed();
+    t_item.iTicket = ++m_iTicket;
+    ++m_iCount;
+
+    if(m_iCount > m_statistics.iMaxQueued)
+        m_statistics.iMaxQueued = m_iCount;
+
+    quint64 t_iTicket = m_iTicket;
+
+    if(!m_bScheduled)
+    {
+        m_bScheduled = true;
+        PluginScheduler::schedule(this);
+    }
+
+    //Rendezvous - the producer may only overwrite the measurement after its delivery
+    if(t_bShared || (m_policy == Block && m_iCapacity == 0))
+        while(m_iCompleted < t_iTicket && !m_bClosed)
+            PluginScheduler::wait(m_delivered, m_mutex);
+}
+
+
+//*************************************************************************************************************
+
+void PluginConnectionEdge::drain()
+{
+    //Deliveries per run, afterwards the edge queues up again behind the other edges
+    const qint32 t_iMaxBatch = 16;
+
+    QMutexLocker locker(&m_mutex);
+
+    for(qint32 t_iBatch = 0; t_iBatch < t_iMaxBatch && m_iCount > 0 && !m_bClosed; ++t_iBatch)
+    {
+        Item t_item = m_qVecItems[m_iHead];
+        m_qVecItems[m_iHead].pMeasurement.clear();
+        m_iHead = (m_iHead + 1) % m_qVecItems.size();
+        --m_iCount;
+        m_notFull.wakeOne();
+
+        locker.unlock();
+
+        m_pReceiverMutex->lock();
+        m_pReceiver->update(t_item.pMeasurement);
+        m_pReceiverMutex->unlock();
+
+        qint64 t_iLatency = m_timer.nsecsElapsed() - t_item.iEnqueued;
+        t_item.pMeasurement.clear();
+
+        locker.relock();
+
+        ++m_statistics.iDelivered;
+        m_statistics.iLastLatency = t_iLatency;
+        if(t_iLatency > m_statistics.iMaxLatency)
+            m_statistics.iMaxLatency = t_iLatency;
+        m_iLatencySum += t_iLatency;
+
+        if(t_item.iTicket > m_iCompleted)
+            m_iCompleted = t_item.iTicket;
+        m_delivered.wakeAll();
+    }
+
+    if(m_iCount > 0 && !m_bClosed)
+    {
+        PluginScheduler::schedule(this);
+        return;
+    }
+
+    m_bScheduled = false;
+    m_idle.wakeAll();
+}
+
+
+//*************************************************************************************************************
+
+void PluginConnectionEdge::dropOldest(qint32 p_iCount)
+{
+    while(m_iCount > p_iCount)
+    {
+        m_iCompleted = m_qVecItems[m_iHead].iTicket;
+        m_qVecItems[m_iHead].pMeasurement.clear();
+        m_iHead = (m_iHead + 1) % m_qVecItems.size();
+        --m_iCount;
+        ++m_statistics.iDropped;
+    }
+
+    m_delivered.wakeAll();
+}
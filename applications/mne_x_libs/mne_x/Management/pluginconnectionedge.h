@@ -0,0 +1,244 @@
+//=============================================================================================================
+/**
+* @file     pluginconnectionedge.h
+* @author   Christoph Dinh <chdinh@nmr.mgh.harvard.edu>;
+*           Matti Hamalainen <msh@nmr.mgh.harvard.edu>
+* @version  1.0
+* @date     October, 2026
+*
+* @section  LICENSE
+*
+* Copyright (C) 2026, Christoph Dinh and Matti Hamalainen. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+* the following conditions are met:
+*     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+*       following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+*       the following disclaimer in the documentation and/or other materials provided with the distribution.
+*     * Neither the name of the Massachusetts General Hospital nor the names of its contributors may be used
+*       to endorse or promote products derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+* PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL MASSACHUSETTS GENERAL HOSPITAL BE LIABLE FOR ANY DIRECT,
+* INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+* NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+* @brief    Contains the declaration of the PluginConnectionEdge class.
+*
+*/
+
+#ifndef PLUGINCONNECTIONEDGE_H
+#define PLUGINCONNECTIONEDGE_H
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include "../mne_x_global.h"
+
+#include "plugininputconnector.h"
+
+#include <xMeas/newmeasurement.h>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// Qt INCLUDES
+//=============================================================================================================
+
+#include <QObject>
+#include <QSharedPointer>
+#include <QVector>
+#include <QMutex>
+#include <QWaitCondition>
+#include <QElapsedTimer>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINE NAMESPACE MNEX
+//=============================================================================================================
+
+namespace MNEX
+{
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// FORWARD DECLARATIONS
+//=============================================================================================================
+
+class IPlugin;
+
+
+//=============================================================================================================
+/**
+* One output to input link of the plug-in graph. The producer's notify only enqueues the measurement into a
+* bounded queue; the delivery into the receiving input connector runs on the PluginScheduler pool. What happens
+* when the queue is full is selected by the policy.
+*
+* Each notify is queued as a snapshot of the measurement (NewMeasurement::snapshot), since producers overwrite their
+* measurement with the next update. A capacity of 0 with the Block policy is a rendezvous: the producer waits
+* until its measurement has been delivered. Measurement types without snapshot, like RealTimeSourceEstimate, are
+* always handed over in a rendezvous, whatever the policy.
+*
+* @brief The PluginConnectionEdge class holds a bounded, scheduled plug-in connection
+*/
+class MNE_X_SHARED_EXPORT PluginConnectionEdge : public QObject
+{
+    Q_OBJECT
+
+    friend class PluginScheduler;
+
+public:
+    typedef QSharedPointer<PluginConnectionEdge> SPtr;              /**< Shared pointer type for PluginConnectionEdge. */
+    typedef QSharedPointer<const PluginConnectionEdge> ConstSPtr;   /**< Const shared pointer type for PluginConnectionEdge. */
+
+    //=========================================================================================================
+    /**
+    * Queue policy when a measurement arrives at a full queue.
+    */
+    enum Policy
+    {
+        Block,          /**< The producer waits for a free slot. */
+        DropOldest,     /**< The oldest queued measurement is dropped. */
+        CoalesceLatest  /**< At most one measurement is pending; a newer one replaces it. */
+    };
+
+    //=========================================================================================================
+    /**
+    * Edge counters. Latencies are measured from the producer's notify to the end of the delivery, in nanoseconds.
+    */
+    struct Statistics
+    {
+        quint64 iReceived;      /**< Measurements notified by the producer. */
+        quint64 iDelivered;     /**< Measurements delivered to the receiver. */
+        quint64 iDropped;       /**< Measurements dropped or replaced before their delivery. */
+        qint32  iQueued;        /**< Measurements currently queued. */
+        qint32  iMaxQueued;     /**< Queue high water mark. */
+        qint64  iLastLatency;   /**< Latency of the last delivery [ns]. */
+        qint64  iMeanLatency;   /**< Mean latency [ns]. */
+        qint64  iMaxLatency;    /**< Maximal latency [ns]. */
+    };
+
+    //=========================================================================================================
+    /**
+    * Constructs a PluginConnectionEdge.
+    *
+    * @param[in] pReceiverPlugin    the receiving plug-in, its deliveries are serialized.
+    * @param[in] pReceiver          the receiving input connector.
+    * @param[in] policy             the queue policy.
+    * @param[in] capacity           the queue capacity, 0 makes a Block edge a rendezvous.
+    * @param[in] parent             parent object.
+    */
+    PluginConnectionEdge(IPlugin* pReceiverPlugin, QSharedPointer<PluginInputConnector> pReceiver, Policy policy = Block, qint32 capacity = 0, QObject *parent = 0);
+
+    //=========================================================================================================
+    /**
+    * Destroys the PluginConnectionEdge after its pending delivery has finished.
+    */
+    virtual ~PluginConnectionEdge();
+
+    //=========================================================================================================
+    /**
+    * Sets the queue policy and capacity. Queued measurements which do not fit anymore are dropped, oldest first.
+    *
+    * @param[in] policy     the queue policy.
+    * @param[in] capacity   the queue capacity.
+    */
+    void setPolicy(Policy policy, qint32 capacity);
+
+    //=========================================================================================================
+    /**
+    * Returns the queue policy.
+    *
+    * @return the queue policy.
+    */
+    Policy policy() const;
+
+    //=========================================================================================================
+    /**
+    * Returns the queue capacity.
+    *
+    * @return the queue capacity.
+    */
+    qint32 capacity() const;
+
+    //=========================================================================================================
+    /**
+    * Returns a snapshot of the edge counters.
+    *
+    * @return the edge counters.
+    */
+    Statistics statistics() const;
+
+    //=========================================================================================================
+    /**
+    * Stops the edge: waiting producers return, queued measurements are discarded and the call returns once the
+    * running delivery has finished. Later notifies are ignored.
+    */
+    void close();
+
+public slots:
+    //=========================================================================================================
+    /**
+    * Enqueues the measurement according to the policy. Connected directly to the producer's output connector.
+    *
+    * @param[in] pMeasurement   the measurement to deliver.
+    */
+    void push(XMEASLIB::NewMeasurement::SPtr pMeasurement);
+
+private:
+    //=========================================================================================================
+    /**
+    * Delivers a batch of queued measurements; called by the PluginScheduler on a pool thread.
+    */
+    void drain();
+
+    //=========================================================================================================
+    /**
+    * Drops queued measurements, oldest first, until at most p_iCount remain. Expects m_mutex to be locked.
+    *
+    * @param[in] p_iCount   the number of measurements to keep.
+    */
+    void dropOldest(qint32 p_iCount);
+
+    struct Item
+    {
+        XMEASLIB::NewMeasurement::SPtr pMeasurement;    /**< The queued measurement. */
+        qint64 iEnqueued;                               /**< Time of the notify [ns]. */
+        quint64 iTicket;                                /**< Sequence number of the notify. */
+    };
+
+    QSharedPointer<QMutex> m_pReceiverMutex;            /**< Serializes the deliveries into the receiving plug-in. */
+    QSharedPointer<PluginInputConnector> m_pReceiver;   /**< The receiving input connector. */
+
+    mutable QMutex m_mutex;         /**< Guards the queue and the counters. */
+    QWaitCondition m_notFull;       /**< Signaled when a slot was freed. */
+    QWaitCondition m_delivered;     /**< Signaled after each delivery. */
+    QWaitCondition m_idle;          /**< Signaled when no drain is scheduled anymore. */
+
+    Policy m_policy;                /**< The queue policy. */
+    qint32 m_iCapacity;             /**< The queue capacity. */
+    QVector<Item> m_qVecItems;      /**< Ring of queued measurements, max(1, capacity) slots. */
+    qint32 m_iHead;                 /**< Ring index of the oldest queued measurement. */
+    qint32 m_iCount;                /**< Number of queued measurements. */
+    quint64 m_iTicket;              /**< Ticket of the last enqueued measurement. */
+    quint64 m_iCompleted;           /**< Ticket of the last delivered measurement. */
+    bool m_bScheduled;              /**< Whether a drain is scheduled or running. */
+    bool m_bClosed;                 /**< Whether the edge was closed. */
+
+    QElapsedTimer m_timer;          /**< Monotonic clock of the latency measurement. */
+    Statistics m_statistics;        /**< The counters. */
+    qint64 m_iLatencySum;           /**< Sum of all latencies [ns]. */
+};
+
+} // NAMESPACE
+
+#endif // PLUGINCONNECTIONEDGE_H
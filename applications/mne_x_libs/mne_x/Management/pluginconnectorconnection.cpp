@@ -44,6 +44,7 @@
 #include <xMeas/newnumeric.h>
 #include <xMeas/newrealtimesamplearray.h>
 #include <xMeas/newrealtimemultisamplearray.h>
+#include <xMeas/newrealtimemultisampleblock.h>
 #include <xMeas/realtimesourceestimate.h>
 
 
@@ -87,6 +88,21 @@ void PluginConnectorConnection::clearConnection()
         disconnect(it.value());
 
     m_qHashConnections.clear();
+
+    //Edges finish their running delivery when they are closed
+    foreach(PluginConnectionEdge::SPtr t_pEdge, m_qHashEdges)
+        t_pEdge->close();
+
+    m_qHashEdges.clear();
+}
+
+
+//*************************************************************************************************************
+
+void PluginConnectorConnection::setPolicy(PluginConnectionEdge::Policy policy, qint32 capacity)
+{
+    foreach(PluginConnectionEdge::SPtr t_pEdge, m_qHashEdges)
+        t_pEdge->setPolicy(policy, capacity);
 }
 
 
@@ -108,35 +124,10 @@ bool PluginConnectorConnection::createConnection()
             //ToDo make this auto connection more fancy
             // < --- Type Check --- >
 
-            //Cast to NewRealTimeSampleArray
-            QSharedPointer< PluginOutputData<NewRealTimeSampleArray> > senderRTSA = m_pSender->getOutputConnectors()[i].dynamicCast< PluginOutputData<NewRealTimeSampleArray> >();
-            QSharedPointer< PluginInputData<NewRealTimeSampleArray> > receiverRTSA = m_pReceiver->getInputConnectors()[j].dynamicCast< PluginInputData<NewRealTimeSampleArray> >();
-            if(senderRTSA && receiverRTSA)
-            {
-                m_qHashConnections.insert(QPair<QString,QString>(m_pSender->getOutputConnectors()[i]->getName(), m_pReceiver->getInputConnectors()[j]->getName()), connect(m_pSender->getOutputConnectors()[i].data(), &PluginOutputConnector::notify,
-                        m_pReceiver->getInputConnectors()[j].data(), &PluginInputConnector::update, Qt::BlockingQueuedConnection));
-                bConnected = true;
-                break;
-            }
-
-            //Cast to NewRealTimeMultiSampleArray
-            QSharedPointer< PluginOutputData<NewRealTimeMultiSampleArray> > senderRTMSA = m_pSender->getOutputConnectors()[i].dynamicCast< PluginOutputData<NewRealTimeMultiSampleArray> >();
-            QSharedPointer< PluginInputData<NewRealTimeMultiSampleArray> > receiverRTMSA = m_pReceiver->getInputConnectors()[j].dynamicCast< PluginInputData<NewRealTimeMultiSampleArray> >();
-            if(senderRTMSA && receiverRTMSA)
-            {
-                m_qHashConnections.insert(QPair<QString,QString>(m_pSender->getOutputConnectors()[i]->getName(), m_pReceiver->getInputConnectors()[j]->getName()), connect(m_pSender->getOutputConnectors()[i].data(), &PluginOutputConnector::notify,
-                        m_pReceiver->getInputConnectors()[j].data(), &PluginInputConnector::update, Qt::BlockingQueuedConnection));
-                bConnected = true;
-                break;
-            }
-
-            //Cast to RealTimeSourceEstimate
-            QSharedPointer< PluginOutputData<RealTimeSourceEstimate> > senderRTSE = m_pSender->getOutputConnectors()[i].dynamicCast< PluginOutputData<RealTimeSourceEstimate> >();
-            QSharedPointer< PluginInputData<RealTimeSourceEstimate> > receiverRTSE = m_pReceiver->getInputConnectors()[j].dynamicCast< PluginInputData<RealTimeSourceEstimate> >();
-            if(senderRTSE && receiverRTSE)
+            ConnectorDataType t_senderType = getDataType(m_pSender->getOutputConnectors()[i]);
+            if(t_senderType != ConnectorDataType::_None && t_senderType != ConnectorDataType::_N && t_senderType == getDataType(m_pReceiver->getInputConnectors()[j]))
             {
-                m_qHashConnections.insert(QPair<QString,QString>(m_pSender->getOutputConnectors()[i]->getName(), m_pReceiver->getInputConnectors()[j]->getName()), connect(m_pSender->getOutputConnectors()[i].data(), &PluginOutputConnector::notify,
-                        m_pReceiver->getInputConnectors()[j].data(), &PluginInputConnector::update, Qt::BlockingQueuedConnection));
+                connectEdge(i, j);
                 bConnected = true;
                 break;
             }
@@ -156,6 +147,51 @@ bool PluginConnectorConnection::createConnection()
 }
 
 
+//*************************************************************************************************************
+
+void PluginConnectorConnection::connectEdge(qint32 i, qint32 j)
+{
+    PluginOutputConnector::SPtr t_pOutput = m_pSender->getOutputConnectors()[i];
+    PluginInputConnector::SPtr t_pInput = m_pReceiver->getInputConnectors()[j];
+    QPair<QString,QString> t_qPair(t_pOutput->getName(), t_pInput->getName());
+
+    removeEdge(t_qPair);
+
+    //A slow receiver must not stall the producer: blocks are queued and the oldest is dropped, sample arrays are
+    //coalesced to the latest one. Source estimates have no snapshot (it would copy the source space per notify),
+    //so they stay a rendezvous. The policy can be changed in the connection widget.
+    PluginConnectionEdge::SPtr t_pEdge;
+    switch(getDataType(t_pOutput))
+    {
+        case ConnectorDataType::_RTMSB:
+            t_pEdge = PluginConnectionEdge::SPtr(new PluginConnectionEdge(m_pReceiver.data(), t_pInput, PluginConnectionEdge::DropOldest, 16));
+            break;
+        case ConnectorDataType::_RTMSA:
+        case ConnectorDataType::_RTSA:
+            t_pEdge = PluginConnectionEdge::SPtr(new PluginConnectionEdge(m_pReceiver.data(), t_pInput, PluginConnectionEdge::CoalesceLatest, 1));
+            break;
+        default:
+            t_pEdge = PluginConnectionEdge::SPtr(new PluginConnectionEdge(m_pReceiver.data(), t_pInput, PluginConnectionEdge::Block, 0));
+            break;
+    }
+
+    m_qHashEdges.insert(t_qPair, t_pEdge);
+    m_qHashConnections.insert(t_qPair, connect(t_pOutput.data(), &PluginOutputConnector::notify, t_pEdge.data(), &PluginConnectionEdge::push, Qt::DirectConnection));
+}
+
+
+//*************************************************************************************************************
+
+void PluginConnectorConnection::removeEdge(const QPair<QString, QString> &p_qPair)
+{
+    if(m_qHashConnections.contains(p_qPair))
+        disconnect(m_qHashConnections.take(p_qPair));
+
+    if(m_qHashEdges.contains(p_qPair))
+        m_qHashEdges.take(p_qPair)->close();
+}
+
+
 //*************************************************************************************************************
 
 ConnectorDataType PluginConnectorConnection::getDataType(QSharedPointer<PluginConnector> pPluginConnector)
@@ -170,6 +206,11 @@ ConnectorDataType PluginConnectorConnection::getDataType(QSharedPointer<PluginCo
     if(RTMSA_Out || RTMSA_In)
         return ConnectorDataType::_RTMSA;
 
+    QSharedPointer< PluginOutputData<XMEASLIB::NewRealTimeMultiSampleBlock> > RTMSB_Out = pPluginConnector.dynamicCast< PluginOutputData<XMEASLIB::NewRealTimeMultiSampleBlock> >();
+    QSharedPointer< PluginInputData<XMEASLIB::NewRealTimeMultiSampleBlock> > RTMSB_In = pPluginConnector.dynamicCast< PluginInputData<XMEASLIB::NewRealTimeMultiSampleBlock> >();
+    if(RTMSB_Out || RTMSB_In)
+        return ConnectorDataType::_RTMSB;
+
     QSharedPointer< PluginOutputData<XMEASLIB::RealTimeSourceEstimate> > RTSE_Out = pPluginConnector.dynamicCast< PluginOutputData<XMEASLIB::RealTimeSourceEstimate> >();
     QSharedPointer< PluginInputData<XMEASLIB::RealTimeSourceEstimate> > RTSE_In = pPluginConnector.dynamicCast< PluginInputData<XMEASLIB::RealTimeSourceEstimate> >();
     if(RTSE_Out || RTSE_In)
@@ -46,6 +46,7 @@
 
 #include "plugininputconnector.h"
 #include "pluginoutputconnector.h"
+#include "pluginconnectionedge.h"
 
 
 //*************************************************************************************************************
@@ -74,6 +75,7 @@ enum ConnectorDataType
 {
     _N,         /**< Numeric */
     _RTMSA,     /**< Real-Time Multi Sample Array */
+    _RTMSB,     /**< Real-Time Multi Sample Block */
     _RTSA,      /**< Real-Time Sample Array */
     _RTSE,      /**< Real-Time Source Estimate */
     _None,      /**< None */
@@ -118,6 +120,24 @@ public:
 
     static ConnectorDataType getDataType(QSharedPointer<PluginConnector> pPluginConnector);
 
+    //=========================================================================================================
+    /**
+    * Sets the queue policy and capacity of all edges of this connection.
+    *
+    * @param[in] policy     the queue policy.
+    * @param[in] capacity   the queue capacity, 0 makes a Block edge a rendezvous.
+    */
+    void setPolicy(PluginConnectionEdge::Policy policy, qint32 capacity);
+
+    //=========================================================================================================
+    /**
+    * Returns the edges of this connection, keyed by QPair<Sender connector, Receiver connector>. Their
+    * statistics() hold the per edge latency and drop counters.
+    *
+    * @return the edges.
+    */
+    inline QHash<QPair<QString, QString>, PluginConnectionEdge::SPtr> getEdges() const;
+
     inline IPlugin::SPtr& getSender();
 
     inline IPlugin::SPtr& getReceiver();
@@ -141,10 +161,28 @@ private:
     */
     bool createConnection();
 
+    //=========================================================================================================
+    /**
+    * Connects the sender's output connector i to the receiver's input connector j through a scheduled edge.
+    *
+    * @param[in] i  index of the output connector.
+    * @param[in] j  index of the input connector.
+    */
+    void connectEdge(qint32 i, qint32 j);
+
+    //=========================================================================================================
+    /**
+    * Disconnects and closes the edge between the named connectors, if any.
+    *
+    * @param[in] p_qPair    QPair<Sender connector, Receiver connector>.
+    */
+    void removeEdge(const QPair<QString, QString> &p_qPair);
+
     IPlugin::SPtr m_pSender;
     IPlugin::SPtr m_pReceiver;
 
     QHash<QPair<QString, QString>, QMetaObject::Connection> m_qHashConnections; /**< QHash which holds the connections between sender and receiver QHash<QPair<Sender,Receiver>, Connection>. */
+    QHash<QPair<QString, QString>, PluginConnectionEdge::SPtr> m_qHashEdges;    /**< QHash which holds the scheduled edges between sender and receiver QHash<QPair<Sender,Receiver>, Edge>. */
 };
 
 //*************************************************************************************************************
@@ -159,6 +197,14 @@ inline QSharedPointer<PluginConnectorConnection> PluginConnectorConnection::crea
 }
 
 
+//*************************************************************************************************************
+
+inline QHash<QPair<QString, QString>, PluginConnectionEdge::SPtr> PluginConnectorConnection::getEdges() const
+{
+    return m_qHashEdges;
+}
+
+
 //*************************************************************************************************************
 
 inline IPlugin::SPtr& PluginConnectorConnection::getSender()
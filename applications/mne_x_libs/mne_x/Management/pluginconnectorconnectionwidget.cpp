@@ -128,6 +128,45 @@ PluginConnectorConnectionWidget::PluginConnectorConnectionWidget(PluginConnector
     foreach(QComboBox* m_pComboBox, m_qMapSenderToReceiverConnections)
         connect(m_pComboBox, static_cast<void (QComboBox::*)(const QString &)>(&QComboBox::currentIndexChanged), this, &PluginConnectorConnectionWidget::updateReceiver);
 
+    //Queue policy of the edges - initialised from an existing edge, if any
+    PluginConnectionEdge::Policy t_policy = PluginConnectionEdge::Block;
+    qint32 t_iCapacity = 0;
+    if(!m_pPluginConnectorConnection->m_qHashEdges.isEmpty())
+    {
+        t_policy = m_pPluginConnectorConnection->m_qHashEdges.begin().value()->policy();
+        t_iCapacity = m_pPluginConnectorConnection->m_qHashEdges.begin().value()->capacity();
+    }
+
+    m_pComboBoxPolicy = new QComboBox(this);
+    m_pComboBoxPolicy->addItem(tr("Block"), PluginConnectionEdge::Block);
+    m_pComboBoxPolicy->addItem(tr("Drop oldest"), PluginConnectionEdge::DropOldest);
+    m_pComboBoxPolicy->addItem(tr("Coalesce latest"), PluginConnectionEdge::CoalesceLatest);
+    m_pComboBoxPolicy->setCurrentIndex(m_pComboBoxPolicy->findData(t_policy));
+
+    m_pSpinBoxCapacity = new QSpinBox(this);
+    m_pSpinBoxCapacity->setRange(0, 1024);
+    m_pSpinBoxCapacity->setValue(t_iCapacity);
+    m_pSpinBoxCapacity->setToolTip(tr("Queued measurements; 0 with Block hands each measurement over in a rendezvous."));
+
+    layout->addWidget(new QLabel(tr("Queue policy"), this),curRow,0);
+    layout->addWidget(m_pComboBoxPolicy,curRow,1);
+    ++curRow;
+
+    layout->addWidget(new QLabel(tr("Queue capacity"), this),curRow,0);
+    layout->addWidget(m_pSpinBoxCapacity,curRow,1);
+    ++curRow;
+
+    m_pLabelStatistics = new QLabel(this);
+    layout->addWidget(m_pLabelStatistics,curRow,0,1,3);
+    ++curRow;
+
+    connect(m_pComboBoxPolicy, static_cast<void (QComboBox::*)(int)>(&QComboBox::currentIndexChanged), this, &PluginConnectorConnectionWidget::updatePolicy);
+    connect(m_pSpinBoxCapacity, static_cast<void (QSpinBox::*)(int)>(&QSpinBox::valueChanged), this, &PluginConnectorConnectionWidget::updatePolicy);
+
+    connect(&m_qTimerStatistics, &QTimer::timeout, this, &PluginConnectorConnectionWidget::updateStatistics);
+    m_qTimerStatistics.start(500);
+    updateStatistics();
+
     layout->addWidget(bottomFiller,curRow,0);
     ++curRow;
 
@@ -141,10 +180,43 @@ PluginConnectorConnectionWidget::PluginConnectorConnectionWidget(PluginConnector
 
 PluginConnectorConnectionWidget::~PluginConnectorConnectionWidget()
 {
+    m_qTimerStatistics.stop();
     m_qMapSenderToReceiverConnections.clear();
 }
 
 
+//*************************************************************************************************************
+
+void PluginConnectorConnectionWidget::updatePolicy()
+{
+    PluginConnectionEdge::Policy t_policy = (PluginConnectionEdge::Policy)m_pComboBoxPolicy->itemData(m_pComboBoxPolicy->currentIndex()).toInt();
+
+    m_pPluginConnectorConnection->setPolicy(t_policy, m_pSpinBoxCapacity->value());
+}
+
+
+//*************************************************************************************************************
+
+void PluginConnectorConnectionWidget::updateStatistics()
+{
+    QStringList t_qListLines;
+
+    QHash<QPair<QString, QString>, PluginConnectionEdge::SPtr>::const_iterator it;
+    for(it = m_pPluginConnectorConnection->m_qHashEdges.constBegin(); it != m_pPluginConnectorConnection->m_qHashEdges.constEnd(); ++it)
+    {
+        PluginConnectionEdge::Statistics t_statistics = it.value()->statistics();
+
+        t_qListLines << tr("%1 -> %2: received %3, delivered %4, dropped %5, queued %6 (max %7), latency %8 / %9 ms (last / max)")
+                        .arg(it.key().first).arg(it.key().second)
+                        .arg(t_statistics.iReceived).arg(t_statistics.iDelivered).arg(t_statistics.iDropped)
+                        .arg(t_statistics.iQueued).arg(t_statistics.iMaxQueued)
+                        .arg(t_statistics.iLastLatency/1.0e6, 0, 'f', 2).arg(t_statistics.iMaxLatency/1.0e6, 0, 'f', 2);
+    }
+
+    m_pLabelStatistics->setText(t_qListLines.isEmpty() ? tr("No active edges.") : t_qListLines.join("\n"));
+}
+
+
 //*************************************************************************************************************
 
 void PluginConnectorConnectionWidget::updateReceiver(const QString &p_sCurrentReceiver)
@@ -175,10 +247,7 @@ void PluginConnectorConnectionWidget::updateReceiver(const QString &p_sCurrentRe
                 if(m_pPluginConnectorConnection->m_pReceiver->getInputConnectors()[j]->getName() == p_sCurrentReceiver)
                     break;
 
-            m_pPluginConnectorConnection->m_qHashConnections.insert(QPair<QString,QString>(m_pPluginConnectorConnection->m_pSender->getOutputConnectors()[i]->getName(),
-                                                                                           m_pPluginConnectorConnection->m_pReceiver->getInputConnectors()[j]->getName()),
-                                                                    connect(m_pPluginConnectorConnection->m_pSender->getOutputConnectors()[i].data(), &PluginOutputConnector::notify,
-                                                                            m_pPluginConnectorConnection->m_pReceiver->getInputConnectors()[j].data(), &PluginInputConnector::update, Qt::BlockingQueuedConnection));
+            m_pPluginConnectorConnection->connectEdge(i, j);
         }
     }
 
@@ -188,8 +257,7 @@ void PluginConnectorConnectionWidget::updateReceiver(const QString &p_sCurrentRe
         if(it.value() != t_qComboBox && it.value()->currentText() == p_sCurrentReceiver)
         {
             QPair<QString, QString> t_qPair(it.key(),it.value()->currentText());
-            disconnect(m_pPluginConnectorConnection->m_qHashConnections[t_qPair]);
-            m_pPluginConnectorConnection->m_qHashConnections.remove(t_qPair);
+            m_pPluginConnectorConnection->removeEdge(t_qPair);
             it.value()->setCurrentIndex(0);
         }
     }
@@ -51,6 +51,8 @@
 #include <QLabel>
 #include <QWidget>
 #include <QComboBox>
+#include <QSpinBox>
+#include <QTimer>
 
 
 //*************************************************************************************************************
@@ -105,6 +107,18 @@ public:
     */
     void updateReceiver(const QString &p_sCurrentReceiver);
 
+    //=========================================================================================================
+    /**
+    * Applies the selected queue policy and capacity to all edges of the connection.
+    */
+    void updatePolicy();
+
+    //=========================================================================================================
+    /**
+    * Refreshes the edge statistics label.
+    */
+    void updateStatistics();
+
 signals:
 
 public slots:
@@ -113,6 +127,11 @@ public slots:
 private:
     QLabel* m_pLabel;                                           /**< Holds the start up widget label. */
 
+    QComboBox*  m_pComboBoxPolicy;                              /**< The queue policy of the edges. */
+    QSpinBox*   m_pSpinBoxCapacity;                             /**< The queue capacity of the edges. */
+    QLabel*     m_pLabelStatistics;                             /**< The delivery and drop counters of the edges. */
+    QTimer      m_qTimerStatistics;                             /**< Refreshes the statistics label. */
+
     PluginConnectorConnection*  m_pPluginConnectorConnection;   /**< a pointer to corresponding PluginConnectorConnection.*/
 
     QMap<QString, QComboBox*> m_qMapSenderToReceiverConnections;/**< To each output a possible list of inputs. */
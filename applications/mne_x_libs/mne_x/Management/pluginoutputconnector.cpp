@@ -42,6 +42,14 @@
 #include "../Interfaces/IPlugin.h"
 
 
+//*************************************************************************************************************
+//=============================================================================================================
+// QT INCLUDES
+//=============================================================================================================
+
+#include <QMetaMethod>
+
+
 //*************************************************************************************************************
 //=============================================================================================================
 // USED NAMESPACES
@@ -76,3 +84,11 @@ bool PluginOutputConnector::isOutputConnector() const
     return true;
 }
 
+
+//*************************************************************************************************************
+
+bool PluginOutputConnector::isConnected() const
+{
+    static const QMetaMethod t_notifySignal = QMetaMethod::fromSignal(&PluginOutputConnector::notify);
+    return isSignalConnected(t_notifySignal);
+}
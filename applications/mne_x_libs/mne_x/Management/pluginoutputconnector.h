@@ -99,6 +99,15 @@ public:
      */
     virtual bool isOutputConnector() const;
 
+    //=========================================================================================================
+    /**
+     * Returns whether an input connector or a display listens to this output. Producers use it to skip
+     * outputs nobody receives.
+     *
+     * @return true if notify is connected
+     */
+    bool isConnected() const;
+
 signals:
     void notify(XMEASLIB::NewMeasurement::SPtr);
 
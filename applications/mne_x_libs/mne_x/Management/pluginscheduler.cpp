@@ -0,0 +1,162 @@
+//=============================================================================================================
+/**
+* @file     pluginscheduler.cpp
+* @author   Christoph Dinh <chdinh@nmr.mgh.harvard.edu>;
+*           Matti Hamalainen <msh@nmr.mgh.harvard.edu>
+* @version  1.0
+* @date     October, 2026
+*
+* @section  LICENSE
+*
+* Copyright (C) 2026, Christoph Dinh and Matti Hamalainen. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+* the following conditions are met:
+*     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+*       following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+*       the following disclaimer in the documentation and/or other materials provided with the distribution.
+*     * Neither the name of the Massachusetts General Hospital nor the names of its contributors may be used
+*       to endorse or promote products derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+* PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL MASSACHUSETTS GENERAL HOSPITAL BE LIABLE FOR ANY DIRECT,
+* INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+* NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+* @brief    Contains the implementation of the PluginScheduler class.
+*
+*/
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include "pluginscheduler.h"
+#include "pluginconnectionedge.h"
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// QT INCLUDES
+//=============================================================================================================
+
+#include <QRunnable>
+#include <QThread>
+#include <QThreadStorage>
+#include <QHash>
+#include <QWeakPointer>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// USED NAMESPACES
+//=============================================================================================================
+
+using namespace MNEX;
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// STATIC HELPERS
+//=============================================================================================================
+
+namespace
+{
+    QThreadStorage<bool> s_isWorker;    // Set in the threads running an edge drain
+}
+
+
+//*************************************************************************************************************
+
+class PluginScheduler::EdgeRunnable : public QRunnable
+{
+public:
+    EdgeRunnable(PluginConnectionEdge* pEdge) : m_pEdge(pEdge) {}
+
+    virtual void run()
+    {
+        s_isWorker.setLocalData(true);
+        PluginScheduler::drain(m_pEdge);
+        s_isWorker.setLocalData(false);
+    }
+
+private:
+    PluginConnectionEdge* m_pEdge;
+};
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINE MEMBER METHODS
+//=============================================================================================================
+
+QThreadPool* PluginScheduler::threadPool()
+{
+    static QThreadPool s_threadPool;
+    return &s_threadPool;
+}
+
+
+//*************************************************************************************************************
+
+void PluginScheduler::schedule(PluginConnectionEdge* pEdge)
+{
+    threadPool()->start(new EdgeRunnable(pEdge));
+}
+
+
+//*************************************************************************************************************
+
+void PluginScheduler::drain(PluginConnectionEdge* pEdge)
+{
+    pEdge->drain();
+}
+
+
+//*************************************************************************************************************
+
+bool PluginScheduler::isWorkerThread()
+{
+    return s_isWorker.hasLocalData() && s_isWorker.localData();
+}
+
+
+//*************************************************************************************************************
+
+void PluginScheduler::wait(QWaitCondition &condition, QMutex &mutex)
+{
+    if(isWorkerThread())
+    {
+        threadPool()->releaseThread();
+        condition.wait(&mutex);
+        threadPool()->reserveThread();
+    }
+    else
+        condition.wait(&mutex);
+}
+
+
+//*************************************************************************************************************
+
+QSharedPointer<QMutex> PluginScheduler::receiverMutex(IPlugin* pPlugin)
+{
+    static QMutex s_mutex;
+    static QHash<IPlugin*, QWeakPointer<QMutex> > s_qHashReceiverMutexes;
+
+    QMutexLocker locker(&s_mutex);
+
+    QSharedPointer<QMutex> t_pMutex = s_qHashReceiverMutexes.value(pPlugin).toStrongRef();
+    if(!t_pMutex)
+    {
+        t_pMutex = QSharedPointer<QMutex>(new QMutex);
+        s_qHashReceiverMutexes.insert(pPlugin, t_pMutex);
+    }
+
+    return t_pMutex;
+}
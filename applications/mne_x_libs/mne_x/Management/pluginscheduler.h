@@ -0,0 +1,147 @@
+//=============================================================================================================
+/**
+* @file     pluginscheduler.h
+* @author   Christoph Dinh <chdinh@nmr.mgh.harvard.edu>;
+*           Matti Hamalainen <msh@nmr.mgh.harvard.edu>
+* @version  1.0
+* @date     October, 2026
+*
+* @section  LICENSE
+*
+* Copyright (C) 2026, Christoph Dinh and Matti Hamalainen. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+* the following conditions are met:
+*     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+*       following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+*       the following disclaimer in the documentation and/or other materials provided with the distribution.
+*     * Neither the name of the Massachusetts General Hospital nor the names of its contributors may be used
+*       to endorse or promote products derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+* PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL MASSACHUSETTS GENERAL HOSPITAL BE LIABLE FOR ANY DIRECT,
+* INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+* NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+* @brief    Contains the declaration of the PluginScheduler class.
+*
+*/
+
+#ifndef PLUGINSCHEDULER_H
+#define PLUGINSCHEDULER_H
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include "../mne_x_global.h"
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// Qt INCLUDES
+//=============================================================================================================
+
+#include <QSharedPointer>
+#include <QMutex>
+#include <QWaitCondition>
+#include <QThreadPool>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINE NAMESPACE MNEX
+//=============================================================================================================
+
+namespace MNEX
+{
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// FORWARD DECLARATIONS
+//=============================================================================================================
+
+class IPlugin;
+class PluginConnectionEdge;
+
+
+//=============================================================================================================
+/**
+* Runs the delivery of all plug-in connection edges on one shared thread pool, sized to the number of cores,
+* instead of on the GUI thread or on a thread per plug-in. Edges are drained in batches, so a busy edge does
+* not starve the others, and the deliveries into one plug-in are serialized, so a plug-in never sees two
+* concurrent update() calls.
+*
+* @brief The PluginScheduler class runs plug-in connection edges on a shared worker pool
+*/
+class MNE_X_SHARED_EXPORT PluginScheduler
+{
+public:
+    //=========================================================================================================
+    /**
+    * Returns the shared worker pool.
+    *
+    * @return the worker pool.
+    */
+    static QThreadPool* threadPool();
+
+    //=========================================================================================================
+    /**
+    * Queues a drain of the edge on the worker pool.
+    *
+    * @param[in] pEdge  the edge to drain.
+    */
+    static void schedule(PluginConnectionEdge* pEdge);
+
+    //=========================================================================================================
+    /**
+    * Returns whether the calling thread is one of the pool workers.
+    *
+    * @return true if called from a worker.
+    */
+    static bool isWorkerThread();
+
+    //=========================================================================================================
+    /**
+    * Waits on the condition. If called from a worker, the worker's pool slot is handed back while waiting, so
+    * blocked edges can not exhaust the pool and dead lock the plug-in graph.
+    *
+    * @param[in] condition  the condition to wait for.
+    * @param[in] mutex      the locked mutex guarding the condition.
+    */
+    static void wait(QWaitCondition &condition, QMutex &mutex);
+
+    //=========================================================================================================
+    /**
+    * Returns the mutex which serializes the deliveries into the plug-in. All edges into the same plug-in share it.
+    *
+    * @param[in] pPlugin    the receiving plug-in.
+    *
+    * @return the delivery mutex of the plug-in.
+    */
+    static QSharedPointer<QMutex> receiverMutex(IPlugin* pPlugin);
+
+private:
+    class EdgeRunnable;
+
+    PluginScheduler();
+
+    //=========================================================================================================
+    /**
+    * Runs one drain of the edge on the calling worker.
+    *
+    * @param[in] pEdge  the edge to drain.
+    */
+    static void drain(PluginConnectionEdge* pEdge);
+};
+
+} // NAMESPACE
+
+#endif // PLUGINSCHEDULER_H
@@ -101,6 +101,8 @@ SOURCES += \
     Management/plugininputdata.cpp \
     Management/pluginoutputdata.cpp \
     Management/pluginconnectorconnection.cpp \
+    Management/pluginconnectionedge.cpp \
+    Management/pluginscheduler.cpp \
     Management/pluginconnectorconnectionwidget.cpp \
     Management/pluginscenemanager.cpp \
     Management/displaymanager.cpp
@@ -118,6 +120,8 @@ HEADERS += \
     Management/plugininputdata.h \
     Management/pluginoutputdata.h \
     Management/pluginconnectorconnection.h \
+    Management/pluginconnectionedge.h \
+    Management/pluginscheduler.h \
     Management/pluginconnectorconnectionwidget.h \
     Management/pluginscenemanager.h \
     Management/displaymanager.h
@@ -47,6 +47,8 @@
 
 #include <xMeas/newrealtimemultisamplearray.h>
 
+#include <generics/tracer.h>
+
 #include <Eigen/Core>
 
 
@@ -79,6 +81,7 @@
 
 using namespace XDISPLIB;
 using namespace XMEASLIB;
+using namespace IOBuffer;
 
 
 //=============================================================================================================
@@ -227,6 +230,8 @@ void NewRealTimeMultiSampleArrayWidget::minValueChanged(double minValue)
 
 void NewRealTimeMultiSampleArrayWidget::update(XMEASLIB::NewMeasurement::SPtr)
 {
+    Tracer::Scope trace("NewRealTimeMultiSampleArrayWidget::update");
+
     //ToDo put most of this in a parallel thread -> to big for process in notifier
     if(m_pRTMSA_New->getMultiSampleArray().size() > 0)
     {
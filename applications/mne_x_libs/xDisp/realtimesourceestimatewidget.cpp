@@ -45,6 +45,8 @@
 
 #include <xMeas/realtimesourceestimate.h>
 
+#include <generics/tracer.h>
+
 #include <disp3D/geometryview.h>
 #include <mne/mne_forwardsolution.h>
 
@@ -93,6 +95,7 @@ using namespace XDISPLIB;
 using namespace DISP3DLIB;
 using namespace MNELIB;
 using namespace XMEASLIB;
+using namespace IOBuffer;
 
 
 using namespace INVERSELIB;
@@ -127,6 +130,8 @@ RealTimeSourceEstimateWidget::~RealTimeSourceEstimateWidget()
 
 void RealTimeSourceEstimateWidget::update(XMEASLIB::NewMeasurement::SPtr)
 {
+    Tracer::Scope trace("RealTimeSourceEstimateWidget::update", m_pRTMSE->getTimestamp());
+
     if(m_bInitialized)
     {
         if(count % 4 == 0)
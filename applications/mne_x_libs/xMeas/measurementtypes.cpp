@@ -43,6 +43,7 @@
 #include "newmeasurement.h"
 #include "newrealtimesamplearray.h"
 #include "newrealtimemultisamplearray.h"
+#include "newrealtimemultisampleblock.h"
 #include "newnumeric.h"
 #include "realtimesourceestimate.h"
 
@@ -73,6 +74,7 @@ void MeasurementTypes::registerTypes()
     qRegisterMetaType< NewMeasurement::SPtr >("NewMeasurement::SPtr");
     qRegisterMetaType< NewRealTimeSampleArray::SPtr >("NewRealTimeSampleArray::SPtr");
     qRegisterMetaType< NewRealTimeMultiSampleArray::SPtr >("NewRealTimeMultiSampleArray::SPtr");
+    qRegisterMetaType< NewRealTimeMultiSampleBlock::SPtr >("NewRealTimeMultiSampleBlock::SPtr");
     qRegisterMetaType< NewNumeric::SPtr >("NewNumeric::SPtr");
     qRegisterMetaType< RealTimeSourceEstimate::SPtr >("RealTimeSourceEstimate::SPtr");
 }
@@ -0,0 +1,91 @@
+//=============================================================================================================
+/**
+* @file     multisampleblock.cpp
+* @author   Christoph Dinh <chdinh@nmr.mgh.harvard.edu>;
+*           Matti Hamalainen <msh@nmr.mgh.harvard.edu>
+* @version  1.0
+* @date     October, 2026
+*
+* @section  LICENSE
+*
+* Copyright (C) 2026, Christoph Dinh and Matti Hamalainen. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+* the following conditions are met:
+*     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+*       following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+*       the following disclaimer in the documentation and/or other materials provided with the distribution.
+*     * Neither the name of the Massachusetts General Hospital nor the names of its contributors may be used
+*       to endorse or promote products derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+* PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL MASSACHUSETTS GENERAL HOSPITAL BE LIABLE FOR ANY DIRECT,
+* INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+* NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+* @brief    Contains the implementation of the MultiSampleBlock class.
+*
+*/
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include "multisampleblock.h"
+
+#include <generics/tracer.h>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// USED NAMESPACES
+//=============================================================================================================
+
+using namespace XMEASLIB;
+using namespace IOBuffer;
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINE MEMBER METHODS
+//=============================================================================================================
+
+MultiSampleBlock::MultiSampleBlock(const MatrixXd &p_matData, qint64 p_iFirstSample, qint64 p_iTimestamp)
+: m_matData(p_matData)
+, m_iFirstSample(p_iFirstSample)
+, m_iTimestamp(p_iTimestamp)
+{
+}
+
+
+//*************************************************************************************************************
+
+MultiSampleBlock::MultiSampleBlock(qint64 p_iFirstSample, qint64 p_iTimestamp)
+: m_iFirstSample(p_iFirstSample)
+, m_iTimestamp(p_iTimestamp)
+{
+}
+
+
+//*************************************************************************************************************
+
+MultiSampleBlock::ConstSPtr MultiSampleBlock::adopt(MatrixXd &p_matData, qint64 p_iFirstSample, qint64 p_iTimestamp)
+{
+    MultiSampleBlock* t_pBlock = new MultiSampleBlock(p_iFirstSample, p_iTimestamp);
+    t_pBlock->m_matData.swap(p_matData);
+    return ConstSPtr(t_pBlock);
+}
+
+
+//*************************************************************************************************************
+
+qint64 MultiSampleBlock::now()
+{
+    return Tracer::now();
+}
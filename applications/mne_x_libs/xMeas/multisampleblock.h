@@ -0,0 +1,186 @@
+//=============================================================================================================
+/**
+* @file     multisampleblock.h
+* @author   Christoph Dinh <chdinh@nmr.mgh.harvard.edu>;
+*           Matti Hamalainen <msh@nmr.mgh.harvard.edu>
+* @version  1.0
+* @date     October, 2026
+*
+* @section  LICENSE
+*
+* Copyright (C) 2026, Christoph Dinh and Matti Hamalainen. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+* the following conditions are met:
+*     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+*       following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+*       the following disclaimer in the documentation and/or other materials provided with the distribution.
+*     * Neither the name of the Massachusetts General Hospital nor the names of its contributors may be used
+*       to endorse or promote products derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+* PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL MASSACHUSETTS GENERAL HOSPITAL BE LIABLE FOR ANY DIRECT,
+* INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+* NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+* @brief    Contains the declaration of the MultiSampleBlock class.
+*
+*/
+
+#ifndef MULTISAMPLEBLOCK_H
+#define MULTISAMPLEBLOCK_H
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include "xmeas_global.h"
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// Qt INCLUDES
+//=============================================================================================================
+
+#include <QSharedPointer>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// Eigen INCLUDES
+//=============================================================================================================
+
+#include <Eigen/Core>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINE NAMESPACE XMEASLIB
+//=============================================================================================================
+
+namespace XMEASLIB
+{
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// USED NAMESPACES
+//=============================================================================================================
+
+using namespace Eigen;
+
+
+//=========================================================================================================
+/**
+* An immutable chunk of channels x samples, shared by all consumers of a NewRealTimeMultiSampleBlock stream.
+* It carries the index of its first sample in the stream and the monotonic time stamp of its acquisition.
+*
+* @brief Immutable, shared multi channel data block.
+*/
+class XMEASSHARED_EXPORT MultiSampleBlock
+{
+public:
+    typedef QSharedPointer<MultiSampleBlock> SPtr;               /**< Shared pointer type for MultiSampleBlock. */
+    typedef QSharedPointer<const MultiSampleBlock> ConstSPtr;    /**< Const shared pointer type for MultiSampleBlock. */
+
+    //=========================================================================================================
+    /**
+    * Constructs a MultiSampleBlock holding a copy of the data.
+    *
+    * @param[in] p_matData          The data, channels x samples.
+    * @param[in] p_iFirstSample     Index of the first sample in the stream.
+    * @param[in] p_iTimestamp       Monotonic acquisition time of the first sample in nanoseconds, see now().
+    */
+    MultiSampleBlock(const MatrixXd &p_matData, qint64 p_iFirstSample, qint64 p_iTimestamp);
+
+    //=========================================================================================================
+    /**
+    * Creates a MultiSampleBlock which takes over the memory of p_matData without copying it; p_matData is empty
+    * afterwards.
+    *
+    * @param[in, out] p_matData     The data, channels x samples.
+    * @param[in] p_iFirstSample     Index of the first sample in the stream.
+    * @param[in] p_iTimestamp       Monotonic acquisition time of the first sample in nanoseconds, see now().
+    *
+    * @return the block.
+    */
+    static ConstSPtr adopt(MatrixXd &p_matData, qint64 p_iFirstSample, qint64 p_iTimestamp);
+
+    //=========================================================================================================
+    /**
+    * Returns the current time of the monotonic clock used for the time stamps, in nanoseconds. This is the
+    * process wide IOBuffer::Tracer clock, so the stamps can be compared with the trace of all processing stages.
+    *
+    * @return the current monotonic time.
+    */
+    static qint64 now();
+
+    //=========================================================================================================
+    /**
+    * Returns the data.
+    *
+    * @return the data, channels x samples.
+    */
+    inline const MatrixXd& data() const;
+
+    //=========================================================================================================
+    /**
+    * Returns the index of the first sample in the stream.
+    *
+    * @return the index of the first sample.
+    */
+    inline qint64 firstSample() const;
+
+    //=========================================================================================================
+    /**
+    * Returns the monotonic acquisition time of the first sample.
+    *
+    * @return the time stamp in nanoseconds.
+    */
+    inline qint64 timestamp() const;
+
+private:
+    MultiSampleBlock(qint64 p_iFirstSample, qint64 p_iTimestamp);
+
+    MatrixXd    m_matData;          /**< The data. */
+    qint64      m_iFirstSample;     /**< Index of the first sample in the stream. */
+    qint64      m_iTimestamp;       /**< Monotonic acquisition time of the first sample [ns]. */
+};
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INLINE DEFINITIONS
+//=============================================================================================================
+
+inline const MatrixXd& MultiSampleBlock::data() const
+{
+    return m_matData;
+}
+
+
+//*************************************************************************************************************
+
+inline qint64 MultiSampleBlock::firstSample() const
+{
+    return m_iFirstSample;
+}
+
+
+//*************************************************************************************************************
+
+inline qint64 MultiSampleBlock::timestamp() const
+{
+    return m_iTimestamp;
+}
+
+} // NAMESPACE
+
+#endif // MULTISAMPLEBLOCK_H
@@ -68,3 +68,11 @@ NewMeasurement::~NewMeasurement()
 {
 
 }
+
+
+//*************************************************************************************************************
+
+NewMeasurement::SPtr NewMeasurement::snapshot() const
+{
+    return NewMeasurement::SPtr();
+}
@@ -125,6 +125,16 @@ public:
     */
     inline int type() const;
 
+    //=========================================================================================================
+    /**
+    * Returns a new measurement holding a copy of the current value, which later updates of this measurement do
+    * not change, so it can be queued for a delayed delivery. Measurement types which can not be copied cheaply
+    * return NULL; their receivers have to read them before the producer continues.
+    *
+    * @return the snapshot, NULL if not supported.
+    */
+    virtual NewMeasurement::SPtr snapshot() const;
+
 signals:
     void notify();
 
@@ -228,6 +228,25 @@ VectorXd NewRealTimeMultiSampleArray::getValue() const
 }
 
 
+//*************************************************************************************************************
+
+NewMeasurement::SPtr NewRealTimeMultiSampleArray::snapshot() const
+{
+    QSharedPointer<NewRealTimeMultiSampleArray> t_pSnapshot(new NewRealTimeMultiSampleArray);
+
+    t_pSnapshot->setName(getName());
+    t_pSnapshot->setVisibility(isVisible());
+    t_pSnapshot->m_pFiffInfo_orig = m_pFiffInfo_orig;
+    t_pSnapshot->m_dSamplingRate = m_dSamplingRate;
+    t_pSnapshot->m_vecValue = m_vecValue;
+    t_pSnapshot->m_ucMultiArraySize = m_ucMultiArraySize;
+    t_pSnapshot->m_matSamples = m_matSamples;
+    t_pSnapshot->m_qListChInfo = m_qListChInfo;
+
+    return t_pSnapshot;
+}
+
+
 //*************************************************************************************************************
 
 void NewRealTimeMultiSampleArray::setValue(VectorXd v)
@@ -205,6 +205,15 @@ public:
     */
     virtual VectorXd getValue() const;
 
+    //=========================================================================================================
+    /**
+    * Returns a new measurement holding a copy of the current multi sample array, the channel info and the fiff
+    * info. Later setValue calls on this measurement do not change the snapshot.
+    *
+    * @return the snapshot.
+    */
+    virtual NewMeasurement::SPtr snapshot() const;
+
 private:
     FiffInfo::SPtr              m_pFiffInfo_orig;   /**< Original Fiff Info if initialized by fiff info. */
 
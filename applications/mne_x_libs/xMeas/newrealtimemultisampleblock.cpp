@@ -0,0 +1,137 @@
+//=============================================================================================================
+/**
+* @file     newrealtimemultisampleblock.cpp
+* @author   Christoph Dinh <chdinh@nmr.mgh.harvard.edu>;
+*           Matti Hamalainen <msh@nmr.mgh.harvard.edu>
+* @version  1.0
+* @date     October, 2026
+*
+* @section  LICENSE
+*
+* Copyright (C) 2026, Christoph Dinh and Matti Hamalainen. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+* the following conditions are met:
+*     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+*       following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+*       the following disclaimer in the documentation and/or other materials provided with the distribution.
+*     * Neither the name of the Massachusetts General Hospital nor the names of its contributors may be used
+*       to endorse or promote products derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+* PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL MASSACHUSETTS GENERAL HOSPITAL BE LIABLE FOR ANY DIRECT,
+* INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+* NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+* @brief    Contains the implementation of the NewRealTimeMultiSampleBlock class.
+*
+*/
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include "newrealtimemultisampleblock.h"
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// QT INCLUDES
+//=============================================================================================================
+
+#include <QMutexLocker>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// USED NAMESPACES
+//=============================================================================================================
+
+using namespace XMEASLIB;
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINE MEMBER METHODS
+//=============================================================================================================
+
+NewRealTimeMultiSampleBlock::NewRealTimeMultiSampleBlock(QObject *parent)
+: NewMeasurement(QMetaType::type("NewRealTimeMultiSampleBlock::SPtr"), parent)
+, m_dSamplingRate(0)
+, m_iNumSamples(0)
+{
+}
+
+
+//*************************************************************************************************************
+
+NewRealTimeMultiSampleBlock::~NewRealTimeMultiSampleBlock()
+{
+
+}
+
+
+//*************************************************************************************************************
+
+void NewRealTimeMultiSampleBlock::initFromFiffInfo(FiffInfo::SPtr &p_pFiffInfo)
+{
+    m_pFiffInfo = p_pFiffInfo;
+    m_dSamplingRate = p_pFiffInfo->sfreq;
+    m_iNumSamples = 0;
+}
+
+
+//*************************************************************************************************************
+
+void NewRealTimeMultiSampleBlock::setValue(MultiSampleBlock::ConstSPtr p_pBlock)
+{
+    m_mutex.lock();
+    m_pBlock = p_pBlock;
+    m_mutex.unlock();
+
+    emit notify();
+}
+
+
+//*************************************************************************************************************
+
+void NewRealTimeMultiSampleBlock::setValue(MatrixXd &p_matData, qint64 p_iTimestamp)
+{
+    qint64 t_iTimestamp = p_iTimestamp >= 0 ? p_iTimestamp : MultiSampleBlock::now();
+    qint64 t_iFirstSample = m_iNumSamples;
+    m_iNumSamples += p_matData.cols();
+
+    setValue(MultiSampleBlock::adopt(p_matData, t_iFirstSample, t_iTimestamp));
+}
+
+
+//*************************************************************************************************************
+
+MultiSampleBlock::ConstSPtr NewRealTimeMultiSampleBlock::getValue() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_pBlock;
+}
+
+
+//*************************************************************************************************************
+
+NewMeasurement::SPtr NewRealTimeMultiSampleBlock::snapshot() const
+{
+    NewRealTimeMultiSampleBlock::SPtr t_pSnapshot(new NewRealTimeMultiSampleBlock);
+
+    t_pSnapshot->setName(getName());
+    t_pSnapshot->setVisibility(isVisible());
+    t_pSnapshot->m_pFiffInfo = m_pFiffInfo;
+    t_pSnapshot->m_dSamplingRate = m_dSamplingRate;
+    t_pSnapshot->m_iNumSamples = m_iNumSamples;
+    t_pSnapshot->m_pBlock = getValue();
+
+    return t_pSnapshot;
+}
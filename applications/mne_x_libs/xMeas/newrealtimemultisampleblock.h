@@ -0,0 +1,211 @@
+//=============================================================================================================
+/**
+* @file     newrealtimemultisampleblock.h
+* @author   Christoph Dinh <chdinh@nmr.mgh.harvard.edu>;
+*           Matti Hamalainen <msh@nmr.mgh.harvard.edu>
+* @version  1.0
+* @date     October, 2026
+*
+* @section  LICENSE
+*
+* Copyright (C) 2026, Christoph Dinh and Matti Hamalainen. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+* the following conditions are met:
+*     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+*       following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+*       the following disclaimer in the documentation and/or other materials provided with the distribution.
+*     * Neither the name of the Massachusetts General Hospital nor the names of its contributors may be used
+*       to endorse or promote products derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+* PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL MASSACHUSETTS GENERAL HOSPITAL BE LIABLE FOR ANY DIRECT,
+* INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+* NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+* @brief    Contains the declaration of the NewRealTimeMultiSampleBlock class.
+*
+*/
+
+#ifndef NEWREALTIMEMULTISAMPLEBLOCK_H
+#define NEWREALTIMEMULTISAMPLEBLOCK_H
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include "xmeas_global.h"
+#include "newmeasurement.h"
+#include "multisampleblock.h"
+
+#include <fiff/fiff_info.h>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// Qt INCLUDES
+//=============================================================================================================
+
+#include <QSharedPointer>
+#include <QMutex>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINE NAMESPACE XMEASLIB
+//=============================================================================================================
+
+namespace XMEASLIB
+{
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// USED NAMESPACES
+//=============================================================================================================
+
+using namespace FIFFLIB;
+
+
+//=========================================================================================================
+/**
+* Block oriented counterpart of NewRealTimeMultiSampleArray: every notify() publishes one immutable
+* MultiSampleBlock, which consumers take with getValue() and share instead of copying. Connections of this type
+* are direct, so a consumer's update() runs on the producer's thread and should only take the block.
+*
+* @brief Real-time multi channel measurement transported in shared blocks.
+*/
+class XMEASSHARED_EXPORT NewRealTimeMultiSampleBlock : public NewMeasurement
+{
+    Q_OBJECT
+public:
+    typedef QSharedPointer<NewRealTimeMultiSampleBlock> SPtr;               /**< Shared pointer type for NewRealTimeMultiSampleBlock. */
+    typedef QSharedPointer<const NewRealTimeMultiSampleBlock> ConstSPtr;    /**< Const shared pointer type for NewRealTimeMultiSampleBlock. */
+
+    //=========================================================================================================
+    /**
+    * Constructs a NewRealTimeMultiSampleBlock.
+    */
+    explicit NewRealTimeMultiSampleBlock(QObject *parent = 0);
+
+    //=========================================================================================================
+    /**
+    * Destroys the NewRealTimeMultiSampleBlock.
+    */
+    virtual ~NewRealTimeMultiSampleBlock();
+
+    //=========================================================================================================
+    /**
+    * Init from fiff info.
+    *
+    * @param[in] p_pFiffInfo     Info to init from
+    */
+    void initFromFiffInfo(FiffInfo::SPtr &p_pFiffInfo);
+
+    //=========================================================================================================
+    /**
+    * Returns the fiff info the measurement was initialized with.
+    *
+    * @return the fiff info.
+    */
+    inline FiffInfo::SPtr& getFiffInfo();
+
+    //=========================================================================================================
+    /**
+    * Returns the sampling rate.
+    *
+    * @return the sampling rate.
+    */
+    inline double getSamplingRate() const;
+
+    //=========================================================================================================
+    /**
+    * Returns the number of channels.
+    *
+    * @return the number of channels.
+    */
+    inline qint32 getNumChannels() const;
+
+    //=========================================================================================================
+    /**
+    * Publishes a block and notifies the consumers.
+    *
+    * @param[in] p_pBlock   The block.
+    */
+    void setValue(MultiSampleBlock::ConstSPtr p_pBlock);
+
+    //=========================================================================================================
+    /**
+    * Publishes the data as the next block of the stream and notifies the consumers. The memory of p_matData is
+    * taken over without a copy; p_matData is empty afterwards.
+    *
+    * @param[in, out] p_matData     The data, channels x samples.
+    * @param[in] p_iTimestamp       Acquisition time stamp, see MultiSampleBlock::now(); -1 stamps the block now.
+    */
+    void setValue(MatrixXd &p_matData, qint64 p_iTimestamp = -1);
+
+    //=========================================================================================================
+    /**
+    * Returns the last published block.
+    *
+    * @return the last block.
+    */
+    MultiSampleBlock::ConstSPtr getValue() const;
+
+    //=========================================================================================================
+    /**
+    * Returns a new measurement holding the last published block and the fiff info. Later setValue calls on this
+    * measurement do not change the snapshot, so it can be queued for a delayed delivery.
+    *
+    * @return the snapshot.
+    */
+    virtual NewMeasurement::SPtr snapshot() const;
+
+private:
+    FiffInfo::SPtr              m_pFiffInfo;        /**< Fiff info. */
+    double                      m_dSamplingRate;    /**< Sampling rate. */
+    qint64                      m_iNumSamples;      /**< Number of samples published so far. */
+
+    mutable QMutex              m_mutex;            /**< Guards m_pBlock. */
+    MultiSampleBlock::ConstSPtr m_pBlock;           /**< The last published block. */
+};
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INLINE DEFINITIONS
+//=============================================================================================================
+
+inline FiffInfo::SPtr& NewRealTimeMultiSampleBlock::getFiffInfo()
+{
+    return m_pFiffInfo;
+}
+
+
+//*************************************************************************************************************
+
+inline double NewRealTimeMultiSampleBlock::getSamplingRate() const
+{
+    return m_dSamplingRate;
+}
+
+
+//*************************************************************************************************************
+
+inline qint32 NewRealTimeMultiSampleBlock::getNumChannels() const
+{
+    return m_pFiffInfo ? m_pFiffInfo->nchan : 0;
+}
+
+} // NAMESPACE
+
+Q_DECLARE_METATYPE(XMEASLIB::NewRealTimeMultiSampleBlock::SPtr)
+
+#endif // NEWREALTIMEMULTISAMPLEBLOCK_H
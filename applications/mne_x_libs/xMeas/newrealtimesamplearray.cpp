@@ -90,6 +90,26 @@ double NewRealTimeSampleArray::getValue() const
 }
 
 
+//*************************************************************************************************************
+
+NewMeasurement::SPtr NewRealTimeSampleArray::snapshot() const
+{
+    QSharedPointer<NewRealTimeSampleArray> t_pSnapshot(new NewRealTimeSampleArray);
+
+    t_pSnapshot->setName(getName());
+    t_pSnapshot->setVisibility(isVisible());
+    t_pSnapshot->m_dMinValue = m_dMinValue;
+    t_pSnapshot->m_dMaxValue = m_dMaxValue;
+    t_pSnapshot->m_dSamplingRate = m_dSamplingRate;
+    t_pSnapshot->m_qString_Unit = m_qString_Unit;
+    t_pSnapshot->m_dValue = m_dValue;
+    t_pSnapshot->m_ucArraySize = m_ucArraySize;
+    t_pSnapshot->m_vecSamples = m_vecSamples;
+
+    return t_pSnapshot;
+}
+
+
 //*************************************************************************************************************
 
 void NewRealTimeSampleArray::setValue(double v)
@@ -210,6 +210,15 @@ public:
     */
     virtual double getValue() const;
 
+    //=========================================================================================================
+    /**
+    * Returns a new measurement holding a copy of the current sample array. Later setValue calls on this
+    * measurement do not change the snapshot.
+    *
+    * @return the snapshot.
+    */
+    virtual NewMeasurement::SPtr snapshot() const;
+
 private:
     double              m_dMinValue;        /**< Holds the minimal value.*/
     double              m_dMaxValue;        /**< Holds the maximal value.*/
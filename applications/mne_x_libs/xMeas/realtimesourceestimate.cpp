@@ -71,6 +71,7 @@ RealTimeSourceEstimate::RealTimeSourceEstimate(QObject *parent)
 , m_iArraySize(600)
 , m_iCurIdx(0)
 , m_fCurTimePoint(0)
+, m_iTimestamp(-1)
 {
     m_MNEStc.data = MatrixXd(0,0);
     m_MNEStc.times = RowVectorXf(m_iArraySize);
@@ -230,6 +230,22 @@ public:
     */
     inline MNESourceEstimate& getStc();
 
+    //=========================================================================================================
+    /**
+    * Sets the acquisition time stamp of the data the next values are estimated from.
+    *
+    * @param[in] p_iTimestamp   the time stamp, see IOBuffer::Tracer::now(); -1 if unknown.
+    */
+    inline void setTimestamp(qint64 p_iTimestamp);
+
+    //=========================================================================================================
+    /**
+    * Returns the acquisition time stamp of the data the current values were estimated from.
+    *
+    * @return the time stamp, -1 if unknown.
+    */
+    inline qint64 getTimestamp() const;
+
 
     bool m_bStcSend; //dirty hack
 
@@ -248,6 +264,7 @@ private:
     float                       m_fCurTimePoint;    /**< The current time point.*/
     MNESourceEstimate           m_MNEStc;           /**< The source estimate. */
     VectorXd                    m_vecValue;         /**< The current attached sample vector.*/
+    qint64                      m_iTimestamp;       /**< Acquisition time stamp of the current values.*/
 };
 
 
@@ -372,6 +389,22 @@ inline MNESourceEstimate& RealTimeSourceEstimate::getStc()
     return m_MNEStc;
 }
 
+
+//*************************************************************************************************************
+
+inline void RealTimeSourceEstimate::setTimestamp(qint64 p_iTimestamp)
+{
+    m_iTimestamp = p_iTimestamp;
+}
+
+
+//*************************************************************************************************************
+
+inline qint64 RealTimeSourceEstimate::getTimestamp() const
+{
+    return m_iTimestamp;
+}
+
 } // NAMESPACE
 
 Q_DECLARE_METATYPE(XMEASLIB::RealTimeSourceEstimate::SPtr)
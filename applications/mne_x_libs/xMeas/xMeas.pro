@@ -88,6 +88,8 @@ SOURCES += \
     realtimesourceestimate.cpp \
     newrealtimesamplearray.cpp \
     newrealtimemultisamplearray.cpp \
+    newrealtimemultisampleblock.cpp \
+    multisampleblock.cpp \
     realtimesamplearraychinfo.cpp \
     newnumeric.cpp \
     newmeasurement.cpp \
@@ -107,6 +109,8 @@ HEADERS += \
     realtimesourceestimate.h \
     newrealtimesamplearray.h \
     newrealtimemultisamplearray.h \
+    newrealtimemultisampleblock.h \
+    multisampleblock.h \
     realtimesamplearraychinfo.h \
     newnumeric.h \
     newmeasurement.h \
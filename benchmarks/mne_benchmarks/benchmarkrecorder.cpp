@@ -0,0 +1,191 @@
+//=============================================================================================================
+/**
+* @file     benchmarkrecorder.cpp
+* @author   Christoph Dinh <chdinh@nmr.mgh.harvard.edu>;
+*           Matti Hamalainen <msh@nmr.mgh.harvard.edu>
+* @version  1.0
+* @date     October, 2026
+*
+* @section  LICENSE
+*
+* Copyright (C) 2012, Christoph Dinh and Matti Hamalainen. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+* the following conditions are met:
+*     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+*       following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+*       the following disclaimer in the documentation and/or other materials provided with the distribution.
+*     * Neither the name of the Massachusetts General Hospital nor the names of its contributors may be used
+*       to endorse or promote products derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+* PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL MASSACHUSETTS GENERAL HOSPITAL BE LIABLE FOR ANY DIRECT,
+* INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+* NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+* @brief    BenchmarkRecorder class definition.
+*
+*/
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include "benchmarkrecorder.h"
+
+#include <stdio.h>
+#include <algorithm>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// QT INCLUDES
+//=============================================================================================================
+
+#include <QDateTime>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QTextStream>
+#include <QThread>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// USED NAMESPACES
+//=============================================================================================================
+
+using namespace MNEBenchmarks;
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINE MEMBER METHODS
+//=============================================================================================================
+
+BenchmarkRecorder::BenchmarkRecorder(qint32 p_iRepeats, qint32 p_iWarmup)
+: m_iRepeats(qMax(1, p_iRepeats))
+, m_iWarmup(qMax(0, p_iWarmup))
+{
+}
+
+
+//*************************************************************************************************************
+
+void BenchmarkRecorder::report(const QString &p_sKernel, const QString &p_sVariant, const QString &p_sData, qint32 p_iChannels, qint32 p_iSources, qint32 p_iSamples, qint32 p_iThreads)
+{
+    QVector<qint64> t_qVecNs = m_qVecNs.mid(qMin(m_iWarmup, m_qVecNs.size()));
+    m_qVecNs.clear();
+
+    if(t_qVecNs.isEmpty())
+    {
+        skip(p_sKernel, QString("no runs recorded"));
+        return;
+    }
+
+    std::sort(t_qVecNs.begin(), t_qVecNs.end());
+
+    Row t_row;
+    t_row.sKernel   = p_sKernel;
+    t_row.sVariant  = p_sVariant;
+    t_row.sData     = p_sData;
+    t_row.iChannels = p_iChannels;
+    t_row.iSources  = p_iSources;
+    t_row.iSamples  = p_iSamples;
+    t_row.iThreads  = p_iThreads;
+    t_row.iRepeats  = t_qVecNs.size();
+
+    qint32 n = t_qVecNs.size();
+    double t_dSum = 0;
+    for(qint32 i = 0; i < n; ++i)
+        t_dSum += t_qVecNs[i];
+
+    t_row.dMinUs    = t_qVecNs[0]*1e-3;
+    t_row.dMedianUs = (n % 2 ? t_qVecNs[n/2] : 0.5*(t_qVecNs[n/2-1] + t_qVecNs[n/2]))*1e-3;
+    t_row.dMeanUs   = t_dSum/n*1e-3;
+    t_row.dMaxUs    = t_qVecNs[n-1]*1e-3;
+
+    m_qListRows.append(t_row);
+
+    printf("[bench] %-32s %-14s %-9s ch %4d  src %6d  smp %6d  thr %2d  median %12.1f us  min %12.1f us\n",
+           p_sKernel.toUtf8().constData(), p_sVariant.toUtf8().constData(), p_sData.toUtf8().constData(),
+           p_iChannels, p_iSources, p_iSamples, p_iThreads, t_row.dMedianUs, t_row.dMinUs);
+    fflush(stdout);
+}
+
+
+//*************************************************************************************************************
+
+void BenchmarkRecorder::skip(const QString &p_sKernel, const QString &p_sReason)
+{
+    m_qVecNs.clear();
+
+    printf("[bench] %-32s skipped: %s\n", p_sKernel.toUtf8().constData(), p_sReason.toUtf8().constData());
+    fflush(stdout);
+}
+
+
+//*************************************************************************************************************
+
+bool BenchmarkRecorder::write(const QString &p_sFileName) const
+{
+    QFile t_file(p_sFileName);
+    if(!t_file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+    {
+        printf("Cannot write %s\n", p_sFileName.toUtf8().constData());
+        return false;
+    }
+
+    if(p_sFileName.endsWith(".json", Qt::CaseInsensitive))
+    {
+        QJsonArray t_jsonRows;
+        for(qint32 i = 0; i < m_qListRows.size(); ++i)
+        {
+            const Row &t_row = m_qListRows[i];
+            QJsonObject t_jsonRow;
+            t_jsonRow.insert("kernel", t_row.sKernel);
+            t_jsonRow.insert("variant", t_row.sVariant);
+            t_jsonRow.insert("data", t_row.sData);
+            t_jsonRow.insert("channels", t_row.iChannels);
+            t_jsonRow.insert("sources", t_row.iSources);
+            t_jsonRow.insert("samples", t_row.iSamples);
+            t_jsonRow.insert("threads", t_row.iThreads);
+            t_jsonRow.insert("repeats", t_row.iRepeats);
+            t_jsonRow.insert("min_us", t_row.dMinUs);
+            t_jsonRow.insert("median_us", t_row.dMedianUs);
+            t_jsonRow.insert("mean_us", t_row.dMeanUs);
+            t_jsonRow.insert("max_us", t_row.dMaxUs);
+            t_jsonRows.append(t_jsonRow);
+        }
+
+        QJsonObject t_jsonRoot;
+        t_jsonRoot.insert("date", QDateTime::currentDateTime().toString(Qt::ISODate));
+        t_jsonRoot.insert("ideal_thread_count", QThread::idealThreadCount());
+        t_jsonRoot.insert("rows", t_jsonRows);
+
+        t_file.write(QJsonDocument(t_jsonRoot).toJson());
+    }
+    else
+    {
+        QTextStream t_stream(&t_file);
+        t_stream << "kernel,variant,data,channels,sources,samples,threads,repeats,min_us,median_us,mean_us,max_us\n";
+        for(qint32 i = 0; i < m_qListRows.size(); ++i)
+        {
+            const Row &t_row = m_qListRows[i];
+            t_stream << t_row.sKernel << "," << t_row.sVariant << "," << t_row.sData << ","
+                     << t_row.iChannels << "," << t_row.iSources << "," << t_row.iSamples << ","
+                     << t_row.iThreads << "," << t_row.iRepeats << ","
+                     << QString::number(t_row.dMinUs, 'f', 1) << "," << QString::number(t_row.dMedianUs, 'f', 1) << ","
+                     << QString::number(t_row.dMeanUs, 'f', 1) << "," << QString::number(t_row.dMaxUs, 'f', 1) << "\n";
+        }
+    }
+
+    return true;
+}
@@ -0,0 +1,202 @@
+//=============================================================================================================
+/**
+* @file     benchmarkrecorder.h
+* @author   Christoph Dinh <chdinh@nmr.mgh.harvard.edu>;
+*           Matti Hamalainen <msh@nmr.mgh.harvard.edu>
+* @version  1.0
+* @date     October, 2026
+*
+* @section  LICENSE
+*
+* Copyright (C) 2012, Christoph Dinh and Matti Hamalainen. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+* the following conditions are met:
+*     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+*       following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+*       the following disclaimer in the documentation and/or other materials provided with the distribution.
+*     * Neither the name of the Massachusetts General Hospital nor the names of its contributors may be used
+*       to endorse or promote products derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+* PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL MASSACHUSETTS GENERAL HOSPITAL BE LIABLE FOR ANY DIRECT,
+* INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+* NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+* @brief    BenchmarkRecorder class declaration.
+*
+*/
+
+#ifndef BENCHMARKRECORDER_H
+#define BENCHMARKRECORDER_H
+
+//*************************************************************************************************************
+//=============================================================================================================
+// QT INCLUDES
+//=============================================================================================================
+
+#include <QElapsedTimer>
+#include <QList>
+#include <QString>
+#include <QVector>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINE NAMESPACE MNEBenchmarks
+//=============================================================================================================
+
+namespace MNEBenchmarks
+{
+
+//=============================================================================================================
+/**
+* Collects the run times of a kernel and turns them into one result row per configuration. The first runs of
+* each configuration are a warm up and are not recorded. The rows are written as CSV or, if the file name ends
+* with .json, as JSON, so that results of two releases can be compared by a script.
+*
+* @brief Timing and machine readable output of the benchmarks
+*/
+class BenchmarkRecorder
+{
+public:
+    //=========================================================================================================
+    /**
+    * One result row, times are given in microseconds.
+    */
+    struct Row
+    {
+        QString sKernel;    /**< Name of the timed kernel. */
+        QString sVariant;   /**< Kernel specific variant, e.g. the inverse method or the read mode. */
+        QString sData;      /**< "sample" for the MNE sample data, "synthetic" for generated data. */
+        qint32 iChannels;   /**< Number of channels. */
+        qint32 iSources;    /**< Number of source locations, 0 if not applicable. */
+        qint32 iSamples;    /**< Number of samples processed per run, 0 if not applicable. */
+        qint32 iThreads;    /**< Number of threads the kernel was allowed to use. */
+        qint32 iRepeats;    /**< Number of recorded runs. */
+        double dMinUs;      /**< Fastest run. */
+        double dMedianUs;   /**< Median run. */
+        double dMeanUs;     /**< Mean run. */
+        double dMaxUs;      /**< Slowest run. */
+    };
+
+    //=========================================================================================================
+    /**
+    * Constructs the recorder.
+    *
+    * @param[in] p_iRepeats     Number of recorded runs per configuration
+    * @param[in] p_iWarmup      Number of runs per configuration which are not recorded
+    */
+    explicit BenchmarkRecorder(qint32 p_iRepeats = 5, qint32 p_iWarmup = 1);
+
+    //=========================================================================================================
+    /**
+    * Returns the number of runs a kernel has to do per configuration, warm up included.
+    *
+    * @return the number of runs
+    */
+    inline qint32 runs() const;
+
+    //=========================================================================================================
+    /**
+    * Starts timing a run.
+    */
+    inline void start();
+
+    //=========================================================================================================
+    /**
+    * Stops timing a run.
+    */
+    inline void stop();
+
+    //=========================================================================================================
+    /**
+    * Turns the runs timed since the last report into a result row and prints it.
+    *
+    * @param[in] p_sKernel      Name of the timed kernel
+    * @param[in] p_sVariant     Kernel specific variant
+    * @param[in] p_sData        "sample" or "synthetic"
+    * @param[in] p_iChannels    Number of channels
+    * @param[in] p_iSources     Number of source locations
+    * @param[in] p_iSamples     Number of samples processed per run
+    * @param[in] p_iThreads     Number of threads
+    */
+    void report(const QString &p_sKernel, const QString &p_sVariant, const QString &p_sData, qint32 p_iChannels, qint32 p_iSources, qint32 p_iSamples, qint32 p_iThreads);
+
+    //=========================================================================================================
+    /**
+    * Discards the runs timed since the last report and prints why, e.g. when a kernel failed on its input.
+    *
+    * @param[in] p_sKernel      Name of the kernel
+    * @param[in] p_sReason      Why it was skipped
+    */
+    void skip(const QString &p_sKernel, const QString &p_sReason);
+
+    //=========================================================================================================
+    /**
+    * Returns the result rows.
+    *
+    * @return the result rows
+    */
+    inline const QList<Row>& rows() const;
+
+    //=========================================================================================================
+    /**
+    * Writes the result rows, as JSON if the file name ends with .json and as CSV otherwise.
+    *
+    * @param[in] p_sFileName    The file to write
+    *
+    * @return true if succeeded, false otherwise
+    */
+    bool write(const QString &p_sFileName) const;
+
+private:
+    QElapsedTimer   m_timer;        /**< Times the current run. */
+    QVector<qint64> m_qVecNs;       /**< Run times in ns since the last report, warm up included. */
+    qint32          m_iRepeats;     /**< Number of recorded runs per configuration. */
+    qint32          m_iWarmup;      /**< Number of warm up runs per configuration. */
+    QList<Row>      m_qListRows;    /**< The result rows. */
+};
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INLINE DEFINITIONS
+//=============================================================================================================
+
+inline qint32 BenchmarkRecorder::runs() const
+{
+    return m_iWarmup + m_iRepeats;
+}
+
+
+//*************************************************************************************************************
+
+inline void BenchmarkRecorder::start()
+{
+    m_timer.start();
+}
+
+
+//*************************************************************************************************************
+
+inline void BenchmarkRecorder::stop()
+{
+    m_qVecNs.append(m_timer.nsecsElapsed());
+}
+
+
+//*************************************************************************************************************
+
+inline const QList<BenchmarkRecorder::Row>& BenchmarkRecorder::rows() const
+{
+    return m_qListRows;
+}
+
+} // NAMESPACE
+
+#endif // BENCHMARKRECORDER_H
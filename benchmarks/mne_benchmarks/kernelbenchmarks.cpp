@@ -0,0 +1,735 @@
+//=============================================================================================================
+/**
+* @file     kernelbenchmarks.cpp
+* @author   Christoph Dinh <chdinh@nmr.mgh.harvard.edu>;
+*           Matti Hamalainen <msh@nmr.mgh.harvard.edu>
+* @version  1.0
+* @date     October, 2026
+*
+* @section  LICENSE
+*
+* Copyright (C) 2012, Christoph Dinh and Matti Hamalainen. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+* the following conditions are met:
+*     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+*       following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+*       the following disclaimer in the documentation and/or other materials provided with the distribution.
+*     * Neither the name of the Massachusetts General Hospital nor the names of its contributors may be used
+*       to endorse or promote products derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+* PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL MASSACHUSETTS GENERAL HOSPITAL BE LIABLE FOR ANY DIRECT,
+* INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+* NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+* @brief    KernelBenchmarks class definition.
+*
+*/
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include "kernelbenchmarks.h"
+#include "syntheticdata.h"
+
+#include <fiff/fiff.h>
+#include <fs/annotationset.h>
+#include <fs/label.h>
+#include <generics/broadcastmatrixbuffer.h>
+#include <inverse/minimumNorm/minimumnorm.h>
+#include <inverse/rapMusic/rapmusic.h>
+#include <mne/mne_forwardsolution.h>
+#include <mne/mne_inverse_operator.h>
+#include <rtInv/rtcov.h>
+#include <utils/filterdata.h>
+#include <utils/kmeans.h>
+#include <utils/mnemath.h>
+
+#include <stdlib.h>
+#include <math.h>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// Eigen INCLUDES
+//=============================================================================================================
+
+#include <Eigen/Core>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// QT INCLUDES
+//=============================================================================================================
+
+#include <QDir>
+#include <QFile>
+#include <QThread>
+#include <QThreadPool>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// USED NAMESPACES
+//=============================================================================================================
+
+using namespace MNEBenchmarks;
+using namespace Eigen;
+using namespace FIFFLIB;
+using namespace FSLIB;
+using namespace MNELIB;
+using namespace INVERSELIB;
+using namespace RTINVLIB;
+using namespace UTILSLIB;
+using namespace IOBuffer;
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINE MEMBER METHODS
+//=============================================================================================================
+
+KernelBenchmarks::KernelBenchmarks(const Options &p_options, BenchmarkRecorder &p_recorder, QObject *parent)
+: QObject(parent)
+, m_options(p_options)
+, m_recorder(p_recorder)
+{
+    //
+    //   EEG only, MEG only and MEG + EEG of the sample data; ico-4, ico-5 like and oct-6 source spaces
+    //
+    if(m_options.bQuick)
+    {
+        m_qListChannels << 60 << 366;
+        m_qListSources << 1026 << 4098;
+        m_qListRapSources << 100 << 200;
+    }
+    else
+    {
+        m_qListChannels << 60 << 306 << 366;
+        m_qListSources << 1026 << 4098 << 8196;
+        m_qListRapSources << 100 << 200 << 400;
+    }
+
+    if(m_options.qListThreads.isEmpty())
+        m_options.qListThreads << 1;
+}
+
+
+//*************************************************************************************************************
+
+void KernelBenchmarks::run()
+{
+    if(sampleFile(QString()).isEmpty())
+        printf("[bench] no sample data in %s, timing generated data only\n", m_options.sSampleDir.toUtf8().constData());
+
+    if(selected("read_raw_segment"))
+        benchReadRawSegment();
+    if(selected("FilterData::applyFFTFilter"))
+        benchFFTFilter();
+    if(selected("RtCov"))
+        benchRtCov();
+    if(selected("prepare_inverse_operator") || selected("assemble_kernel") || selected("MinimumNorm::calculateInverse") || selected("MinimumNorm::doInverseSetup") || selected("MNEMath::combine_xyz"))
+        benchInverse();
+    if(selected("RapMusic::calculateInverse"))
+        benchRapMusic();
+    if(selected("cluster_forward_solution"))
+        benchClusterForwardSolution();
+    if(selected("KMeans::calculate"))
+        benchKMeans();
+
+    setThreads(QThread::idealThreadCount());
+}
+
+
+//*************************************************************************************************************
+
+void KernelBenchmarks::setThreads(qint32 p_iThreads)
+{
+    QThreadPool::globalInstance()->setMaxThreadCount(p_iThreads);
+    Eigen::setNbThreads(p_iThreads);
+#ifdef _OPENMP
+    omp_set_num_threads(p_iThreads);
+#endif
+}
+
+
+//*************************************************************************************************************
+
+void KernelBenchmarks::onCovCalculated(FiffCov::SPtr p_pCov)
+{
+    Q_UNUSED(p_pCov);
+    m_semCov.release();
+}
+
+
+//*************************************************************************************************************
+
+bool KernelBenchmarks::selected(const QString &p_sKernel) const
+{
+    if(m_options.qListKernels.isEmpty())
+        return true;
+
+    for(qint32 i = 0; i < m_options.qListKernels.size(); ++i)
+        if(p_sKernel.contains(m_options.qListKernels[i], Qt::CaseInsensitive))
+            return true;
+
+    return false;
+}
+
+
+//*************************************************************************************************************
+
+QString KernelBenchmarks::sampleFile(const QString &p_sFile) const
+{
+    QString t_sPath = QDir(m_options.sSampleDir).filePath(p_sFile);
+    return QFile::exists(t_sPath) ? t_sPath : QString();
+}
+
+
+//*************************************************************************************************************
+
+void KernelBenchmarks::benchReadRawSegment()
+{
+    QString t_sKernel("read_raw_segment");
+
+    //
+    //   Generated file with as many channels as the largest configuration, 20 s
+    //
+    qint32 t_iMaxChannels = m_qListChannels.last();
+    FiffInfo::SPtr t_pInfo = SyntheticData::info(t_iMaxChannels);
+    QString t_sSynthetic = QDir(m_options.sTempDir).filePath("mne_benchmarks_raw.fif");
+    if(!SyntheticData::writeRaw(t_sSynthetic, *t_pInfo, 20*(qint32)t_pInfo->sfreq))
+    {
+        m_recorder.skip(t_sKernel, QString("cannot write %1").arg(t_sSynthetic));
+        return;
+    }
+
+    QList<QPair<QString, QString> > t_qListFiles;
+    t_qListFiles << qMakePair(QString("synthetic"), t_sSynthetic);
+    if(!sampleFile("MEG/sample/sample_audvis_raw.fif").isEmpty())
+        t_qListFiles << qMakePair(QString("sample"), sampleFile("MEG/sample/sample_audvis_raw.fif"));
+
+    for(qint32 f = 0; f < t_qListFiles.size(); ++f)
+    {
+        for(qint32 m = 0; m < 2; ++m)
+        {
+            bool t_bMapped = m == 1;
+
+            QFile t_file(t_qListFiles[f].second);
+            FiffRawData raw(t_file);
+            if(raw.info.nchan <= 0 || (t_bMapped && !raw.mapFile()))
+            {
+                m_recorder.skip(t_sKernel, QString("cannot read %1").arg(t_qListFiles[f].second));
+                continue;
+            }
+
+            fiff_int_t quantum = (fiff_int_t)ceil(raw.info.sfreq);
+            qint32 t_iSamples = raw.last_samp - raw.first_samp + 1;
+
+            QList<qint32> t_qListChannels;
+            for(qint32 c = 0; c < m_qListChannels.size(); ++c)
+                if(m_qListChannels[c] < raw.info.nchan)
+                    t_qListChannels << m_qListChannels[c];
+            t_qListChannels << raw.info.nchan;
+
+            for(qint32 c = 0; c < t_qListChannels.size(); ++c)
+            {
+                RowVectorXi sel = RowVectorXi::LinSpaced(t_qListChannels[c], 0, t_qListChannels[c] - 1);
+
+                for(qint32 t = 0; t < m_options.qListThreads.size(); ++t)
+                {
+                    setThreads(m_options.qListThreads[t]);
+
+                    MatrixXd data, times;
+                    for(qint32 r = 0; r < m_recorder.runs(); ++r)
+                    {
+                        m_recorder.start();
+                        for(fiff_int_t first = raw.first_samp; first <= raw.last_samp; first += quantum)
+                            raw.read_raw_segment(data, times, first, qMin(first + quantum - 1, raw.last_samp), sel);
+                        m_recorder.stop();
+                    }
+                    m_recorder.report(t_sKernel, t_bMapped ? "mapped" : "buffered", t_qListFiles[f].first, sel.size(), 0, t_iSamples, m_options.qListThreads[t]);
+                }
+            }
+        }
+    }
+
+    QFile::remove(t_sSynthetic);
+}
+
+
+//*************************************************************************************************************
+
+void KernelBenchmarks::benchFFTFilter()
+{
+    QString t_sKernel("FilterData::applyFFTFilter");
+
+    //
+    //   One second blocks at 600 Hz, band pass 1 - 40 Hz as in the real-time filter of mne_x
+    //
+    float t_fSFreq = 600.0f;
+    qint32 t_iSamples = (qint32)t_fSFreq;
+    qint32 t_iOrder = 80;
+    qint32 t_iFFTLength = 1;
+    while(t_iFFTLength < t_iSamples + t_iOrder)
+        t_iFFTLength *= 2;
+
+    double t_dNyquist = t_fSFreq/2.0;
+    FilterData t_filter(QString("BPF"), FilterData::BPF, t_iOrder, 20.5/t_dNyquist, 39.0/t_dNyquist, 5.0/t_dNyquist, t_iFFTLength);
+
+    for(qint32 c = 0; c < m_qListChannels.size(); ++c)
+    {
+        MatrixXd t_matData = SyntheticData::data(m_qListChannels[c], t_iSamples);
+        MatrixXd t_matFiltered(t_matData.rows(), t_iSamples);
+
+        for(qint32 t = 0; t < m_options.qListThreads.size(); ++t)
+        {
+            setThreads(m_options.qListThreads[t]);
+
+            for(qint32 r = 0; r < m_recorder.runs(); ++r)
+            {
+                m_recorder.start();
+                for(qint32 i = 0; i < t_matData.rows(); ++i)
+                {
+                    RowVectorXd t_vecRow = t_matData.row(i);
+                    t_matFiltered.row(i) = t_filter.applyFFTFilter(t_vecRow).head(t_iSamples);
+                }
+                m_recorder.stop();
+            }
+            m_recorder.report(t_sKernel, QString("bpf_order%1_fft%2").arg(t_iOrder).arg(t_iFFTLength), "synthetic", m_qListChannels[c], 0, t_iSamples, m_options.qListThreads[t]);
+        }
+    }
+}
+
+
+//*************************************************************************************************************
+
+void KernelBenchmarks::benchRtCov()
+{
+    QString t_sKernel("RtCov");
+
+    //
+    //   Each run pushes t_iBlocks blocks and waits for the estimate which they complete
+    //
+    qint32 t_iBlockSize = 100;
+    qint32 t_iBlocks = m_options.bQuick ? 20 : 50;
+
+    QList<QPair<QString, RtCov::Mode> > t_qListModes;
+    t_qListModes << qMakePair(QString("accumulate"), RtCov::Accumulate)
+                 << qMakePair(QString("sliding_window"), RtCov::SlidingWindow)
+                 << qMakePair(QString("exponential"), RtCov::ExponentiallyWeighted);
+
+    for(qint32 c = 0; c < m_qListChannels.size(); ++c)
+    {
+        FiffInfo::SPtr t_pInfo = SyntheticData::info(m_qListChannels[c]);
+
+        QList<MatrixXd> t_qListBlocks;
+        for(qint32 b = 0; b < t_iBlocks; ++b)
+            t_qListBlocks << SyntheticData::data(m_qListChannels[c], t_iBlockSize, b + 1) * 1e-12;
+
+        for(qint32 m = 0; m < t_qListModes.size(); ++m)
+        {
+            for(qint32 t = 0; t < m_options.qListThreads.size(); ++t)
+            {
+                setThreads(m_options.qListThreads[t]);
+
+                qint32 t_iMaxSamples = t_iBlocks*t_iBlockSize;
+                if(t_qListModes[m].second == RtCov::Accumulate)
+                    t_iMaxSamples -= 1;
+
+                BroadcastMatrixBuffer<double>::SPtr t_pBuffer(new BroadcastMatrixBuffer<double>(8, m_qListChannels[c], t_iBlockSize));
+
+                RtCov t_rtCov(t_iMaxSamples, t_pInfo);
+                t_rtCov.setMode(t_qListModes[m].second);
+                t_rtCov.setEmitInterval(t_iBlocks);
+                t_rtCov.attach(t_pBuffer, BroadcastMatrixBuffer<double>::Block);
+                connect(&t_rtCov, &RtCov::covCalculated, this, &KernelBenchmarks::onCovCalculated, Qt::DirectConnection);
+                t_rtCov.start();
+
+                for(qint32 r = 0; r < m_recorder.runs(); ++r)
+                {
+                    m_recorder.start();
+                    for(qint32 b = 0; b < t_iBlocks; ++b)
+                        t_pBuffer->push(&t_qListBlocks[b]);
+                    m_semCov.acquire();
+                    m_recorder.stop();
+                }
+
+                t_rtCov.stop();
+                m_semCov.acquire(m_semCov.available());
+
+                m_recorder.report(t_sKernel, t_qListModes[m].first, "synthetic", m_qListChannels[c], 0, t_iBlocks*t_iBlockSize, m_options.qListThreads[t]);
+            }
+        }
+    }
+}
+
+
+//*************************************************************************************************************
+
+void KernelBenchmarks::benchInverse()
+{
+    float t_fLambda2 = 1.0f/9.0f;   // SNR 3
+    qint32 t_iSamples = 300;
+
+    //
+    //   Inverse operators: generated ones over the grid, the sample one if available
+    //
+    QList<QPair<qint32, qint32> > t_qListShapes;
+    for(qint32 c = 0; c < m_qListChannels.size(); ++c)
+        for(qint32 s = 0; s < m_qListSources.size(); ++s)
+            t_qListShapes << qMakePair(m_qListChannels[c], m_qListSources[s]);
+
+    QString t_sSampleInv = sampleFile("MEG/sample/sample_audvis-meg-eeg-oct-6-meg-eeg-inv.fif");
+    qint32 t_iNumOperators = t_qListShapes.size() + (t_sSampleInv.isEmpty() ? 0 : 1);
+
+    for(qint32 o = 0; o < t_iNumOperators; ++o)
+    {
+        MNEInverseOperator t_invOp;
+        QString t_sData;
+        if(o < t_qListShapes.size())
+        {
+            FiffInfo::SPtr t_pInfo = SyntheticData::info(t_qListShapes[o].first);
+            t_invOp = SyntheticData::inverseOperator(SyntheticData::forwardSolution(*t_pInfo, t_qListShapes[o].second));
+            t_sData = QString("synthetic");
+        }
+        else
+        {
+            QFile t_fileInv(t_sSampleInv);
+            t_invOp = MNEInverseOperator(t_fileInv);
+            t_sData = QString("sample");
+        }
+
+        qint32 t_iChannels = t_invOp.eigen_fields->data.cols();
+        qint32 t_iSources = t_invOp.nsource;
+        MatrixXd t_matData = SyntheticData::data(t_iChannels, t_iSamples) * 1e-12;
+        MatrixXf t_matDataF = t_matData.cast<float>();
+
+        for(qint32 t = 0; t < m_options.qListThreads.size(); ++t)
+        {
+            setThreads(m_options.qListThreads[t]);
+
+            MNEInverseOperator t_invPrepared;
+
+            if(selected("prepare_inverse_operator"))
+            {
+                for(qint32 r = 0; r < m_recorder.runs(); ++r)
+                {
+                    m_recorder.start();
+                    t_invPrepared = t_invOp.prepare_inverse_operator(1, t_fLambda2, true, false);
+                    m_recorder.stop();
+                }
+                m_recorder.report("prepare_inverse_operator", "dSPM", t_sData, t_iChannels, t_iSources, 0, m_options.qListThreads[t]);
+            }
+
+            if(selected("assemble_kernel"))
+            {
+                if(t_invPrepared.nsource < 0)
+                    t_invPrepared = t_invOp.prepare_inverse_operator(1, t_fLambda2, true, false);
+
+                MatrixXd K;
+                SparseMatrix<double> noise_norm;
+                QList<VectorXi> vertno;
+                for(qint32 r = 0; r < m_recorder.runs(); ++r)
+                {
+                    m_recorder.start();
+                    t_invPrepared.assemble_kernel(Label(), QString("dSPM"), false, K, noise_norm, vertno);
+                    m_recorder.stop();
+                }
+                m_recorder.report("assemble_kernel", "dSPM", t_sData, t_iChannels, t_iSources, 0, m_options.qListThreads[t]);
+            }
+
+            if(selected("MinimumNorm::calculateInverse"))
+            {
+                QStringList t_qListMethods;
+                t_qListMethods << "MNE" << "dSPM";
+                for(qint32 m = 0; m < t_qListMethods.size(); ++m)
+                {
+                    MatrixXd t_matReference;
+
+                    for(qint32 f = 0; f < 2; ++f)
+                    {
+                        for(qint32 p = 0; p < 2; ++p)
+                        {
+                            MinimumNorm t_minimumNorm(t_invOp, t_fLambda2, t_qListMethods[m]);
+                            t_minimumNorm.setFactoredKernel(f == 1);
+                            t_minimumNorm.setSinglePrecision(p == 1);
+                            t_minimumNorm.doInverseSetup(1, false);
+
+                            QString t_sVariant = t_qListMethods[m];
+                            if(f == 1)
+                                t_sVariant += " factored";
+                            if(p == 1)
+                                t_sVariant += " float";
+
+                            MNESourceEstimate t_stc;
+                            for(qint32 r = 0; r < m_recorder.runs(); ++r)
+                            {
+                                m_recorder.start();
+                                if(p == 1)
+                                    t_stc = t_minimumNorm.calculateInverse(t_matDataF, 0.0f, 1.0f/600.0f);
+                                else
+                                    t_stc = t_minimumNorm.calculateInverse(t_matData, 0.0f, 1.0f/600.0f);
+                                m_recorder.stop();
+                            }
+                            m_recorder.report("MinimumNorm::calculateInverse", t_sVariant, t_sData, t_iChannels, t_iSources, t_iSamples, m_options.qListThreads[t]);
+
+                            // Validate all variants against the dense double precision result
+                            if(f == 0 && p == 0)
+                                t_matReference = t_stc.data;
+                            else if(t_matReference.size() > 0 && t_stc.data.rows() == t_matReference.rows())
+                            {
+                                double t_dError = (t_stc.data - t_matReference).cwiseAbs().maxCoeff() / t_matReference.cwiseAbs().maxCoeff();
+                                double t_dBound = p == 1 ? 1e-4 : 1e-10;
+                                printf("[bench] MinimumNorm::calculateInverse %s max deviation %g of the largest source value (bound %g)%s\n", t_sVariant.toUtf8().constData(), t_dError, t_dBound, t_dError > t_dBound ? " EXCEEDED" : "");
+                            }
+                        }
+                    }
+                }
+            }
+
+            if(selected("MinimumNorm::doInverseSetup"))
+            {
+                MinimumNorm t_minimumNorm(t_invOp, t_fLambda2, QString("dSPM"));
+
+                for(qint32 r = 0; r < m_recorder.runs(); ++r)
+                {
+                    t_minimumNorm.clearKernelCache();
+                    m_recorder.start();
+                    t_minimumNorm.doInverseSetup(1, false);
+                    m_recorder.stop();
+                }
+                m_recorder.report("MinimumNorm::doInverseSetup", "dSPM", t_sData, t_iChannels, t_iSources, 0, m_options.qListThreads[t]);
+
+                for(qint32 r = 0; r < m_recorder.runs(); ++r)
+                {
+                    m_recorder.start();
+                    t_minimumNorm.doInverseSetup(1, false);
+                    m_recorder.stop();
+                }
+                m_recorder.report("MinimumNorm::doInverseSetup", "dSPM cached", t_sData, t_iChannels, t_iSources, 0, m_options.qListThreads[t]);
+            }
+
+            if(selected("MNEMath::combine_xyz") && t_invOp.source_ori == FIFFV_MNE_FREE_ORI)
+            {
+                MatrixXd t_matSol = SyntheticData::data(3*t_iSources, t_iSamples);
+                VectorXd t_vecScale = VectorXd::Constant(t_iSources, 2.0);
+                SparseMatrix<double> t_matScale(t_iSources, t_iSources);
+                t_matScale.setIdentity();
+                t_matScale *= 2.0;
+                MatrixXd t_matOut;
+
+                for(qint32 r = 0; r < m_recorder.runs(); ++r)
+                {
+                    m_recorder.start();
+                    t_matOut.resize(t_iSources, t_iSamples);
+                    for(qint32 i = 0; i < t_matSol.cols(); ++i)
+                    {
+                        VectorXd* tmp = MNEMath::combine_xyz(t_matSol.col(i));
+                        t_matOut.col(i) = tmp->cwiseSqrt();
+                        delete tmp;
+                    }
+                    t_matOut = t_matScale*t_matOut;
+                    m_recorder.stop();
+                }
+                m_recorder.report("MNEMath::combine_xyz", "per column", t_sData, t_iChannels, t_iSources, t_iSamples, m_options.qListThreads[t]);
+
+                for(qint32 r = 0; r < m_recorder.runs(); ++r)
+                {
+                    m_recorder.start();
+                    MNEMath::combine_xyz_normalized(t_matSol, t_vecScale, t_matOut);
+                    m_recorder.stop();
+                }
+                m_recorder.report("MNEMath::combine_xyz", "fused", t_sData, t_iChannels, t_iSources, t_iSamples, m_options.qListThreads[t]);
+            }
+        }
+    }
+}
+
+
+//*************************************************************************************************************
+
+void KernelBenchmarks::benchRapMusic()
+{
+    QString t_sKernel("RapMusic::calculateInverse");
+    qint32 t_iSamples = 100;
+    qint32 t_iDipolePairs = 2;
+
+    //
+    //   Forward solutions: generated ones over the grid, the clustered sample one if available
+    //
+    QList<QPair<qint32, qint32> > t_qListShapes;
+    for(qint32 c = 0; c < m_qListChannels.size(); ++c)
+        for(qint32 s = 0; s < m_qListRapSources.size(); ++s)
+            t_qListShapes << qMakePair(m_qListChannels[c], m_qListRapSources[s]);
+
+    QString t_sSampleFwd = sampleFile("MEG/sample/sample_audvis-meg-eeg-oct-6-fwd.fif");
+    QString t_sSampleLh = sampleFile("subjects/sample/label/lh.aparc.a2009s.annot");
+    QString t_sSampleRh = sampleFile("subjects/sample/label/rh.aparc.a2009s.annot");
+    bool t_bSample = !t_sSampleFwd.isEmpty() && !t_sSampleLh.isEmpty() && !t_sSampleRh.isEmpty();
+    qint32 t_iNumForwards = t_qListShapes.size() + (t_bSample ? 1 : 0);
+
+    for(qint32 o = 0; o < t_iNumForwards; ++o)
+    {
+        MNEForwardSolution t_fwd;
+        QString t_sData;
+        if(o < t_qListShapes.size())
+        {
+            FiffInfo::SPtr t_pInfo = SyntheticData::info(t_qListShapes[o].first);
+            t_fwd = SyntheticData::forwardSolution(*t_pInfo, t_qListShapes[o].second);
+            t_sData = QString("synthetic");
+        }
+        else
+        {
+            QFile t_fileFwd(t_sSampleFwd);
+            MNEForwardSolution t_fwdFull(t_fileFwd);
+            AnnotationSet t_annotationSet(t_sSampleLh, t_sSampleRh);
+            t_fwd = t_fwdFull.cluster_forward_solution(t_annotationSet, 40);
+            t_sData = QString("sample");
+        }
+
+        qint32 t_iChannels = t_fwd.sol->data.rows();
+        qint32 t_iSources = t_fwd.sol->data.cols()/3;
+        MatrixXd t_matData = SyntheticData::data(t_iChannels, t_iSamples) * 1e-12;
+
+        for(qint32 t = 0; t < m_options.qListThreads.size(); ++t)
+        {
+            setThreads(m_options.qListThreads[t]);
+
+            // RapMusic takes its thread count from OpenMP when it is initialized
+            RapMusic t_rapMusic(t_fwd, false, t_iDipolePairs);
+
+            for(qint32 r = 0; r < m_recorder.runs(); ++r)
+            {
+                m_recorder.start();
+                MNESourceEstimate t_stc = t_rapMusic.calculateInverse(t_matData, 0.0f, 1.0f/600.0f);
+                m_recorder.stop();
+            }
+            m_recorder.report(t_sKernel, QString("pairs%1").arg(t_iDipolePairs), t_sData, t_iChannels, t_iSources, t_iSamples, m_options.qListThreads[t]);
+        }
+    }
+}
+
+
+//*************************************************************************************************************
+
+void KernelBenchmarks::benchClusterForwardSolution()
+{
+    QString t_sKernel("cluster_forward_solution");
+    qint32 t_iClusterSize = 40;
+    qint32 t_iNumLabels = 40;
+
+    for(qint32 c = 0; c < m_qListChannels.size(); ++c)
+    {
+        FiffInfo::SPtr t_pInfo = SyntheticData::info(m_qListChannels[c]);
+
+        for(qint32 s = 0; s < m_qListSources.size(); ++s)
+        {
+            MNEForwardSolution t_fwd = SyntheticData::forwardSolution(*t_pInfo, m_qListSources[s]);
+            AnnotationSet t_annotationSet = SyntheticData::annotationSet(t_fwd, t_iNumLabels);
+
+            for(qint32 t = 0; t < m_options.qListThreads.size(); ++t)
+            {
+                setThreads(m_options.qListThreads[t]);
+
+                for(qint32 r = 0; r < m_recorder.runs(); ++r)
+                {
+                    // KMeans starts from random samples
+                    srand(1);
+                    m_recorder.start();
+                    MNEForwardSolution t_fwdClustered = t_fwd.cluster_forward_solution(t_annotationSet, t_iClusterSize);
+                    m_recorder.stop();
+                }
+                m_recorder.report(t_sKernel, QString("size%1").arg(t_iClusterSize), "synthetic", m_qListChannels[c], m_qListSources[s], 0, m_options.qListThreads[t]);
+            }
+        }
+    }
+
+    //
+    //   Sample forward solution with the a2009s parcellation: MEG, EEG and both
+    //
+    QString t_sSampleFwd = sampleFile("MEG/sample/sample_audvis-meg-eeg-oct-6-fwd.fif");
+    QString t_sSampleLh = sampleFile("subjects/sample/label/lh.aparc.a2009s.annot");
+    QString t_sSampleRh = sampleFile("subjects/sample/label/rh.aparc.a2009s.annot");
+    if(t_sSampleFwd.isEmpty() || t_sSampleLh.isEmpty() || t_sSampleRh.isEmpty())
+        return;
+
+    QFile t_fileFwd(t_sSampleFwd);
+    MNEForwardSolution t_fwdFull(t_fileFwd);
+    AnnotationSet t_annotationSet(t_sSampleLh, t_sSampleRh);
+
+    for(qint32 p = 0; p < 3; ++p)
+    {
+        MNEForwardSolution t_fwd = t_fwdFull.pick_types(p != 1, p != 0);
+
+        for(qint32 t = 0; t < m_options.qListThreads.size(); ++t)
+        {
+            setThreads(m_options.qListThreads[t]);
+
+            for(qint32 r = 0; r < m_recorder.runs(); ++r)
+            {
+                srand(1);
+                m_recorder.start();
+                MNEForwardSolution t_fwdClustered = t_fwd.cluster_forward_solution(t_annotationSet, t_iClusterSize);
+                m_recorder.stop();
+            }
+            m_recorder.report(t_sKernel, QString("size%1").arg(t_iClusterSize), "sample", t_fwd.nchan, t_fwd.nsource, 0, m_options.qListThreads[t]);
+        }
+    }
+}
+
+
+//*************************************************************************************************************
+
+void KernelBenchmarks::benchKMeans()
+{
+    QString t_sKernel("KMeans::calculate");
+    qint32 t_iClusterSize = 40;
+
+    QList<qint32> t_qListRegionSources;
+    t_qListRegionSources << 100 << 400;
+    if(m_options.bQuick)
+        t_qListRegionSources.removeLast();
+
+    for(qint32 c = 0; c < m_qListChannels.size(); ++c)
+    {
+        for(qint32 s = 0; s < t_qListRegionSources.size(); ++s)
+        {
+            //
+            //   Region gain matrix as clustered by cluster_forward_solution: sources x sensors(x,y,z)
+            //
+            MatrixXd t_matRoiG = SyntheticData::data(t_qListRegionSources[s], 3*m_qListChannels[c]);
+            qint32 t_iClusters = (qint32)ceil((double)t_qListRegionSources[s]/(double)t_iClusterSize);
+
+            for(qint32 t = 0; t < m_options.qListThreads.size(); ++t)
+            {
+                setThreads(m_options.qListThreads[t]);
+
+                VectorXi idx;
+                MatrixXd ctrs, D;
+                VectorXd sumd;
+                for(qint32 r = 0; r < m_recorder.runs(); ++r)
+                {
+                    KMeans t_kMeans(QString("cityblock"), QString("sample"), 5);
+                    srand(1);
+                    m_recorder.start();
+                    t_kMeans.calculate(t_matRoiG, t_iClusters, idx, ctrs, sumd, D);
+                    m_recorder.stop();
+                }
+                m_recorder.report(t_sKernel, QString("cityblock_k%1").arg(t_iClusters), "synthetic", m_qListChannels[c], t_qListRegionSources[s], 0, m_options.qListThreads[t]);
+            }
+        }
+    }
+}
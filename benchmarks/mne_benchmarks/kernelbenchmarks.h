@@ -0,0 +1,169 @@
+//=============================================================================================================
+/**
+* @file     kernelbenchmarks.h
+* @author   Christoph Dinh <chdinh@nmr.mgh.harvard.edu>;
+*           Matti Hamalainen <msh@nmr.mgh.harvard.edu>
+* @version  1.0
+* @date     October, 2026
+*
+* @section  LICENSE
+*
+* Copyright (C) 2012, Christoph Dinh and Matti Hamalainen. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+* the following conditions are met:
+*     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+*       following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+*       the following disclaimer in the documentation and/or other materials provided with the distribution.
+*     * Neither the name of the Massachusetts General Hospital nor the names of its contributors may be used
+*       to endorse or promote products derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+* PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL MASSACHUSETTS GENERAL HOSPITAL BE LIABLE FOR ANY DIRECT,
+* INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+* NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+* @brief    KernelBenchmarks class declaration.
+*
+*/
+
+#ifndef KERNELBENCHMARKS_H
+#define KERNELBENCHMARKS_H
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include "benchmarkrecorder.h"
+
+#include <fiff/fiff_cov.h>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// QT INCLUDES
+//=============================================================================================================
+
+#include <QList>
+#include <QObject>
+#include <QSemaphore>
+#include <QString>
+#include <QStringList>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINE NAMESPACE MNEBenchmarks
+//=============================================================================================================
+
+namespace MNEBenchmarks
+{
+
+//=============================================================================================================
+/**
+* Times the core numeric kernels over a grid of channel counts, source counts and thread counts. Every kernel
+* runs on generated data of the shapes of the MNE sample data; if the sample data is found, the kernels which
+* read files additionally run on it. A thread count limits the global QThreadPool, Eigen and OpenMP; kernels
+* which are single threaded are timed at each thread count as well, so that their rows show when they start
+* to scale.
+*
+* @brief Benchmarks of the core numeric kernels
+*/
+class KernelBenchmarks : public QObject
+{
+    Q_OBJECT
+public:
+    //=========================================================================================================
+    /**
+    * Benchmark settings.
+    */
+    struct Options
+    {
+        QList<qint32> qListThreads;     /**< Thread counts to run each configuration with. */
+        QStringList qListKernels;       /**< Run only the kernels whose name contains one of these, all if empty. */
+        QString sSampleDir;             /**< Directory of the MNE sample data, may not exist. */
+        QString sTempDir;               /**< Directory for generated files. */
+        bool bQuick;                    /**< Use a reduced grid, e.g. for continuous integration. */
+    };
+
+    //=========================================================================================================
+    /**
+    * Constructs the benchmarks.
+    *
+    * @param[in] p_options      The benchmark settings
+    * @param[in] p_recorder     Collects the results
+    * @param[in] parent         Parent QObject (optional)
+    */
+    KernelBenchmarks(const Options &p_options, BenchmarkRecorder &p_recorder, QObject *parent = 0);
+
+    //=========================================================================================================
+    /**
+    * Runs all selected kernels.
+    */
+    void run();
+
+    //=========================================================================================================
+    /**
+    * Limits the global QThreadPool, Eigen and OpenMP to the given number of threads.
+    *
+    * @param[in] p_iThreads     Number of threads
+    */
+    static void setThreads(qint32 p_iThreads);
+
+private slots:
+    //=========================================================================================================
+    /**
+    * Receives the estimates of RtCov, is called in the RtCov thread.
+    *
+    * @param[in] p_pCov     The covariance matrix
+    */
+    void onCovCalculated(FIFFLIB::FiffCov::SPtr p_pCov);
+
+private:
+    //=========================================================================================================
+    /**
+    * Returns whether a kernel was selected.
+    *
+    * @param[in] p_sKernel      Name of the kernel
+    *
+    * @return true if the kernel has to be timed
+    */
+    bool selected(const QString &p_sKernel) const;
+
+    //=========================================================================================================
+    /**
+    * Returns the path of a file of the sample data.
+    *
+    * @param[in] p_sFile        The file relative to the sample data directory
+    *
+    * @return the path, an empty string if the file does not exist
+    */
+    QString sampleFile(const QString &p_sFile) const;
+
+    void benchReadRawSegment();             /**< Times FiffRawData::read_raw_segment, buffered and memory mapped. */
+    void benchFFTFilter();                  /**< Times FilterData::applyFFTFilter on each channel of a block. */
+    void benchRtCov();                      /**< Times RtCov updates of all modes up to the emitted estimate. */
+    void benchInverse();                    /**< Times prepare_inverse_operator, assemble_kernel, the MinimumNorm setup and application and the free orientation combine. */
+    void benchRapMusic();                   /**< Times RapMusic::calculateInverse. */
+    void benchClusterForwardSolution();     /**< Times MNEForwardSolution::cluster_forward_solution. */
+    void benchKMeans();                     /**< Times KMeans::calculate on region gain matrices. */
+
+    Options             m_options;          /**< The benchmark settings. */
+    BenchmarkRecorder&  m_recorder;         /**< Collects the results. */
+
+    QList<qint32>       m_qListChannels;    /**< Channel counts of the generated data. */
+    QList<qint32>       m_qListSources;     /**< Source counts of the generated distributed source spaces. */
+    QList<qint32>       m_qListRapSources;  /**< Source counts of the generated clustered source spaces used by RapMusic. */
+
+    QSemaphore          m_semCov;           /**< Released for every covariance estimate of RtCov. */
+};
+
+} // NAMESPACE
+
+#endif // KERNELBENCHMARKS_H
@@ -0,0 +1,155 @@
+//=============================================================================================================
+/**
+* @file     main.cpp
+* @author   Christoph Dinh <chdinh@nmr.mgh.harvard.edu>;
+*           Matti Hamalainen <msh@nmr.mgh.harvard.edu>
+* @version  1.0
+* @date     October, 2026
+*
+* @section  LICENSE
+*
+* Copyright (C) 2012, Christoph Dinh and Matti Hamalainen. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+* the following conditions are met:
+*     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+*       following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+*       the following disclaimer in the documentation and/or other materials provided with the distribution.
+*     * Neither the name of the Massachusetts General Hospital nor the names of its contributors may be used
+*       to endorse or promote products derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+* PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL MASSACHUSETTS GENERAL HOSPITAL BE LIABLE FOR ANY DIRECT,
+* INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+* NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+* @brief    Times the core numeric kernels of the MNE libraries across channel, source and thread counts and
+*           writes the results as CSV or JSON, so that releases can be compared.
+*
+*           Usage: mne_benchmarks [--data <sample data dir>] [--out <file.csv|file.json>] [--threads 1,2,4]
+*                                 [--repeats <n>] [--kernels <name,...>] [--tmp <dir>] [--quick]
+*
+*/
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include "benchmarkrecorder.h"
+#include "kernelbenchmarks.h"
+
+#include <stdio.h>
+#include <string.h>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// QT INCLUDES
+//=============================================================================================================
+
+#include <QtCore/QCoreApplication>
+#include <QDir>
+#include <QStringList>
+#include <QThread>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// USED NAMESPACES
+//=============================================================================================================
+
+using namespace MNEBenchmarks;
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// MAIN
+//=============================================================================================================
+
+//=============================================================================================================
+/**
+* The function main marks the entry point of the program.
+* By default, main has the storage class extern.
+*
+* @param [in] argc (argument count) is an integer that indicates how many arguments were entered on the command line when the program was started.
+* @param [in] argv (argument vector) is an array of pointers to arrays of character objects. The array objects are null-terminated strings, representing the arguments that were entered on the command line when the program was started.
+* @return the value that was set to exit() (which is 0 if exit() is called via quit()).
+*/
+int main(int argc, char *argv[])
+{
+    QCoreApplication a(argc, argv);
+
+    KernelBenchmarks::Options t_options;
+    t_options.sSampleDir = QString("./MNE-sample-data");
+    t_options.sTempDir = QDir::tempPath();
+    t_options.bQuick = false;
+
+    QString t_sFileOut("./mne_benchmarks.csv");
+    QString t_sThreads = QString("1,%1").arg(QThread::idealThreadCount());
+    qint32 t_iRepeats = 5;
+
+    // Parse command line parameters
+    for(qint32 i = 0; i < argc; ++i)
+    {
+        if(strcmp(argv[i], "-data") == 0 || strcmp(argv[i], "--data") == 0)
+        {
+            if(i + 1 < argc)
+                t_options.sSampleDir = QString::fromUtf8(argv[i+1]);
+        }
+        else if(strcmp(argv[i], "-out") == 0 || strcmp(argv[i], "--out") == 0)
+        {
+            if(i + 1 < argc)
+                t_sFileOut = QString::fromUtf8(argv[i+1]);
+        }
+        else if(strcmp(argv[i], "-threads") == 0 || strcmp(argv[i], "--threads") == 0)
+        {
+            if(i + 1 < argc)
+                t_sThreads = QString::fromUtf8(argv[i+1]);
+        }
+        else if(strcmp(argv[i], "-repeats") == 0 || strcmp(argv[i], "--repeats") == 0)
+        {
+            if(i + 1 < argc)
+                t_iRepeats = atoi(argv[i+1]);
+        }
+        else if(strcmp(argv[i], "-kernels") == 0 || strcmp(argv[i], "--kernels") == 0)
+        {
+            if(i + 1 < argc)
+                t_options.qListKernels = QString::fromUtf8(argv[i+1]).split(",", QString::SkipEmptyParts);
+        }
+        else if(strcmp(argv[i], "-tmp") == 0 || strcmp(argv[i], "--tmp") == 0)
+        {
+            if(i + 1 < argc)
+                t_options.sTempDir = QString::fromUtf8(argv[i+1]);
+        }
+        else if(strcmp(argv[i], "-quick") == 0 || strcmp(argv[i], "--quick") == 0)
+        {
+            t_options.bQuick = true;
+        }
+    }
+
+    QStringList t_qListThreads = t_sThreads.split(",", QString::SkipEmptyParts);
+    for(qint32 i = 0; i < t_qListThreads.size(); ++i)
+    {
+        qint32 t_iThreads = t_qListThreads[i].toInt();
+        if(t_iThreads > 0 && !t_options.qListThreads.contains(t_iThreads))
+            t_options.qListThreads << t_iThreads;
+    }
+
+    BenchmarkRecorder t_recorder(t_iRepeats);
+    KernelBenchmarks t_benchmarks(t_options, t_recorder);
+    t_benchmarks.run();
+
+    if(!t_recorder.write(t_sFileOut))
+        return -1;
+
+    printf("[bench] %d results written to %s\n", t_recorder.rows().size(), t_sFileOut.toUtf8().constData());
+
+    return 0;
+}
@@ -0,0 +1,323 @@
+//=============================================================================================================
+/**
+* @file     syntheticdata.cpp
+* @author   Christoph Dinh <chdinh@nmr.mgh.harvard.edu>;
+*           Matti Hamalainen <msh@nmr.mgh.harvard.edu>
+* @version  1.0
+* @date     October, 2026
+*
+* @section  LICENSE
+*
+* Copyright (C) 2012, Christoph Dinh and Matti Hamalainen. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+* the following conditions are met:
+*     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+*       following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+*       the following disclaimer in the documentation and/or other materials provided with the distribution.
+*     * Neither the name of the Massachusetts General Hospital nor the names of its contributors may be used
+*       to endorse or promote products derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+* PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL MASSACHUSETTS GENERAL HOSPITAL BE LIABLE FOR ANY DIRECT,
+* INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+* NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+* @brief    SyntheticData class definition.
+*
+*/
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include "syntheticdata.h"
+
+#include <fiff/fiff_constants.h>
+#include <fiff/fiff_stream.h>
+
+#include <stdlib.h>
+#include <math.h>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// Eigen INCLUDES
+//=============================================================================================================
+
+#include <Eigen/Eigenvalues>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// QT INCLUDES
+//=============================================================================================================
+
+#include <QFile>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// USED NAMESPACES
+//=============================================================================================================
+
+using namespace MNEBenchmarks;
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINE MEMBER METHODS
+//=============================================================================================================
+
+FiffInfo::SPtr SyntheticData::info(qint32 p_iNumChannels, float p_fSFreq)
+{
+    FiffInfo::SPtr t_pInfo(new FiffInfo());
+
+    qint32 t_iNumMeg = p_iNumChannels > 60 ? qMin(306, p_iNumChannels) : 0;
+
+    for(qint32 k = 0; k < p_iNumChannels; ++k)
+    {
+        FiffChInfo t_ch;
+        t_ch.scanno = k + 1;
+        t_ch.logno = k + 1;
+        t_ch.range = 1.0f;
+        t_ch.cal = 1.0f;
+        t_ch.coord_frame = FIFFV_COORD_HEAD;
+
+        if(k < t_iNumMeg)
+        {
+            bool t_bMag = (k % 3) == 2;
+            t_ch.kind = FIFFV_MEG_CH;
+            t_ch.unit = t_bMag ? FIFF_UNIT_T : FIFF_UNIT_T_M;
+            t_ch.coil_type = t_bMag ? FIFFV_COIL_VV_MAG_T3 : FIFFV_COIL_VV_PLANAR_T1;
+            t_ch.ch_name = QString("MEG %1").arg(k + 1, 4, 10, QChar('0'));
+        }
+        else
+        {
+            t_ch.kind = FIFFV_EEG_CH;
+            t_ch.unit = FIFF_UNIT_V;
+            t_ch.coil_type = FIFFV_COIL_EEG;
+            t_ch.ch_name = QString("EEG %1").arg(k - t_iNumMeg + 1, 3, 10, QChar('0'));
+        }
+
+        t_pInfo->chs.append(t_ch);
+        t_pInfo->ch_names.append(t_ch.ch_name);
+    }
+
+    t_pInfo->nchan = p_iNumChannels;
+    t_pInfo->sfreq = p_fSFreq;
+    t_pInfo->highpass = 0.1f;
+    t_pInfo->lowpass = p_fSFreq/3.0f;
+
+    return t_pInfo;
+}
+
+
+//*************************************************************************************************************
+
+MatrixXd SyntheticData::data(qint32 p_iRows, qint32 p_iCols, unsigned int p_iSeed)
+{
+    srand(p_iSeed);
+    return MatrixXd::Random(p_iRows, p_iCols);
+}
+
+
+//*************************************************************************************************************
+
+bool SyntheticData::writeRaw(const QString &p_sFileName, const FiffInfo &p_info, qint32 p_iNumSamples)
+{
+    QFile t_file(p_sFileName);
+    MatrixXd cals;
+    FiffStream::SPtr t_pStream = FiffStream::start_writing_raw(t_file, p_info, cals);
+    if(!t_pStream)
+        return false;
+
+    //
+    //   Scale to the usual magnitudes of gradiometers, magnetometers and EEG
+    //
+    VectorXd t_vecScale(p_info.nchan);
+    for(qint32 k = 0; k < p_info.nchan; ++k)
+        t_vecScale[k] = p_info.chs[k].unit == FIFF_UNIT_T_M ? 1e-10 : (p_info.chs[k].unit == FIFF_UNIT_T ? 1e-12 : 1e-5);
+
+    qint32 t_iQuantum = (qint32)ceil(p_info.sfreq);
+    unsigned int t_iSeed = 1;
+    for(qint32 first = 0; first < p_iNumSamples; first += t_iQuantum)
+    {
+        MatrixXd t_matBuf = t_vecScale.asDiagonal() * data(p_info.nchan, qMin(t_iQuantum, p_iNumSamples - first), t_iSeed++);
+        if(!t_pStream->write_raw_buffer(t_matBuf, cals))
+            return false;
+    }
+    t_pStream->finish_writing_raw();
+
+    return true;
+}
+
+
+//*************************************************************************************************************
+
+MNEForwardSolution SyntheticData::forwardSolution(const FiffInfo &p_info, qint32 p_iNumSources)
+{
+    MNEForwardSolution t_fwd;
+
+    t_fwd.info = p_info;
+    t_fwd.source_ori = FIFFV_MNE_FREE_ORI;
+    t_fwd.surf_ori = false;
+    t_fwd.coord_frame = FIFFV_COORD_HEAD;
+    t_fwd.nsource = p_iNumSources;
+    t_fwd.nchan = p_info.nchan;
+
+    t_fwd.sol->data = data(p_info.nchan, 3*p_iNumSources, 2) * 1e-8;
+    t_fwd.sol->nrow = p_info.nchan;
+    t_fwd.sol->ncol = 3*p_iNumSources;
+    t_fwd.sol->row_names = p_info.ch_names;
+
+    //
+    //   Two hemispheres, source locations on a 7 cm sphere
+    //
+    MatrixXd t_matDir = data(p_iNumSources, 3, 3);
+    t_fwd.source_rr = MatrixX3f(p_iNumSources, 3);
+    t_fwd.source_nn = MatrixX3f::Zero(3*p_iNumSources, 3);
+    for(qint32 i = 0; i < p_iNumSources; ++i)
+    {
+        t_fwd.source_rr.row(i) = (0.07 * t_matDir.row(i).normalized()).cast<float>();
+        t_fwd.source_nn.block(3*i, 0, 3, 3) = Matrix3f::Identity();
+    }
+
+    qint32 t_iOffset = 0;
+    for(qint32 h = 0; h < 2; ++h)
+    {
+        qint32 t_iNumUse = h == 0 ? p_iNumSources/2 : p_iNumSources - p_iNumSources/2;
+
+        MNEHemisphere t_hemi;
+        t_hemi.id = h == 0 ? FIFFV_MNE_SURF_LEFT_HEMI : FIFFV_MNE_SURF_RIGHT_HEMI;
+        t_hemi.np = t_iNumUse;
+        t_hemi.nuse = t_iNumUse;
+        t_hemi.coord_frame = FIFFV_COORD_HEAD;
+        t_hemi.inuse = VectorXi::Ones(t_iNumUse);
+        t_hemi.vertno = VectorXi::LinSpaced(t_iNumUse, 0, t_iNumUse - 1);
+        t_hemi.rr = t_fwd.source_rr.block(t_iOffset, 0, t_iNumUse, 3);
+        t_hemi.nn = t_hemi.rr.rowwise().normalized();
+
+        t_fwd.src.append(t_hemi);
+        t_iOffset += t_iNumUse;
+    }
+
+    return t_fwd;
+}
+
+
+//*************************************************************************************************************
+
+MNEInverseOperator SyntheticData::inverseOperator(const MNEForwardSolution &p_forward)
+{
+    qint32 t_iNumChannels = p_forward.sol->data.rows();
+    qint32 t_iNumComps = p_forward.sol->data.cols();
+
+    MNEInverseOperator t_inv;
+
+    t_inv.info = p_forward.info;
+    t_inv.methods = FIFFV_MNE_MEG_EEG;
+    t_inv.source_ori = p_forward.source_ori;
+    t_inv.nsource = p_forward.nsource;
+    t_inv.nchan = t_iNumChannels;
+    t_inv.coord_frame = p_forward.coord_frame;
+    t_inv.source_nn = p_forward.source_nn;
+    t_inv.src = p_forward.src;
+    t_inv.nave = 1;
+
+    //
+    //   Full noise covariance, eigenvalues ascending, rows of eigvec are the eigenvectors
+    //
+    MatrixXd t_matA = data(t_iNumChannels, 2*t_iNumChannels, 4);
+    MatrixXd t_matC = t_matA*t_matA.transpose()/(2*t_iNumChannels) + MatrixXd::Identity(t_iNumChannels, t_iNumChannels)*0.1;
+    SelfAdjointEigenSolver<MatrixXd> t_eigC(t_matC);
+
+    t_inv.noise_cov->kind = FIFFV_MNE_NOISE_COV;
+    t_inv.noise_cov->diag = false;
+    t_inv.noise_cov->dim = t_iNumChannels;
+    t_inv.noise_cov->names = p_forward.info.ch_names;
+    t_inv.noise_cov->data = t_matC;
+    t_inv.noise_cov->eig = t_eigC.eigenvalues();
+    t_inv.noise_cov->eigvec = t_eigC.eigenvectors().transpose();
+    t_inv.noise_cov->nfree = 2*t_iNumChannels;
+
+    t_inv.source_cov->kind = FIFFV_MNE_SOURCE_COV;
+    t_inv.source_cov->diag = true;
+    t_inv.source_cov->dim = t_iNumComps;
+    t_inv.source_cov->data = MatrixXd::Ones(t_iNumComps, 1);
+
+    t_inv.orient_prior->diag = true;
+    t_inv.orient_prior->dim = t_iNumComps;
+    t_inv.orient_prior->data = MatrixXd::Ones(t_iNumComps, 1);
+
+    //
+    //   Whitener as prepare_inverse_operator builds it; SVD of the whitened gain matrix G_w = U S V' through the
+    //   eigen decomposition of G_w G_w', which is much cheaper than a SVD of the wide gain matrix: V = G_w' U S^-1
+    //
+    MatrixXd t_matWhitener = t_eigC.eigenvalues().cwiseSqrt().cwiseInverse().asDiagonal() * t_inv.noise_cov->eigvec;
+    MatrixXd t_matGw = t_matWhitener * p_forward.sol->data;
+    SelfAdjointEigenSolver<MatrixXd> t_eigG(t_matGw*t_matGw.transpose());
+
+    VectorXd t_vecSing = t_eigG.eigenvalues().reverse().cwiseMax(0).cwiseSqrt();
+    MatrixXd t_matU = t_eigG.eigenvectors().rowwise().reverse();
+
+    t_inv.sing = t_vecSing;
+    t_inv.eigen_leads_weighted = false;
+
+    t_inv.eigen_fields->data = t_matU.transpose();
+    t_inv.eigen_fields->nrow = t_matU.cols();
+    t_inv.eigen_fields->ncol = t_iNumChannels;
+    t_inv.eigen_fields->col_names = p_forward.info.ch_names;
+
+    VectorXd t_vecSingInv = VectorXd::Zero(t_vecSing.size());
+    for(qint32 i = 0; i < t_vecSing.size(); ++i)
+        if(t_vecSing[i] > 0)
+            t_vecSingInv[i] = 1.0/t_vecSing[i];
+
+    t_inv.eigen_leads->data = (t_matGw.transpose() * t_matU) * t_vecSingInv.asDiagonal();
+    t_inv.eigen_leads->nrow = t_iNumComps;
+    t_inv.eigen_leads->ncol = t_matU.cols();
+
+    return t_inv;
+}
+
+
+//*************************************************************************************************************
+
+AnnotationSet SyntheticData::annotationSet(const MNEForwardSolution &p_forward, qint32 p_iNumLabels)
+{
+    AnnotationSet t_annotationSet;
+
+    for(qint32 h = 0; h < 2; ++h)
+    {
+        Annotation &t_annotation = t_annotationSet[h];
+        qint32 t_iNumVert = p_forward.src[h].np;
+
+        //
+        //   Id 0 is the unlabeled rest, which is not clustered
+        //
+        Colortable &t_colortable = t_annotation.getColortable();
+        t_colortable.numEntries = p_iNumLabels + 1;
+        t_colortable.table = MatrixXi::Zero(p_iNumLabels + 1, 5);
+        t_colortable.struct_names.clear();
+        t_colortable.struct_names << QString("unknown");
+        for(qint32 i = 1; i <= p_iNumLabels; ++i)
+        {
+            t_colortable.table(i, 4) = i;
+            t_colortable.struct_names << QString("label_%1").arg(i);
+        }
+
+        t_annotation.getVertices() = VectorXi::LinSpaced(t_iNumVert, 0, t_iNumVert - 1);
+        t_annotation.getLabelIds() = VectorXi(t_iNumVert);
+        for(qint32 v = 0; v < t_iNumVert; ++v)
+            t_annotation.getLabelIds()[v] = 1 + (qint32)(((qint64)v * p_iNumLabels) / t_iNumVert);
+    }
+
+    return t_annotationSet;
+}
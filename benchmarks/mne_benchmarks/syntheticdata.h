@@ -0,0 +1,171 @@
+//=============================================================================================================
+/**
+* @file     syntheticdata.h
+* @author   Christoph Dinh <chdinh@nmr.mgh.harvard.edu>;
+*           Matti Hamalainen <msh@nmr.mgh.harvard.edu>
+* @version  1.0
+* @date     October, 2026
+*
+* @section  LICENSE
+*
+* Copyright (C) 2012, Christoph Dinh and Matti Hamalainen. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+* the following conditions are met:
+*     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+*       following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+*       the following disclaimer in the documentation and/or other materials provided with the distribution.
+*     * Neither the name of the Massachusetts General Hospital nor the names of its contributors may be used
+*       to endorse or promote products derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+* PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL MASSACHUSETTS GENERAL HOSPITAL BE LIABLE FOR ANY DIRECT,
+* INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+* NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+* @brief    SyntheticData class declaration.
+*
+*/
+
+#ifndef SYNTHETICDATA_H
+#define SYNTHETICDATA_H
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include <fiff/fiff_info.h>
+#include <fs/annotationset.h>
+#include <mne/mne_forwardsolution.h>
+#include <mne/mne_inverse_operator.h>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// Eigen INCLUDES
+//=============================================================================================================
+
+#include <Eigen/Core>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// QT INCLUDES
+//=============================================================================================================
+
+#include <QString>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// DEFINE NAMESPACE MNEBenchmarks
+//=============================================================================================================
+
+namespace MNEBenchmarks
+{
+
+//*************************************************************************************************************
+//=============================================================================================================
+// USED NAMESPACES
+//=============================================================================================================
+
+using namespace Eigen;
+using namespace FIFFLIB;
+using namespace FSLIB;
+using namespace MNELIB;
+
+
+//=============================================================================================================
+/**
+* Generates inputs with the shapes of the MNE sample data, so that every kernel can be timed without the sample
+* data and at channel and source counts the sample data does not have. The values are random but reproducible,
+* each generator reseeds the random number generator. Channels are laid out like a Vectorview system: up to 306
+* MEG channels in triplets of two planar gradiometers and one magnetometer, the remaining ones EEG; 60 channels
+* or less are EEG only.
+*
+* @brief Generated benchmark inputs
+*/
+class SyntheticData
+{
+public:
+    //=========================================================================================================
+    /**
+    * Generates the measurement info.
+    *
+    * @param[in] p_iNumChannels     Number of channels
+    * @param[in] p_fSFreq           Sampling frequency in Hz
+    *
+    * @return the measurement info
+    */
+    static FiffInfo::SPtr info(qint32 p_iNumChannels, float p_fSFreq = 600.0f);
+
+    //=========================================================================================================
+    /**
+    * Generates a data matrix of sensor or source space amplitudes.
+    *
+    * @param[in] p_iRows    Number of rows
+    * @param[in] p_iCols    Number of columns
+    * @param[in] p_iSeed    Seed of the random number generator
+    *
+    * @return the data matrix
+    */
+    static MatrixXd data(qint32 p_iRows, qint32 p_iCols, unsigned int p_iSeed = 1);
+
+    //=========================================================================================================
+    /**
+    * Writes a raw data file in buffers of one second.
+    *
+    * @param[in] p_sFileName    The file to write
+    * @param[in] p_info         The measurement info
+    * @param[in] p_iNumSamples  Number of samples to write
+    *
+    * @return true if succeeded, false otherwise
+    */
+    static bool writeRaw(const QString &p_sFileName, const FiffInfo &p_info, qint32 p_iNumSamples);
+
+    //=========================================================================================================
+    /**
+    * Generates a free orientation forward solution with two hemispheres. The vertices of each hemisphere are
+    * numbered consecutively, the source locations are spread over a sphere.
+    *
+    * @param[in] p_info             The measurement info
+    * @param[in] p_iNumSources      Number of source locations, split between the hemispheres
+    *
+    * @return the forward solution
+    */
+    static MNEForwardSolution forwardSolution(const FiffInfo &p_info, qint32 p_iNumSources);
+
+    //=========================================================================================================
+    /**
+    * Generates an inverse operator of the given forward solution, decomposed the way make_inverse_operator does
+    * it: whitened gain matrix, unit source covariance and no depth weighting. The noise covariance is a full
+    * random covariance.
+    *
+    * @param[in] p_forward      The forward solution
+    *
+    * @return the inverse operator
+    */
+    static MNEInverseOperator inverseOperator(const MNEForwardSolution &p_forward);
+
+    //=========================================================================================================
+    /**
+    * Generates an annotation of the forward solution's source space which splits each hemisphere into
+    * contiguous labels of about the same size.
+    *
+    * @param[in] p_forward          The forward solution
+    * @param[in] p_iNumLabels       Number of labels per hemisphere
+    *
+    * @return the annotation set
+    */
+    static AnnotationSet annotationSet(const MNEForwardSolution &p_forward, qint32 p_iNumLabels);
+};
+
+} // NAMESPACE
+
+#endif // SYNTHETICDATA_H
@@ -0,0 +1,253 @@
+//=============================================================================================================
+/**
+* @file     main.cpp
+* @author   Christoph Dinh <chdinh@nmr.mgh.harvard.edu>;
+*           Matti Hamalainen <msh@nmr.mgh.harvard.edu>
+* @version  1.0
+* @date     October, 2026
+*
+* @section  LICENSE
+*
+* Copyright (C) 2012, Christoph Dinh and Matti Hamalainen. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+* the following conditions are met:
+*     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+*       following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+*       the following disclaimer in the documentation and/or other materials provided with the distribution.
+*     * Neither the name of the Massachusetts General Hospital nor the names of its contributors may be used
+*       to endorse or promote products derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+* PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL MASSACHUSETTS GENERAL HOSPITAL BE LIABLE FOR ANY DIRECT,
+* INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+* NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+* @brief    Round-trip and throughput benchmark of compressed raw data buffers against the uncompressed path.
+*
+*/
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include <iostream>
+#include <math.h>
+
+
+#include <fiff/fiff.h>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// QT INCLUDES
+//=============================================================================================================
+
+#include <QtCore/QCoreApplication>
+#include <QElapsedTimer>
+#include <QFileInfo>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// USED NAMESPACES
+//=============================================================================================================
+
+using namespace FIFFLIB;
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// STATIC DEFINITIONS
+//=============================================================================================================
+
+//=============================================================================================================
+/**
+* Reads a raw file sequentially in quanta and returns the elapsed time in seconds.
+*
+* @param[in] p_qStringFile  The file to read
+* @param[in] quantum        Number of samples per read
+* @param[in] p_pReference   If given, each quantum is compared to the same quantum of this file
+* @param[out] p_dMaxError   Largest absolute difference to the reference
+*
+* @return elapsed time in seconds, negative if reading failed
+*/
+static double timeRead(const QString& p_qStringFile, fiff_int_t quantum, FiffRawData* p_pReference, double& p_dMaxError)
+{
+    QFile t_file(p_qStringFile);
+    FiffRawData raw(t_file);
+    if(raw.info.nchan <= 0)
+        return -1.0;
+
+    MatrixXd data, times, ref;
+    p_dMaxError = 0;
+
+    QElapsedTimer timer;
+    qint64 t_iNs = 0;
+    for(fiff_int_t first = raw.first_samp; first <= raw.last_samp; first += quantum)
+    {
+        fiff_int_t last = qMin(first + quantum - 1, raw.last_samp);
+
+        timer.start();
+        if(!raw.read_raw_segment(data, times, first, last))
+            return -1.0;
+        t_iNs += timer.nsecsElapsed();
+
+        if(p_pReference)
+        {
+            p_pReference->read_raw_segment(ref, times, first, last);
+            p_dMaxError = qMax(p_dMaxError, (data - ref).cwiseAbs().maxCoeff());
+        }
+    }
+
+    return t_iNs*1e-9;
+}
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// MAIN
+//=============================================================================================================
+
+//=============================================================================================================
+/**
+* The function main marks the entry point of the program.
+* By default, main has the storage class extern.
+*
+* @param [in] argc (argument count) is an integer that indicates how many arguments were entered on the command line when the program was started.
+* @param [in] argv (argument vector) is an array of pointers to arrays of character objects. The array objects are null-terminated strings, representing the arguments that were entered on the command line when the program was started.
+* @return the value that was set to exit() (which is 0 if exit() is called via quit()).
+*/
+int main(int argc, char *argv[])
+{
+    QCoreApplication a(argc, argv);
+
+    QString t_sFileIn = argc > 1 ? QString(argv[1]) : QString("./MNE-sample-data/MEG/sample/sample_audvis_raw.fif");
+    QString t_sFilePlain("./MNE-sample-data/MEG/sample/sample_write/test_plain.fif");
+    QString t_sFileCompressed("./MNE-sample-data/MEG/sample/sample_write/test_compressed.fif");
+
+    QFile t_fileIn(t_sFileIn);
+    FiffRawData raw(t_fileIn);
+    if(raw.info.nchan <= 0 || raw.rawdir.size() == 0)
+    {
+        printf("Cannot read %s\n", t_sFileIn.toUtf8().constData());
+        return -1;
+    }
+
+    //
+    //   Keep the storage type of the input, so that the compressed copy is exact
+    //
+    fiff_int_t t_iStoreType = FIFFT_FLOAT;
+    for(qint32 k = 0; k < raw.rawdir.size(); ++k)
+    {
+        if(raw.rawdir[k].ent.kind != -1)
+        {
+            fiff_int_t t_iType = raw.rawdir[k].ent.type;
+            if(t_iType == FIFFT_DAU_PACK16 || t_iType == FIFFT_SHORT || t_iType == FIFFT_INT)
+                t_iStoreType = t_iType;
+            break;
+        }
+    }
+    qint32 t_iBytesPerSample = (t_iStoreType == FIFFT_DAU_PACK16 || t_iStoreType == FIFFT_SHORT) ? 2 : 4;
+
+    fiff_int_t quantum = ceil(10.0f*raw.info.sfreq);
+
+    //
+    //   Write an uncompressed and a compressed copy, timing the buffer writes only
+    //
+    QFile t_filePlain(t_sFilePlain);
+    QFile t_fileCompressed(t_sFileCompressed);
+    MatrixXd cals;
+    FiffStream::SPtr t_pPlain = FiffStream::start_writing_raw(t_filePlain, raw.info, cals);
+    FiffStream::SPtr t_pCompressed = FiffStream::start_writing_raw(t_fileCompressed, raw.info, cals);
+
+    MatrixXd data, times;
+    QElapsedTimer timer;
+    qint64 t_iNsWritePlain = 0, t_iNsWriteCompressed = 0;
+    qint64 t_iNsEncode = 0, t_iNsDecode = 0;
+    qint64 t_iSamples = 0;
+    QByteArray t_qByteArrayCoded;
+    MatrixXd t_matDecoded;
+
+    for(fiff_int_t first = raw.first_samp; first <= raw.last_samp; first += quantum)
+    {
+        fiff_int_t last = qMin(first + quantum - 1, raw.last_samp);
+        if(!raw.read_raw_segment(data, times, first, last))
+        {
+            printf("error during read_raw_segment\n");
+            return -1;
+        }
+        if(first == raw.first_samp && first > 0)
+        {
+            t_pPlain->write_int(FIFF_FIRST_SAMPLE, &first);
+            t_pCompressed->write_int(FIFF_FIRST_SAMPLE, &first);
+        }
+
+        timer.start();
+        t_pPlain->write_raw_buffer(data, cals);
+        t_iNsWritePlain += timer.nsecsElapsed();
+
+        timer.start();
+        t_pCompressed->write_raw_buffer_compressed(data, cals, t_iStoreType);
+        t_iNsWriteCompressed += timer.nsecsElapsed();
+
+        //
+        //   In-memory codec throughput, without any file I/O
+        //
+        timer.start();
+        FiffBufferCodec::encode(data, cals, t_iStoreType, t_qByteArrayCoded);
+        t_iNsEncode += timer.nsecsElapsed();
+
+        timer.start();
+        FiffBufferCodec::decode(reinterpret_cast<const uchar*>(t_qByteArrayCoded.constData()), t_qByteArrayCoded.size(), t_matDecoded);
+        t_iNsDecode += timer.nsecsElapsed();
+
+        t_iSamples += data.cols();
+    }
+    t_pPlain->finish_writing_raw();
+    t_pCompressed->finish_writing_raw();
+
+    //
+    //   Read back: original, uncompressed copy and compressed copy; the compressed copy is compared to the original
+    //
+    double t_dErrCompressed, t_dErrNone;
+    double t_dReadIn = timeRead(t_sFileIn, quantum, NULL, t_dErrNone);
+    double t_dReadPlain = timeRead(t_sFilePlain, quantum, NULL, t_dErrNone);
+    double t_dReadCompressed = timeRead(t_sFileCompressed, quantum, &raw, t_dErrCompressed);
+
+    double t_dStoredMB = (double)t_iSamples*raw.info.nchan*t_iBytesPerSample/(1024.0*1024.0);
+    qint64 t_iSizeInput = QFileInfo(t_sFileIn).size();
+    qint64 t_iSizePlain = QFileInfo(t_sFilePlain).size();
+    qint64 t_iSizeCompressed = QFileInfo(t_sFileCompressed).size();
+
+    //
+    //   Machine readable summary, one key value pair per line; MB/s refer to the uncompressed storage size.
+    //   The compression ratio is taken against the input, which holds the data in the same storage type as the
+    //   compressed copy; the plain copy is always float32 and only gives the ratio against float32.
+    //
+    printf("store_type %d\n", t_iStoreType);
+    printf("channels %d\n", raw.info.nchan);
+    printf("samples %lld\n", t_iSamples);
+    printf("size_input_bytes %lld\n", t_iSizeInput);
+    printf("size_plain_float32_bytes %lld\n", t_iSizePlain);
+    printf("size_compressed_bytes %lld\n", t_iSizeCompressed);
+    printf("compression_ratio %.3f\n", (double)t_iSizeInput/(double)t_iSizeCompressed);
+    printf("compression_ratio_vs_float32 %.3f\n", (double)t_iSizePlain/(double)t_iSizeCompressed);
+    printf("encode_mb_s %.1f\n", t_dStoredMB/(t_iNsEncode*1e-9));
+    printf("decode_mb_s %.1f\n", t_dStoredMB/(t_iNsDecode*1e-9));
+    printf("write_plain_mb_s %.1f\n", t_dStoredMB/(t_iNsWritePlain*1e-9));
+    printf("write_compressed_mb_s %.1f\n", t_dStoredMB/(t_iNsWriteCompressed*1e-9));
+    printf("read_input_mb_s %.1f\n", t_dStoredMB/t_dReadIn);
+    printf("read_plain_mb_s %.1f\n", t_dStoredMB/t_dReadPlain);
+    printf("read_compressed_mb_s %.1f\n", t_dStoredMB/t_dReadCompressed);
+    printf("roundtrip_max_abs_error %g\n", t_dErrCompressed);
+
+    return 0;
+}
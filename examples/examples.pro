@@ -41,6 +41,7 @@ TEMPLATE = subdirs
 SUBDIRS += \
     readRaw \
     readWriteRaw \
+    compressRaw \
     readFwd \
     readEpochs \
     readEvoked \
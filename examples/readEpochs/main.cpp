@@ -274,69 +274,11 @@ int main(int argc, char *argv[])
         }
     }
     //
-    //    Select the desired events
+    //    Read the epochs of the desired events in a single pass over the data
     //
-    qint32 count = 0;
-    MatrixXi selected = MatrixXi::Zero(1, events.rows());
-    for (p = 0; p < events.rows(); ++p)
-    {
-        if (events(p,1) == 0 && events(p,2) == event)
-        {
-            selected(0,count) = p;
-            ++count;
-        }
-    }
-    selected.conservativeResize(1, count);
-    if (count > 0)
-        printf("%d matching events found\n",count);
-    else
-    {
-        printf("No desired events found.\n");
+    MNEEpochDataList data = MNEEpochDataList::readEpochs(raw, events, tmin, tmax, event, picks);
+    if (data.size() == 0)
         return 0;
-    }
-
-
-    fiff_int_t event_samp, from, to;
-    MatrixXd timesDummy;
-
-    MNEEpochDataList data;
-
-    MNEEpochData* epoch = NULL;
-
-    MatrixXd times;
-
-    for (p = 0; p < count; ++p)
-    {
-        //
-        //       Read a data segment
-        //
-        event_samp = events(selected(p),0);
-        from = event_samp + tmin*raw.info.sfreq;
-        to   = event_samp + floor(tmax*raw.info.sfreq + 0.5);
-
-        epoch = new MNEEpochData();
-
-        if(raw.read_raw_segment(epoch->epoch, timesDummy, from, to, picks))
-        {
-            if (p == 0)
-            {
-                times.resize(1, to-from+1);
-                for (qint32 i = 0; i < times.cols(); ++i)
-                    times(0, i) = ((float)(from-event_samp+i)) / raw.info.sfreq;
-            }
-
-            epoch->event = event;
-            epoch->tmin = ((float)(from)-(float)(raw.first_samp))/raw.info.sfreq;
-            epoch->tmax = ((float)(to)-(float)(raw.first_samp))/raw.info.sfreq;
-
-            data.append(MNEEpochData::SPtr(epoch));//List takes ownwership of the pointer - no delete need
-        }
-        else
-        {
-            printf("Can't read the event data segments");
-            return 0;
-        }
-    }
 
     //Example for average_epochs
     data.average(raw.info,raw.first_samp,raw.last_samp);
@@ -138,19 +138,17 @@ int main(int argc, char *argv[])
     //
     bool first_buffer = true;
 
-    fiff_int_t first, last;
     MatrixXd data;
     MatrixXd times;
 
-    for(first = from; first < to; first+=quantum)
-    {
-        last = first+quantum-1;
-        if (last > to)
-        {
-            last = to;
-        }
+    //
+    //   Decode the next quanta on worker threads while the current one is written
+    //
+    FiffRawReadAhead reader(raw, quantum, 4, 2, from, to/*, picks*/);
 
-        if (!raw.read_raw_segment(data,times,first,last/*,picks*/))
+    for(fiff_int_t first = from; !reader.atEnd(); first+=quantum)
+    {
+        if (!reader.next(data,times))
         {
                 printf("error during read_raw_segment\n");
                 return -1;
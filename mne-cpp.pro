@@ -44,8 +44,9 @@ lessThan(QT_MAJOR_VERSION, 5){
 
 SUBDIRS += \
     MNE \
-    unit_tests \
     examples \
-    applications
+    benchmarks \
+    applications \
+    unit_tests
 
 CONFIG += ordered
@@ -0,0 +1,820 @@
+//=============================================================================================================
+/**
+* @file     main.cpp
+* @author   Christoph Dinh <chdinh@nmr.mgh.harvard.edu>;
+*           Matti Hamalainen <msh@nmr.mgh.harvard.edu>
+* @version  1.0
+* @date     October, 2026
+*
+* @section  LICENSE
+*
+* Copyright (C) 2013, Christoph Dinh and Matti Hamalainen. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+* the following conditions are met:
+*     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+*       following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+*       the following disclaimer in the documentation and/or other materials provided with the distribution.
+*     * Neither the name of the Massachusetts General Hospital nor the names of its contributors may be used
+*       to endorse or promote products derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+* PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL MASSACHUSETTS GENERAL HOSPITAL BE LIABLE FOR ANY DIRECT,
+* INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+* NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+* @brief    Tests of the lock-free SpscMatrixBuffer and a microbenchmark against the semaphore based
+*           CircularMatrixBuffer.
+*
+*/
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include <stdio.h>
+
+#include <generics/circularmatrixbuffer.h>
+#include <generics/spscmatrixbuffer.h>
+#include <generics/broadcastmatrixbuffer.h>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// Eigen
+//=============================================================================================================
+
+#include <Eigen/Core>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// QT INCLUDES
+//=============================================================================================================
+
+#include <QtTest>
+#include <QElapsedTimer>
+#include <QThread>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// USED NAMESPACES
+//=============================================================================================================
+
+using namespace Eigen;
+using namespace IOBuffer;
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// STATIC HELPERS
+//=============================================================================================================
+
+//
+//   Block number i: element (r,c) holds i*rows*cols + c*rows + r, so order and content can both be checked
+//
+static void fillBlock(MatrixXd& p_matBlock, int p_iNumber)
+{
+    double t_dOffset = (double)p_iNumber*p_matBlock.size();
+    for(int c = 0; c < p_matBlock.cols(); ++c)
+        for(int r = 0; r < p_matBlock.rows(); ++r)
+            p_matBlock(r,c) = t_dOffset + c*p_matBlock.rows() + r;
+}
+
+static bool checkBlock(const MatrixXd& p_matBlock, int p_iNumber)
+{
+    double t_dOffset = (double)p_iNumber*p_matBlock.size();
+    for(int c = 0; c < p_matBlock.cols(); ++c)
+        for(int r = 0; r < p_matBlock.rows(); ++r)
+            if(p_matBlock(r,c) != t_dOffset + c*p_matBlock.rows() + r)
+                return false;
+    return true;
+}
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// THREADS
+//=============================================================================================================
+
+enum Variant {
+    Semaphore,      /**< CircularMatrixBuffer push/pop. */
+    SpscCopy,       /**< SpscMatrixBuffer push/pop. */
+    SpscZeroCopy    /**< SpscMatrixBuffer peek/commit. */
+};
+
+//=============================================================================================================
+/**
+* Shared state of one run. The producer writes numbered blocks (see fillBlock), the consumer checks them.
+* With bTiming, the first element of each block carries the time it was produced instead and only the last
+* element is checked.
+*/
+struct Run
+{
+    Variant variant;
+    int numBlocks;
+    bool bTiming;
+    QElapsedTimer timer;
+    CircularMatrixBuffer<double>* pSemaphoreBuffer;
+    SpscMatrixBuffer<double>* pSpscBuffer;
+
+    double latencySum;      /**< Written by the consumer, [ns]. */
+    double latencyMax;      /**< Written by the consumer, [ns]. */
+    double checksum;        /**< Written by the consumer, sum of the last element of all blocks. */
+    int numMismatches;      /**< Written by the consumer, blocks which arrived out of order or corrupted. */
+};
+
+
+//*************************************************************************************************************
+
+class Producer : public QThread
+{
+public:
+    Producer(Run* pRun, int rows, int cols) : m_pRun(pRun), m_matBlock(rows, cols) {}
+
+protected:
+    void run()
+    {
+        for(int i = 0; i < m_pRun->numBlocks; ++i)
+        {
+            fillBlock(m_matBlock, i);
+            if(m_pRun->bTiming)
+                m_matBlock(0,0) = (double)m_pRun->timer.nsecsElapsed();
+            switch(m_pRun->variant)
+            {
+                case Semaphore:
+                    m_pRun->pSemaphoreBuffer->push(&m_matBlock);
+                    break;
+                case SpscCopy:
+                    m_pRun->pSpscBuffer->push(&m_matBlock);
+                    break;
+                case SpscZeroCopy:
+                {
+                    SpscMatrixBuffer<double>::MatrixMap slot = m_pRun->pSpscBuffer->peekWrite();
+                    slot = m_matBlock;
+                    m_pRun->pSpscBuffer->commitWrite();
+                    break;
+                }
+            }
+        }
+    }
+
+private:
+    Run* m_pRun;
+    MatrixXd m_matBlock;
+};
+
+
+//*************************************************************************************************************
+
+class Consumer : public QThread
+{
+public:
+    Consumer(Run* pRun) : m_pRun(pRun) {}
+
+protected:
+    void run()
+    {
+        MatrixXd block(m_pRun->pSpscBuffer->rows(), m_pRun->pSpscBuffer->cols());
+        m_pRun->latencySum = 0;
+        m_pRun->latencyMax = 0;
+        m_pRun->checksum = 0;
+        m_pRun->numMismatches = 0;
+
+        for(int i = 0; i < m_pRun->numBlocks; ++i)
+        {
+            switch(m_pRun->variant)
+            {
+                case Semaphore:
+                    block = m_pRun->pSemaphoreBuffer->pop();
+                    break;
+                case SpscCopy:
+                    m_pRun->pSpscBuffer->pop(block);
+                    break;
+                default:
+                {
+                    SpscMatrixBuffer<double>::ConstMatrixMap slot = m_pRun->pSpscBuffer->peekRead();
+                    block = slot;
+                    m_pRun->pSpscBuffer->commitRead();
+                    break;
+                }
+            }
+
+            double last = block(block.rows()-1, block.cols()-1);
+            if(m_pRun->bTiming)
+            {
+                double latency = (double)m_pRun->timer.nsecsElapsed() - block(0,0);
+                m_pRun->latencySum += latency;
+                m_pRun->latencyMax = qMax(m_pRun->latencyMax, latency);
+                if(last != (double)(i+1)*block.size() - 1)
+                    ++m_pRun->numMismatches;
+            }
+            else if(!checkBlock(block, i))
+                ++m_pRun->numMismatches;
+            m_pRun->checksum += last;
+        }
+    }
+
+private:
+    Run* m_pRun;
+};
+
+
+//=============================================================================================================
+/**
+* Tests of the SpscMatrixBuffer and the BroadcastMatrixBuffer.
+*/
+class TestMneBuffer : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void emptyAndFull();
+    void wrapAround();
+    void release();
+    void threadedOrderAndContent_data();
+    void threadedOrderAndContent();
+    void benchmark();
+    void broadcastBlockReaders();
+    void broadcastSkipReader();
+    void broadcastRelease();
+    void broadcastAttachDetach();
+    void broadcastTimestamps();
+
+private:
+    void runThreads(Run& run, int rows, int cols);
+
+    int m_iRows;
+    int m_iCols;
+    int m_iSlots;
+};
+
+
+//*************************************************************************************************************
+
+void TestMneBuffer::initTestCase()
+{
+    //306 channels, blocks of 16 samples
+    m_iRows = 306;
+    m_iCols = 16;
+    m_iSlots = 8;
+}
+
+
+//*************************************************************************************************************
+
+void TestMneBuffer::emptyAndFull()
+{
+    SpscMatrixBuffer<double> buffer(m_iSlots, m_iRows, m_iCols);
+    MatrixXd block(m_iRows, m_iCols);
+
+    //Empty: non-waiting reads fail and leave the buffer untouched
+    QCOMPARE(buffer.count(), (quint32)0);
+    QVERIFY(!buffer.pop(block, false));
+    QVERIFY(buffer.peekRead(false).data() == NULL);
+
+    //Fill every slot
+    for(quint32 i = 0; i < buffer.size(); ++i)
+    {
+        fillBlock(block, i);
+        QVERIFY(buffer.push(&block, false));
+    }
+    QCOMPARE(buffer.count(), buffer.size());
+
+    //Full: non-waiting writes fail and do not overwrite the oldest block
+    fillBlock(block, buffer.size());
+    QVERIFY(!buffer.push(&block, false));
+    QVERIFY(buffer.peekWrite(false).data() == NULL);
+    QCOMPARE(buffer.count(), buffer.size());
+
+    //Matrices of the wrong size are rejected
+    MatrixXd wrongSize(m_iRows, m_iCols + 1);
+    QVERIFY(!buffer.push(&wrongSize, false));
+
+    //Drain in order
+    for(quint32 i = 0; i < buffer.size(); ++i)
+    {
+        QVERIFY(buffer.pop(block, false));
+        QVERIFY(checkBlock(block, i));
+    }
+    QCOMPARE(buffer.count(), (quint32)0);
+    QVERIFY(!buffer.pop(block, false));
+}
+
+
+//*************************************************************************************************************
+
+void TestMneBuffer::wrapAround()
+{
+    SpscMatrixBuffer<double> buffer(m_iSlots, m_iRows, m_iCols);
+    MatrixXd block(m_iRows, m_iCols);
+
+    //Keep the ring partly filled while the indices wrap several times, mixing both APIs
+    const int numBlocks = 5*buffer.size() + 3;
+    const int lead = buffer.size() - 1;
+    int written = 0;
+    int read = 0;
+    while(read < numBlocks)
+    {
+        while(written < numBlocks && written - read < lead)
+        {
+            if(written % 2)
+            {
+                SpscMatrixBuffer<double>::MatrixMap slot = buffer.peekWrite(false);
+                QVERIFY(slot.data() != NULL);
+                fillBlock(block, written);
+                slot = block;
+                buffer.commitWrite();
+            }
+            else
+            {
+                fillBlock(block, written);
+                QVERIFY(buffer.push(&block, false));
+            }
+            ++written;
+        }
+        QCOMPARE(buffer.count(), (quint32)(written - read));
+
+        if(read % 3)
+        {
+            SpscMatrixBuffer<double>::ConstMatrixMap slot = buffer.peekRead(false);
+            QVERIFY(slot.data() != NULL);
+            block = slot;
+            buffer.commitRead();
+        }
+        else
+            QVERIFY(buffer.pop(block, false));
+        QVERIFY2(checkBlock(block, read), qPrintable(QString("Block %1 out of order or corrupted").arg(read)));
+        ++read;
+    }
+    QCOMPARE(buffer.count(), (quint32)0);
+}
+
+
+//*************************************************************************************************************
+
+class BlockedReader : public QThread
+{
+public:
+    BlockedReader(SpscMatrixBuffer<double>* pBuffer) : m_pBuffer(pBuffer), m_bPopped(true) {}
+    bool popped() const { return m_bPopped; }
+
+protected:
+    void run()
+    {
+        MatrixXd block;
+        m_bPopped = m_pBuffer->pop(block);
+    }
+
+private:
+    SpscMatrixBuffer<double>* m_pBuffer;
+    bool m_bPopped;
+};
+
+void TestMneBuffer::release()
+{
+    SpscMatrixBuffer<double> buffer(m_iSlots, m_iRows, m_iCols, 10);
+
+    //A reader waiting on an empty buffer returns false once the buffer is released
+    BlockedReader reader(&buffer);
+    reader.start();
+    QTest::qWait(50);
+    buffer.release();
+    QVERIFY(reader.wait(5000));
+    QVERIFY(!reader.popped());
+
+    //clear() makes the buffer usable again
+    buffer.clear();
+    MatrixXd block(m_iRows, m_iCols);
+    fillBlock(block, 0);
+    QVERIFY(buffer.push(&block, false));
+    QVERIFY(buffer.pop(block, false));
+    QVERIFY(checkBlock(block, 0));
+}
+
+
+//*************************************************************************************************************
+
+void TestMneBuffer::threadedOrderAndContent_data()
+{
+    QTest::addColumn<int>("variant");
+    QTest::addColumn<int>("spinCount");
+
+    QTest::newRow("copy, spinning") << (int)SpscCopy << 1000;
+    QTest::newRow("copy, parking") << (int)SpscCopy << 0;
+    QTest::newRow("zero copy, spinning") << (int)SpscZeroCopy << 1000;
+    QTest::newRow("zero copy, parking") << (int)SpscZeroCopy << 0;
+}
+
+
+//*************************************************************************************************************
+
+void TestMneBuffer::threadedOrderAndContent()
+{
+    QFETCH(int, variant);
+    QFETCH(int, spinCount);
+
+    SpscMatrixBuffer<double> buffer(m_iSlots, m_iRows, m_iCols, spinCount);
+
+    Run run;
+    run.variant = (Variant)variant;
+    run.numBlocks = 5000;
+    run.bTiming = false;
+    run.pSemaphoreBuffer = NULL;
+    run.pSpscBuffer = &buffer;
+    runThreads(run, m_iRows, m_iCols);
+
+    //Sum over i of the last element of block i
+    double size = (double)m_iRows*m_iCols;
+    double expected = size*(double)run.numBlocks*(run.numBlocks + 1)/2.0 - run.numBlocks;
+
+    QCOMPARE(run.numMismatches, 0);
+    QCOMPARE(run.checksum, expected);
+    QCOMPARE(buffer.count(), (quint32)0);
+}
+
+
+//*************************************************************************************************************
+
+void TestMneBuffer::benchmark()
+{
+    const int numBlocks = 20000;
+
+    CircularMatrixBuffer<double> semaphoreBuffer(m_iSlots, m_iRows, m_iCols);
+    SpscMatrixBuffer<double> spscBuffer(m_iSlots, m_iRows, m_iCols);
+
+    const char* names[] = { "semaphore", "spsc_copy", "spsc_zero_copy" };
+
+    double size = (double)m_iRows*m_iCols;
+    double expected = size*(double)numBlocks*(numBlocks + 1)/2.0 - numBlocks;
+
+    //
+    //   Machine readable: one line per variant
+    //
+    printf("variant blocks ns_per_block latency_mean_us latency_max_us checksum\n");
+    for(int v = Semaphore; v <= SpscZeroCopy; ++v)
+    {
+        Run run;
+        run.variant = (Variant)v;
+        run.numBlocks = numBlocks;
+        run.bTiming = true;
+        run.pSemaphoreBuffer = &semaphoreBuffer;
+        run.pSpscBuffer = &spscBuffer;
+
+        runThreads(run, m_iRows, m_iCols);
+        qint64 elapsed = run.timer.nsecsElapsed();
+
+        printf("%s %d %.1f %.2f %.2f %.0f\n", names[v], numBlocks, (double)elapsed/numBlocks, run.latencySum/numBlocks*1e-3, run.latencyMax*1e-3, run.checksum);
+
+        QCOMPARE(run.numMismatches, 0);
+        QCOMPARE(run.checksum, expected);
+    }
+}
+
+
+//*************************************************************************************************************
+
+class BroadcastReader : public QThread
+{
+public:
+    BroadcastReader(BroadcastMatrixBuffer<double>* pBuffer, BroadcastMatrixBuffer<double>::ReaderPolicy policy, int iDelayUs = 0)
+    : m_reader(pBuffer, policy), m_iDelayUs(iDelayUs), m_iNumRead(0), m_iNumMismatches(0) {}
+    BroadcastMatrixBuffer<double>::Reader& reader() { return m_reader; }
+    int numRead() const { return m_iNumRead; }
+    int numMismatches() const { return m_iNumMismatches; }
+
+protected:
+    void run()
+    {
+        //Reads until the buffer is released and drained; Block readers see every block, Skip readers may leave gaps
+        MatrixXd block;
+        int last = -1;
+        while(m_reader.pop(block))
+        {
+            int number = (int)(block(0,0)/block.size());
+            bool bInOrder = m_reader.policy() == BroadcastMatrixBuffer<double>::Block ? number == last + 1 : number > last;
+            if(!bInOrder || !checkBlock(block, number))
+                ++m_iNumMismatches;
+            last = number;
+            ++m_iNumRead;
+            if(m_iDelayUs > 0)
+                usleep(m_iDelayUs);
+        }
+    }
+
+private:
+    BroadcastMatrixBuffer<double>::Reader m_reader;
+    int m_iDelayUs;
+    int m_iNumRead;
+    int m_iNumMismatches;
+};
+
+
+//*************************************************************************************************************
+
+class BroadcastWriter : public QThread
+{
+public:
+    BroadcastWriter(BroadcastMatrixBuffer<double>* pBuffer, int iNumBlocks = -1)
+    : m_pBuffer(pBuffer), m_iNumBlocks(iNumBlocks), m_iNumPushed(0), m_bFailed(false) {}
+    void stop() { m_iStop.storeRelease(1); }
+    int numPushed() const { return m_iNumPushed; }
+    bool failed() const { return m_bFailed; }
+
+protected:
+    void run()
+    {
+        //Writes numbered blocks until iNumBlocks are written (unlimited if negative), stop() or a failed push
+        MatrixXd block(m_pBuffer->rows(), m_pBuffer->cols());
+        while(m_iStop.loadAcquire() == 0 && m_iNumPushed != m_iNumBlocks)
+        {
+            fillBlock(block, m_iNumPushed);
+            if(!m_pBuffer->push(&block))
+            {
+                m_bFailed = true;
+                break;
+            }
+            ++m_iNumPushed;
+        }
+    }
+
+private:
+    BroadcastMatrixBuffer<double>* m_pBuffer;
+    int m_iNumBlocks;
+    int m_iNumPushed;
+    bool m_bFailed;
+    QAtomicInt m_iStop;
+};
+
+
+//*************************************************************************************************************
+
+void TestMneBuffer::broadcastBlockReaders()
+{
+    BroadcastMatrixBuffer<double> buffer(m_iSlots, m_iRows, m_iCols);
+
+    //One slow reader, the producer has to wait for it
+    QList<BroadcastReader*> readers;
+    readers << new BroadcastReader(&buffer, BroadcastMatrixBuffer<double>::Block)
+            << new BroadcastReader(&buffer, BroadcastMatrixBuffer<double>::Block)
+            << new BroadcastReader(&buffer, BroadcastMatrixBuffer<double>::Block, 50);
+    int numReaders = buffer.readerCount();
+
+    BroadcastWriter writer(&buffer, 2000);
+    for(int i = 0; i < readers.size(); ++i)
+        readers[i]->start();
+    writer.start();
+
+    bool bWriterDone = writer.wait(60000);
+    buffer.release();
+    bool bReadersDone = true;
+    for(int i = 0; i < readers.size(); ++i)
+        bReadersDone = readers[i]->wait(5000) && bReadersDone;
+
+    QCOMPARE(numReaders, readers.size());
+    QVERIFY(bWriterDone);
+    QVERIFY(bReadersDone);
+    QVERIFY(!writer.failed());
+    for(int i = 0; i < readers.size(); ++i)
+    {
+        QCOMPARE(readers[i]->numRead(), writer.numPushed());
+        QCOMPARE(readers[i]->numMismatches(), 0);
+        QCOMPARE(readers[i]->reader().dropped(), (quint64)0);
+    }
+
+    qDeleteAll(readers);
+    QCOMPARE(buffer.readerCount(), 0);
+}
+
+
+//*************************************************************************************************************
+
+void TestMneBuffer::broadcastSkipReader()
+{
+    BroadcastMatrixBuffer<double> buffer(m_iSlots, m_iRows, m_iCols);
+    BroadcastMatrixBuffer<double>::Reader fast(&buffer, BroadcastMatrixBuffer<double>::Block);
+    BroadcastMatrixBuffer<double>::Reader slow(&buffer, BroadcastMatrixBuffer<double>::Skip);
+    MatrixXd block(m_iRows, m_iCols);
+
+    //The Skip reader does not read at all, it never stalls the producer
+    const int numBlocks = 3*buffer.size() + 2;
+    for(int i = 0; i < numBlocks; ++i)
+    {
+        fillBlock(block, i);
+        QVERIFY(buffer.push(&block, false));
+        QVERIFY(fast.pop(block, false));
+        QVERIFY(checkBlock(block, i));
+    }
+    QCOMPARE(fast.dropped(), (quint64)0);
+
+    //It lost the oldest blocks and keeps the newest ring
+    QCOMPARE(slow.dropped(), (quint64)(numBlocks - buffer.size()));
+    QCOMPARE(slow.available(), buffer.size());
+    for(int i = numBlocks - buffer.size(); i < numBlocks; ++i)
+    {
+        QVERIFY(slow.pop(block, false));
+        QVERIFY(checkBlock(block, i));
+    }
+    QVERIFY(!slow.pop(block, false));
+
+    //A slot held by peek() is not taken away, the producer has to wait instead
+    for(quint32 i = 0; i < buffer.size(); ++i)
+    {
+        fillBlock(block, numBlocks + i);
+        QVERIFY(buffer.push(&block, false));
+        QVERIFY(fast.pop(block, false));
+    }
+    BroadcastMatrixBuffer<double>::ConstMatrixMap held = slow.peek(false);
+    QVERIFY(held.data() != NULL);
+    QVERIFY(!buffer.push(&block, false));
+    QVERIFY(checkBlock(held, numBlocks));
+    slow.commit();
+    QVERIFY(buffer.push(&block, false));
+    QCOMPARE(slow.dropped(), (quint64)(numBlocks - buffer.size()));
+}
+
+
+//*************************************************************************************************************
+
+void TestMneBuffer::broadcastRelease()
+{
+    BroadcastMatrixBuffer<double> buffer(m_iSlots, m_iRows, m_iCols);
+    BroadcastMatrixBuffer<double>::Reader stalled(&buffer, BroadcastMatrixBuffer<double>::Block);
+    MatrixXd block(m_iRows, m_iCols);
+    for(quint32 i = 0; i < buffer.size(); ++i)
+    {
+        fillBlock(block, i);
+        QVERIFY(buffer.push(&block, false));
+    }
+    QVERIFY(!buffer.push(&block, false));
+
+    //A producer waiting for the stalled reader and a reader waiting for data both return once the buffer is released
+    BroadcastWriter writer(&buffer);
+    BroadcastReader waiting(&buffer, BroadcastMatrixBuffer<double>::Block);
+    writer.start();
+    waiting.start();
+    QTest::qWait(50);
+    bool bWriterBlocked = writer.isRunning();
+    bool bReaderBlocked = waiting.isRunning();
+    buffer.release();
+    QVERIFY(writer.wait(5000));
+    QVERIFY(waiting.wait(5000));
+
+    QVERIFY(bWriterBlocked);
+    QVERIFY(bReaderBlocked);
+    QVERIFY(writer.failed());
+    QCOMPARE(writer.numPushed(), 0);
+    QCOMPARE(waiting.numRead(), 0);
+
+    //Releasing the stalled reader alone lets the producer go on
+    BroadcastMatrixBuffer<double> buffer2(m_iSlots, m_iRows, m_iCols);
+    BroadcastMatrixBuffer<double>::Reader stalled2(&buffer2, BroadcastMatrixBuffer<double>::Block);
+    for(quint32 i = 0; i < buffer2.size(); ++i)
+        QVERIFY(buffer2.push(&block, false));
+
+    BroadcastWriter writer2(&buffer2, 1);
+    writer2.start();
+    QTest::qWait(50);
+    bool bWriter2Blocked = writer2.isRunning();
+    stalled2.release();
+    QVERIFY(writer2.wait(5000));
+
+    QVERIFY(bWriter2Blocked);
+    QVERIFY(!writer2.failed());
+    QCOMPARE(writer2.numPushed(), 1);
+}
+
+
+//*************************************************************************************************************
+
+void TestMneBuffer::broadcastAttachDetach()
+{
+    BroadcastMatrixBuffer<double> buffer(m_iSlots, m_iRows, m_iCols);
+    BroadcastReader permanent(&buffer, BroadcastMatrixBuffer<double>::Block);
+    BroadcastWriter writer(&buffer);
+    permanent.start();
+    writer.start();
+
+    //Readers come and go while the producer runs; they see consecutive blocks from their attachment on
+    MatrixXd block;
+    int numMismatches = 0;
+    int numWrongCounts = 0;
+    for(int k = 0; k < 50; ++k)
+    {
+        BroadcastMatrixBuffer<double>::ReaderPolicy policy = k % 2 ? BroadcastMatrixBuffer<double>::Block : BroadcastMatrixBuffer<double>::Skip;
+        BroadcastMatrixBuffer<double>::Reader* pReader = new BroadcastMatrixBuffer<double>::Reader(&buffer, policy);
+        if(buffer.readerCount() != 2)
+            ++numWrongCounts;
+
+        int last = -1;
+        for(int j = 0; j < 5; ++j)
+        {
+            pReader->pop(block);
+            int number = (int)(block(0,0)/block.size());
+            bool bInOrder = last < 0 || (policy == BroadcastMatrixBuffer<double>::Block ? number == last + 1 : number > last);
+            if(!bInOrder || !checkBlock(block, number))
+                ++numMismatches;
+            last = number;
+        }
+
+        //Detaching a Block reader which is behind must not leave the producer waiting
+        delete pReader;
+        if(buffer.readerCount() != 1)
+            ++numWrongCounts;
+    }
+
+    writer.stop();
+    bool bWriterDone = writer.wait(5000);
+    buffer.release();
+    bool bReaderDone = permanent.wait(5000);
+
+    QVERIFY(bWriterDone);
+    QVERIFY(bReaderDone);
+    QCOMPARE(numMismatches, 0);
+    QCOMPARE(numWrongCounts, 0);
+    QVERIFY(!writer.failed());
+    QCOMPARE(permanent.numRead(), writer.numPushed());
+    QCOMPARE(permanent.numMismatches(), 0);
+}
+
+
+//*************************************************************************************************************
+
+void TestMneBuffer::broadcastTimestamps()
+{
+    BroadcastMatrixBuffer<double> buffer(m_iSlots, m_iRows, m_iCols);
+    BroadcastMatrixBuffer<double>::Reader reader(&buffer, BroadcastMatrixBuffer<double>::Block);
+    MatrixXd block(m_iRows, m_iCols);
+
+    //Each slot keeps its own time stamp while the ring is full, over several wraps and both write paths
+    for(int round = 0; round < 3; ++round)
+    {
+        for(quint32 k = 0; k < buffer.size(); ++k)
+        {
+            int i = round*buffer.size() + k;
+            fillBlock(block, i);
+            if(k % 3 == 0)
+                QVERIFY(buffer.push(&block, false));
+            else if(k % 3 == 1)
+                QVERIFY(buffer.push(&block, false, 1000 + i));
+            else
+            {
+                BroadcastMatrixBuffer<double>::MatrixMap slot = buffer.peekWrite(false);
+                QVERIFY(slot.data() != NULL);
+                slot = block;
+                buffer.commitWrite(1000 + i);
+            }
+        }
+
+        for(quint32 k = 0; k < buffer.size(); ++k)
+        {
+            int i = round*buffer.size() + k;
+            if(k % 2)
+            {
+                BroadcastMatrixBuffer<double>::ConstMatrixMap slot = reader.peek(false);
+                QVERIFY(slot.data() != NULL);
+                QVERIFY(checkBlock(slot, i));
+                reader.commit();
+            }
+            else
+            {
+                QVERIFY(reader.pop(block, false));
+                QVERIFY(checkBlock(block, i));
+            }
+            QCOMPARE(reader.timestamp(), k % 3 == 0 ? (qint64)-1 : (qint64)(1000 + i));
+        }
+    }
+}
+
+
+//*************************************************************************************************************
+
+void TestMneBuffer::runThreads(Run& run, int rows, int cols)
+{
+    Producer producer(&run, rows, cols);
+    Consumer consumer(&run);
+
+    run.timer.start();
+    consumer.start();
+    producer.start();
+    producer.wait();
+    consumer.wait();
+}
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// MAIN
+//=============================================================================================================
+
+QTEST_GUILESS_MAIN(TestMneBuffer)
+#include "main.moc"
@@ -0,0 +1,299 @@
+//=============================================================================================================
+/**
+* @file     main.cpp
+* @author   Christoph Dinh <chdinh@nmr.mgh.harvard.edu>;
+*           Matti Hamalainen <msh@nmr.mgh.harvard.edu>
+* @version  1.0
+* @date     October, 2026
+*
+* @section  LICENSE
+*
+* Copyright (C) 2013, Christoph Dinh and Matti Hamalainen. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+* the following conditions are met:
+*     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+*       following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+*       the following disclaimer in the documentation and/or other materials provided with the distribution.
+*     * Neither the name of the Massachusetts General Hospital nor the names of its contributors may be used
+*       to endorse or promote products derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+* PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL MASSACHUSETTS GENERAL HOSPITAL BE LIABLE FOR ANY DIRECT,
+* INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+* NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+* @brief    Round trip tests of the FiffBufferCodec.
+*
+*/
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include <fiff/fiff_buffer_codec.h>
+#include <fiff/fiff_constants.h>
+
+#include <climits>
+#include <cmath>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// Eigen
+//=============================================================================================================
+
+#include <Eigen/Core>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// QT INCLUDES
+//=============================================================================================================
+
+#include <QtTest>
+#include <QtEndian>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// USED NAMESPACES
+//=============================================================================================================
+
+using namespace Eigen;
+using namespace FIFFLIB;
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// STATIC HELPERS
+//=============================================================================================================
+
+//
+//   Test buffer in the value range of a storage type, channel c%4: constant, alternating between the minimum
+//   and the maximum (full range deltas), pseudo random, smooth. Float values are exactly representable.
+//
+static MatrixXd makeBuffer(fiff_int_t p_iType, qint32 p_iNChan, qint32 p_iNSamp)
+{
+    double t_dMin = p_iType == FIFFT_INT ? -2147483648.0 : p_iType == FIFFT_FLOAT ? -3.4e38 : -32768.0;
+    double t_dMax = p_iType == FIFFT_INT ? 2147483647.0 : p_iType == FIFFT_FLOAT ? 3.4e38 : 32767.0;
+    double t_dScale = p_iType == FIFFT_FLOAT ? 1e-12 : 1000.0;
+
+    MatrixXd t_matData(p_iNChan, p_iNSamp);
+    quint32 t_iSeed = 12345;
+    for(qint32 c = 0; c < p_iNChan; ++c)
+    {
+        for(qint32 s = 0; s < p_iNSamp; ++s)
+        {
+            t_iSeed = t_iSeed*1103515245u + 12345u;
+            double t_dValue;
+            switch(c % 4)
+            {
+                case 0:
+                    t_dValue = 7.0*t_dScale/1000.0;
+                    break;
+                case 1:
+                    t_dValue = s % 2 ? t_dMax : t_dMin;
+                    break;
+                case 2:
+                    t_dValue = (double)((qint32)(t_iSeed >> 16) % 2000 - 1000)*t_dScale/1000.0;
+                    break;
+                default:
+                    t_dValue = sin(0.1*s)*t_dScale;
+                    break;
+            }
+            t_matData(c,s) = p_iType == FIFFT_FLOAT ? (double)(float)t_dValue : floor(t_dValue + 0.5);
+        }
+    }
+    return t_matData;
+}
+
+static bool decode(const QByteArray& p_qByteArray, MatrixXd& p_matData, const RowVectorXi& sel = defaultRowVectorXi)
+{
+    return FiffBufferCodec::decode(reinterpret_cast<const uchar*>(p_qByteArray.constData()), p_qByteArray.size(), p_matData, sel);
+}
+
+
+//=============================================================================================================
+/**
+* Tests of the FiffBufferCodec.
+*/
+class TestMneCodec : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void roundTrip_data();
+    void roundTrip();
+    void constantChannels();
+    void calibration();
+    void truncated();
+    void corrupted();
+};
+
+
+//*************************************************************************************************************
+
+void TestMneCodec::roundTrip_data()
+{
+    QTest::addColumn<int>("type");
+    QTest::addColumn<int>("nsamp");
+
+    const int t_iTypes[] = {FIFFT_INT, FIFFT_SHORT, FIFFT_DAU_PACK16, FIFFT_FLOAT};
+    const int t_iNSamps[] = {1, 2, FiffBufferCodec::BlockSize - 1, FiffBufferCodec::BlockSize, FiffBufferCodec::BlockSize + 1, 1000};
+
+    for(int t = 0; t < 4; ++t)
+        for(int n = 0; n < 6; ++n)
+            QTest::newRow(qPrintable(QString("type %1, %2 samples").arg(t_iTypes[t]).arg(t_iNSamps[n]))) << t_iTypes[t] << t_iNSamps[n];
+}
+
+
+//*************************************************************************************************************
+
+void TestMneCodec::roundTrip()
+{
+    QFETCH(int, type);
+    QFETCH(int, nsamp);
+
+    MatrixXd t_matData = makeBuffer(type, 9, nsamp);
+
+    QByteArray t_qByteArray;
+    QVERIFY(FiffBufferCodec::encode(t_matData, RowVectorXd::Ones(9), type, t_qByteArray));
+
+    fiff_int_t t_iType;
+    qint32 t_iNChan, t_iNSamp;
+    QVERIFY(FiffBufferCodec::readHeader(reinterpret_cast<const uchar*>(t_qByteArray.constData()), t_qByteArray.size(), t_iType, t_iNChan, t_iNSamp));
+    QCOMPARE(t_iType, type);
+    QCOMPARE(t_iNChan, 9);
+    QCOMPARE(t_iNSamp, nsamp);
+
+    //Lossless, all channels
+    MatrixXd t_matDecoded;
+    QVERIFY(decode(t_qByteArray, t_matDecoded));
+    QCOMPARE((int)t_matDecoded.rows(), 9);
+    QCOMPARE((int)t_matDecoded.cols(), nsamp);
+    QVERIFY(t_matDecoded == t_matData);
+
+    //Channel selection
+    RowVectorXi sel(3);
+    sel << 8, 1, 4;
+    QVERIFY(decode(t_qByteArray, t_matDecoded, sel));
+    QCOMPARE((int)t_matDecoded.rows(), 3);
+    for(int r = 0; r < sel.size(); ++r)
+        QVERIFY(t_matDecoded.row(r) == t_matData.row(sel[r]));
+}
+
+
+//*************************************************************************************************************
+
+void TestMneCodec::constantChannels()
+{
+    //A constant channel costs about one bit per sample
+    MatrixXd t_matData = MatrixXd::Constant(4, 640, 42.0);
+
+    QByteArray t_qByteArray;
+    QVERIFY(FiffBufferCodec::encode(t_matData, RowVectorXd::Ones(4), FIFFT_INT, t_qByteArray));
+    QVERIFY(t_qByteArray.size() < t_matData.size()/4);
+
+    MatrixXd t_matDecoded;
+    QVERIFY(decode(t_qByteArray, t_matDecoded));
+    QVERIFY(t_matDecoded == t_matData);
+}
+
+
+//*************************************************************************************************************
+
+void TestMneCodec::calibration()
+{
+    //Integer storage is lossless for data calibrated with the same factors
+    RowVectorXd cals(2);
+    cals << 1e-13, 2.5;
+    MatrixXd t_matRaw(2, 3);
+    t_matRaw << 1, 2, 3,
+               -4, 5, 6;
+    MatrixXd t_matCalibrated = t_matRaw;
+    t_matCalibrated.row(0) *= cals[0];
+    t_matCalibrated.row(1) *= cals[1];
+
+    QByteArray t_qByteArray;
+    QVERIFY(FiffBufferCodec::encode(t_matCalibrated, cals, FIFFT_INT, t_qByteArray));
+
+    MatrixXd t_matDecoded;
+    QVERIFY(decode(t_qByteArray, t_matDecoded));
+    QVERIFY(t_matDecoded == t_matRaw);
+
+    //Sizes and storage types are checked
+    QVERIFY(!FiffBufferCodec::encode(t_matCalibrated, RowVectorXd::Ones(3), FIFFT_INT, t_qByteArray));
+    QVERIFY(!FiffBufferCodec::encode(t_matCalibrated, cals, FIFFT_DOUBLE, t_qByteArray));
+}
+
+
+//*************************************************************************************************************
+
+void TestMneCodec::truncated()
+{
+    QByteArray t_qByteArray;
+    QVERIFY(FiffBufferCodec::encode(makeBuffer(FIFFT_INT, 9, 1000), RowVectorXd::Ones(9), FIFFT_INT, t_qByteArray));
+
+    //Every cut of the payload is detected
+    MatrixXd t_matDecoded;
+    for(int t_iSize = 0; t_iSize < t_qByteArray.size(); t_iSize += 1 + t_qByteArray.size()/100)
+        QVERIFY2(!decode(t_qByteArray.left(t_iSize), t_matDecoded), qPrintable(QString("Payload cut at %1 bytes decoded").arg(t_iSize)));
+}
+
+
+//*************************************************************************************************************
+
+void TestMneCodec::corrupted()
+{
+    const int t_iNChan = 4;
+    const int t_iDirSize = 3*4 + t_iNChan*4;
+
+    QByteArray t_qByteArray;
+    QVERIFY(FiffBufferCodec::encode(makeBuffer(FIFFT_INT, t_iNChan, 100), RowVectorXd::Ones(t_iNChan), FIFFT_INT, t_qByteArray));
+
+    MatrixXd t_matDecoded;
+
+    //Unknown storage type
+    QByteArray t_qByteArrayBad = t_qByteArray;
+    qToBigEndian<qint32>(FIFFT_DOUBLE, reinterpret_cast<uchar*>(t_qByteArrayBad.data()));
+    QVERIFY(!decode(t_qByteArrayBad, t_matDecoded));
+
+    //Sample count which the streams can not hold - must fail before allocating
+    t_qByteArrayBad = t_qByteArray;
+    qToBigEndian<qint32>(INT_MAX, reinterpret_cast<uchar*>(t_qByteArrayBad.data()) + 8);
+    QVERIFY(!decode(t_qByteArrayBad, t_matDecoded));
+
+    //Negative channel byte count, the total still fits
+    t_qByteArrayBad = t_qByteArray;
+    uchar* t_pDir = reinterpret_cast<uchar*>(t_qByteArrayBad.data()) + 12;
+    qToBigEndian<qint32>(-100, t_pDir);
+    qToBigEndian<qint32>(qFromBigEndian<qint32>(t_pDir + 4) + 100, t_pDir + 4);
+    QVERIFY(!decode(t_qByteArrayBad, t_matDecoded));
+
+    //Zeroed channel streams
+    t_qByteArrayBad = t_qByteArray;
+    memset(t_qByteArrayBad.data() + t_iDirSize, 0, t_qByteArrayBad.size() - t_iDirSize);
+    QVERIFY(!decode(t_qByteArrayBad, t_matDecoded));
+
+    //Selection outside of the channels
+    RowVectorXi sel(1);
+    sel << t_iNChan;
+    QVERIFY(!decode(t_qByteArray, t_matDecoded, sel));
+}
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// MAIN
+//=============================================================================================================
+
+QTEST_GUILESS_MAIN(TestMneCodec)
+#include "main.moc"
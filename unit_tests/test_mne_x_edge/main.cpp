@@ -0,0 +1,380 @@
+//=============================================================================================================
+/**
+* @file     main.cpp
+* @author   Christoph Dinh <chdinh@nmr.mgh.harvard.edu>;
+*           Matti Hamalainen <msh@nmr.mgh.harvard.edu>
+* @version  1.0
+* @date     October, 2026
+*
+* @section  LICENSE
+*
+* Copyright (C) 2013, Christoph Dinh and Matti Hamalainen. All rights reserved.
+*
+* Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+* the following conditions are met:
+*     * Redistributions of source code must retain the above copyright notice, this list of conditions and the
+*       following disclaimer.
+*     * Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+*       the following disclaimer in the documentation and/or other materials provided with the distribution.
+*     * Neither the name of the Massachusetts General Hospital nor the names of its contributors may be used
+*       to endorse or promote products derived from this software without specific prior written permission.
+*
+* THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+* WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+* PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL MASSACHUSETTS GENERAL HOSPITAL BE LIABLE FOR ANY DIRECT,
+* INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+* PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+* HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+* NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+* POSSIBILITY OF SUCH DAMAGE.
+*
+* @brief    Tests of the PluginConnectionEdge queue policies.
+*
+*/
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// INCLUDES
+//=============================================================================================================
+
+#include <mne_x/Management/pluginconnectionedge.h>
+#include <mne_x/Management/plugininputconnector.h>
+
+#include <xMeas/newrealtimemultisampleblock.h>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// Eigen
+//=============================================================================================================
+
+#include <Eigen/Core>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// QT INCLUDES
+//=============================================================================================================
+
+#include <QtTest>
+#include <QSemaphore>
+#include <QThread>
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// USED NAMESPACES
+//=============================================================================================================
+
+using namespace Eigen;
+using namespace MNEX;
+using namespace XMEASLIB;
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// RECEIVER
+//=============================================================================================================
+
+//=============================================================================================================
+/**
+* Records the deliveries of an edge. Each delivery waits for a permit of the gate, so the test decides when the
+* receiver may continue. Blocks are recorded by their first element, other measurements as -1.
+*/
+class Receiver : public QObject
+{
+    Q_OBJECT
+public:
+    Receiver() : m_iEntered(0) {}
+
+    QList<int> delivered() const { QMutexLocker locker(&m_mutex); return m_qListDelivered; }
+    int entered() const { QMutexLocker locker(&m_mutex); return m_iEntered; }
+
+    QSemaphore m_gate;
+
+public slots:
+    void update(XMEASLIB::NewMeasurement::SPtr pMeasurement)
+    {
+        m_mutex.lock();
+        ++m_iEntered;
+        m_mutex.unlock();
+
+        m_gate.acquire();
+
+        NewRealTimeMultiSampleBlock::SPtr t_pRTMSB = pMeasurement.dynamicCast<NewRealTimeMultiSampleBlock>();
+        QMutexLocker locker(&m_mutex);
+        m_qListDelivered.append(t_pRTMSB ? (int)t_pRTMSB->getValue()->data()(0,0) : -1);
+    }
+
+private:
+    mutable QMutex m_mutex;
+    int m_iEntered;
+    QList<int> m_qListDelivered;
+};
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// THREADS
+//=============================================================================================================
+
+//=============================================================================================================
+/**
+* Pushes numbered blocks, or a plain measurement without snapshot, through an edge; push may block.
+*/
+class Pusher : public QThread
+{
+public:
+    Pusher(PluginConnectionEdge* pEdge, NewMeasurement::SPtr pMeasurement, int first, int count)
+    : m_pEdge(pEdge), m_pMeasurement(pMeasurement), m_iFirst(first), m_iCount(count) {}
+
+protected:
+    void run()
+    {
+        for(int i = m_iFirst; i < m_iFirst + m_iCount; ++i)
+        {
+            NewRealTimeMultiSampleBlock::SPtr t_pRTMSB = m_pMeasurement.dynamicCast<NewRealTimeMultiSampleBlock>();
+            if(t_pRTMSB)
+            {
+                MatrixXd t_matData = MatrixXd::Constant(4, 8, i);
+                t_pRTMSB->setValue(t_matData, i);
+            }
+            m_pEdge->push(m_pMeasurement);
+        }
+    }
+
+private:
+    PluginConnectionEdge* m_pEdge;
+    NewMeasurement::SPtr m_pMeasurement;
+    int m_iFirst;
+    int m_iCount;
+};
+
+
+//*************************************************************************************************************
+
+class Closer : public QThread
+{
+public:
+    Closer(PluginConnectionEdge* pEdge) : m_pEdge(pEdge) {}
+
+protected:
+    void run() { m_pEdge->close(); }
+
+private:
+    PluginConnectionEdge* m_pEdge;
+};
+
+
+//=============================================================================================================
+/**
+* Tests of the PluginConnectionEdge.
+*/
+class TestMneXEdge : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void init();
+    void cleanup();
+    void blockPolicy();
+    void dropOldest();
+    void coalesceLatest();
+    void closeDuringDrain();
+    void rendezvous();
+
+private:
+    void pushBlocks(int first, int count);
+    void waitEntered(int count);
+
+    QSharedPointer<PluginInputConnector> m_pInput;
+    Receiver* m_pReceiver;
+    PluginConnectionEdge* m_pEdge;
+    NewRealTimeMultiSampleBlock::SPtr m_pRTMSB;
+};
+
+
+//*************************************************************************************************************
+
+void TestMneXEdge::init()
+{
+    m_pInput = QSharedPointer<PluginInputConnector>(new PluginInputConnector(NULL, "in", "Test input"));
+    m_pReceiver = new Receiver;
+    connect(m_pInput.data(), &PluginInputConnector::notify, m_pReceiver, &Receiver::update, Qt::DirectConnection);
+
+    m_pEdge = NULL;
+    m_pRTMSB = NewRealTimeMultiSampleBlock::SPtr(new NewRealTimeMultiSampleBlock);
+}
+
+
+//*************************************************************************************************************
+
+void TestMneXEdge::cleanup()
+{
+    //Let a pending delivery finish before the edge and the receiver go away
+    m_pReceiver->m_gate.release(1000);
+    delete m_pEdge;
+    m_pEdge = NULL;
+    delete m_pReceiver;
+    m_pInput.clear();
+}
+
+
+//*************************************************************************************************************
+
+void TestMneXEdge::pushBlocks(int first, int count)
+{
+    Pusher t_pusher(m_pEdge, m_pRTMSB, first, count);
+    t_pusher.start();
+    QVERIFY(t_pusher.wait(5000));
+}
+
+
+//*************************************************************************************************************
+
+void TestMneXEdge::waitEntered(int count)
+{
+    QTRY_COMPARE_WITH_TIMEOUT(m_pReceiver->entered(), count, 5000);
+}
+
+
+//*************************************************************************************************************
+
+void TestMneXEdge::blockPolicy()
+{
+    m_pEdge = new PluginConnectionEdge(NULL, m_pInput, PluginConnectionEdge::Block, 2);
+
+    //One block in delivery, two queued - the producer waits with the fourth
+    Pusher t_pusher(m_pEdge, m_pRTMSB, 0, 6);
+    t_pusher.start();
+    waitEntered(1);
+    QTest::qWait(100);
+    QVERIFY(t_pusher.isRunning());
+    QCOMPARE(m_pEdge->statistics().iQueued, 2);
+
+    m_pReceiver->m_gate.release(6);
+    QVERIFY(t_pusher.wait(5000));
+    QTRY_COMPARE_WITH_TIMEOUT(m_pEdge->statistics().iDelivered, (quint64)6, 5000);
+
+    QCOMPARE(m_pReceiver->delivered(), QList<int>() << 0 << 1 << 2 << 3 << 4 << 5);
+    QCOMPARE(m_pEdge->statistics().iDropped, (quint64)0);
+    QCOMPARE(m_pEdge->statistics().iMaxQueued, 2);
+}
+
+
+//*************************************************************************************************************
+
+void TestMneXEdge::dropOldest()
+{
+    m_pEdge = new PluginConnectionEdge(NULL, m_pInput, PluginConnectionEdge::DropOldest, 2);
+
+    //Block 0 is in delivery; 1 to 3 are dropped in favour of 4 and 5 without waiting for the receiver
+    pushBlocks(0, 1);
+    waitEntered(1);
+    pushBlocks(1, 5);
+
+    PluginConnectionEdge::Statistics t_statistics = m_pEdge->statistics();
+    QCOMPARE(t_statistics.iReceived, (quint64)6);
+    QCOMPARE(t_statistics.iDropped, (quint64)3);
+    QCOMPARE(t_statistics.iQueued, 2);
+
+    m_pReceiver->m_gate.release(3);
+    QTRY_COMPARE_WITH_TIMEOUT(m_pEdge->statistics().iDelivered, (quint64)3, 5000);
+    QCOMPARE(m_pReceiver->delivered(), QList<int>() << 0 << 4 << 5);
+}
+
+
+//*************************************************************************************************************
+
+void TestMneXEdge::coalesceLatest()
+{
+    m_pEdge = new PluginConnectionEdge(NULL, m_pInput, PluginConnectionEdge::CoalesceLatest, 1);
+
+    //Only the latest block waits behind the one in delivery
+    pushBlocks(0, 1);
+    waitEntered(1);
+    pushBlocks(1, 5);
+
+    PluginConnectionEdge::Statistics t_statistics = m_pEdge->statistics();
+    QCOMPARE(t_statistics.iDropped, (quint64)4);
+    QCOMPARE(t_statistics.iQueued, 1);
+
+    m_pReceiver->m_gate.release(2);
+    QTRY_COMPARE_WITH_TIMEOUT(m_pEdge->statistics().iDelivered, (quint64)2, 5000);
+    QCOMPARE(m_pReceiver->delivered(), QList<int>() << 0 << 5);
+}
+
+
+//*************************************************************************************************************
+
+void TestMneXEdge::closeDuringDrain()
+{
+    m_pEdge = new PluginConnectionEdge(NULL, m_pInput, PluginConnectionEdge::Block, 4);
+
+    pushBlocks(0, 1);
+    waitEntered(1);
+    pushBlocks(1, 2);
+
+    //close() waits for the running delivery and drops the queue
+    Closer t_closer(m_pEdge);
+    t_closer.start();
+    QTest::qWait(100);
+    QVERIFY(t_closer.isRunning());
+
+    m_pReceiver->m_gate.release(1);
+    QVERIFY(t_closer.wait(5000));
+
+    QCOMPARE(m_pReceiver->delivered(), QList<int>() << 0);
+    QCOMPARE(m_pEdge->statistics().iDropped, (quint64)2);
+    QCOMPARE(m_pEdge->statistics().iQueued, 0);
+
+    //A closed edge ignores further measurements
+    pushBlocks(3, 1);
+    QCOMPARE(m_pEdge->statistics().iReceived, (quint64)3);
+    QTest::qWait(50);
+    QCOMPARE(m_pReceiver->entered(), 1);
+}
+
+
+//*************************************************************************************************************
+
+void TestMneXEdge::rendezvous()
+{
+    //Measurements without snapshot are handed over in a rendezvous, whatever the policy
+    m_pEdge = new PluginConnectionEdge(NULL, m_pInput, PluginConnectionEdge::DropOldest, 4);
+
+    NewMeasurement::SPtr t_pShared(new NewMeasurement);
+    Pusher t_pusher(m_pEdge, t_pShared, 0, 1);
+    t_pusher.start();
+    waitEntered(1);
+    QTest::qWait(100);
+    QVERIFY(t_pusher.isRunning());
+
+    m_pReceiver->m_gate.release(1);
+    QVERIFY(t_pusher.wait(5000));
+    QCOMPARE(m_pReceiver->delivered(), QList<int>() << -1);
+
+    //A Block edge without capacity is a rendezvous for blocks too
+    m_pEdge->setPolicy(PluginConnectionEdge::Block, 0);
+
+    Pusher t_pusherBlock(m_pEdge, m_pRTMSB, 1, 1);
+    t_pusherBlock.start();
+    waitEntered(2);
+    QTest::qWait(100);
+    QVERIFY(t_pusherBlock.isRunning());
+
+    m_pReceiver->m_gate.release(1);
+    QVERIFY(t_pusherBlock.wait(5000));
+    QCOMPARE(m_pReceiver->delivered(), QList<int>() << -1 << 1);
+}
+
+
+//*************************************************************************************************************
+//=============================================================================================================
+// MAIN
+//=============================================================================================================
+
+QTEST_GUILESS_MAIN(TestMneXEdge)
+
+#include "main.moc"
@@ -41,12 +41,15 @@ SUBDIRS += \
     test_mne_libs \
     test_mne_rt \
     mne_x_plugin_com \
+    test_mne_buffer \
+    test_mne_codec \
     test_mne_future
 
 contains(MNECPP_CONFIG, isGui) {
     SUBDIRS += \
         test_mne_disp \
         test_mne_graph \
+        test_mne_x_edge \
 
     qtHaveModule(3d) {
         isEqual(QT_MAJOR_VERSION, 5){